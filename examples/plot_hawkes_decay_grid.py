@@ -0,0 +1,88 @@
+"""
+===================================================
+Hawkes decay selection over a grid
+===================================================
+
+Models with exponential kernels of fixed decay precompute weights that depend
+on the decay, hence changing the decay usually triggers a full pass over the
+data. ``compute_weights_for_decays`` precomputes weights for a whole grid of
+decays in a single pass, after which setting the decay to any value of the
+grid is free.
+
+This example selects the decay of
+`tick.optim.model.ModelHawkesFixedExpKernLogLik` and
+`tick.optim.model.ModelHawkesFixedExpKernLeastSq` over a grid, either
+recomputing the weights for each decay or precomputing them all at once, and
+plots the time needed by both strategies.
+"""
+from time import time
+
+import matplotlib.pyplot as plt
+import numpy as np
+
+from tick.optim.model import ModelHawkesFixedExpKernLogLik, \
+    ModelHawkesFixedExpKernLeastSq
+from tick.simulation import SimuHawkesExpKernels
+
+n_nodes = 10
+end_time = 10000
+
+np.random.seed(2398)
+adjacency = np.random.uniform(0, 0.1, size=(n_nodes, n_nodes))
+baseline = np.random.uniform(0.05, 0.2, n_nodes)
+hawkes = SimuHawkesExpKernels(adjacency=adjacency, decays=2.,
+                              baseline=baseline, end_time=end_time,
+                              verbose=False, seed=1039)
+hawkes.simulate()
+
+coeffs = np.hstack((baseline, adjacency.ravel()))
+decays = np.linspace(0.5, 5, 30)
+
+models = {
+    'loglik': lambda decay: ModelHawkesFixedExpKernLogLik(decay),
+    'least squares': lambda decay: ModelHawkesFixedExpKernLeastSq(decay),
+}
+
+
+def set_decay(model, decay):
+    if isinstance(model, ModelHawkesFixedExpKernLogLik):
+        model.decay = decay
+    else:
+        model.decays = decay
+
+
+one_by_one_times, grid_times = [], []
+for name, model_factory in models.items():
+    model = model_factory(decays[0]).fit(hawkes.timestamps)
+    start = time()
+    one_by_one_losses = []
+    for decay in decays:
+        set_decay(model, decay)
+        one_by_one_losses.append(model.loss(coeffs))
+    one_by_one_times.append(time() - start)
+
+    model = model_factory(decays[0]).fit(hawkes.timestamps)
+    start = time()
+    model.compute_weights_for_decays(decays)
+    grid_losses = []
+    for decay in decays:
+        set_decay(model, decay)
+        grid_losses.append(model.loss(coeffs))
+    grid_times.append(time() - start)
+
+    np.testing.assert_array_almost_equal(one_by_one_losses, grid_losses)
+
+positions = np.arange(len(models))
+width = 0.35
+fig, ax = plt.subplots(1, 1, figsize=(6, 4))
+ax.bar(positions - width / 2, one_by_one_times, width, label='one by one')
+ax.bar(positions + width / 2, grid_times, width,
+       label='compute_weights_for_decays')
+ax.set_xticks(positions)
+ax.set_xticklabels(list(models.keys()))
+ax.set_ylabel('time (seconds)')
+ax.set_title('Loss over a grid of %i decays' % len(decays))
+ax.legend()
+
+fig.tight_layout()
+plt.show()
@@ -0,0 +1,78 @@
+"""
+===================================================
+Hawkes log-likelihood with truncated weights
+===================================================
+
+`tick.optim.model.ModelHawkesFixedExpKernLogLik` precomputes, for each event,
+the decayed influence of all nodes, that is ``n_jumps * n_nodes`` weights.
+With many nodes whose events rarely overlap, most of these weights are
+negligible. The ``weights_threshold`` parameter drops the weights below a
+given threshold, which trades accuracy for memory and speed.
+
+This example benchmarks, for several thresholds, the number of stored weights,
+the time needed by ``loss_and_grad`` and the relative error on the loss
+compared to the dense layout (``weights_threshold=0``).
+"""
+from time import time
+
+import matplotlib.pyplot as plt
+import numpy as np
+
+from tick.optim.model import ModelHawkesFixedExpKernLogLik
+from tick.simulation import SimuHawkesExpKernels
+
+n_nodes = 200
+decay = 3.
+end_time = 2000
+
+np.random.seed(2398)
+adjacency = np.random.binomial(1, 0.02, size=(n_nodes, n_nodes)) * 0.3
+baseline = np.random.uniform(0.005, 0.05, n_nodes)
+hawkes = SimuHawkesExpKernels(adjacency=adjacency, decays=decay,
+                              baseline=baseline, end_time=end_time,
+                              verbose=False, seed=1039)
+hawkes.adjust_spectral_radius(0.8)
+hawkes.simulate()
+
+coeffs = np.hstack((baseline, hawkes.adjacency.ravel()))
+grad = np.empty_like(coeffs)
+n_repeats = 10
+
+thresholds = [0, 1e-8, 1e-4, 1e-2, 1e-1]
+n_stored_weights, times, errors = [], [], []
+for weights_threshold in thresholds:
+    model = ModelHawkesFixedExpKernLogLik(decay,
+                                          weights_threshold=weights_threshold)
+    model.fit(hawkes.timestamps, end_times=end_time)
+    loss = model.loss_and_grad(coeffs, grad)
+
+    start = time()
+    for _ in range(n_repeats):
+        model.loss_and_grad(coeffs, grad)
+    times.append((time() - start) / n_repeats)
+    n_stored_weights.append(model.n_stored_weights)
+
+    if weights_threshold == 0:
+        dense_loss = loss
+    errors.append(abs(loss - dense_loss) / abs(dense_loss))
+
+labels = [str(threshold) for threshold in thresholds]
+fig, axes = plt.subplots(1, 3, figsize=(12, 4))
+
+axes[0].bar(range(len(thresholds)), n_stored_weights)
+axes[0].set_title('Number of stored weights')
+
+axes[1].bar(range(len(thresholds)), times)
+axes[1].set_title('loss_and_grad time (seconds)')
+
+axes[2].bar(range(1, len(thresholds)), errors[1:])
+axes[2].set_yscale('log')
+axes[2].set_title('Relative error on loss')
+
+for ax in axes:
+    ax.set_xticks(range(len(thresholds)))
+    ax.set_xticklabels(labels)
+    ax.set_xlabel('weights_threshold')
+
+fig.tight_layout()
+plt.show()
@@ -497,6 +497,7 @@ model_core_info = {
                   "hawkes_fixed_expkern_loglik.cpp",
                   "hawkes_fixed_expkern_leastsq.cpp",
                   "hawkes_fixed_sumexpkern_leastsq.cpp",
+                  "hawkes_fixed_sumexpkern_loglik.cpp",
                   "hawkes_utils.cpp",
                   "linreg.cpp",
                   "linreg_with_intercepts.cpp",
@@ -512,6 +513,7 @@ model_core_info = {
                 "hawkes_fixed_expkern_loglik.h",
                 "hawkes_fixed_expkern_leastsq.h",
                 "hawkes_fixed_sumexpkern_leastsq.h",
+                "hawkes_fixed_sumexpkern_loglik.h",
                 "hawkes_utils.h",
                 "linreg.h",
                 "linreg_with_intercepts.h",
@@ -576,13 +578,19 @@ solver_core_info = {
                   "sgd.cpp",
                   "svrg.cpp",
                   "sdca.cpp",
-                  "adagrad.cpp"],
+                  "adagrad.cpp",
+                  "hawkes_leastsq_newton.cpp",
+                  "hawkes_loglik_newton_cg.cpp",
+                  "separable_penalization.cpp"],
     "h_files": ["sto_solver.h",
                 "sgd.h",
                 "svrg.h",
                 "sdca.h",
                 "adagrad.h",
-                "sto_solver.h"],
+                "sto_solver.h",
+                "hawkes_leastsq_newton.h",
+                "hawkes_loglik_newton_cg.h",
+                "separable_penalization.h"],
     "swig_files": ["solver_module.i"],
     "module_dir": "./tick/optim/solver/",
     "extension_name": "solver",
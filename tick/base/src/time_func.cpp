@@ -7,11 +7,7 @@
 #include <float.h>
 #include "time_func.h"
 
-const double floor_threshold = 1e-10;
-
-double threshold_floor(const double x) {
-  return std::floor((x) + floor_threshold);
-}
+constexpr double TimeFunction::floor_threshold;
 
 const double timefunc_oversampling = 5.0;
 
@@ -26,11 +22,12 @@ TimeFunction::TimeFunction(double y) {
 TimeFunction::TimeFunction(const ArrayDouble &Y,
                            BorderType type, InterMode mode,
                            double dt, double border_value)
-    : inter_mode(mode), border_type(type), dt(dt), border_value(border_value) {
+    : inter_mode(mode), border_type(type), t0(0), dt(dt), border_value(border_value) {
   sampled_y = SArrayDouble::new_ptr(Y.size());
   std::copy(Y.data(), Y.data() + Y.size(), sampled_y->data());
 
   last_value_before_border = dt * sampled_y->size();
+  compute_sampled_primitive();
 }
 
 TimeFunction::TimeFunction(const ArrayDouble &T, const ArrayDouble &Y, double dt)
@@ -119,6 +116,7 @@ TimeFunction::TimeFunction(const ArrayDouble &T, const ArrayDouble &Y,
   }
 
   support_right = sampled_y->size() * dt + t0;
+  compute_sampled_primitive();
 }
 
 TimeFunction::~TimeFunction() {
@@ -148,33 +146,12 @@ void TimeFunction::compute_future_max() {
 }
 
 double TimeFunction::value(double t) {
-  // First handle if we are out of the border
-
-  // this test must be the first one otherwise we might have problem with constant TimeFunctions
-  if (t > last_value_before_border + floor_threshold) {
-    if (border_type != BorderType::Cyclic) {
-      return border_value;
-    } else {
-      // If border type is cyclic then we simply return the value it would have in the first cycle
-      const double divider = last_value_before_border;
-      const int quotient = static_cast<int>(threshold_floor(t / divider));
-      return value(t - quotient * divider);
-    }
-  } else if (t < t0) {
-    // which behavior do we want if t < t0 ?
-    return 0.0;
-  } else if (t < 0) {
-    return 0.0;
+  switch (inter_mode) {
+    case (InterMode::InterLinear):return value_no_dispatch<InterMode::InterLinear>(t);
+    case (InterMode::InterConstLeft):return value_no_dispatch<InterMode::InterConstLeft>(t);
+    case (InterMode::InterConstRight):return value_no_dispatch<InterMode::InterConstRight>(t);
+    default:throw std::runtime_error("Undefined interpolation mode");
   }
-
-  const ulong i_left = get_index_(t);
-
-  const double t_left = get_t_from_index_(i_left);
-  const double y_left = (*sampled_y)[i_left];
-  const double t_right = get_t_from_index_(i_left + 1);
-  const double y_right = (*sampled_y)[i_left + 1];
-
-  return interpolation(t_left, y_left, t_right, y_right, t);
 }
 
 SArrayDoublePtr TimeFunction::value(ArrayDouble &array) {
@@ -190,30 +167,14 @@ double TimeFunction::future_bound(double t) {
     compute_future_max();
   }
 
-  if (t > last_value_before_border) {
-    // First handle if we are out of the border
-    if (border_type != BorderType::Cyclic) {
-      return border_value;
-    } else {
-      // If border type is cyclic then we simply return the value it would have in the first cycle
-      const double divider = last_value_before_border;
-      const int quotient = static_cast<int>(threshold_floor(t / divider));
-      return future_bound(t - quotient * divider);
-    }
-  } else if (t < t0) {
-    return (*future_max)[0];
-  } else if (t < 0) {
-    return (*future_max)[0];
+  switch (inter_mode) {
+    case (InterMode::InterLinear):return future_bound_no_dispatch<InterMode::InterLinear>(t);
+    case (InterMode::InterConstLeft):
+      return future_bound_no_dispatch<InterMode::InterConstLeft>(t);
+    case (InterMode::InterConstRight):
+      return future_bound_no_dispatch<InterMode::InterConstRight>(t);
+    default:throw std::runtime_error("Undefined interpolation mode");
   }
-
-  const ulong i_left = get_index_(t);
-
-  const double t_left = get_t_from_index_(i_left);
-  const double y_left = (*future_max)[i_left];
-  const double t_right = get_t_from_index_(i_left + 1);
-  const double y_right = (*future_max)[i_left + 1];
-
-  return interpolation(t_left, y_left, t_right, y_right, t);
 }
 
 SArrayDoublePtr TimeFunction::future_bound(ArrayDouble &array) {
@@ -293,33 +254,63 @@ double TimeFunction::get_norm() {
   return norm;
 }
 
-double TimeFunction::constant_left_interpolation(double t_left, double y_left,
-                                                 double t_right, double y_right,
-                                                 double t_value) {
-  if (std::abs(t_value - t_left) < floor_threshold)
-    return y_left;
-  else
-    return y_right;
+void TimeFunction::compute_sampled_primitive() {
+  // Check this TimeFunction is not constant
+  if (last_value_before_border < 0 || sampled_y == nullptr || sampled_y->size() < 2) {
+    sampled_primitive = nullptr;
+    return;
+  }
+
+  const ulong sample_size = sampled_y->size();
+  sampled_primitive = SArrayDouble::new_ptr(sample_size);
+  (*sampled_primitive)[0] = 0;
+  for (ulong i = 0; i < sample_size - 1; ++i) {
+    // Cells are clipped at the last value before border
+    const double span = std::min(dt, std::max(0.0, last_value_before_border - get_t_from_index_(i)));
+    (*sampled_primitive)[i + 1] = (*sampled_primitive)[i] + cell_primitive_(i, span);
+  }
 }
 
-double TimeFunction::constant_right_interpolation(double t_left, double y_left,
-                                                  double t_right, double y_right,
-                                                  double t_value) {
-  if (std::abs(t_value - t_right) < floor_threshold)
-    return y_right;
-  else
-    return y_left;
+double TimeFunction::cell_primitive_(ulong i, double span) {
+  const double y_left = (*sampled_y)[i];
+  const double y_right = (*sampled_y)[i + 1];
+  switch (inter_mode) {
+    case (InterMode::InterLinear):return (y_left + (y_right - y_left) * span / (2 * dt)) * span;
+    case (InterMode::InterConstLeft):return y_right * span;
+    case (InterMode::InterConstRight):return y_left * span;
+    default:throw std::runtime_error("Undefined interpolation mode");
+  }
 }
 
-double TimeFunction::linear_interpolation(double t_left, double y_left,
-                                          double t_right, double y_right,
-                                          double t_value) {
-  if (std::abs(t_left - t_right) < floor_threshold) {
-    return (y_left + y_right) / 2.0;
-  } else {
-    double slope = (y_right - y_left) / (t_right - t_left);
-    return y_left + slope * (t_value - t_left);
+double TimeFunction::primitive(double t) {
+  // Constant TimeFunction
+  if (last_value_before_border < 0) return t > 0 ? border_value * t : 0;
+
+  if (t > last_value_before_border) {
+    const double primitive_at_border = primitive(last_value_before_border);
+    if (border_type != BorderType::Cyclic) {
+      return primitive_at_border + border_value * (t - last_value_before_border);
+    } else {
+      // Each full cycle adds the integral over the first one
+      const double divider = last_value_before_border;
+      const int quotient = static_cast<int>(threshold_floor(t / divider));
+      return quotient * primitive_at_border + primitive(t - quotient * divider);
+    }
+  } else if (t <= t0) {
+    return 0.0;
   }
+
+  // The last cell is the one to use on its right bound
+  const ulong i_left = std::min(get_index_(t), sampled_primitive->size() - 2);
+  return (*sampled_primitive)[i_left] + cell_primitive_(i_left, t - get_t_from_index_(i_left));
+}
+
+SArrayDoublePtr TimeFunction::primitive(ArrayDouble &array) {
+  SArrayDoublePtr primitive_array = SArrayDouble::new_ptr(array.size());
+  for (ulong i = 0; i < primitive_array->size(); ++i) {
+    (*primitive_array)[i] = primitive(array[i]);
+  }
+  return primitive_array;
 }
 
 double TimeFunction::interpolation(double t_left, double y_left,
@@ -343,11 +334,3 @@ double TimeFunction::interpolation(double t_left, double y_left,
     default:throw std::runtime_error("Undefined interpolation mode");
   }
 }
-
-ulong TimeFunction::get_index_(double t) {
-  return (ulong) threshold_floor((t - t0) / dt);
-}
-
-double TimeFunction::get_t_from_index_(ulong i) {
-  return t0 + dt * i;
-}
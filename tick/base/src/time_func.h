@@ -84,10 +84,25 @@ class DLL_PUBLIC TimeFunction {
     // Call function
     double value(double t);
 
+    /**
+     * @brief Value of the function at t, with the interpolation mode given at compile time
+     * instead of being dispatched at each call. This is what value computes once the mode is
+     * dispatched, it is meant for loops evaluating the function many times
+     */
+    template <InterMode mode>
+    inline double value_no_dispatch(double t) const;
+
     SArrayDoublePtr value(ArrayDouble &array);
 
     double future_bound(double t);
 
+    /**
+     * @brief Same as future_bound with the interpolation mode given at compile time
+     * @note compute_future_max must have been called beforehand
+     */
+    template <InterMode mode>
+    inline double future_bound_no_dispatch(double t) const;
+
     void compute_future_max();
 
     SArrayDoublePtr future_bound(ArrayDouble &array);
@@ -96,26 +111,75 @@ class DLL_PUBLIC TimeFunction {
 
     double get_norm();
 
+    // Integral of the function between 0 and t
+    double primitive(double t);
+
+    SArrayDoublePtr primitive(ArrayDouble &array);
+
  private:
     SArrayDoublePtr sampled_y;
     SArrayDoublePtr future_max;
+    // Primitive at the sampled times, it is computed at construction and not serialized
+    SArrayDoublePtr sampled_primitive;
     double t0;
     double dt;
     double support_right;
     double last_value_before_border;
     double border_value;
 
-    inline ulong get_index_(double t);
-
-    inline double get_t_from_index_(ulong i);
-
-    inline double constant_left_interpolation(double x_left, double y_left, double x_right, double y_right,
-                                              double x_value);
-
-    inline double constant_right_interpolation(double x_left, double y_left, double x_right, double y_right,
-                                               double x_value);
-
-    inline double linear_interpolation(double x_left, double y_left, double x_right, double y_right, double x_value);
+    //! @brief Threshold used when comparing times and flooring indices
+    static constexpr double floor_threshold = 1e-10;
+
+    static double threshold_floor(const double x) {
+      return std::floor(x + floor_threshold);
+    }
+
+    ulong get_index_(double t) const {
+      return (ulong) threshold_floor((t - t0) / dt);
+    }
+
+    double get_t_from_index_(ulong i) const {
+      return t0 + dt * i;
+    }
+
+    // Interpolation at t between the sampled values of the cell starting at index i_left
+    template <InterMode mode>
+    inline double interpolation_no_dispatch(const ArrayDouble &values, ulong i_left,
+                                            double t) const;
+
+    void compute_sampled_primitive();
+
+    // Integral of the function between the sampled time i and this time shifted by span
+    inline double cell_primitive_(ulong i, double span);
+
+    static double constant_left_interpolation(double t_left, double y_left,
+                                              double /*t_right*/, double y_right,
+                                              double t_value) {
+      if (std::abs(t_value - t_left) < floor_threshold)
+        return y_left;
+      else
+        return y_right;
+    }
+
+    static double constant_right_interpolation(double /*t_left*/, double y_left,
+                                               double t_right, double y_right,
+                                               double t_value) {
+      if (std::abs(t_value - t_right) < floor_threshold)
+        return y_right;
+      else
+        return y_left;
+    }
+
+    static double linear_interpolation(double t_left, double y_left,
+                                       double t_right, double y_right,
+                                       double t_value) {
+      if (std::abs(t_left - t_right) < floor_threshold) {
+        return (y_left + y_right) / 2.0;
+      } else {
+        double slope = (y_right - y_left) / (t_right - t_left);
+        return y_left + slope * (t_value - t_left);
+      }
+    }
 
  public:
     double get_border_value() { return border_value; }
@@ -139,6 +203,8 @@ class DLL_PUBLIC TimeFunction {
     ar(CEREAL_NVP(support_right));
     ar(CEREAL_NVP(last_value_before_border));
     ar(CEREAL_NVP(border_value));
+
+    compute_sampled_primitive();
   }
 
   template<class Archive>
@@ -156,6 +222,69 @@ class DLL_PUBLIC TimeFunction {
   }
 };
 
+template <TimeFunction::InterMode mode>
+double TimeFunction::interpolation_no_dispatch(const ArrayDouble &values, ulong i_left,
+                                               double t) const {
+  const double t_left = get_t_from_index_(i_left);
+  const double y_left = values[i_left];
+  const double t_right = get_t_from_index_(i_left + 1);
+  const double y_right = values[i_left + 1];
+
+  switch (mode) {
+    case (InterMode::InterLinear):return linear_interpolation(t_left, y_left, t_right, y_right, t);
+    case (InterMode::InterConstLeft):
+      return constant_left_interpolation(t_left, y_left, t_right, y_right, t);
+    case (InterMode::InterConstRight):
+      return constant_right_interpolation(t_left, y_left, t_right, y_right, t);
+  }
+  return 0;
+}
+
+template <TimeFunction::InterMode mode>
+double TimeFunction::value_no_dispatch(double t) const {
+  // First handle if we are out of the border
+
+  // this test must be the first one otherwise we might have problem with constant TimeFunctions
+  if (t > last_value_before_border + floor_threshold) {
+    if (border_type != BorderType::Cyclic) {
+      return border_value;
+    } else {
+      // If border type is cyclic then we simply return the value it would have in the first cycle
+      const double divider = last_value_before_border;
+      const int quotient = static_cast<int>(threshold_floor(t / divider));
+      return value_no_dispatch<mode>(t - quotient * divider);
+    }
+  } else if (t < t0) {
+    // which behavior do we want if t < t0 ?
+    return 0.0;
+  } else if (t < 0) {
+    return 0.0;
+  }
+
+  return interpolation_no_dispatch<mode>(*sampled_y, get_index_(t), t);
+}
+
+template <TimeFunction::InterMode mode>
+double TimeFunction::future_bound_no_dispatch(double t) const {
+  if (t > last_value_before_border) {
+    // First handle if we are out of the border
+    if (border_type != BorderType::Cyclic) {
+      return border_value;
+    } else {
+      // If border type is cyclic then we simply return the value it would have in the first cycle
+      const double divider = last_value_before_border;
+      const int quotient = static_cast<int>(threshold_floor(t / divider));
+      return future_bound_no_dispatch<mode>(t - quotient * divider);
+    }
+  } else if (t < t0) {
+    return (*future_max)[0];
+  } else if (t < 0) {
+    return (*future_max)[0];
+  }
+
+  return interpolation_no_dispatch<mode>(*future_max, get_index_(t), t);
+}
+
 typedef std::shared_ptr<TimeFunction> TimeFunctionPtr;
 
 #endif  // TICK_BASE_SRC_TIME_FUNC_H_
@@ -321,9 +321,38 @@ TEST(TimeFuncTest, Serialization) {
     ASSERT_DOUBLE_EQ(tf.value(1.0), tf_restored.value(1.0));
     ASSERT_DOUBLE_EQ(tf.value(0.5), tf_restored.value(0.5));
     ASSERT_DOUBLE_EQ(tf.value(1.5), tf_restored.value(1.5));
+    ASSERT_DOUBLE_EQ(tf.primitive(1.5), tf_restored.primitive(1.5));
   }
 }
 
+TEST(TimeFuncTest, Primitive) {
+  ArrayDouble T({0.0, 1.0, 2.0});
+  ArrayDouble Y({1.0, 0.0, -1.0});
+
+  TimeFunction tf(T, Y, 0.2);
+  EXPECT_DOUBLE_EQ(tf.primitive(-1.), 0.);
+  EXPECT_NEAR(tf.primitive(0.5), 0.375, 1e-12);
+  EXPECT_NEAR(tf.primitive(1.), 0.5, 1e-12);
+  EXPECT_NEAR(tf.primitive(1.3), 0.455, 1e-12);
+  EXPECT_NEAR(tf.primitive(2.), tf.get_norm(), 1e-12);
+  EXPECT_NEAR(tf.primitive(10.), 0., 1e-12);
+
+  ArrayDouble Y_steps({1.0, 2.0, 3.0});
+  TimeFunction tf_cyclic(T, Y_steps, TimeFunction::BorderType::Cyclic,
+                         TimeFunction::InterMode::InterConstRight);
+  EXPECT_NEAR(tf_cyclic.primitive(1.5), 2., 1e-12);
+  EXPECT_NEAR(tf_cyclic.primitive(5.), 7., 1e-12);
+
+  TimeFunction tf_continue(T, Y_steps, TimeFunction::BorderType::BorderContinue,
+                           TimeFunction::InterMode::InterConstLeft);
+  EXPECT_NEAR(tf_continue.primitive(0.5), 1., 1e-12);
+  EXPECT_NEAR(tf_continue.primitive(4.), 5. + 3. * 2., 1e-12);
+
+  TimeFunction tf_constant(2.);
+  EXPECT_DOUBLE_EQ(tf_constant.primitive(-1.), 0.);
+  EXPECT_DOUBLE_EQ(tf_constant.primitive(3.), 6.);
+}
+
 TEST(DebugTest, PrintArray2D) {
   testing::internal::CaptureStdout();
 
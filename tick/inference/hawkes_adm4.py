@@ -236,6 +236,105 @@ class HawkesADM4(LearnerHawkesNoParam):
         self._model.fit(events, end_times=end_times)
         self._prox_nuclear.n_rows = self.n_nodes
 
+    def fit_path(self, events, C, lasso_nuclear_ratio=None, rho=None,
+                 end_times=None, baseline_start=None, adjacency_start=None):
+        """Fit the model for a sequence of penalization levels, each fit
+        being started from the solution of the previous one.
+
+        Weights computed from the data are shared by all fits. The
+        auxiliary variables of the augmented Lagrangian are also kept from
+        one fit to the next, scaled dual variables being rescaled when
+        `rho` changes. Hence, fits of close penalization levels usually need
+        few iterations.
+
+        Parameters
+        ----------
+        events : `list` of `list` of `np.ndarray`
+            List of Hawkes processes realizations.
+            Each realization of the Hawkes process is a list of n_node for
+            each component of the Hawkes. Namely `events[i][j]` contains a
+            one-dimensional `numpy.array` of the events' timestamps of
+            component j of realization i.
+
+            If only one realization is given, it will be wrapped into a list
+
+        C : `np.ndarray`, shape=(n_fits,)
+            Levels of penalization of the successive fits
+
+        lasso_nuclear_ratio : `float` or `np.ndarray`, default=None
+            Ratios of Lasso-Nuclear regularization of the successive fits,
+            either shared by all fits or given as an array of shape
+            (n_fits,). If `None`, current `lasso_nuclear_ratio` is used for
+            all fits
+
+        rho : `float` or `np.ndarray`, default=None
+            Penalty parameters of the augmented Lagrangian of the successive
+            fits, either shared by all fits or given as an array of shape
+            (n_fits,). If `None`, current `rho` is used for all fits
+
+        end_times : `np.ndarray` or `float`, default = None
+            List of end time of all hawkes processes that will be given to the
+            model. If None, it will be set to each realization's latest time.
+            If only one realization is provided, then a float can be given.
+
+        baseline_start : `None` or `np.ndarray`, shape=(n_nodes)
+            Set initial value of baseline parameter of the first fit
+            If `None` starts with uniform 1 values
+
+        adjacency_start : `None` or `np.ndarray`, shape=(n_nodes, n_nodes)
+            Set initial value of adjacency parameter of the first fit
+            If `None` starts with random values uniformly sampled between 0.5
+            and 0.9
+
+        Returns
+        -------
+        baselines : `np.ndarray`, shape=(n_fits, n_nodes)
+            Baseline obtained by each fit
+
+        adjacencies : `np.ndarray`, shape=(n_fits, n_nodes, n_nodes)
+            Adjacency matrix obtained by each fit
+
+        Notes
+        -----
+        Once done, the learner is in the state of the last fit and `history`
+        records the iterations of the last fit only.
+        """
+        C = np.atleast_1d(np.array(C, dtype=float))
+        n_fits = len(C)
+        if lasso_nuclear_ratio is None:
+            lasso_nuclear_ratio = self.lasso_nuclear_ratio
+        if rho is None:
+            rho = self.rho
+        lasso_nuclear_ratio = np.broadcast_to(lasso_nuclear_ratio, n_fits)
+        rho = np.broadcast_to(rho, n_fits)
+
+        LearnerHawkesNoParam.fit(self, events, end_times=end_times)
+
+        baselines = np.empty((n_fits, self.n_nodes))
+        adjacencies = np.empty((n_fits, self.n_nodes, self.n_nodes))
+        for fit_index in range(n_fits):
+            previous_rho = self.rho
+            self.C = C[fit_index]
+            self.lasso_nuclear_ratio = lasso_nuclear_ratio[fit_index]
+            self.rho = rho[fit_index]
+
+            self._start_solve()
+            if fit_index == 0:
+                auxiliary_variables = self._init_solve(baseline_start,
+                                                       adjacency_start)
+            else:
+                z1, z2, u1, u2 = auxiliary_variables
+                u1 *= previous_rho / self.rho
+                u2 *= previous_rho / self.rho
+            self._solve_admm(*auxiliary_variables,
+                             warm_start=fit_index > 0)
+            self._end_solve()
+
+            baselines[fit_index] = self.baseline
+            adjacencies[fit_index] = self.adjacency
+
+        return baselines, adjacencies
+
     def _solve(self, baseline_start=None, adjacency_start=None):
         """Perform one iteration of the algorithm
 
@@ -250,7 +349,13 @@ class HawkesADM4(LearnerHawkesNoParam):
             If `None` starts with random values uniformly sampled between 0.5
             and 0.9
         """
+        z1, z2, u1, u2 = self._init_solve(baseline_start, adjacency_start)
+        self._solve_admm(z1, z2, u1, u2)
 
+    def _init_solve(self, baseline_start, adjacency_start):
+        """Set starting baseline and adjacency and returns the auxiliary
+        variables z1, z2, u1, u2 of the augmented Lagrangian
+        """
         if baseline_start is None:
             baseline_start = np.ones(self.n_nodes)
 
@@ -265,7 +370,12 @@ class HawkesADM4(LearnerHawkesNoParam):
         z2 = np.zeros_like(self.adjacency)
         u1 = np.zeros_like(self.adjacency)
         u2 = np.zeros_like(self.adjacency)
+        return z1, z2, u1, u2
 
+    def _solve_admm(self, z1, z2, u1, u2, warm_start=False):
+        """Run the algorithm from current baseline and adjacency, the
+        auxiliary variables z1, z2, u1, u2 being updated in place
+        """
         if self.rho <= 0:
             raise ValueError("The parameter rho equals {}, while it should "
                              "be strictly positive.".format(self.rho))
@@ -296,11 +406,11 @@ class HawkesADM4(LearnerHawkesNoParam):
                 if max(inner_rel_baseline, inner_rel_adjacency) < inner_tol:
                     break
 
-            z1 = self._prox_nuclear.call(np.ravel(self.adjacency + u1),
-                                         step=1. / self.rho) \
+            z1[:] = self._prox_nuclear.call(np.ravel(self.adjacency + u1),
+                                            step=1. / self.rho) \
                 .reshape(self.n_nodes, self.n_nodes)
-            z2 = self._prox_l1.call(np.ravel(self.adjacency + u2),
-                                    step=1. / self.rho) \
+            z2[:] = self._prox_l1.call(np.ravel(self.adjacency + u2),
+                                       step=1. / self.rho) \
                 .reshape(self.n_nodes, self.n_nodes)
 
             u1 += self.adjacency - z1
@@ -314,8 +424,10 @@ class HawkesADM4(LearnerHawkesNoParam):
 
             max_relative_distance = max(rel_baseline, rel_adjacency)
             # We perform at least 5 iterations as at start we sometimes reach a
-            # low tolerance if inner_tol is too low
-            converged = max_relative_distance <= self.tol and i > 5
+            # low tolerance if inner_tol is too low. This does not happen when
+            # starting from the solution of a close problem
+            converged = max_relative_distance <= self.tol and \
+                        (i > 5 or warm_start)
             force_print = (i == self.max_iter) or converged
 
             self._handle_history(i, obj=objective, rel_obj=rel_obj,
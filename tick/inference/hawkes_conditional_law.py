@@ -5,11 +5,11 @@ import sys
 import warnings
 
 import numpy as np
-from tick.base import Base, ThreadPool
+from tick.base import Base
 from numpy.polynomial.legendre import leggauss
 from scipy.linalg import solve
 
-from .build.inference import PointProcessCondLaw
+from .build.inference import PointProcessCondLaws
 
 
 # noinspection PyPep8Naming
@@ -155,7 +155,6 @@ class HawkesConditionalLaw(Base):
     _attrinfos = {
         '_hawkes_object': {},
         '_lags': {},
-        '_lock': {'writable': False},
         '_phi_ijl': {}, '_norm_ijl': {},
         '_ijl2index': {},
         '_index2ijl': {},
@@ -213,7 +212,6 @@ class HawkesConditionalLaw(Base):
         # Represents the conditional laws written above without conditioning by
         # the mark (so a i,j list)
         self._claw1 = None
-        self._lock = None
 
         # quad_x : `np.ndarray`, shape=(n_quad, )
         # The abscissa of the quadrature points used for the Fredholm system
@@ -569,21 +567,26 @@ class HawkesConditionalLaw(Base):
             self._n_events[0, i] += good
             self._n_events[1, i] += bad
 
-        # We might want to use threads, since this is the time consuming part
-        with_multi_processing = self.n_threads > 1
-        if with_multi_processing:
-            pool = ThreadPool(with_lock=True, max_threads=self.n_threads)
-            self._set('_lock', pool.lock)
+        # This is the time consuming part, all conditional laws are computed
+        # at once (in parallel over pairs of components)
+        mark_bounds = [np.array([interval[0] for interval in intervals] +
+                                [intervals[-1][1]], dtype=float)
+                       for intervals in self.marked_components]
+        claw_X = np.zeros(len(self._lags) - 1)
+        claw_Y = np.zeros((self._n_index, len(self._lags) - 1))
+        PointProcessCondLaws([r[0] for r in realization],
+                             [r[1] for r in realization], mark_bounds,
+                             self._lags, T, claw_X, claw_Y, self.n_threads)
+        self._claw_X = claw_X
 
-        for index, (i, j, l) in enumerate(self._index2ijl):
-            if with_multi_processing:
-                pool.add_work(self._PointProcessCondLaw, realization,
-                              index, i, j, l, T)
+        # Update claw
+        for index in range(self._n_index):
+            if self.n_realizations == 0:
+                self._claw[index] = claw_Y[index]
             else:
-                self._PointProcessCondLaw(realization, index, i, j, l, T)
-
-        if with_multi_processing:
-            pool.start()
+                self._claw[index] *= self.n_realizations
+                self._claw[index] += claw_Y[index]
+                self._claw[index] /= self.n_realizations + 1
 
         # Here we compute the G^ij (not conditioned to l)
         # It is recomputed each time
@@ -641,45 +644,9 @@ class HawkesConditionalLaw(Base):
                 self._claw[index1] = t
                 self._claw[index2] = t
 
-        # We can remove the thread lock (lock disallows pickling)
-        self._set('_lock', None)
-
         if compute:
             self.compute()
 
-    def _PointProcessCondLaw(self, realization, index, i, j, l, T):
-
-        claw_X = np.zeros(len(self._lags) - 1)
-        claw_Y = np.zeros(len(self._lags) - 1)
-
-        lambda_i = len(realization[i][0]) / T
-
-        PointProcessCondLaw(realization[i][0],
-                            realization[j][0], realization[j][1], self._lags,
-                            self.marked_components[j][l][0],
-                            self.marked_components[j][l][1],
-                            T,
-                            lambda_i,
-                            claw_X, claw_Y)
-
-        self._claw_X = claw_X
-
-        # TODO: this lock acquire is very expensive here
-        if self.n_threads > 1:
-            self._lock.acquire()
-
-        # Update claw
-        if self.n_realizations == 0:
-            self._claw[index] = claw_Y
-        else:
-            self._claw[index] *= self.n_realizations
-            self._claw[index] += claw_Y
-            self._claw[index] /= self.n_realizations + 1
-
-        # Unlock
-        if self.n_threads > 1:
-            self._lock.release()
-
     def _compute_lags(self):
         """Computes the lags at which the claw will be computed
         """
@@ -63,6 +63,21 @@ class HawkesEM(LearnerHawkesNoParam):
         * if `int <= 0`: the number of physical cores available on the CPU
         * otherwise the desired number of threads
 
+    cache_pairs : `bool`, default=False
+        If `True`, the pairs of events that are closer than the kernel
+        support, and the kernel bin their time difference falls in, are
+        found once in parallel and stored, instead of being found again at
+        each iteration. This makes iterations much faster, at the cost of a
+        memory proportional to the number of such pairs
+
+    n_starts : `int`, default=1
+        Number of starting points from which the algorithm is run. The
+        first one is given by `baseline_start` and `kernel_start`, the other
+        ones have random kernels. All starts are updated at once, the pairs
+        of events being found only once per iteration, until all of them
+        have converged. The estimation with the best log-likelihood is then
+        kept
+
     Attributes
     ----------
     n_nodes : `int`
@@ -92,7 +107,7 @@ class HawkesEM(LearnerHawkesNoParam):
     def __init__(self, kernel_support=None, kernel_size=10,
                  kernel_discretization=None, tol=1e-5, max_iter=100,
                  print_every=10, record_every=10,
-                 verbose=False, n_threads=1):
+                 verbose=False, n_threads=1, cache_pairs=False, n_starts=1):
 
         LearnerHawkesNoParam.__init__(
             self, n_threads=n_threads, verbose=verbose, tol=tol,
@@ -106,6 +121,10 @@ class HawkesEM(LearnerHawkesNoParam):
         else:
             raise ValueError('Either kernel support or kernel discretization '
                              'must be provided')
+        self.cache_pairs = cache_pairs
+        if n_starts < 1:
+            raise ValueError('n_starts must be positive, got %s' % n_starts)
+        self.n_starts = n_starts
 
         self.baseline = None
         self.kernel = None
@@ -158,35 +177,40 @@ class HawkesEM(LearnerHawkesNoParam):
             Used to force start values for kernel parameter
             If `None` starts with random values
         """
+        kernel_shape = (self.n_nodes, self.n_nodes, self.kernel_size)
         if kernel_start is None:
-            self.kernel = 0.1 * np.random.uniform(
-                size=(self.n_nodes, self.n_nodes, self.kernel_size))
+            kernels = 0.1 * np.random.uniform(
+                size=(self.n_starts,) + kernel_shape)
         else:
-            if kernel_start.shape != (self.n_nodes, self.n_nodes,
-                                      self.kernel_size):
+            if kernel_start.shape != kernel_shape:
                 raise ValueError('kernel_start has shape {} but should have '
                                  'shape {}'.format(
-                    kernel_start.shape,
-                    (self.n_nodes, self.n_nodes, self.kernel_size)
+                    kernel_start.shape, kernel_shape
                 ))
-            self.kernel = kernel_start.copy()
+            kernels = np.empty((self.n_starts,) + kernel_shape)
+            kernels[0] = kernel_start
+            kernels[1:] = 0.1 * np.random.uniform(
+                size=(self.n_starts - 1,) + kernel_shape)
 
-        if baseline_start is None:
-            self.baseline = np.zeros(self.n_nodes) + 1
-        else:
-            self.baseline = baseline_start.copy()
+        baselines = np.ones((self.n_starts, self.n_nodes))
+        if baseline_start is not None:
+            baselines[0] = baseline_start
 
-        _kernel_uvm_2d = self.kernel.reshape((self.n_nodes,
-                                              self.n_nodes * self.kernel_size))
+        _kernels_suvm_2d = kernels.reshape((self.n_starts * self.n_nodes,
+                                            self.n_nodes * self.kernel_size))
 
         for i in range(self.max_iter + 1):
-            prev_baseline = self.baseline.copy()
-            prev_kernel = self.kernel.copy()
+            prev_baselines = baselines.copy()
+            prev_kernels = kernels.copy()
 
-            self._learner.solve(self.baseline, _kernel_uvm_2d)
+            self._learner.solve_starts(baselines, _kernels_suvm_2d)
 
-            rel_baseline = relative_distance(self.baseline, prev_baseline)
-            rel_kernel = relative_distance(self.kernel, prev_kernel)
+            rel_baseline = max(
+                relative_distance(baselines[s], prev_baselines[s])
+                for s in range(self.n_starts))
+            rel_kernel = max(
+                relative_distance(kernels[s], prev_kernels[s])
+                for s in range(self.n_starts))
 
             converged = max(rel_baseline, rel_kernel) <= self.tol
             force_print = (i == self.max_iter) or converged
@@ -196,6 +220,15 @@ class HawkesEM(LearnerHawkesNoParam):
             if converged:
                 break
 
+        best_start = 0
+        if self.n_starts > 1:
+            losses = np.empty(self.n_starts)
+            self._learner.loss_starts(baselines, _kernels_suvm_2d, losses)
+            best_start = np.argmin(losses)
+
+        self.baseline = baselines[best_start].copy()
+        self.kernel = kernels[best_start].copy()
+
     def get_kernel_supports(self):
         """Computes kernel support. This makes our learner compliant with
         `tick.plot.plot_hawkes_kernels` API
@@ -255,7 +288,36 @@ class HawkesEM(LearnerHawkesNoParam):
         return self.kernel.dot(kernel_intervals)
 
     def objective(self, coeffs, loss: float = None):
-        raise NotImplementedError()
+        """Compute the objective minimized by the learner at `coeffs`, the
+        negative log-likelihood divided by the number of events
+
+        Parameters
+        ----------
+        coeffs : `numpy.ndarray`, shape=(n_coeffs,)
+            The objective is computed at this point, baseline and kernel
+            values being stacked as in `coeffs`
+
+        loss : `float`, default=`None`
+            Gives the value of the loss if already known (allows to
+            avoid its computation in some cases)
+
+        Returns
+        -------
+        output : `float`
+            Value of the objective at given `coeffs`
+        """
+        if loss is not None:
+            return loss
+
+        coeffs = np.array(coeffs, dtype=float)
+        baseline = coeffs[:self.n_nodes]
+        kernel = coeffs[self.n_nodes:].reshape(
+            (self.n_nodes, self.n_nodes * self.kernel_size))
+        return self._learner.loss(baseline, kernel)
+
+    @property
+    def coeffs(self):
+        return np.hstack((self.baseline, self.kernel.ravel()))
 
     @property
     def kernel_support(self):
@@ -281,6 +343,14 @@ class HawkesEM(LearnerHawkesNoParam):
     def kernel_dt(self, val):
         self._learner.set_kernel_dt(val)
 
+    @property
+    def cache_pairs(self):
+        return self._learner.get_cache_pairs()
+
+    @cache_pairs.setter
+    def cache_pairs(self, val):
+        self._learner.set_cache_pairs(val)
+
     @property
     def kernel_discretization(self):
         return self._learner.get_kernel_discretization()
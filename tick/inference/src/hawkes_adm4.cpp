@@ -27,11 +27,17 @@ void HawkesADM4::compute_weights() {
   }
 
   // Compute weights
+  build_event_streams();
+  // decay between consecutive events of the stream of each realization
+  ArrayDoubleList1D stream_decays(n_realizations);
+  parallel_run(std::min(get_n_threads(), static_cast<const unsigned int>(n_realizations)),
+               n_realizations, &HawkesADM4::compute_stream_decays_r, this, stream_decays);
+
   // variable to compute kernel integral in parallel that will be reduced afterwards
   ArrayDouble2d map_kernel_integral(n_realizations, n_nodes);
   map_kernel_integral.init_to_zero();
-  parallel_run(get_n_threads(), n_nodes * n_realizations, &HawkesADM4::compute_weights_ru, this,
-               map_kernel_integral);
+  parallel_run(get_n_threads(), n_nodes * n_realizations, &HawkesADM4::compute_weights_rv, this,
+               stream_decays, map_kernel_integral);
 
   kernel_integral.init_to_zero();
   for (ulong r = 0; r < n_realizations; ++r) {
@@ -44,43 +50,47 @@ void HawkesADM4::compute_weights() {
   weights_computed = true;
 }
 
-// This code is very similar to ModelHawkesFixedExpKernLogLik
-void HawkesADM4::compute_weights_ru(const ulong r_u, ArrayDouble2d &map_kernel_integral) {
-  // Obtain realization and node index from r_u
-  const ulong r = static_cast<const ulong>(r_u / n_nodes);
-  const ulong u = r_u % n_nodes;
-  ArrayDouble2d g_ru = view(g[r][u]);
-  const ArrayDouble timestamps_ru = view(*timestamps_list[r][u]);
+void HawkesADM4::compute_stream_decays_r(const ulong r, ArrayDoubleList1D &stream_decays) {
+  const HawkesEventStream &stream = event_streams[r];
+  stream_decays[r] = ArrayDouble(stream.size());
+  ArrayDouble &stream_decays_r = stream_decays[r];
+  for (ulong e = 1; e < stream.size(); ++e) {
+    stream_decays_r[e] = cexp(-decay * (stream.get_time(e) - stream.get_time(e - 1)));
+  }
+}
+
+void HawkesADM4::compute_weights_rv(const ulong r_v, const ArrayDoubleList1D &stream_decays,
+                                    ArrayDouble2d &map_kernel_integral) {
+  // Obtain realization and node index from r_v
+  const ulong r = static_cast<const ulong>(r_v / n_nodes);
+  const ulong v = r_v % n_nodes;
+  const HawkesEventStream &stream = event_streams[r];
+  const ArrayDouble &stream_decays_r = stream_decays[r];
   const double end_time_r = (*end_times)[r];
-  ArrayDouble map_kernel_integral_r = view_row(map_kernel_integral, r);
+  double &kernel_integral_rv = map_kernel_integral(r, v);
+
+  // We fill column v of g[r][u] for all nodes u in a single pass over the stream:
+  // g_v = \sum_{t_j^v < t} g(t - t_j^v) at the time t of the current event, the events of v
+  // occurring at this time are added once time moves on
+  double g_v = 0;
+  double pending_g_v = 0;
+  for (ulong e = 0; e < stream.size(); ++e) {
+    if (e > 0 && stream.get_time(e) > stream.get_time(e - 1)) {
+      g_v = (g_v + pending_g_v) * stream_decays_r[e];
+      pending_g_v = 0;
+    }
 
-  for (ulong v = 0; v < n_nodes; v++) {
-    const ArrayDouble timestamps_rv = view(*timestamps_list[r][v]);
-    ulong ij = 0;
-    for (ulong k = 0; k < timestamps_ru.size(); k++) {
-      const double t_ru_k = timestamps_ru[k];
-
-      if (k > 0) {
-        const double ebt = cexp(-decay * (t_ru_k - timestamps_ru[k - 1]));
-        g_ru[k * n_nodes + v] = g_ru[(k - 1) * n_nodes + v] * ebt;
-      } else {
-        g_ru[k * n_nodes + v] = 0;
-      }
-      while ((ij < timestamps_rv.size()) && (timestamps_rv[ij] < t_ru_k)) {
-        const double ebt = cexp(-decay * (t_ru_k - timestamps_rv[ij]));
-        g_ru[k * n_nodes + v] += decay * ebt;
-        ij++;
-      }
-
-      if (u == v) {
-        // We use this pass over the data to fill kernel_integral
-        map_kernel_integral_r[u] += (1. - cexp(-decay * (end_time_r - t_ru_k)));
-      }
+    const ulong u = stream.get_node(e);
+    g[r][u][stream.get_index(e) * n_nodes + v] = g_v;
+
+    if (u == v) {
+      pending_g_v += decay;
+      // We use this pass over the data to fill kernel_integral
+      kernel_integral_rv += (1. - cexp(-decay * (end_time_r - stream.get_time(e))));
     }
   }
 }
 
-// The main method for performing one iteration
 void HawkesADM4::solve(ArrayDouble &mu, ArrayDouble2d &adjacency,
                        ArrayDouble2d &z1, ArrayDouble2d &z2,
                        ArrayDouble2d &u1, ArrayDouble2d &u2) {
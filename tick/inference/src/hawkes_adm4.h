@@ -45,7 +45,10 @@ class HawkesADM4 : public ModelHawkesList {
              ArrayDouble2d &u1, ArrayDouble2d &u2);
 
  private:
-  void compute_weights_ru(const ulong r_u, ArrayDouble2d &map_kernel_integral);
+  void compute_stream_decays_r(const ulong r, ArrayDoubleList1D &stream_decays);
+
+  void compute_weights_rv(const ulong r_v, const ArrayDoubleList1D &stream_decays,
+                          ArrayDouble2d &map_kernel_integral);
 
   void update_u(const ulong u, ArrayDouble &mu, ArrayDouble2d &adjacency, ArrayDouble2d &z1,
                 ArrayDouble2d &z2, ArrayDouble2d &u1, ArrayDouble2d &u2);
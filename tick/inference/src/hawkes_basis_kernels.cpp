@@ -50,6 +50,7 @@ void compute_C(ArrayDouble &u_realization,
 
 // Procedure called by HawkesBasisKernels::solve
 // Not commented, see LaTeX notes
+// Ddm_temp must be zero, only the range of m reached by an event is used and reset afterwards
 double compute_mu_q_D(ulong u_index,
                       SArrayDoublePtrList1D &realization,
                       double T,
@@ -77,7 +78,7 @@ double compute_mu_q_D(ulong u_index,
   for (ulong i = u.size() - 1; i != static_cast<ulong>(-1); i--) {
     double norm = 0;
     qvd_temp.init_to_zero();
-    Ddm_temp.init_to_zero();
+    ulong m_min = M, m_max = 0;
 
     double t_i = u[i];
 
@@ -103,6 +104,8 @@ double compute_mu_q_D(ulong u_index,
         } else {
           ulong m = static_cast<ulong>(std::floor((t_i - t_j) / kernel_dt));
           if (m >= M) break;
+          m_min = std::min(m_min, m);
+          m_max = std::max(m_max, m);
           for (ulong d = 0; d < D; d++) {
             double val = ad[d] * gdm[d * M + m];
             qd_temp[d] += val;
@@ -115,8 +118,9 @@ double compute_mu_q_D(ulong u_index,
 
     mu_out += mu / norm;
     for (ulong d = 0; d < D; d++) {
-      for (ulong m = 0; m < M; m++) {
+      for (ulong m = m_min; m <= m_max; m++) {
         Ddm[d * M + m] += Ddm_temp[d * M + m] / (norm * kernel_dt);
+        Ddm_temp[d * M + m] = 0;
       }
       for (ulong v_index = 0; v_index < dim; v_index++) {
         qvd[v_index * D + d] += avd[v_index * D + d] * qvd_temp[v_index * D + d] / norm;
@@ -179,53 +183,92 @@ HawkesBasisKernels::HawkesBasisKernels(const double kernel_support, const ulong
 
 void HawkesBasisKernels::allocate_weights() {
   const ulong n_basis = get_n_basis();
-  rud = ArrayDouble2d(n_nodes, n_basis);
-  Dudm = ArrayDouble2d(n_nodes, n_basis * kernel_size);
+  const unsigned int n_threads = get_n_accumulation_threads();
+  rud = ArrayDouble2d(n_threads * n_nodes, n_basis);
+  Dtdm = ArrayDouble2d(n_threads, n_basis * kernel_size);
   Gdm = ArrayDouble2d(n_basis, kernel_size);
-  Dudm_temp = ArrayDouble2d(n_nodes, n_basis * kernel_size);
-  Cudm = ArrayDouble2d(n_nodes, n_basis * kernel_size);
+  Ctdm = ArrayDouble2d(n_threads, n_basis * kernel_size);
   a_sum_vd = ArrayDouble2d(n_nodes, n_basis);
-  quvd_temp = ArrayDouble2d(n_nodes, n_nodes * n_basis);
-  quvd = ArrayDouble2d(n_nodes, n_nodes * n_basis);
+  quvd = ArrayDouble2d(n_threads * n_nodes, n_nodes * n_basis);
+  next_mu = ArrayDouble2d(n_threads, n_nodes);
 
   weights_computed = true;
 }
 
+unsigned int HawkesBasisKernels::get_n_accumulation_threads() const {
+  return std::min(get_n_threads(), static_cast<unsigned int>(n_realizations * n_nodes));
+}
+
 // A method called in parallel by the method 'solve' (see below)
-void HawkesBasisKernels::solve_u(ulong u,
-                                   ArrayDouble &mu,
-                                   ArrayDouble2d &gdm,
-                                   ArrayDouble2d &auvd) {
+void HawkesBasisKernels::solve_thread(const ulong thread,
+                                      ArrayDouble &mu,
+                                      ArrayDouble2d &gdm,
+                                      ArrayDouble2d &auvd) {
   const ulong n_basis = get_n_basis();
+  const ulong n_threads = next_mu.n_rows();
+
+  // Each thread handles a contiguous block of (realization, node) pairs r_u
+  const ulong n_r_u = n_realizations * n_nodes;
+  const ulong r_u_start = thread * n_r_u / n_threads;
+  const ulong r_u_end = (thread + 1) * n_r_u / n_threads;
+
+  ArrayDouble2d Cdm(n_basis, kernel_size, view_row(Ctdm, thread).data());
+  ArrayDouble2d Ddm(n_basis, kernel_size, view_row(Dtdm, thread).data());
+
+  // Buffers used for each event of node u
+  ArrayDouble2d Ddm_temp(n_basis, kernel_size);
+  Ddm_temp.init_to_zero();
+  ArrayDouble2d qvd_temp(n_nodes, n_basis);
+
+  for (ulong r_u = r_u_start; r_u < r_u_end; ++r_u) {
+    // Obtain realization and node index from r_u
+    const ulong r = r_u / n_nodes;
+    const ulong u = r_u % n_nodes;
+
+    ArrayDouble rd = view_row(rud, thread * n_nodes + u);
+    ArrayDouble2d avd(n_nodes, n_basis, view_row(auvd, u).data());
+    ArrayDouble2d qvd(n_nodes, n_basis, view_row(quvd, thread * n_nodes + u).data());
+    ArrayDouble a_sum_v = view_row(a_sum_vd, u);
 
-  ArrayDouble rd = view_row(rud, u);
-  double mu_out = 0;
-  ArrayDouble2d Cdm(n_basis, kernel_size, view_row(Cudm, u).data());
-  ArrayDouble2d Ddm(n_basis, kernel_size, view_row(Dudm, u).data());
-  ArrayDouble2d Ddm_temp(n_basis, kernel_size, view_row(Dudm_temp, u).data());
-  ArrayDouble2d avd(n_nodes, n_basis, view_row(auvd, u).data());
-  ArrayDouble2d qvd(n_nodes, n_basis, view_row(quvd, u).data());
-  ArrayDouble2d qvd_temp(n_nodes, n_basis, view_row(quvd_temp, u).data());
-  ArrayDouble a_sum_v = view_row(a_sum_vd, u);
-
-  for (ulong r = 0; r < n_realizations; r++) {
     compute_r(*(timestamps_list[r][u]), (*end_times)[r], get_kernel_dt(), gdm, Gdm, rd);
     compute_C(*timestamps_list[r][u], (*end_times)[r], get_kernel_dt(), gdm, a_sum_v, Cdm);
-    mu_out += compute_mu_q_D(u, timestamps_list[r], (*end_times)[r], get_kernel_dt(), gdm,
-                             avd, mu[u], qvd, qvd_temp, Ddm, Ddm_temp);
+    next_mu(thread, u) += compute_mu_q_D(u, timestamps_list[r], (*end_times)[r],
+                                         get_kernel_dt(), gdm, avd, mu[u], qvd, qvd_temp,
+                                         Ddm, Ddm_temp);
   }
+}
+
+// A method called in parallel by the method 'solve' (see below)
+void HawkesBasisKernels::solve_d(const ulong d,
+                                 ArrayDouble2d &gdm,
+                                 ArrayDouble &rerr_d,
+                                 ulong max_iter_gdm,
+                                 double max_tol_gdm) {
+  const ulong n_basis = get_n_basis();
 
-  mu_out /= end_times->sum();
-  mu[u] = mu_out;
+  // We reduce the computations of Ctdm and Dtdm for basis function d in the first row
+  ArrayDouble Cm(kernel_size, view_row(Ctdm, 0).data() + d * kernel_size);
+  ArrayDouble Dm(kernel_size, view_row(Dtdm, 0).data() + d * kernel_size);
+  for (ulong t = 1; t < Ctdm.n_rows(); t++) {
+    for (ulong m = 0; m < kernel_size; m++) {
+      Cm[m] += Ctdm[t * n_basis * kernel_size + d * kernel_size + m];
+      Dm[m] += Dtdm[t * n_basis * kernel_size + d * kernel_size + m];
+    }
+  }
+
+  ArrayDouble gm = view_row(gdm, d);
+  rerr_d[d] = compute_gdm(alpha, get_kernel_dt(), gm, Cm, Dm, max_tol_gdm, max_iter_gdm);
 }
 
 // The main method for performing one iteration
 double HawkesBasisKernels::solve(ArrayDouble &mu,
-                                   ArrayDouble2d &gdm,
-                                   ArrayDouble2d &auvd,
-                                   ulong max_iter_gdm,
-                                   double max_tol_gdm) {
-  if (!weights_computed) allocate_weights();
+                                 ArrayDouble2d &gdm,
+                                 ArrayDouble2d &auvd,
+                                 ulong max_iter_gdm,
+                                 double max_tol_gdm) {
+  // Buffers are allocated per thread, and the number of threads might have changed
+  const unsigned int n_threads = get_n_accumulation_threads();
+  if (!weights_computed || next_mu.n_rows() != n_threads) allocate_weights();
 
   if (mu.size() != n_nodes) {
     TICK_ERROR("baseline / mu argument must be an array of size " << n_nodes);
@@ -259,20 +302,29 @@ double HawkesBasisKernels::solve(ArrayDouble &mu,
 
   rud.init_to_zero();
   quvd.init_to_zero();
-  Dudm.init_to_zero();
-  Cudm.init_to_zero();
+  Dtdm.init_to_zero();
+  Ctdm.init_to_zero();
+  next_mu.init_to_zero();
 
-  // Parallel loop on u to run compute_r, compute_C, Scompute_mu_q_D
-  parallel_run(get_n_threads(), n_nodes, &HawkesBasisKernels::solve_u, this, mu, gdm, auvd);
+  // Parallel loop on blocks of realizations and nodes to run compute_r, compute_C,
+  // compute_mu_q_D, each thread accumulating in its own buffers
+  parallel_run(n_threads, n_threads, &HawkesBasisKernels::solve_thread, this, mu, gdm, auvd);
 
-  // Then we reduce the computations of Cudm and Dudm
-  // We store in component u=0 the sum_u=0^n_nodes Cudm (same for Dudm)
-  for (ulong u = 1; u < n_nodes; u++) {
-    for (ulong d = 0; d < n_basis; d++) {
-      for (ulong m = 0; m < kernel_size; m++) {
-        Cudm[d * kernel_size + m] += Cudm[u * n_basis * kernel_size + d * kernel_size + m];
-        Dudm[d * kernel_size + m] += Dudm[u * n_basis * kernel_size + d * kernel_size + m];
-      }
+  // Then we reduce the computations of mu, rud and quvd over threads
+  // We store in thread t=0 the sum_t=0^n_threads rud (same for quvd)
+  for (ulong u = 0; u < n_nodes; u++) {
+    double mu_out = 0;
+    for (ulong t = 0; t < n_threads; t++) {
+      mu_out += next_mu(t, u);
+    }
+    mu[u] = mu_out / end_times->sum();
+  }
+  for (ulong t = 1; t < n_threads; t++) {
+    for (ulong u = 0; u < n_nodes; u++) {
+      ArrayDouble rd = view_row(rud, u);
+      rd.mult_incr(view_row(rud, t * n_nodes + u), 1.);
+      ArrayDouble qvd = view_row(quvd, u);
+      qvd.mult_incr(view_row(quvd, t * n_nodes + u), 1.);
     }
   }
 
@@ -286,24 +338,19 @@ double HawkesBasisKernels::solve(ArrayDouble &mu,
     }
   }
 
+  // Parallel loop on basis functions to reduce Ctdm and Dtdm and run compute_gdm
+  ArrayDouble rerr_d(n_basis);
+  parallel_run(std::min(max_n_threads, static_cast<unsigned int>(n_basis)), n_basis,
+               &HawkesBasisKernels::solve_d, this, gdm, rerr_d, max_iter_gdm, max_tol_gdm);
+
   double rerr_gdm = 0;
   for (ulong d = 0; d < n_basis; d++) {
-    ArrayDouble gm = view_row(gdm, d);
-    ArrayDouble2d Cdm(n_basis, kernel_size, view_row(Cudm, 0).data());
-    ArrayDouble2d Ddm(n_basis, kernel_size, view_row(Dudm, 0).data());
-    ArrayDouble Cm = view_row(Cdm, d);
-    ArrayDouble Dm = view_row(Ddm, d);
-    double rerr = compute_gdm(alpha, get_kernel_dt(), gm, Cm, Dm, max_tol_gdm, max_iter_gdm);
-    rerr_gdm = std::max(rerr, rerr_gdm);
+    rerr_gdm = std::max(rerr_d[d], rerr_gdm);
   }
 
   return rerr_gdm;
 }
 
-unsigned int HawkesBasisKernels::get_n_threads() const {
-  return std::min(this->max_n_threads, static_cast<unsigned int>(n_nodes));
-}
-
 void HawkesBasisKernels::set_kernel_support(const double kernel_support) {
   if (kernel_support <= 0) {
     TICK_ERROR("Kernel support must be positive and you have provided " << kernel_support)
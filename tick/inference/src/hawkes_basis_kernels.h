@@ -33,9 +33,13 @@ class HawkesBasisKernels : public ModelHawkesList {
   //! @brief penalty parameter
   double alpha;
 
-  //! @brief Buffer variables
-  ArrayDouble2d rud, Dudm, Dudm_temp, Cudm, Gdm, a_sum_vd;
-  ArrayDouble2d quvd, quvd_temp;
+  //! @brief Buffer variables, accumulated by each thread t in row t * n_nodes + u of rud and
+  //! quvd and in row t of Dtdm and Ctdm, then reduced
+  ArrayDouble2d rud, Dtdm, Ctdm, Gdm, a_sum_vd;
+  ArrayDouble2d quvd;
+
+  //! @brief Buffer variables to compute next baseline (mu), one row per thread
+  ArrayDouble2d next_mu;
 
  public :
   HawkesBasisKernels(const double kernel_support,
@@ -51,17 +55,23 @@ class HawkesBasisKernels : public ModelHawkesList {
                double max_tol_gdm);
 
  private:
-  void solve_u(ulong u,
-               ArrayDouble &mu,
+  void solve_thread(const ulong thread,
+                    ArrayDouble &mu,
+                    ArrayDouble2d &gdm,
+                    ArrayDouble2d &auvd);
+
+  void solve_d(const ulong d,
                ArrayDouble2d &gdm,
-               ArrayDouble2d &auvd);
+               ArrayDouble &rerr_d,
+               ulong max_iter_gdm,
+               double max_tol_gdm);
 
   void allocate_weights();
 
- public:
-  //! @brief we need to override this function as we do not parallelize over realizations
-  unsigned int get_n_threads() const override;
+  //! @brief Number of threads, each with its own buffers, sharing (realization, node) pairs
+  unsigned int get_n_accumulation_threads() const;
 
+ public:
   double get_kernel_support() const { return kernel_support; }
 
   ulong get_kernel_size() const { return kernel_size; }
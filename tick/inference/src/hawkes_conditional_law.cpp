@@ -8,7 +8,10 @@
 #define Py_END_ALLOW_THREADS
 #endif
 
-#include "array.h"
+#include "hawkes_conditional_law.h"
+
+#include <algorithm>
+#include <cmath>
 
 // The non parametric estimation is based on the following quantities :
 //
@@ -139,6 +142,208 @@ void PointProcessCondLaw(ArrayDouble &y_time,
   Py_END_ALLOW_THREADS
 }
 
+// PointProcessCondLaw adds, for each lag and each jump z_t of Z, the number of jumps of Y in
+// ]z_t + lags[k], z_t + lags[k + 1]], except the first and the last jump of Y which are never
+// counted. Summed over the jumps of Z, this is the number of pairs (z_t, y_t) whose y_t falls in
+// this interval, which is found by visiting the jumps of Y between z_t + lags[0] and
+// z_t + lags[N] once, or by N binary searches when there are more of them than lags.
+//
+// All pairs (i, j) of components are computed, Y being component i and Z component j, in
+// parallel. The mark intervals of component j are given by consecutive values of
+// mark_bounds[j] and are all updated in the same loop on the jumps of Z.
+// The result of PointProcessCondLaw for component i, component j and the l-th mark interval
+// of component j is stored in the row of res_Y of index (i, j, l) in lexical order.
+
+namespace {
+
+class PointProcessCondLawsComputer {
+  const ArrayDoubleList1D &times;
+  const ArrayDoubleList1D &marks;
+  const ArrayDoubleList1D &mark_bounds;
+  const ArrayDouble &lags;
+  const double T;
+  ArrayDouble2d &res_Y;
+
+  //! @brief First row of res_Y of each component j, for i = 0
+  std::vector<ulong> row_offsets;
+  ulong n_rows_per_node;
+
+ public:
+  PointProcessCondLawsComputer(const ArrayDoubleList1D &times, const ArrayDoubleList1D &marks,
+                               const ArrayDoubleList1D &mark_bounds, const ArrayDouble &lags,
+                               const double T, ArrayDouble2d &res_Y)
+      : times(times), marks(marks), mark_bounds(mark_bounds), lags(lags), T(T), res_Y(res_Y) {
+    row_offsets = std::vector<ulong>(times.size() + 1, 0);
+    for (ulong j = 0; j < times.size(); ++j) {
+      row_offsets[j + 1] = row_offsets[j] + mark_bounds[j].size() - 1;
+    }
+    n_rows_per_node = row_offsets.back();
+  }
+
+  ulong get_n_rows() const { return times.size() * n_rows_per_node; }
+
+  void compute_i_j(const ulong i_j);
+};
+
+void PointProcessCondLawsComputer::compute_i_j(const ulong i_j) {
+  const ulong n_nodes = times.size();
+  const ulong i = i_j / n_nodes;
+  const ulong j = i_j % n_nodes;
+  const ArrayDouble &y_time = times[i];
+  const ArrayDouble &z_time = times[j];
+  const ArrayDouble &z_mark = marks[j];
+  const ArrayDouble &bounds = mark_bounds[j];
+  const ulong n_marks = bounds.size() - 1;
+  const ulong first_row = i * n_rows_per_node + row_offsets[j];
+  const ulong N = lags.size() - 1;
+  const double lagMax = lags[N];
+  const ulong log2_lags = static_cast<ulong>(std::ceil(std::log2(N + 1)));
+
+  std::vector<ulong> n_terms(n_marks, 0);
+  // A mark interval is done once one of its jumps has been found after the last jump of Y
+  std::vector<bool> done(n_marks, false);
+  std::vector<ulong> eligible_marks;
+  // To improve performance by remembering the last point of Y in each time slice
+  std::vector<ulong> tab_y_index(N, 0);
+  std::vector<double> z_counts(N);
+
+  // Only the jumps of Y from index 1 to y_end - 1 are counted
+  const ulong y_end = y_time.size() > 1 ? y_time.size() - 1 : 1;
+
+  ulong y_index = 0;
+  ulong window_start = 1;
+  ulong window_end = 1;
+  for (ulong z_index = 0; z_index < z_time.size(); z_index++) {
+    // Mark intervals for which it is an eligible jump
+    eligible_marks.clear();
+    for (ulong l = 0; l < n_marks; ++l) {
+      const double zmin = bounds[l], zmax = bounds[l + 1];
+      if (zmin < zmax && z_index > 0 &&
+        (zmin > z_mark[z_index] - z_mark[z_index - 1]
+          || z_mark[z_index] - z_mark[z_index - 1] > zmax))
+        continue;
+      if (!done[l]) eligible_marks.push_back(l);
+    }
+    if (eligible_marks.empty()) continue;
+
+    const double z_t = z_time[z_index];
+    if (z_t + lagMax >= T) break;
+    while (y_index < y_time.size() && y_time[y_index] < z_t) y_index++;
+    for (ulong l : eligible_marks) {
+      n_terms[l] += 1;
+      if (y_index >= y_time.size()) done[l] = true;
+    }
+    if (y_index >= y_time.size()) continue;
+
+    // Counts are added directly to the result when a single mark interval is eligible
+    double *counts = &res_Y(first_row + eligible_marks[0], 0);
+    if (eligible_marks.size() > 1) {
+      std::fill(z_counts.begin(), z_counts.end(), 0.);
+      counts = z_counts.data();
+    }
+
+    // Counted jumps of Y in ]z_t + lags[0], z_t + lagMax], starting at or after z_t
+    window_start = std::max(window_start, y_index);
+    while (window_start < y_end && y_time[window_start] <= z_t + lags[0]) window_start++;
+    window_end = std::max(window_end, window_start);
+    while (window_end < y_end && y_time[window_end] <= z_t + lagMax) window_end++;
+
+    // When there are few jumps of Y in the window, they are binned one by one with a binary
+    // search on the lags. Otherwise, the first jump after each lag is found by moving forward
+    // its position for the previous jump of Z
+    if ((window_end - window_start) * log2_lags < N) {
+      // Each jump of Y falls in the last lag interval k such that z_t + lags[k] < y_t, which
+      // is searched after the one of the previous jump
+      ulong k = 0;
+      for (ulong y_index_lag = window_start; y_index_lag < window_end; ++y_index_lag) {
+        const double y_t = y_time[y_index_lag];
+        k = std::partition_point(lags.data() + k + 1, lags.data() + N,
+                                 [z_t, y_t](double lag) { return z_t + lag < y_t; })
+            - lags.data() - 1;
+        counts[k] += 1;
+      }
+    } else {
+      ulong y_index_lag = window_start;
+      for (ulong k = 0; k < N; k++) {
+        // First jump of Y after z_t + lags[k + 1]
+        ulong &y_index_lag_delta = tab_y_index[k];
+        y_index_lag_delta = std::max(y_index_lag_delta, y_index_lag);
+        while (y_index_lag_delta < window_end && y_time[y_index_lag_delta] <= z_t + lags[k + 1])
+          y_index_lag_delta++;
+        counts[k] += y_index_lag_delta - y_index_lag;
+        y_index_lag = y_index_lag_delta;
+      }
+    }
+
+    if (eligible_marks.size() > 1) {
+      for (ulong l : eligible_marks) {
+        for (ulong k = 0; k < N; k++) res_Y(first_row + l, k) += z_counts[k];
+      }
+    }
+  }
+
+  const double y_lambda = y_time.size() / T;
+  for (ulong l = 0; l < n_marks; ++l) {
+    ArrayDouble res_Y_l = view_row(res_Y, first_row + l);
+    for (ulong k = 0; k < N; k++) {
+      if (n_terms[l] != 0) {
+        res_Y_l[k] /= n_terms[l];
+      }
+      res_Y_l[k] /= (lags[k + 1] - lags[k]);
+      res_Y_l[k] -= y_lambda;
+    }
+  }
+}
+
+}  // namespace
+
+void PointProcessCondLaws(ArrayDoubleList1D &times, ArrayDoubleList1D &marks,
+                          ArrayDoubleList1D &mark_bounds,
+                          ArrayDouble &lags,
+                          double T,
+                          ArrayDouble &res_X, ArrayDouble2d &res_Y,
+                          int n_threads) {
+  if (times.size() != marks.size() || times.size() != mark_bounds.size()) {
+    TICK_ERROR("times (size=" << times.size() << "), marks (size=" << marks.size()
+                              << ") and mark_bounds (size=" << mark_bounds.size()
+                              << ") should have the same size");
+  }
+  for (ulong j = 0; j < times.size(); ++j) {
+    if (times[j].size() != marks[j].size()) {
+      TICK_ERROR("times[" << j << "] (size=" << times[j].size() << ") and marks[" << j
+                          << "] (size=" << marks[j].size() << ") should have the same size");
+    }
+    if (mark_bounds[j].size() < 2) {
+      TICK_ERROR("mark_bounds[" << j << "] should contain at least two values");
+    }
+  }
+
+  if (res_X.size() + 1 != lags.size()) {
+    TICK_ERROR(
+      "lags (size=" << lags.size() << ") should be of the size of res_X (size=" << res_X.size()
+                    << " plus one");
+  }
+
+  PointProcessCondLawsComputer computer(times, marks, mark_bounds, lags, T, res_Y);
+  if (res_Y.n_rows() != computer.get_n_rows() || res_Y.n_cols() != res_X.size()) {
+    TICK_ERROR("res_Y should be of shape (" << computer.get_n_rows() << ", " << res_X.size()
+                                            << ")");
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+
+  res_Y.init_to_zero();
+  parallel_run(n_threads, times.size() * times.size(),
+               &PointProcessCondLawsComputer::compute_i_j, &computer);
+
+  const ulong N = lags.size() - 1;
+  for (ulong k = 0; k < N; k++) {
+    res_X[k] = (lags[k + 1] + lags[k]) / 2.0;
+  }
+
+  Py_END_ALLOW_THREADS
+}
+
 //
 // Given two point processes Y and Z, computes the Signal
 //
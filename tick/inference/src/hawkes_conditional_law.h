@@ -15,4 +15,11 @@ extern void PointProcessCondLaw(ArrayDouble &y_time,
                                 double y_lambda,
                                 ArrayDouble &res_X, ArrayDouble &res_Y);
 
+extern void PointProcessCondLaws(ArrayDoubleList1D &times, ArrayDoubleList1D &marks,
+                                 ArrayDoubleList1D &mark_bounds,
+                                 ArrayDouble &lags,
+                                 double T,
+                                 ArrayDouble &res_X, ArrayDouble2d &res_Y,
+                                 int n_threads = 1);
+
 #endif  // TICK_INFERENCE_SRC_HAWKES_CONDITIONAL_LAW_H_
@@ -3,170 +3,288 @@
 
 #include "hawkes_em.h"
 
+#include <limits>
+
 HawkesEM::HawkesEM(const double kernel_support, const ulong kernel_size,
                    const int max_n_threads)
     : ModelHawkesList(max_n_threads, 0),
-      kernel_discretization(nullptr) {
+      kernel_discretization(nullptr), cache_pairs(false) {
   set_kernel_support(kernel_support);
   set_kernel_size(kernel_size);
 }
 
 HawkesEM::HawkesEM(const SArrayDoublePtr kernel_discretization, const int max_n_threads)
-    : ModelHawkesList(max_n_threads, 0) {
+    : ModelHawkesList(max_n_threads, 0), cache_pairs(false) {
   set_kernel_discretization(kernel_discretization);
 }
 
 void HawkesEM::allocate_weights() {
-  next_mu = ArrayDouble2d(n_realizations, n_nodes);
-  next_kernels = ArrayDouble2d(n_realizations * n_nodes, n_nodes * kernel_size);
-  unnormalized_kernels = ArrayDouble2d(n_realizations * n_nodes, n_nodes * kernel_size);
+  if (n_nodes * kernel_size > std::numeric_limits<std::uint32_t>::max()) {
+    TICK_ERROR("HawkesEM cannot be used with " << n_nodes * kernel_size << " kernel bins");
+  }
+  build_event_streams();
+  allocate_buffers(1);
+  compute_kernel_integral_weights();
+
+  pair_offsets.clear();
+  pair_kernel_indices.clear();
+  if (cache_pairs) {
+    pair_offsets.resize(n_realizations * n_nodes);
+    pair_kernel_indices.resize(n_realizations * n_nodes);
+    parallel_run(get_n_threads(), n_nodes * n_realizations, &HawkesEM::compute_pairs_u_r, this);
+  }
   weights_computed = true;
 }
 
+void HawkesEM::allocate_buffers(const ulong n_starts) {
+  // Buffers are kept while neither the data, the number of starts nor the kernel size change
+  const ulong n_rows = n_realizations * n_nodes;
+  const ulong n_kernel_cols = n_starts * n_nodes * kernel_size;
+  if (next_mu.n_rows() == n_rows && next_mu.n_cols() == n_starts &&
+      next_kernels.n_rows() == n_rows && next_kernels.n_cols() == n_kernel_cols &&
+      sum_log_norms.n_rows() == n_rows && sum_log_norms.n_cols() == n_starts) {
+    return;
+  }
+  next_mu = ArrayDouble2d(n_rows, n_starts);
+  next_kernels = ArrayDouble2d(n_rows, n_kernel_cols);
+  sum_log_norms = ArrayDouble2d(n_rows, n_starts);
+}
+
+ulong HawkesEM::get_n_starts(const ArrayDouble2d &mus, const ArrayDouble2d &kernels) const {
+  if (mus.n_cols() != n_nodes) {
+    TICK_ERROR("baseline / mu argument must be an array of size " << n_nodes);
+  }
+  const ulong n_starts = mus.n_rows();
+  if (kernels.n_rows() != n_starts * n_nodes || kernels.n_cols() != n_nodes * kernel_size) {
+    TICK_ERROR("kernels argument must be an array of shape ("
+                   << n_starts * n_nodes << ", " << n_nodes * kernel_size << ")");
+  }
+  return n_starts;
+}
+
 void HawkesEM::solve(ArrayDouble &mu, ArrayDouble2d &kernels) {
   if (!weights_computed) allocate_weights();
 
   if (mu.size() != n_nodes) {
     TICK_ERROR("baseline / mu argument must be an array of size " << n_nodes);
   }
-  if (kernels.n_rows() != n_nodes || kernels.n_cols() != n_nodes * kernel_size) {
-    TICK_ERROR("kernels argument must be an array of shape ("
-                   << n_nodes << ", " << n_nodes * kernel_size << ")");
-  }
+  ArrayDouble2d mus(1, n_nodes, mu.data());
+  solve_starts(mus, kernels);
+}
+
+void HawkesEM::solve_starts(ArrayDouble2d &mus, ArrayDouble2d &kernels) {
+  if (!weights_computed) allocate_weights();
+  const ulong n_starts = get_n_starts(mus, kernels);
+  allocate_buffers(n_starts);
 
   // Map
   // Fill next_mu and next_kernels
   next_mu.init_to_zero();
   next_kernels.init_to_zero();
+  const bool compute_next = true;
   parallel_run(get_n_threads(), n_nodes * n_realizations,
-               &HawkesEM::solve_u_r, this, mu, kernels);
+               &HawkesEM::solve_u_r, this, mus, kernels, compute_next);
 
   // Reduce
-  // Fill mu and kernels with next_mu and next_kernels
-  mu.init_to_zero();
+  // Fill mus and kernels with next_mu and next_kernels
+  mus.init_to_zero();
   kernels.init_to_zero();
+  const ulong kernel_u_size = n_nodes * kernel_size;
   for (ulong r = 0; r < n_realizations; r++) {
     for (ulong node_u = 0; node_u < n_nodes; ++node_u) {
-      mu[node_u] += next_mu(r, node_u);
+      const ulong r_u = r * n_nodes + node_u;
+      for (ulong s = 0; s < n_starts; ++s) {
+        mus(s, node_u) += next_mu(r_u, s);
+
+        ArrayDouble next_kernel_u_r(kernel_u_size,
+                                    view_row(next_kernels, r_u).data() + s * kernel_u_size);
+        ArrayDouble kernel_u = view_row(kernels, s * n_nodes + node_u);
+        kernel_u.mult_incr(next_kernel_u_r, 1.);
+      }
+    }
+  }
+}
+
+double HawkesEM::loss(ArrayDouble &mu, ArrayDouble2d &kernels) {
+  if (!weights_computed) allocate_weights();
+
+  if (mu.size() != n_nodes) {
+    TICK_ERROR("baseline / mu argument must be an array of size " << n_nodes);
+  }
+  ArrayDouble2d mus(1, n_nodes, mu.data());
+  ArrayDouble out(1);
+  loss_starts(mus, kernels, out);
+  return out[0];
+}
+
+// The log-likelihood is \sum_u \sum_i log(lambda_u(t_i^u)) - \sum_u \int_0^T lambda_u(t) dt
+// where the intensities at the events are the norms of solve_u_r
+void HawkesEM::loss_starts(ArrayDouble2d &mus, ArrayDouble2d &kernels, ArrayDouble &out) {
+  if (!weights_computed) allocate_weights();
+  const ulong n_starts = get_n_starts(mus, kernels);
+  if (out.size() != n_starts) {
+    TICK_ERROR("out argument must be an array of size " << n_starts);
+  }
+  allocate_buffers(n_starts);
+
+  sum_log_norms.init_to_zero();
+  const bool compute_next = false;
+  parallel_run(get_n_threads(), n_nodes * n_realizations,
+               &HawkesEM::solve_u_r, this, mus, kernels, compute_next);
 
-      ArrayDouble2d next_kernel_u_r(n_nodes, kernel_size,
-                                    view_row(next_kernels, r * n_nodes + node_u).data());
-      ArrayDouble2d kernel_u(n_nodes, kernel_size, view_row(kernels, node_u).data());
-      kernel_u.mult_incr(next_kernel_u_r, 1.);
+  for (ulong s = 0; s < n_starts; ++s) {
+    double loglik = 0;
+    for (ulong r_u = 0; r_u < n_realizations * n_nodes; ++r_u) loglik += sum_log_norms(r_u, s);
+    for (ulong node_u = 0; node_u < n_nodes; ++node_u) {
+      loglik -= mus(s, node_u) * end_times->sum();
+      loglik -= view_row(kernels, s * n_nodes + node_u).dot(kernel_integral_weights);
     }
+    out[s] = -loglik / get_n_total_jumps();
   }
 }
 
-void HawkesEM::solve_u_r(const ulong r_u, const ArrayDouble &mu,
-                         ArrayDouble2d &kernels) {
+// As next_kernel_ru(v, m) is the sum over the pairs in bin (v, m) of
+// kernel_u(v, m) / (norm_u * n_jumps_v * dt_m), 1 / norm_u is accumulated for each pair and the
+// constant factor is applied once at the end
+void HawkesEM::solve_u_r(const ulong r_u, const ArrayDouble2d &mus,
+                         const ArrayDouble2d &kernels, const bool compute_next) {
   // Obtain realization and node index from r_u
   const ulong r = static_cast<const ulong>(r_u / n_nodes);
   const ulong node_u = r_u % n_nodes;
+  const ulong n_starts = mus.n_rows();
+  const ulong kernel_u_size = n_nodes * kernel_size;
+
+  ArrayDouble next_mu_ru = view_row(next_mu, r_u);
+  ArrayDouble next_kernels_ru = view_row(next_kernels, r_u);
+  ArrayDouble sum_log_norms_ru = view_row(sum_log_norms, r_u);
+  ArrayDouble sum_inverse_norms(n_starts);
+  sum_inverse_norms.init_to_zero();
+
+  // Pairs of the current event, if they are not cached
+  std::vector<std::uint32_t> event_kernel_indices;
+  const ulong *cached_offsets = cache_pairs ? pair_offsets[r_u].data() : nullptr;
+  const std::uint32_t *cached_kernel_indices =
+      cache_pairs ? pair_kernel_indices[r_u].data() : nullptr;
+
+  const ulong n_events_u = timestamps_list[r][node_u]->size();
+  for (ulong i = 0; i < n_events_u; ++i) {
+    const std::uint32_t *pairs;
+    ulong n_pairs;
+    if (cache_pairs) {
+      pairs = cached_kernel_indices + cached_offsets[i];
+      n_pairs = cached_offsets[i + 1] - cached_offsets[i];
+    } else {
+      event_kernel_indices.clear();
+      find_pairs(r, node_u, i, event_kernel_indices);
+      pairs = event_kernel_indices.data();
+      n_pairs = event_kernel_indices.size();
+    }
+
+    // The pairs being found once, all starts are updated with them
+    for (ulong s = 0; s < n_starts; ++s) {
+      const double *kernel_u = kernels.data() + (s * n_nodes + node_u) * kernel_u_size;
+
+      // norm will be equal to mu_u + \sum_v \sum_(t_j <= t_i) g_uv(t_i - t_j)
+      double norm_u = mus(s, node_u);
+      for (ulong p = 0; p < n_pairs; ++p) norm_u += kernel_u[pairs[p]];
 
-  // Fetch corresponding data
-  SArrayDoublePtrList1D &realization = timestamps_list[r];
-  ArrayDouble2d kernel_u(n_nodes, kernel_size, view_row(kernels, node_u).data());
-  const double mu_u = mu[node_u];
-
-  // initialize next data
-  ArrayDouble2d next_kernel_ru(n_nodes, kernel_size,
-                               view_row(next_kernels, r * n_nodes + node_u).data());
-  ArrayDouble2d unnormalized_kernel_ru(n_nodes, kernel_size,
-                                       view_row(unnormalized_kernels,
-                                                r * n_nodes + node_u).data());
-  double &next_mu_ru = next_mu(r, node_u);
-
-  ArrayDouble timestamps_u = view(*realization[node_u]);
-
-  // This array will allow us to find quicker the events in each component that
-  // have occurred just before the events we will look at
-  ArrayULong last_indices(n_nodes);
-  for (ulong v = 0; v < n_nodes; v++) {
-    last_indices[v] = realization[v]->size();
-  }
-
-  // We loop in reverse order to benefit from last_indices
-  for (ulong i = timestamps_u.size() - 1; i != static_cast<ulong>(-1); i--) {
-    // this array will store temporary values
-    unnormalized_kernel_ru.init_to_zero();
-
-    // norm will be equal to mu_u + \sum_v \sum_(t_j < t_i) g_uv(t_i - t_j)
-    double norm_u = 0;
-
-    const double t_i = timestamps_u[i];
-    for (ulong node_v = 0; node_v < n_nodes; node_v++) {
-      ArrayDouble timestamps_v = view(*realization[node_v]);
-
-      // Update the corresponding index such that it is the largest index which
-      // satisfies v[index] <= t_i
-      while (true) {
-        if (last_indices[node_v] == 0) break;
-        if (last_indices[node_v] < timestamps_v.size() &&
-            t_i >= timestamps_v[last_indices[node_v]])
-          break;
-        last_indices[node_v]--;
+      if (!compute_next) {
+        sum_log_norms_ru[s] += log(norm_u);
+        continue;
       }
-      if (t_i < timestamps_v[last_indices[node_v]]) continue;
-
-      // Get the corresponding kernels and their size
-      ArrayDouble kernel_ruv = view_row(kernel_u, node_v);
-      ArrayDouble unnormalized_kernel_ruv = view_row(unnormalized_kernel_ru, node_v);
-
-      ulong j0 = last_indices[node_v];
-      ulong last_m = 0;
-
-      // So now we loop on the indices of y backward starting from the index computed above
-      for (ulong j = j0; j != static_cast<ulong>(-1); j--) {
-        // Case the two events are in fact the same one
-        if (node_u == node_v && i == j) {
-          norm_u += mu_u;
-        } else {
-          // Case they are different
-          const double t_j = timestamps_v[j];
-
-          const double t_diff = t_i - t_j;
-          if (t_diff < kernel_support) {
-            // We get the index in the kernel array
-            ulong m;
-            if (kernel_discretization == nullptr) {
-              m = static_cast<ulong>(floor(t_diff / get_kernel_dt()));
-            } else {
-              // last_m allows us to find m value quicker as m >= last_m
-              m = last_m;
-              while ((*kernel_discretization)[m + 1] < t_diff) m++;
-            }
-            last_m = m;
-
-            // Then we get the corresponding kernel value
-            double unnormalized_p_uv_ij = kernel_ruv[m];
-
-            // Update contribution to kernel of p_ij
-            unnormalized_kernel_ruv[m] += unnormalized_p_uv_ij;
-
-            // Update the norm
-            norm_u += unnormalized_p_uv_ij;
-          } else {
-            // If the two events are too far away --> we are done with the second loop
-            break;
-          }
-        }
+
+      // If norm is zero then nothing to do (no contribution)
+      if (norm_u == 0) continue;
+      const double inverse_norm_u = 1. / norm_u;
+      sum_inverse_norms[s] += inverse_norm_u;
+      double *next_kernel_ru = next_kernels_ru.data() + s * kernel_u_size;
+      for (ulong p = 0; p < n_pairs; ++p) {
+        next_kernel_ru[pairs[p]] += inverse_norm_u;
+      }
+    }
+  }
+  if (!compute_next) return;
+
+  for (ulong s = 0; s < n_starts; ++s) {
+    next_mu_ru[s] += mus(s, node_u) * sum_inverse_norms[s] / end_times->sum();
+
+    const double *kernel_u = kernels.data() + (s * n_nodes + node_u) * kernel_u_size;
+    double *next_kernel_ru = next_kernels_ru.data() + s * kernel_u_size;
+    for (ulong node_v = 0; node_v < n_nodes; ++node_v) {
+      for (ulong m = 0; m < kernel_size; ++m) {
+        const ulong index = node_v * kernel_size + m;
+        if (next_kernel_ru[index] == 0) continue;
+        next_kernel_ru[index] *=
+            kernel_u[index] / ((*n_jumps_per_node)[node_v] * get_kernel_dt(m));
       }
     }
-    // We are now ready to perform normalization !
-
-    // If norm is zero then nothing to do (no contribution)
-    if (norm_u == 0) continue;
-
-    // Otherwise, we need to norm the kernel_temp's and the mu_temp
-    // and add their contributions to the estimation
-    next_mu_ru += mu_u / (norm_u * end_times->sum());
-    for (ulong node_v = 0; node_v < n_nodes; node_v++) {
-      ArrayDouble unnormalized_kernel_ruv = view_row(unnormalized_kernel_ru, node_v);
-      ArrayDouble next_kernel_ruv = view_row(next_kernel_ru, node_v);
-      for (ulong m = 0; m < kernel_size; m++) {
-        const double normalization_term = norm_u * (*n_jumps_per_node)[node_v] * get_kernel_dt(m);
-        next_kernel_ruv[m] += unnormalized_kernel_ruv[m] / normalization_term;
+  }
+}
+
+// The events j such that t_j <= t_i are the ones preceding in the stream the last event that
+// occurs at t_i, they are visited backward as long as they are in the kernel support. The event
+// itself is accounted for in mu_u
+void HawkesEM::find_pairs(const ulong r, const ulong node_u, const ulong i,
+                          std::vector<std::uint32_t> &kernel_indices) const {
+  const HawkesEventStream &stream = event_streams[r];
+  const ulong position_i = stream.get_position(node_u, i);
+  const double t_i = stream.get_time(position_i);
+  ulong window_end = position_i + 1;
+  while (window_end < stream.size() && stream.get_time(window_end) == t_i) window_end++;
+
+  ulong last_m = 0;
+  for (ulong position_j = window_end; position_j-- > 0;) {
+    const double t_diff = t_i - stream.get_time(position_j);
+    if (t_diff >= kernel_support) break;
+    // Events are visited by increasing t_diff
+    const ulong m = get_kernel_index(t_diff, last_m);
+    last_m = m;
+    if (position_j == position_i) continue;
+    kernel_indices.push_back(
+        static_cast<std::uint32_t>(stream.get_node(position_j) * kernel_size + m));
+  }
+}
+
+void HawkesEM::compute_pairs_u_r(const ulong r_u) {
+  const ulong r = static_cast<ulong>(r_u / n_nodes);
+  const ulong node_u = r_u % n_nodes;
+  const ulong n_events_u = timestamps_list[r][node_u]->size();
+
+  std::vector<ulong> &offsets = pair_offsets[r_u];
+  std::vector<std::uint32_t> &kernel_indices = pair_kernel_indices[r_u];
+  offsets = std::vector<ulong>(n_events_u + 1, 0);
+  kernel_indices.clear();
+
+  for (ulong i = 0; i < n_events_u; ++i) {
+    find_pairs(r, node_u, i, kernel_indices);
+    offsets[i + 1] = kernel_indices.size();
+  }
+  kernel_indices.shrink_to_fit();
+}
+
+// Events whose realization ends after the kernel support contribute to all bins entirely
+void HawkesEM::compute_kernel_integral_weights() {
+  const SArrayDoublePtr discretization = get_kernel_discretization();
+  kernel_integral_weights = ArrayDouble(n_nodes * kernel_size);
+  kernel_integral_weights.init_to_zero();
+  for (ulong r = 0; r < n_realizations; ++r) {
+    const double end_time = (*end_times)[r];
+    for (ulong node_v = 0; node_v < n_nodes; ++node_v) {
+      ArrayDouble weights_v(kernel_size, kernel_integral_weights.data() + node_v * kernel_size);
+      ulong n_full_events = 0;
+      const ArrayDouble &timestamps_v = *timestamps_list[r][node_v];
+      for (ulong j = 0; j < timestamps_v.size(); ++j) {
+        const double remaining_time = end_time - timestamps_v[j];
+        if (remaining_time >= kernel_support) {
+          n_full_events++;
+          continue;
+        }
+        for (ulong m = 0; m < kernel_size && (*discretization)[m] < remaining_time; ++m) {
+          weights_v[m] += std::min((*discretization)[m + 1], remaining_time)
+              - (*discretization)[m];
+        }
       }
+      for (ulong m = 0; m < kernel_size; ++m) weights_v[m] += n_full_events * get_kernel_dt(m);
     }
   }
 }
@@ -222,6 +340,17 @@ void HawkesEM::set_kernel_dt(const double kernel_dt) {
   set_kernel_size(static_cast<ulong>(std::ceil(kernel_support / kernel_dt)));
 }
 
+void HawkesEM::set_cache_pairs(const bool cache_pairs) {
+  this->cache_pairs = cache_pairs;
+  weights_computed = false;
+}
+
+ulong HawkesEM::get_n_cached_pairs() const {
+  ulong n_cached_pairs = 0;
+  for (auto &kernel_indices : pair_kernel_indices) n_cached_pairs += kernel_indices.size();
+  return n_cached_pairs;
+}
+
 void HawkesEM::set_kernel_discretization(const SArrayDoublePtr kernel_discretization1) {
   set_kernel_support(kernel_discretization1->last());
   set_kernel_size(kernel_discretization1->size() - 1);
@@ -235,6 +364,28 @@ void HawkesEM::set_kernel_discretization(const SArrayDoublePtr kernel_discretiza
   }
 
   kernel_discretization->sort();
+  compute_kernel_bin_lookup();
   weights_computed = false;
 }
 
+// Cells are as small as the smallest bin, so that each one intersects at most two bins, unless
+// this requires more than max_cells_per_bin cells per bin on average
+void HawkesEM::compute_kernel_bin_lookup() {
+  const ulong max_cells_per_bin = 16;
+  double min_dt = kernel_support;
+  for (ulong m = 0; m < kernel_size; ++m) {
+    if (get_kernel_dt(m) > 0) min_dt = std::min(min_dt, get_kernel_dt(m));
+  }
+  const ulong n_cells = std::min(static_cast<ulong>(std::ceil(kernel_support / min_dt)),
+                                 max_cells_per_bin * kernel_size);
+  kernel_bin_lookup_inverse_dt = n_cells / kernel_support;
+
+  kernel_bin_lookup = ArrayULong(n_cells + 1);
+  ulong m = 0;
+  for (ulong cell = 0; cell <= n_cells; ++cell) {
+    const double cell_start = cell / kernel_bin_lookup_inverse_dt;
+    while (m + 1 < kernel_size && (*kernel_discretization)[m + 1] < cell_start) m++;
+    kernel_bin_lookup[cell] = m;
+  }
+}
+
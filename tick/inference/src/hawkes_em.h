@@ -28,10 +28,34 @@ class HawkesEM : public ModelHawkesList {
   //! @brief explicit discretization of the kernel
   SArrayDoublePtr kernel_discretization;
 
-  //! @brief buffer variables
+  //! @brief Uniform grid over the support of an explicit discretization: the bins intersecting
+  //! cell c (of width 1 / kernel_bin_lookup_inverse_dt) are between kernel_bin_lookup[c] and
+  //! kernel_bin_lookup[c + 1]
+  ArrayULong kernel_bin_lookup;
+  double kernel_bin_lookup_inverse_dt;
+
+  //! @brief buffer variables, row r * n_nodes + u holds the contributions of node u of
+  //! realization r for all the starts solved at once
   ArrayDouble2d next_mu;
   ArrayDouble2d next_kernels;
-  ArrayDouble2d unnormalized_kernels;
+  ArrayDouble2d sum_log_norms;
+
+  //! @brief For each node v and kernel bin m, sum over the events t_j^v of the length of the
+  //! part of bin m that lies before the end time of their realization, once shifted by t_j^v.
+  //! The compensator of a kernel is its scalar product with these weights
+  ArrayDouble kernel_integral_weights;
+
+  //! @brief If true, the pairs of events in the kernel support and their kernel bins are found
+  //! once, when weights are allocated, instead of at each iteration
+  bool cache_pairs;
+
+  //! @brief For each r * n_nodes + u, the pairs of the i-th event of node u are stored from
+  //! pair_offsets[r_u][i] to pair_offsets[r_u][i + 1] in pair_kernel_indices[r_u]
+  std::vector<std::vector<ulong>> pair_offsets;
+
+  //! @brief For each r * n_nodes + u and each pair (t_i^u, t_j^v) with t_j^v <= t_i^u in the
+  //! kernel support, index v * kernel_size + m of the kernel bin m in which t_i^u - t_j^v falls
+  std::vector<std::vector<std::uint32_t>> pair_kernel_indices;
 
  public :
   HawkesEM(const double kernel_support, const ulong kernel_size,
@@ -45,10 +69,78 @@ class HawkesEM : public ModelHawkesList {
   //! @brief The main method to perform one iteration
   void solve(ArrayDouble &mu, ArrayDouble2d &kernels);
 
+  /**
+   * @brief Perform one iteration from several starting points at once, the pairs of events
+   * being found once for all of them
+   * \param mus : baselines of the starts, of shape (n_starts, n_nodes)
+   * \param kernels : kernels of the starts, of shape (n_starts * n_nodes, n_nodes * kernel_size),
+   * rows s * n_nodes to (s + 1) * n_nodes being the kernels of start s
+   */
+  void solve_starts(ArrayDouble2d &mus, ArrayDouble2d &kernels);
+
+  //! @brief Negative log-likelihood of the data, divided by the total number of events, for
+  //! the given baseline and piecewise constant kernels
+  double loss(ArrayDouble &mu, ArrayDouble2d &kernels);
+
+  //! @brief Same as loss for several starting points at once, laid out as in solve_starts,
+  //! the loss of start s being stored in out[s]
+  void loss_starts(ArrayDouble2d &mus, ArrayDouble2d &kernels, ArrayDouble &out);
+
  private:
-  //! @brief A method called in parallel by the method 'solve'
+  //! @brief Check the shapes of starting points and return their number
+  ulong get_n_starts(const ArrayDouble2d &mus, const ArrayDouble2d &kernels) const;
+
+  //! @brief Resize buffer variables if needed to solve n_starts starts at once
+  void allocate_buffers(const ulong n_starts);
+
+  //! @brief A method called in parallel by the methods 'solve_starts' and 'loss_starts'
+  //! @param r_u : r * n_realizations + u, tells which realization and which node
+  //! @param compute_next : if false, only sum_log_norms is filled
+  void solve_u_r(const ulong r_u, const ArrayDouble2d &mus, const ArrayDouble2d &kernels,
+                 const bool compute_next);
+
+  //! @brief Append to kernel_indices the pairs of events in the kernel support of the i-th
+  //! event of node u of realization r
+  //! \note Pairs are stored as in pair_kernel_indices
+  void find_pairs(const ulong r, const ulong node_u, const ulong i,
+                  std::vector<std::uint32_t> &kernel_indices) const;
+
+  //! @brief Find and store the pairs of events in the kernel support for one node of one
+  //! realization, called in parallel by allocate_weights
   //! @param r_u : r * n_realizations + u, tells which realization and which node
-  void solve_u_r(const ulong r_u, const ArrayDouble &mu, ArrayDouble2d &kernel);
+  void compute_pairs_u_r(const ulong r_u);
+
+  //! @brief Fill kernel_integral_weights
+  void compute_kernel_integral_weights();
+
+  //! @brief Index of the kernel bin in which t_diff falls, t_diff being in [0, kernel_support)
+  //! @param last_m : a lower bound of this index, returned directly if t_diff falls in its bin
+  //! \note With an explicit discretization, the bin is otherwise searched among the few bins
+  //! that intersect the cell of kernel_bin_lookup in which t_diff falls
+  inline ulong get_kernel_index(const double t_diff, const ulong last_m = 0) const {
+    if (kernel_discretization == nullptr) {
+      return static_cast<ulong>(floor(t_diff / get_kernel_dt()));
+    }
+    if ((*kernel_discretization)[last_m + 1] >= t_diff) return last_m;
+    const ulong cell = std::min(static_cast<ulong>(t_diff * kernel_bin_lookup_inverse_dt),
+                                kernel_bin_lookup.size() - 2);
+    // Branch-free search of the first bin whose upper bound is not smaller than t_diff
+    ulong m = kernel_bin_lookup[cell];
+    ulong n_candidates = kernel_bin_lookup[cell + 1] - m + 1;
+    while (n_candidates > 1) {
+      const ulong half = n_candidates / 2;
+      m = (*kernel_discretization)[m + half + 1] < t_diff ? m + half : m;
+      n_candidates -= half;
+    }
+    m += (*kernel_discretization)[m + 1] < t_diff;
+    // Rounding of the cell index might leave t_diff in a neighbour bin
+    while (m > 0 && (*kernel_discretization)[m] >= t_diff) m--;
+    while ((*kernel_discretization)[m + 1] < t_diff) m++;
+    return m;
+  }
+
+  //! @brief Build kernel_bin_lookup from kernel_discretization
+  void compute_kernel_bin_lookup();
 
   //! @brief Discretization parameter of the kernel
   //! If kernel_discretization is a nullptr then it is equal to kernel_support / kernel_size
@@ -90,6 +182,16 @@ class HawkesEM : public ModelHawkesList {
   void set_kernel_dt(const double kernel_dt);
 
   void set_kernel_discretization(const SArrayDoublePtr kernel_discretization);
+
+  bool get_cache_pairs() const { return cache_pairs; }
+
+  //! @brief Set whether pairs of events in the kernel support are stored across iterations
+  //! \note This is worth it when many iterations are run on the same data, memory is then
+  //! proportional to the number of pairs
+  void set_cache_pairs(const bool cache_pairs);
+
+  //! @brief Returns the number of pairs of events currently stored
+  ulong get_n_cached_pairs() const;
 };
 
 #endif  // TICK_INFERENCE_SRC_HAWKES_EM_H_
@@ -3,6 +3,14 @@
 #include "base.h"
 #include "hawkes_sumgaussians.h"
 
+namespace {
+
+//! @brief Number of standard deviations beyond which a gaussian function is considered null.
+//! Its relative value there is below 1e-17 and the erf of its integral rounds to 1
+const double n_std_support = 9.;
+
+}  // namespace
+
 // soft-thresholding operator
 double soft_thres(double z, double alpha) {
   return (z > 0 ? std::max(std::abs(z) - alpha, 0.) : -std::max(std::abs(z) - alpha, 0.));
@@ -44,11 +52,21 @@ void HawkesSumGaussians::compute_weights() {
         max_mean_gaussian / static_cast<double>(n_gaussians);
   }
   std_gaussian = max_mean_gaussian / (n_gaussians * M_PI);
-  std_gaussian_sq = std_gaussian * std_gaussian;
   norm_constant_gauss = std_gaussian * std::sqrt(2. * M_PI);
   norm_constant_erf = std_gaussian * std::sqrt(2);
+  gaussian_step = max_mean_gaussian / static_cast<double>(n_gaussians);
+  gaussian_support = means_gaussians[n_gaussians - 1] + n_std_support * std_gaussian;
+
+  const double step_in_std_sq = (gaussian_step / std_gaussian) * (gaussian_step / std_gaussian);
+  gaussian_ratios = ArrayDouble(n_gaussians);
+  gaussian_integrals = ArrayDouble(n_gaussians);
+  for (ulong m = 0; m < n_gaussians; m++) {
+    gaussian_ratios[m] = std::exp(-(m + 0.5) * step_in_std_sq);
+    gaussian_integrals[m] = 0.5 + 0.5 * std::erf(means_gaussians[m] / norm_constant_erf);
+  }
 
   // Compute weights
+  build_event_streams();
   // variable to compute kernel integral in parallel that will be reduced afterwards
   ArrayDouble2d map_kernel_integral(n_realizations, n_nodes * n_gaussians);
   map_kernel_integral.init_to_zero();
@@ -78,29 +96,56 @@ void HawkesSumGaussians::compute_weights_ru(const ulong r_u, ArrayDouble2d &map_
   const double end_time_r = (*end_times)[r];
   ArrayDouble map_kernel_integral_r = view_row(map_kernel_integral, r);
 
-  for (ulong v = 0; v < n_nodes; v++) {
-    const ArrayDouble timestamps_rv = view(*timestamps_list[r][v]);
-    for (ulong k = 0; k < timestamps_ru.size(); k++) {
-      const double t_ru_k = timestamps_ru[k];
-      ArrayDouble g_ru_k = view_row(g_ru, k);
-      for (ulong m = 0; m < n_gaussians; m++) {
-        ulong ij = 0;
-        while ((ij < timestamps_rv.size()) && (timestamps_rv[ij] < t_ru_k)) {
-          g_ru_k[v * n_gaussians + m] +=
-              cexp(-(t_ru_k - timestamps_rv[ij] - means_gaussians[m])
-                       * (t_ru_k - timestamps_rv[ij] - means_gaussians[m])
-                       / (2. * std_gaussian_sq))
-                  / norm_constant_gauss;
-          ij++;
-        }
+  const HawkesEventStream &stream = event_streams[r];
+  for (ulong k = 0; k < timestamps_ru.size(); k++) {
+    const double t_ru_k = timestamps_ru[k];
+    ArrayDouble g_ru_k = view_row(g_ru, k);
+
+    // The events j such that t_j < t_ru_k are the ones preceding in the stream the first event
+    // that occurs at t_ru_k
+    ulong position_j = stream.get_position(u, k);
+    while (position_j > 0 && stream.get_time(position_j - 1) == t_ru_k) position_j--;
+
+    while (position_j-- > 0) {
+      const double t_diff = t_ru_k - stream.get_time(position_j);
+      // Previous events are even further in the past
+      if (t_diff > gaussian_support) break;
+      double *g_ru_k_v = g_ru_k.data() + stream.get_node(position_j) * n_gaussians;
+
+      // Only the gaussian functions whose mean is less than n_std_support standard deviations
+      // away are computed. Starting from the closest one, the value of each gaussian function
+      // is the value of its neighbour times a ratio, which needs a single exponential
+      const ulong m_closest =
+          std::min(n_gaussians - 1, static_cast<ulong>(t_diff / gaussian_step + 0.5));
+      const double d_closest = (t_diff - means_gaussians[m_closest]) / std_gaussian;
+      const double value_closest = cexp(-0.5 * d_closest * d_closest) / norm_constant_gauss;
+      const double ratio = cexp(gaussian_step / std_gaussian * d_closest);
+      const double inverse_ratio = 1. / ratio;
+      g_ru_k_v[m_closest] += value_closest;
+
+      double value = value_closest;
+      for (ulong m = m_closest + 1;
+           m < n_gaussians && means_gaussians[m] - t_diff <= n_std_support * std_gaussian; m++) {
+        value *= ratio * gaussian_ratios[m - 1 - m_closest];
+        g_ru_k_v[m] += value;
+      }
+      value = value_closest;
+      for (ulong m = m_closest;
+           m > 0 && t_diff - means_gaussians[m - 1] <= n_std_support * std_gaussian; m--) {
+        value *= inverse_ratio * gaussian_ratios[m_closest - m];
+        g_ru_k_v[m - 1] += value;
       }
-      if (u == v) {
-        // We use this pass over the data to fill kernel_integral
-        for (ulong m = 0; m < n_gaussians; m++) {
-          map_kernel_integral_r[u * n_gaussians + m] +=
-              0.5 * std::erf((end_time_r - t_ru_k - means_gaussians[m]) / norm_constant_erf)
-                  + 0.5 * std::erf(means_gaussians[m] / norm_constant_erf);
-        }
+    }
+
+    // We use this pass over the data to fill kernel_integral
+    for (ulong m = 0; m < n_gaussians; m++) {
+      const double time_to_end = end_time_r - t_ru_k - means_gaussians[m];
+      if (time_to_end > n_std_support * std_gaussian) {
+        map_kernel_integral_r[u * n_gaussians + m] += gaussian_integrals[m];
+      } else {
+        map_kernel_integral_r[u * n_gaussians + m] +=
+            0.5 * std::erf(time_to_end / norm_constant_erf)
+                + 0.5 * std::erf(means_gaussians[m] / norm_constant_erf);
       }
     }
   }
@@ -24,10 +24,22 @@ class HawkesSumGaussians : public ModelHawkesList {
   double std_gaussian;
 
   //! @brief Useful constants that appear in weights computation.
-  double std_gaussian_sq = std_gaussian*std_gaussian;
   double norm_constant_gauss = std_gaussian * std::sqrt(2.*M_PI);
   double norm_constant_erf = std_gaussian * std::sqrt(2);
 
+  //! @brief Distance between the means of two consecutive gaussian functions
+  double gaussian_step;
+
+  //! @brief Time lag beyond which all gaussian functions are considered null
+  double gaussian_support;
+
+  //! @brief Ratios used to compute the value of a gaussian function from the value of its
+  //! neighbour: gaussian_ratios[k] = exp(-(k + 1/2) gaussian_step^2 / std_gaussian^2)
+  ArrayDouble gaussian_ratios;
+
+  //! @brief Integrals of the gaussian functions over positive times
+  ArrayDouble gaussian_integrals;
+
   //! @brief Step size used in update formulas (7) and (8)
   double step_size;
 
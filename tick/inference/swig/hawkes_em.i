@@ -19,6 +19,12 @@ class HawkesEM : public ModelHawkesList {
 
   void solve(ArrayDouble &mu, ArrayDouble2d &kernels);
 
+  void solve_starts(ArrayDouble2d &mus, ArrayDouble2d &kernels);
+
+  double loss(ArrayDouble &mu, ArrayDouble2d &kernels);
+
+  void loss_starts(ArrayDouble2d &mus, ArrayDouble2d &kernels, ArrayDouble &out);
+
   double get_kernel_support() const;
   ulong get_kernel_size() const;
   double get_kernel_fixed_dt() const;
@@ -28,4 +34,8 @@ class HawkesEM : public ModelHawkesList {
   void set_kernel_size(const ulong kernel_size);
   void set_kernel_dt(const double kernel_dt);
   void set_kernel_discretization(const SArrayDoublePtr kernel_discretization);
+
+  bool get_cache_pairs() const;
+  void set_cache_pairs(const bool cache_pairs);
+  ulong get_n_cached_pairs() const;
 };
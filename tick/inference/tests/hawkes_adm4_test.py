@@ -46,6 +46,46 @@ class Test(unittest.TestCase):
         np.testing.assert_array_almost_equal(learner.adjacency, adjacency,
                                              decimal=6)
 
+    def test_hawkes_adm4_fit_path(self):
+        """...Test HawkesADM4 fit_path starts like fit and warm starts the
+        following fits
+        """
+        events = [np.array([1, 1.2, 3.4, 5.8, 10.3, 11, 13.4]),
+                  np.array([2, 5, 8.3, 9.10, 15, 18, 20, 33])]
+
+        n_nodes = len(events)
+        decay = 0.7
+        Cs = np.array([10, 5, 2])
+        lasso_nuclear_ratio = 0.7
+        rhos = np.array([0.5, 0.5, 0.3])
+
+        baseline_start = np.zeros(n_nodes) + .2
+        adjacency_start = np.zeros((n_nodes, n_nodes)) + .2
+
+        learner = HawkesADM4(decay, rho=rhos[0], C=Cs[0],
+                             lasso_nuclear_ratio=lasso_nuclear_ratio,
+                             max_iter=10, verbose=False, em_max_iter=3)
+        learner.fit(events, baseline_start=baseline_start,
+                    adjacency_start=adjacency_start)
+
+        path_learner = HawkesADM4(decay, lasso_nuclear_ratio=0.1,
+                                  max_iter=10, verbose=False, em_max_iter=3)
+        baselines, adjacencies = path_learner.fit_path(
+            events, Cs, lasso_nuclear_ratio=lasso_nuclear_ratio, rho=rhos,
+            baseline_start=baseline_start, adjacency_start=adjacency_start)
+
+        self.assertEqual(baselines.shape, (3, n_nodes))
+        self.assertEqual(adjacencies.shape, (3, n_nodes, n_nodes))
+        np.testing.assert_array_equal(baselines[0], learner.baseline)
+        np.testing.assert_array_equal(adjacencies[0], learner.adjacency)
+
+        self.assertEqual(path_learner.C, Cs[-1])
+        self.assertEqual(path_learner.rho, rhos[-1])
+        self.assertEqual(path_learner.lasso_nuclear_ratio, lasso_nuclear_ratio)
+        np.testing.assert_array_equal(baselines[-1], path_learner.baseline)
+        np.testing.assert_array_equal(adjacencies[-1], path_learner.adjacency)
+        self.assertTrue(np.all(baselines > 0))
+
     def test_hawkes_adm4_set_data(self):
         """...Test set_data method of Hawkes ADM4
         """
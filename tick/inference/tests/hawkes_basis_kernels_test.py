@@ -73,6 +73,49 @@ class Test(unittest.TestCase):
         np.testing.assert_array_almost_equal(em.basis_kernels,
                                              basis_kernels, decimal=3)
 
+    def test_em_basis_kernels_threads(self):
+        """...Test that HawkesBasisKernels gives the same results on several
+        realizations whatever the number of threads
+        """
+        ticks = [
+            [np.array([1, 1.2, 3.4, 5.8, 10.3, 11, 13.4]),
+             np.array([2, 5, 8.3, 9.10, 15, 18, 20, 33])],
+            [np.array([2, 3.2, 11.4, 12.8, 45]),
+             np.array([2, 3, 8.8, 9, 15.3, 19])],
+            [np.array([0.5, 4, 7.7]),
+             np.array([1.1, 2.5, 3, 6, 9.5])]
+        ]
+        n_basis = 2
+        n_nodes = len(ticks[0])
+        kernel_size = 40
+
+        mu = np.zeros(n_nodes) + .2
+        auvd = np.zeros((n_nodes, n_nodes, n_basis)) + .4
+        auvd[1, :, :] += .2
+        gdm = np.zeros((n_basis, kernel_size))
+        gdm[0] = 0.1 * 0.29 * np.exp(-0.29 * np.arange(kernel_size) * .1)
+        gdm[1] = 0.8 * np.exp(-np.arange(kernel_size) * .1)
+
+        em = HawkesBasisKernels(kernel_support=4, kernel_size=kernel_size,
+                                n_basis=n_basis, C=5e-2, n_threads=1,
+                                max_iter=4, ode_max_iter=100)
+        em.fit(ticks, baseline_start=mu, amplitudes_start=auvd,
+               basis_kernels_start=gdm)
+        baseline = em.baseline.copy()
+        amplitudes = em.amplitudes.copy()
+        basis_kernels = em.basis_kernels.copy()
+
+        # There are 6 (realization, node) pairs, split unevenly between 4
+        # threads, and fewer pairs than threads with 8
+        for n_threads in [2, 4, 8]:
+            em.n_threads = n_threads
+            em.fit(ticks, baseline_start=mu, amplitudes_start=auvd,
+                   basis_kernels_start=gdm)
+            np.testing.assert_allclose(em.baseline, baseline, rtol=1e-10)
+            np.testing.assert_allclose(em.amplitudes, amplitudes, rtol=1e-10)
+            np.testing.assert_allclose(em.basis_kernels, basis_kernels,
+                                       rtol=1e-10)
+
 
 if __name__ == "__main__":
     unittest.main()
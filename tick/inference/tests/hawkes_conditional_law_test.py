@@ -6,6 +6,8 @@ import numpy as np
 from numpy.random import random, randint
 
 from tick.inference import HawkesConditionalLaw
+from tick.inference.build.inference import PointProcessCondLaw, \
+    PointProcessCondLaws
 from tick.inference.tests.inference import InferenceTest
 
 
@@ -91,6 +93,45 @@ class Test(InferenceTest):
                                              [[0.46108403, -0.09467477],
                                               [-0.04787463, -3.82917571]])
 
+    def test_point_process_cond_laws(self):
+        """...Test PointProcessCondLaws computes the same conditional laws as
+        PointProcessCondLaw for all pairs of components and mark intervals
+        """
+        T = 200.
+        # Times on a 0.01 grid, like lags, so that some jumps fall exactly on
+        # lag boundaries
+        times = [np.sort(np.round(random(n) * T, 2)) for n in [300, 400, 60]]
+        marks = [random(len(t)) for t in times]
+        # The first component is not marked
+        mark_bounds = [np.array([0., 0.]), np.array([-1., -0.2, 0.3, 1.]),
+                       np.array([-1., 0., 1.])]
+        n_rows = len(times) * sum(len(bounds) - 1 for bounds in mark_bounds)
+
+        # Many lags over a short support: few jumps in each window, which are
+        # binned one by one. Few lags over a long support: many jumps in each
+        # window, counted by moving forward a cursor per lag
+        for lags in [np.linspace(0, 2, 1001),
+                     np.array([0.05, 0.5, 1., 2., 4.])]:
+            claw_X = np.zeros(len(lags) - 1)
+            claw_Y = np.zeros((n_rows, len(lags) - 1))
+            PointProcessCondLaws(times, marks, mark_bounds, lags, T, claw_X,
+                                 claw_Y, 3)
+
+            row = 0
+            for i in range(len(times)):
+                for j in range(len(times)):
+                    for zmin, zmax in zip(mark_bounds[j][:-1],
+                                          mark_bounds[j][1:]):
+                        expected_X = np.zeros(len(lags) - 1)
+                        expected_Y = np.zeros(len(lags) - 1)
+                        PointProcessCondLaw(times[i], times[j], marks[j],
+                                            lags, zmin, zmax, T,
+                                            len(times[i]) / T, expected_X,
+                                            expected_Y)
+                        np.testing.assert_array_equal(claw_X, expected_X)
+                        np.testing.assert_array_equal(claw_Y[row], expected_Y)
+                        row += 1
+
     def test_incremental_fit(self):
         # This should not raise a warning
         self.model.incremental_fit(self.timestamps, compute=False)
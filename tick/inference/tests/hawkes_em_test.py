@@ -71,6 +71,127 @@ class Test(unittest.TestCase):
         np.testing.assert_array_equal(em.get_kernel_supports(),
                                       np.ones((self.n_nodes, self.n_nodes)) * 3)
 
+    def test_hawkes_em_cache_pairs(self):
+        """...Test that HawkesEM gives the same estimation when pairs of
+        events are cached
+        """
+        baseline = np.zeros(self.n_nodes) + .2
+        kernel = np.zeros((self.n_nodes, self.n_nodes, 3)) + .4
+
+        for kernel_discretization in [None, np.array([0., 0.5, 1.5, 3.])]:
+            em = HawkesEM(kernel_support=3, kernel_size=3,
+                          kernel_discretization=kernel_discretization,
+                          max_iter=10)
+            em.fit(self.events, baseline_start=baseline, kernel_start=kernel)
+
+            em_cache = HawkesEM(kernel_support=3, kernel_size=3,
+                                kernel_discretization=kernel_discretization,
+                                max_iter=10, n_threads=2, cache_pairs=True)
+            self.assertTrue(em_cache.cache_pairs)
+            em_cache.fit(self.events, baseline_start=baseline,
+                         kernel_start=kernel)
+            self.assertGreater(em_cache._learner.get_n_cached_pairs(), 0)
+
+            np.testing.assert_array_almost_equal(em_cache.baseline,
+                                                 em.baseline, decimal=10)
+            np.testing.assert_array_almost_equal(em_cache.kernel, em.kernel,
+                                                 decimal=10)
+
+    def test_hawkes_em_kernel_discretization_lookup(self):
+        """...Test that an explicit discretization, whose bins are found
+        with a lookup table, gives the same estimation as the equivalent
+        uniform discretization
+        """
+        baseline = np.zeros(self.n_nodes) + .2
+        kernel = np.zeros((self.n_nodes, self.n_nodes, 30)) + .04
+
+        em = HawkesEM(kernel_support=3, kernel_size=30, max_iter=10)
+        em.fit(self.events, baseline_start=baseline, kernel_start=kernel)
+
+        em_discretization = HawkesEM(
+            kernel_discretization=np.linspace(0, 3, 31), max_iter=10)
+        em_discretization.fit(self.events, baseline_start=baseline,
+                              kernel_start=kernel)
+
+        np.testing.assert_array_almost_equal(em_discretization.baseline,
+                                             em.baseline, decimal=10)
+        np.testing.assert_array_almost_equal(em_discretization.kernel,
+                                             em.kernel, decimal=10)
+
+    def test_hawkes_em_objective(self):
+        """...Test HawkesEM objective is the negative log-likelihood of its
+        piecewise constant kernels divided by the number of events
+        """
+        kernel_discretization = np.array([0., 0.5, 1.5, 3.])
+        kernel_dt = kernel_discretization[1:] - kernel_discretization[:-1]
+        em = HawkesEM(kernel_discretization=kernel_discretization,
+                      max_iter=3)
+        em.fit(self.events)
+
+        loglik = 0
+        for realization, end_time in zip(self.events, em.end_times):
+            for u in range(self.n_nodes):
+                loglik -= em.baseline[u] * end_time
+                for t_i in realization[u]:
+                    intensity = em.baseline[u]
+                    for v in range(self.n_nodes):
+                        t_diff = t_i - realization[v]
+                        t_diff = t_diff[(t_diff > 0) & (t_diff < 3)]
+                        bins = np.searchsorted(kernel_discretization,
+                                               t_diff) - 1
+                        intensity += em.kernel[u, v, bins].sum()
+                    loglik += np.log(intensity)
+
+                for v in range(self.n_nodes):
+                    for t_j in realization[v]:
+                        integrated_dt = np.clip(
+                            end_time - t_j - kernel_discretization[:-1], 0,
+                            kernel_dt)
+                        loglik -= em.kernel[u, v].dot(integrated_dt)
+
+        self.assertAlmostEqual(em.objective(em.coeffs), -loglik / em.n_jumps)
+
+    def test_hawkes_em_n_starts(self):
+        """...Test that HawkesEM keeps the start with the best objective when
+        it is run from several starts
+        """
+        baseline = np.zeros(self.n_nodes) + .2
+        kernel = np.zeros((self.n_nodes, self.n_nodes, 3)) + .4
+
+        em = HawkesEM(kernel_support=3, kernel_size=3, max_iter=20)
+        em.fit(self.events, baseline_start=baseline, kernel_start=kernel)
+
+        for cache_pairs in [False, True]:
+            em_starts = HawkesEM(kernel_support=3, kernel_size=3, max_iter=20,
+                                 n_threads=2, n_starts=5,
+                                 cache_pairs=cache_pairs)
+            em_starts.fit(self.events, baseline_start=baseline,
+                          kernel_start=kernel)
+            self.assertLessEqual(em_starts.objective(em_starts.coeffs),
+                                 em.objective(em.coeffs) + 1e-10)
+
+        with self.assertRaises(ValueError):
+            HawkesEM(kernel_support=3, n_starts=0)
+
+    def test_hawkes_em_refit_kernel_size(self):
+        """...Test that HawkesEM can be fitted again after its kernel size
+        has been increased
+        """
+        baseline = np.zeros(self.n_nodes) + .2
+        em = HawkesEM(kernel_support=3, kernel_size=3, max_iter=10)
+        em.fit(self.events, baseline_start=baseline,
+               kernel_start=np.zeros((self.n_nodes, self.n_nodes, 3)) + .4)
+
+        kernel_start = np.zeros((self.n_nodes, self.n_nodes, 8)) + .2
+        em.kernel_size = 8
+        em.fit(self.events, baseline_start=baseline, kernel_start=kernel_start)
+
+        fresh_em = HawkesEM(kernel_support=3, kernel_size=8, max_iter=10)
+        fresh_em.fit(self.events, baseline_start=baseline,
+                     kernel_start=kernel_start)
+        np.testing.assert_array_almost_equal(em.baseline, fresh_em.baseline)
+        np.testing.assert_array_almost_equal(em.kernel, fresh_em.kernel)
+
     def test_hawkes_em_kernel_support(self):
         """...Test that Hawkes em kernel support parameter is correctly
         synchronized
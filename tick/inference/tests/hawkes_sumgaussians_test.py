@@ -2,6 +2,7 @@
 
 import unittest
 import numpy as np
+from scipy.special import erf
 from tick.inference import HawkesSumGaussians
 
 
@@ -77,6 +78,76 @@ class Test(unittest.TestCase):
                                              means_gaussians)
         self.assertEqual(learner.std_gaussian, std_gaussian)
 
+    def test_hawkes_sumgaussians_pruned_weights(self):
+        """...Test that one EM iteration of HawkesSumGaussians, whose weights
+        skip pairs of events and gaussians that are out of support, matches a
+        brute force computation
+        """
+        n_gaussians = 4
+        strength_lasso, strength_grouplasso = 1e-2, 2e-2
+        # A negligible step makes the proximal step an identity
+        learner = HawkesSumGaussians(2., n_gaussians=n_gaussians,
+                                     step_size=1e-300, em_max_iter=1,
+                                     n_threads=2, verbose=False)
+        learner.strength_lasso = strength_lasso
+        learner.strength_grouplasso = strength_grouplasso
+        means = learner.means_gaussians
+        std = learner.std_gaussian
+
+        # Some lags and times to end fall exactly on the pruning thresholds
+        # of pairs, of gaussians and of kernel integrals
+        support = means[-1] + 9 * std
+        events = [
+            [np.array([1., 1. + support, 5., 6., 20. - means[2] - 9 * std]),
+             np.array([1. + means[-1] - 9 * std, 1. + means[0] + 9 * std, 5.,
+                       7.2, 11.])],
+            [np.array([0.5, 2., 2. + support, 13.]),
+             np.array([3., 4., 3. + support, 12.9])]
+        ]
+        end_times = np.array([20., 14.])
+        n_nodes = 2
+        baseline = np.array([0.3, 0.5])
+        amplitudes = 0.1 + 0.05 * np.arange(n_nodes * n_nodes * n_gaussians)
+        amplitudes = amplitudes.reshape(n_nodes, n_nodes, n_gaussians)
+
+        def gaussians(t):
+            return np.exp(-0.5 * ((t - means) / std) ** 2) / \
+                   (std * np.sqrt(2 * np.pi))
+
+        kernel_integrals = np.zeros((n_nodes, n_gaussians))
+        next_baseline = np.zeros(n_nodes)
+        next_C = np.zeros((n_nodes, n_nodes, n_gaussians))
+        for realization, end_time in zip(events, end_times):
+            for v in range(n_nodes):
+                for t_j in realization[v]:
+                    kernel_integrals[v] += \
+                        0.5 * erf((end_time - t_j - means) /
+                                  (std * np.sqrt(2))) + \
+                        0.5 * erf(means / (std * np.sqrt(2)))
+            for u in range(n_nodes):
+                for t_i in realization[u]:
+                    g = np.array([
+                        sum(gaussians(t_i - t_j)
+                            for t_j in realization[v] if t_j < t_i)
+                        for v in range(n_nodes)])
+                    norm = baseline[u] + np.sum(amplitudes[u] * g)
+                    next_baseline[u] += baseline[u] / norm
+                    next_C[u] += amplitudes[u] * g / norm
+
+        expected_baseline = next_baseline / end_times.sum()
+        A = strength_grouplasso / np.linalg.norm(amplitudes, axis=2)
+        B = kernel_integrals + strength_lasso
+        expected_amplitudes = \
+            (-B + np.sqrt(B ** 2 + 4 * A[:, :, np.newaxis] * next_C)) / \
+            (2 * A[:, :, np.newaxis])
+
+        learner._learner.set_data(events, end_times)
+        amplitudes_2d = amplitudes.reshape(n_nodes, n_nodes * n_gaussians)
+        learner._learner.solve(baseline, amplitudes_2d)
+        np.testing.assert_allclose(baseline, expected_baseline, rtol=1e-12)
+        np.testing.assert_allclose(amplitudes, expected_amplitudes,
+                                   rtol=1e-12)
+
     def test_hawkes_sumgaussians_set_data(self):
         """...Test set_data method of Hawkes SumGaussians
         """
@@ -11,7 +11,12 @@ from .coxreg_partial_lik import ModelCoxRegPartialLik
 
 from .hawkes_fixed_expkern_loglik import ModelHawkesFixedExpKernLogLik
 from .hawkes_fixed_expkern_leastsq import ModelHawkesFixedExpKernLeastSq
+from .hawkes_fixed_expkern_leastsq_online import \
+    ModelHawkesFixedExpKernLeastSqOnline
+from .hawkes_fixed_expkern_leastsq_binned import \
+    ModelHawkesFixedExpKernLeastSqBinned
 from .hawkes_fixed_sumexpkern_leastsq import ModelHawkesFixedSumExpKernLeastSq
+from .hawkes_fixed_sumexpkern_loglik import ModelHawkesFixedSumExpKernLogLik
 
 from .sccs import ModelSCCS
 
@@ -23,6 +28,9 @@ __all__ = ["ModelLinReg",
            "ModelCoxRegPartialLik",
            "ModelHawkesFixedExpKernLogLik",
            "ModelHawkesFixedExpKernLeastSq",
+           "ModelHawkesFixedExpKernLeastSqOnline",
+           "ModelHawkesFixedExpKernLeastSqBinned",
            "ModelHawkesFixedSumExpKernLeastSq",
+           "ModelHawkesFixedSumExpKernLogLik",
            "ModelSCCS"
            ]
@@ -14,6 +14,15 @@ class ModelCoxRegPartialLik(ModelFirstOrder):
     This class gives first order information (gradient and loss) for
     this model.
 
+    Parameters
+    ----------
+    n_threads : `int`, default=1
+        Number of threads used for parallel computation.
+
+        * if ``int <= 0``: the number of physical cores available on
+          the CPU
+        * otherwise the desired number of threads
+
     Attributes
     ----------
     features : `numpy.ndarray`, shape=(n_samples, n_features), (read-only)
@@ -67,11 +76,16 @@ class ModelCoxRegPartialLik(ModelFirstOrder):
         },
         "censoring_rate": {
             "writable": False
+        },
+        "n_threads": {
+            "writable": True,
+            "cpp_setter": "set_n_threads"
         }
     }
 
-    def __init__(self):
+    def __init__(self, n_threads: int = 1):
         ModelFirstOrder.__init__(self)
+        self.n_threads = n_threads
         self.features = None
         self.times = None
         self.censoring = None
@@ -126,7 +140,8 @@ class ModelCoxRegPartialLik(ModelFirstOrder):
         self._set("n_features", n_features)
         self._set("_model", _ModelCoxRegPartialLik(self.features,
                                                    self.times,
-                                                   self.censoring))
+                                                   self.censoring,
+                                                   self.n_threads))
 
     def _grad(self, coeffs: np.ndarray, out: np.ndarray) -> None:
         self._model.grad(coeffs, out)
@@ -134,6 +149,9 @@ class ModelCoxRegPartialLik(ModelFirstOrder):
     def _loss(self, coeffs: np.ndarray) -> float:
         return self._model.loss(coeffs)
 
+    def _loss_and_grad(self, coeffs: np.ndarray, out: np.ndarray) -> float:
+        return self._model.loss_and_grad(coeffs, out)
+
     def _get_n_coeffs(self, *args, **kwargs):
         return self.n_features
 
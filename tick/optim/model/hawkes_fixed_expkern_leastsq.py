@@ -149,6 +149,36 @@ class ModelHawkesFixedExpKernLeastSq(ModelHawkes):
             decays_matrix = np.zeros((self.n_nodes, self.n_nodes)) + decays
             self._model.set_decays(decays_matrix)
 
+    def compute_weights_for_decays(self, decays):
+        """Precompute weights for several decays in a single pass over the
+        data, each decay being shared by all kernels. Afterwards, setting
+        `decays` to one of these values does not trigger any computation,
+        which speeds up the search of the best decay over a grid.
+
+        Parameters
+        ----------
+        decays : `np.ndarray`, shape=(n_decays, )
+            Decays for which weights are precomputed
+
+        Notes
+        -----
+        This requires data given through `fit`. Exponentials are computed
+        exactly, whatever `approx` is.
+        """
+        if not self._fitted:
+            raise ValueError("call ``fit`` before using "
+                             "``compute_weights_for_decays``")
+        self._model.compute_weights_for_decays(
+            np.array(decays, dtype=float))
+        return self
+
+    @property
+    def cached_decays(self):
+        """Decays for which weights have been precomputed with
+        `compute_weights_for_decays`
+        """
+        return self._model.get_cached_decays()
+
     def hessian(self, x):
         """Return model's hessian
 
@@ -0,0 +1,96 @@
+# License: BSD 3 clause
+
+import numpy as np
+
+from .hawkes_fixed_expkern_leastsq import ModelHawkesFixedExpKernLeastSq
+from .build.model import ModelHawkesFixedExpKernLeastSqBinned as \
+    _ModelHawkesFixedExpKernLeastSqBinned
+
+
+class ModelHawkesFixedExpKernLeastSqBinned(ModelHawkesFixedExpKernLeastSq):
+    """Hawkes process model exponential kernels with fixed and given decays,
+    whose least square loss is approximated from the number of events of
+    each node on a uniform grid.
+
+    It approximates the loss of `ModelHawkesFixedExpKernLeastSq`:
+
+    .. math::
+        \\sum_{i=1}^{D} \\left(
+            \\int_0^T \\lambda_i(t)^2 dt
+            - 2 \\int_0^T \\lambda_i(t) dN_i(t)
+        \\right)
+
+    where :math:`\\lambda_i` is the intensity:
+
+    .. math::
+        \\forall i \\in [1 \\dots D], \\quad
+        \\lambda_i(t) = \\mu_i + \\sum_{j=1}^D
+        \\sum_{t_k^j < t} \\phi_{ij}(t - t_k^j)
+
+    and with an exponential parametrisation of the kernels
+
+    .. math::
+        \phi_{ij}(t) = \\alpha^{ij} \\beta^{ij}
+                       \exp (- \\beta^{ij} t) 1_{t > 0}
+
+    Each realization is divided in bins of equal size, no larger than
+    `bin_size`, and only the number of events of each node in each bin is
+    kept. Events are considered as uniformly distributed in their bin, the
+    weights of the loss are then computed with recursive filters over the
+    bins, whose cost does not depend on the number of events. This trades a
+    bias, that vanishes as `bin_size` goes to 0, for much less computations
+    when there are many events per bin.
+
+    Parameters
+    ----------
+    decays : `float` or `numpy.ndarray`, shape=(n_nodes, n_nodes)
+        Either a `float` giving the decay of all exponential kernels or
+        a (n_nodes, n_nodes) `numpy.ndarray` giving the decays of
+        the exponential kernels for all pairs of nodes.
+
+    bin_size : `float`
+        Maximum size of the bins in which each realization is divided
+
+    n_threads : `int`, default=1
+        Number of threads used for parallel computation.
+
+        * if ``int <= 0``: the number of physical cores available on
+          the CPU
+        * otherwise the desired number of threads
+
+    Attributes
+    ----------
+    n_nodes : `int` (read-only)
+        Number of components, or dimension of the Hawkes model
+
+    data : `list` of `numpy.array` (read-only)
+        The events given to the model through `fit` method.
+        Note that data given through `incremental_fit` is not stored
+    """
+
+    _attrinfos = {
+        "bin_size": {
+            "writable": False
+        },
+    }
+
+    def __init__(self, decays: np.ndarray, bin_size: float,
+                 n_threads: int = 1):
+        ModelHawkesFixedExpKernLeastSq.__init__(self, decays,
+                                                n_threads=n_threads)
+        self.bin_size = bin_size
+        if isinstance(decays, (int, float)):
+            decays = np.array([[decays]], dtype=float)
+        elif isinstance(decays, list):
+            decays = np.array(decays)
+        elif decays.dtype != float:
+            decays = decays.astype(float)
+        self._model = _ModelHawkesFixedExpKernLeastSqBinned(
+            decays.copy(), bin_size, self.n_threads)
+
+    def compute_weights_for_decays(self, decays):
+        """Not available for this model: weights computed from the bins are
+        cheap to compute again for a new decay
+        """
+        raise NotImplementedError("ModelHawkesFixedExpKernLeastSqBinned does "
+                                  "not precompute weights for several decays")
@@ -0,0 +1,160 @@
+# License: BSD 3 clause
+
+import numpy as np
+
+from tick.optim.model.base import ModelHawkes, LOSS_AND_GRAD
+from .build.model import ModelHawkesFixedExpKernLeastSqOnline as \
+    _ModelHawkesFixedExpKernLeastSqOnline
+
+
+class ModelHawkesFixedExpKernLeastSqOnline(ModelHawkes):
+    """Hawkes process model exponential kernels with fixed and given decay,
+    whose events are appended while the process is being observed.
+    It is modeled with least square loss:
+
+    .. math::
+        \\sum_{i=1}^{D} \\left(
+            \\int_{T-W}^T \\lambda_i(t)^2 dt
+            - 2 \\int_{T-W}^T \\lambda_i(t) dN_i(t)
+        \\right)
+
+    where :math:`\\lambda_i` is the intensity:
+
+    .. math::
+        \\forall i \\in [1 \\dots D], \\quad
+        \\lambda_i(t) = \\mu_i + \\sum_{j=1}^D
+        \\sum_{t_k^j < t} \\phi_{ij}(t - t_k^j)
+
+    where
+
+    * :math:`D` is the number of nodes
+    * :math:`\mu_i` are the baseline intensities
+    * :math:`\phi_{ij}` are the kernels
+    * :math:`t_k^j` are the timestamps of all events of node :math:`j`
+    * :math:`T` is the current end time of the observation
+    * :math:`W` is the length of the window, :math:`T - W` being replaced
+      by 0 if no window is used
+
+    and with an exponential parametrisation of the kernels
+
+    .. math::
+        \phi_{ij}(t) = \\alpha^{ij} \\beta
+                       \exp (- \\beta t) 1_{t > 0}
+
+    The model keeps running sums of the events, updated in
+    :math:`O(D)` per appended event, from which the weights of the loss are
+    derived. Hence appending new events with `append` does not require to
+    go over past events again.
+
+    Parameters
+    ----------
+    decay : `float`
+        The decay coefficient of the exponential kernels.
+        All kernels share this decay.
+
+    window_length : `float`, default=0
+        If positive, only the events of the last `window_length` units of
+        time are accounted for in the loss, the intensity still depending on
+        all past events. Otherwise all events since time 0 are used.
+
+    n_threads : `int`, default=1
+        Number of threads used for parallel computation.
+
+        * if ``int <= 0``: the number of physical cores available on
+          the CPU
+        * otherwise the desired number of threads
+
+    Attributes
+    ----------
+    n_nodes : `int` (read-only)
+        Number of components, or dimension of the Hawkes model
+
+    end_time : `float` (read-only)
+        Current end time of the observation
+
+    data : `list` of `numpy.array` (read-only)
+        The events given to the model through `fit` method.
+        Note that data given through `append` is not stored
+    """
+    # In Hawkes case, getting value and grad at the same time need only
+    # one pas over the data
+    pass_per_operation = \
+        {k: v for d in [ModelHawkes.pass_per_operation,
+                        {LOSS_AND_GRAD: 2}] for k, v in d.items()}
+
+    _attrinfos = {
+        "decay": {
+            "writable": False
+        },
+        "window_length": {
+            "writable": False
+        },
+    }
+
+    def __init__(self, decay: float, window_length: float = 0.,
+                 n_threads: int = 1):
+        ModelHawkes.__init__(self, approx=0, n_threads=n_threads)
+        self.decay = decay
+        self.window_length = window_length
+        self._model = _ModelHawkesFixedExpKernLeastSqOnline(
+            decay, window_length, self.n_threads)
+
+    def _set_data(self, events: list):
+        """Set the events observed so far.
+
+        Parameters
+        ----------
+        events : `list` of `np.ndarray`
+            The events of each component of the realization. Namely
+            `events[j]` contains a one-dimensional `np.ndarray` of
+            the events' timestamps of component j
+        """
+        self._set("data", events)
+        if not isinstance(events[0], np.ndarray):
+            raise ValueError("ModelHawkesFixedExpKernLeastSqOnline handles "
+                             "a single realization")
+
+        end_time = self._end_times
+        if end_time is None:
+            end_time = max(map(max, events))
+
+        self._model.set_data(events, float(end_time))
+
+    def append(self, events, end_time=None):
+        """Append newly observed events to the realization.
+
+        Parameters
+        ----------
+        events : `list` of `np.ndarray`
+            The new events of each component. Namely `events[j]` contains a
+            one-dimensional `np.ndarray` of the new timestamps of
+            component j, that must not be earlier than the current
+            `end_time`
+
+        end_time : `float`, default=None
+            New end time of the observation.
+            If None, it will be set to the latest appended time.
+        """
+        if end_time is None:
+            end_time = max(max(e) for e in events if len(e) > 0)
+
+        self._model.append(events, float(end_time))
+
+        self._set("_fitted", True)
+        return self
+
+    @property
+    def end_time(self):
+        return self._model.get_end_time()
+
+    @property
+    def _epoch_size(self):
+        # This gives the typical size of an epoch when using a
+        # stochastic optimization algorithm
+        return self.n_nodes
+
+    @property
+    def _rand_max(self):
+        # This allows to obtain the range of the random sampling when
+        # using a stochastic optimization algorithm
+        return self.n_nodes
@@ -59,6 +59,15 @@ class ModelHawkesFixedExpKernLogLik(ModelHawkes,
           the CPU
         * otherwise the desired number of threads
 
+    weights_threshold : `float`, default=0
+        Trades accuracy for memory. The model stores, for each event, the
+        decayed influence of all nodes, that is `n_jumps * n_nodes` weights.
+        If positive, influences below this threshold are not stored, which
+        underestimates each intensity by at most
+        `weights_threshold * sum_j adjacency[i, j]`. This is useful when
+        nodes are many and their events rarely overlap within a few
+        `1 / decay`. If 0, all weights are stored in dense arrays.
+
     Attributes
     ----------
     n_nodes : `int` (read-only)
@@ -78,14 +87,19 @@ class ModelHawkesFixedExpKernLogLik(ModelHawkes,
         "decay": {
             "cpp_setter": "set_decay"
         },
+        "weights_threshold": {
+            "cpp_setter": "set_weights_threshold"
+        },
     }
 
-    def __init__(self, decay: float, n_threads: int = 1):
+    def __init__(self, decay: float, n_threads: int = 1,
+                 weights_threshold: float = 0.):
         ModelHawkes.__init__(self, n_threads=1, approx=0)
         ModelSecondOrder.__init__(self)
         ModelSelfConcordant.__init__(self)
         self.decay = decay
         self._model = _ModelHawkesFixedExpKernLogLik(decay, n_threads)
+        self.weights_threshold = weights_threshold
 
     def fit(self, events, end_times=None):
         """Set the corresponding realization(s) of the process.
@@ -120,10 +134,72 @@ class ModelHawkesFixedExpKernLogLik(ModelHawkes,
     def _get_sc_constant(self) -> float:
         return 2.0
 
+    def hessian_vector_product(self, coeffs: np.ndarray,
+                               vector: np.ndarray) -> np.ndarray:
+        """Computes the product of the hessian of the model computed at
+        ``coeffs`` with ``vector``, without forming the hessian
+
+        Parameters
+        ----------
+        coeffs : `numpy.ndarray`, shape=(n_coeffs,)
+            Vector where the hessian is computed
+
+        vector : `numpy.ndarray`, shape=(n_coeffs,)
+            Vector multiplied by the hessian
+
+        Returns
+        -------
+        output : `numpy.ndarray`, shape=(n_coeffs,)
+            Product of the hessian with ``vector``
+        """
+        if not self._fitted:
+            raise ValueError("call ``fit`` before using "
+                             "``hessian_vector_product``")
+        out = np.empty(self.n_coeffs)
+        self._model.hessian_vector_product(coeffs, vector, out)
+        return out
+
+    def compute_weights_for_decays(self, decays):
+        """Precompute weights for several decays in a single pass over the
+        data. Afterwards, setting `decay` to one of these values does not
+        trigger any computation, which speeds up the search of the best decay
+        over a grid.
+
+        Parameters
+        ----------
+        decays : `np.ndarray`, shape=(n_decays, )
+            Decays for which weights are precomputed
+
+        Notes
+        -----
+        Weights of all decays are kept in memory, this requires `n_decays`
+        times the memory needed for a single decay. It is available only if
+        `weights_threshold` is 0.
+        """
+        if not self._fitted:
+            raise ValueError("call ``fit`` before using "
+                             "``compute_weights_for_decays``")
+        self._model.compute_weights_for_decays(
+            np.array(decays, dtype=float))
+        return self
+
     @property
     def decays(self):
         return self.decay
 
+    @property
+    def cached_decays(self):
+        """Decays for which weights have been precomputed with
+        `compute_weights_for_decays`
+        """
+        return self._model.get_cached_decays()
+
+    @property
+    def n_stored_weights(self):
+        """Number of weights currently stored by the model
+        """
+        return self._model.get_n_stored_weights()
+
     @property
     def _epoch_size(self):
         # This gives the typical size of an epoch when using a
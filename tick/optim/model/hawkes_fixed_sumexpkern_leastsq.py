@@ -61,6 +61,12 @@ class ModelHawkesFixedSumExpKernLeastSq(ModelHawkes):
         In piecewise constant setting this denotes the period of the 
         piecewise constant baseline function.
 
+    float_weights : `bool`, default=False
+        If `True`, the largest precomputed weights, whose size grows as
+        :math:`(D U)^2`, are stored in single precision. This halves their
+        memory footprint at the cost of a relative precision of order 1e-7
+        on loss and gradient
+
     approx : `int`, default=0 (read-only)
         Level of approximation used for computing exponential functions
 
@@ -104,10 +110,15 @@ class ModelHawkesFixedSumExpKernLeastSq(ModelHawkes):
         "_period_length": {
             "writable": False,
         },
+        "float_weights": {
+            "writable": True,
+            "cpp_setter": "set_float_weights"
+        },
     }
 
     def __init__(self, decays: np.ndarray, n_baselines=1, period_length=None,
-                 approx: int = 0, n_threads: int = 1):
+                 approx: int = 0, n_threads: int = 1,
+                 float_weights: bool = False):
         ModelHawkes.__init__(self, approx=approx, n_threads=n_threads)
         self._end_times = None
 
@@ -126,10 +137,11 @@ class ModelHawkesFixedSumExpKernLeastSq(ModelHawkes):
         self.decays = decays.copy()
         self.n_baselines = n_baselines
         self.period_length = period_length
+        self.float_weights = float_weights
 
         self._model = _ModelHawkesFixedSumExpKernLeastSqList(
             self.decays, self.n_baselines, self.cast_period_length(),
-            self.n_threads, self.approx
+            self.n_threads, self.approx, self.float_weights
         )
 
     @property
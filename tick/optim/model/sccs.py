@@ -21,6 +21,21 @@ class ModelSCCS(ModelFirstOrder, ModelLipschitz):
         values of the features over the `n_lags` time intervals. `n_lags`
         must be between 0 and `n_intervals` - 1
 
+    n_threads : `int`, default=1
+        Number of threads used for parallel computation over patients.
+
+        * if ``int <= 0``: the number of physical cores available on
+          the CPU
+        * otherwise the desired number of threads
+
+    implicit_lags : `bool`, default=False
+        If `True`, the features given to ``fit`` are the raw exposures of
+        shape (n_intervals, n_features), and the lagged features are
+        computed on the fly by the model instead of being produced by
+        `LongitudinalFeaturesLagger`, which divides memory usage by
+        ``n_lags + 1``. Coefficients are ordered as the columns of
+        `LongitudinalFeaturesLagger` outputs.
+
     Attributes
     ----------
     features : `list` of `numpy.ndarray` or `list` of `scipy.sparse.csr_matrix`,
@@ -72,10 +87,18 @@ class ModelSCCS(ModelFirstOrder, ModelLipschitz):
         },
         "n_intervals": {
             "writable": False
+        },
+        "n_threads": {
+            "writable": True,
+            "cpp_setter": "set_n_threads"
+        },
+        "implicit_lags": {
+            "writable": False
         }
     }
 
-    def __init__(self, n_intervals: int, n_lags: int):
+    def __init__(self, n_intervals: int, n_lags: int, n_threads: int = 1,
+                 implicit_lags: bool = False):
         if n_lags >= n_intervals:
             raise ValueError("n_lags should be < n_intervals")
 
@@ -83,6 +106,8 @@ class ModelSCCS(ModelFirstOrder, ModelLipschitz):
         ModelLipschitz.__init__(self)
         self.n_lags = n_lags
         self.n_intervals = n_intervals
+        self.n_threads = n_threads
+        self.implicit_lags = implicit_lags
         self.labels = None
         self.features = None
         self.censoring = None
@@ -116,7 +141,9 @@ class ModelSCCS(ModelFirstOrder, ModelLipschitz):
                   _ModelSCCS(features=self.features,
                              labels=self.labels,
                              censoring=self.censoring,
-                             n_lags=self.n_lags))
+                             n_lags=self.n_lags,
+                             n_threads=self.n_threads,
+                             implicit_lags=self.implicit_lags))
 
         return self
 
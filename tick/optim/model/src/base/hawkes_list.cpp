@@ -1,7 +1,6 @@
 // License: BSD 3 clause
 
 #include "hawkes_list.h"
-#include "hawkes_utils.h"
 
 ModelHawkesList::ModelHawkesList(
     const int max_n_threads,
@@ -22,9 +21,22 @@ void ModelHawkesList::set_data(const SArrayDoublePtrList2D &timestamps_list,
   this->timestamps_list = timestamps_list;
   this->end_times = end_times;
 
+  event_streams.clear();
+
   weights_computed = false;
 }
 
+void ModelHawkesList::build_event_streams() {
+  if (event_streams.size() == n_realizations) return;
+  event_streams = std::vector<HawkesEventStream>(n_realizations);
+  parallel_run(std::min(max_n_threads, static_cast<unsigned int>(n_realizations)),
+               n_realizations, &ModelHawkesList::build_event_stream, this);
+}
+
+void ModelHawkesList::build_event_stream(const ulong r) {
+  event_streams[r] = HawkesEventStream(timestamps_list[r]);
+}
+
 unsigned int ModelHawkesList::get_n_threads() const {
   return std::min(this->max_n_threads, static_cast<unsigned int>(n_nodes * n_realizations));
 }
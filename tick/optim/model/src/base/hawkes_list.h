@@ -7,6 +7,7 @@
 #include "base.h"
 #include "hawkes_model.h"
 #include "hawkes_single.h"
+#include "hawkes_utils.h"
 
 /** \class ModelHawkesList
  * \brief Base class of Hawkes models handling several realizations
@@ -25,6 +26,10 @@ class DLL_PUBLIC ModelHawkesList : public ModelHawkes {
   //! @brief Number of jumps of the process per realization (size=n_realizations)
   VArrayULongPtr n_jumps_per_realization;
 
+  //! @brief Events of each realization merged in a single stream sorted by time, empty until
+  //! build_event_streams is called
+  std::vector<HawkesEventStream> event_streams;
+
  public:
   //! @brief Constructor
   //! \param max_n_threads : number of cores to be used for multithreading. If negative,
@@ -45,6 +50,14 @@ class DLL_PUBLIC ModelHawkesList : public ModelHawkes {
   }
 
   virtual unsigned int get_n_threads() const;
+
+ protected:
+  //! @brief Build event_streams, if not done since the last call to set_data. It is only
+  //! called by the models that visit events of all nodes in time order
+  void build_event_streams();
+
+ private:
+  void build_event_stream(const ulong r);
 };
 
 #endif  // TICK_OPTIM_MODEL_SRC_BASE_HAWKES_LIST_H_
@@ -13,7 +13,9 @@
 
 ModelCoxRegPartialLik::ModelCoxRegPartialLik(const SBaseArrayDouble2dPtr features,
                                              const SArrayDoublePtr times_,
-                                             const SArrayUShortPtr censoring_) {
+                                             const SArrayUShortPtr censoring_,
+                                             const int n_threads)
+    : n_threads(n_threads >= 1 ? n_threads : std::thread::hardware_concurrency()) {
     n_samples = features->n_rows();
     n_features = features->n_cols();
     n_failures = 0;
@@ -27,8 +29,7 @@ ModelCoxRegPartialLik::ModelCoxRegPartialLik(const SBaseArrayDouble2dPtr feature
     // Will contain inner products for loss and gradient computations
     inner_prods = ArrayDouble(n_samples);
     // Used for gradient computations
-    s1 = ArrayDouble(n_features);
-
+    risk_set_weights = ArrayDouble(n_samples);
     // Get the indices that sort the times by decreasing order in idx
     idx = ArrayULong(n_samples);
     times.sort(idx, false);
@@ -61,20 +62,35 @@ ModelCoxRegPartialLik::ModelCoxRegPartialLik(const SBaseArrayDouble2dPtr feature
             i_failure++;
         }
     }
+
+    // Used for gradient computations
+    inv_risk_set_sums = ArrayDouble(static_cast<ulong>(n_failures));
+}
+
+void ModelCoxRegPartialLik::compute_inner_prod_i(const ulong i, const ArrayDouble &coeffs) {
+    inner_prods[i] = get_feature(i).dot(coeffs);
+}
+
+double ModelCoxRegPartialLik::compute_inner_prods(const ArrayDouble &coeffs) {
+    parallel_run(n_threads, n_samples, &ModelCoxRegPartialLik::compute_inner_prod_i,
+                 this, coeffs);
+    // Maximal inner product is kept to avoid overflows
+    return inner_prods.max();
+}
+
+void ModelCoxRegPartialLik::inc_grad_i(const ulong i, ArrayDouble &out) {
+    const double weight = risk_set_weights[i];
+    if (weight != 0) {
+        out.mult_incr(get_feature(i), weight);
+    }
 }
 
 
 double ModelCoxRegPartialLik::loss(const ArrayDouble &coeffs) {
     const ulong n_failures_minus_one = n_failures - 1;
     // Compute all the inner products and maintain the maximal one
-    double max_inner_prod = -DBL_MAX;
-    for (ulong i = 0; i < n_samples; ++i) {
-        const double inner_prod = get_feature(i).dot(coeffs);
-        inner_prods[i] = inner_prod;
-        if (inner_prod > max_inner_prod) {
-            max_inner_prod = inner_prod;
-        }
-    }
+    const double max_inner_prod = compute_inner_prods(coeffs);
+
     double log_lik = 0;
     double s = DBL_MIN;
     const ulong idx0 = get_idx_failure(0);
@@ -99,57 +115,63 @@ double ModelCoxRegPartialLik::loss(const ArrayDouble &coeffs) {
 }
 
 void ModelCoxRegPartialLik::grad(const ArrayDouble &coeffs, ArrayDouble &out) {
-    const ulong n_failures_minus_one = n_failures - 1;
-    // grad must be filled with 0
-    out.init_to_zero();
-    s1.init_to_zero();
-    inner_prods.init_to_zero();
+    loss_and_grad(coeffs, out);
+}
 
+double ModelCoxRegPartialLik::loss_and_grad(const ArrayDouble &coeffs, ArrayDouble &out) {
+    // Compute first all inner products and keep the maximum
+    // (to avoid overflow)
+    const double max_inner_prod = compute_inner_prods(coeffs);
+
+    // Forward pass over samples sorted by decreasing times: the risk set of the k-th failure
+    // contains all samples up to get_idx_failure(k)
     // Initialize s to a very small positive number (to avoid division by
     // 0 in weird cases)
     double s2 = DBL_MIN;
-
-    // Compute first all inner products and keep the maximum
-    // (to avoid overflow)
-    double max_inner_prod = -DBL_MAX;
-    for (ulong i = 0; i < n_samples; ++i) {
-        const double inner_prod = get_feature(i).dot(coeffs);
-        inner_prods[i] = inner_prod;
-        if (inner_prod > max_inner_prod) {
-            max_inner_prod = inner_prod;
+    double log_lik = 0;
+    ulong i = 0;
+    for (ulong k = 0; k < n_failures; ++k) {
+        const ulong idx = get_idx_failure(k);
+        for (; i <= idx; ++i) {
+            const double diff = inner_prods[i] - max_inner_prod;
+            const double exp_diff = diff > DBL_MIN_EXP ? exp(diff) : 0;
+            risk_set_weights[i] = exp_diff;
+            s2 += exp_diff;
         }
+        log_lik += log(s2) - inner_prods[idx] + max_inner_prod;
+        inv_risk_set_sums[k] = 1 / s2;
     }
 
-    const ulong idx0 = get_idx_failure(0);
-    for (ulong i = 0; i <= idx0; ++i) {
-        const double diff = inner_prods[i] - max_inner_prod;
-        const double exp_diff = exp(diff);
-        if (diff > DBL_MIN_EXP) {
-            const BaseArrayDouble x_i = get_feature(i);
-            s1.mult_incr(x_i, exp_diff);
-            s2 += exp_diff;
+    // Backward pass: sample i belongs to the risk sets of all failures k such that
+    // get_idx_failure(k) >= i, hence its weight in the gradient is
+    // exp(x_i^T w) * sum_{k, idx_k >= i} 1 / s_k, minus one if it is a failure
+    double sum_inv_s = 0;
+    ulong k = n_failures;
+    for (i = n_samples; i-- > 0;) {
+        bool is_failure = false;
+        if (k > 0 && get_idx_failure(k - 1) == i) {
+            k--;
+            sum_inv_s += inv_risk_set_sums[k];
+            is_failure = true;
+        }
+        if (sum_inv_s == 0) {
+            // Samples after the last failure are in no risk set
+            risk_set_weights[i] = 0;
+        } else {
+            risk_set_weights[i] *= sum_inv_s;
+            if (is_failure) risk_set_weights[i] -= 1;
         }
     }
 
-    for (ulong k = 0; k < n_failures; ++k) {
-        const ulong idx = get_idx_failure(k);
-        const BaseArrayDouble x_idx = get_feature(idx);
+    // grad must be filled with 0
+    out.init_to_zero();
+    parallel_map_array<ArrayDouble>(n_threads,
+                                    n_samples,
+                                    [](ArrayDouble &r, const ArrayDouble &s) { r.mult_incr(s, 1.0); },
+                                    &ModelCoxRegPartialLik::inc_grad_i,
+                                    this,
+                                    out);
+    out /= n_failures;
 
-        out.mult_add_mult_incr(s1, 1 / s2, x_idx, -1);
-        if (k != n_failures_minus_one) {
-            const ulong idx_next = get_idx_failure(k+1) + 1;
-            for (ulong i = idx + 1; i < idx_next; ++i) {
-                const BaseArrayDouble x_i = get_feature(i);
-                double diff = inner_prods[i] - max_inner_prod;
-                if (diff > DBL_MIN_EXP) {
-                    const double exp_diff = exp(diff);
-                    s1.mult_incr(x_i, exp_diff);
-                    s2 += exp_diff;
-                }
-            }
-        }
-    }
-    for (ulong j = 0; j < n_features; ++j) {
-        out[j] /= n_failures;
-    }
+    return log_lik / n_failures;
 }
@@ -12,9 +12,12 @@
 class DLL_PUBLIC ModelCoxRegPartialLik : public Model {
  private:
     ArrayDouble inner_prods;
-    ArrayDouble s1;
+    ArrayDouble risk_set_weights;
+    ArrayDouble inv_risk_set_sums;
     ArrayULong idx;
 
+    unsigned int n_threads;
+
  protected:
     ulong n_samples, n_features, n_failures;
 
@@ -39,10 +42,30 @@ class DLL_PUBLIC ModelCoxRegPartialLik : public Model {
         return idx_failures[i];
     }
 
+    /**
+     * \brief Stores the inner product between sample i and coeffs in inner_prods
+     * \note For two different values of i, this function will modify different coordinates of
+     * inner_prods. Hence, it is thread safe.
+     */
+    void compute_inner_prod_i(const ulong i, const ArrayDouble &coeffs);
+
+    /**
+     * \brief Computes all inner products (in parallel) and returns the maximal one
+     */
+    double compute_inner_prods(const ArrayDouble &coeffs);
+
+    /**
+     * \brief Increments out with the contribution of sample i to the gradient, namely
+     * risk_set_weights[i] * x_i. Only the non-zero entries of x_i are visited.
+     * \note out is the first argument (after i) as this is necessary for parallel_map_array
+     */
+    void inc_grad_i(const ulong i, ArrayDouble &out);
+
  public:
     ModelCoxRegPartialLik(const SBaseArrayDouble2dPtr features,
                           const SArrayDoublePtr times,
-                          const SArrayUShortPtr censoring);
+                          const SArrayUShortPtr censoring,
+                          const int n_threads = 1);
 
     const char *get_class_name() const override {
         return "ModelCoxRegPartialLik";
@@ -64,6 +87,32 @@ class DLL_PUBLIC ModelCoxRegPartialLik : public Model {
     double loss(const ArrayDouble &coeffs) override;
 
     void grad(const ArrayDouble &coeffs, ArrayDouble &out) override;
+
+    /**
+     * \brief Computation of the value and of the gradient of minus the partial Cox
+     * log-likelihood at point coeffs, sharing the inner products and the risk set sums.
+     *
+     * \note
+     * Since the risk sets are nested, the gradient
+     * \f$ \sum_k ( \sum_{i \in R_k} e^{x_i^T w} x_i ) / ( \sum_{i \in R_k} e^{x_i^T w} )
+     * - x_{(k)} \f$
+     * is rewritten as \f$ \sum_i c_i x_i \f$ where \f$ c_i \f$ only depends on the inner
+     * products. This avoids to maintain a dense running sum of features, hence each sample only
+     * touches its non-zero entries, and the final accumulation is done in parallel.
+     *
+     * \param coeffs : The vector at which the loss and gradient are computed
+     * \param out : Array in which the value of the gradient is stored
+     * \return The value of the loss
+    */
+    double loss_and_grad(const ArrayDouble &coeffs, ArrayDouble &out);
+
+    unsigned int get_n_threads() const {
+        return n_threads;
+    }
+
+    void set_n_threads(unsigned int n_threads) {
+        this->n_threads = n_threads;
+    }
 };
 
 
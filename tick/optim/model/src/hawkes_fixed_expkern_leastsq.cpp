@@ -168,9 +168,26 @@ void ModelHawkesFixedExpKernLeastSq::allocate_weights() {
   E.init_to_zero();
 }
 
+void ModelHawkesFixedExpKernLeastSq::set_data(const SArrayDoublePtrList1D &timestamps,
+                                              const double end_time) {
+  ModelHawkesSingle::set_data(timestamps, end_time);
+  cached_decays = ArrayDouble(0);
+  cached_E.clear();
+  cached_Dg.clear();
+  cached_Dg2.clear();
+  cached_C.clear();
+}
+
+void ModelHawkesFixedExpKernLeastSq::set_decays(const SArrayDouble2dPtr decays) {
+  this->decays = decays;
+  weights_computed = false;
+  load_cached_weights();
+}
+
 // Full initialization of the arrays H, Dg, Dg2 and C
 // Must be performed just once
 void ModelHawkesFixedExpKernLeastSq::compute_weights() {
+  if (load_cached_weights()) return;
   allocate_weights();
   parallel_run(get_n_threads(), n_nodes, &ModelHawkesFixedExpKernLeastSq::compute_weights_i, this);
   weights_computed = true;
@@ -235,6 +252,123 @@ void ModelHawkesFixedExpKernLeastSq::compute_weights_i(const ulong i) {
   }
 }
 
+void ModelHawkesFixedExpKernLeastSq::compute_weights_for_decays(const ArrayDouble &decays) {
+  if (n_nodes == 0) {
+    TICK_ERROR("Please provide valid timestamps before allocating weights")
+  }
+  for (ulong d = 0; d < decays.size(); d++) {
+    if (decays[d] <= 0) TICK_ERROR("decays must be positive, got " << decays[d]);
+  }
+
+  cached_decays = decays;
+  const auto zeros = [this](const ulong n_cols) {
+    ArrayDouble2d array(n_nodes, n_cols);
+    array.init_to_zero();
+    return array;
+  };
+  cached_E = std::vector<ArrayDouble2d>(decays.size(), zeros(n_nodes * n_nodes));
+  cached_Dg = std::vector<ArrayDouble2d>(decays.size(), zeros(n_nodes));
+  cached_Dg2 = std::vector<ArrayDouble2d>(decays.size(), zeros(n_nodes));
+  cached_C = std::vector<ArrayDouble2d>(decays.size(), zeros(n_nodes));
+
+  parallel_run(get_n_threads(), n_nodes,
+               &ModelHawkesFixedExpKernLeastSq::compute_weights_i_for_decays, this,
+               cached_decays, cached_E, cached_Dg, cached_Dg2, cached_C);
+
+  load_cached_weights();
+}
+
+// Same computations as compute_weights_i when all decays are equal: H(j1, j) then does not
+// depend on j1 and E(j1, i, j) does not depend on j1 either
+void ModelHawkesFixedExpKernLeastSq::compute_weights_i_for_decays(
+    const ulong i, const ArrayDouble &decays,
+    std::vector<ArrayDouble2d> &E_list, std::vector<ArrayDouble2d> &Dg_list,
+    std::vector<ArrayDouble2d> &Dg2_list, std::vector<ArrayDouble2d> &C_list) const {
+  const ArrayDouble &t_i = *timestamps[i];
+  const ulong N_i_size = t_i.size();
+  const ulong n_decays = decays.size();
+  const double *betas = decays.data();
+
+  // Values for all decays are stored contiguously so that the loops over decays vectorize
+  std::vector<double> ebt(n_decays), H_j(n_decays), E_i_j(n_decays), C_i_j(n_decays),
+      Dg_i_j(n_decays), Dg2_i_j(n_decays);
+
+  for (ulong j = 0; j < n_nodes; j++) {
+    const ArrayDouble &t_j = *timestamps[j];
+    const ulong N_j_size = t_j.size();
+    for (auto *values : {&H_j, &E_i_j, &C_i_j, &Dg_i_j, &Dg2_i_j}) {
+      std::fill(values->begin(), values->end(), 0.);
+    }
+
+    ulong ij = 0;
+    for (ulong k = 0; k < N_i_size; k++) {
+      if (k > 0) {
+        const double dt = t_i[k] - t_i[k - 1];
+        for (ulong d = 0; d < n_decays; d++) ebt[d] = std::exp(-betas[d] * dt);
+        for (ulong d = 0; d < n_decays; d++) H_j[d] *= ebt[d];
+      }
+      while ((ij < N_j_size) && (t_j[ij] < t_i[k])) {
+        const double dt = t_i[k] - t_j[ij];
+        const double dt_end = end_time - t_j[ij];
+        for (ulong d = 0; d < n_decays; d++) {
+          H_j[d] += betas[d] * std::exp(-betas[d] * dt);
+          Dg_i_j[d] += 1 - std::exp(-betas[d] * dt_end);
+          Dg2_i_j[d] += betas[d] * (1 - std::exp(-2 * betas[d] * dt_end)) / 2;
+        }
+        ij++;
+      }
+
+      const double dt_end = end_time - t_i[k];
+      for (ulong d = 0; d < n_decays; d++) {
+        C_i_j[d] += H_j[d];
+        E_i_j[d] += (1 - std::exp(-2 * betas[d] * dt_end)) / 2 * H_j[d];
+      }
+    }
+
+    while (ij < N_j_size) {
+      const double dt_end = end_time - t_j[ij];
+      for (ulong d = 0; d < n_decays; d++) {
+        Dg_i_j[d] += 1 - std::exp(-betas[d] * dt_end);
+        Dg2_i_j[d] += betas[d] * (1 - std::exp(-2 * betas[d] * dt_end)) / 2;
+      }
+      ij++;
+    }
+
+    for (ulong d = 0; d < n_decays; d++) {
+      Dg_list[d](i, j) += Dg_i_j[d];
+      Dg2_list[d](i, j) += Dg2_i_j[d];
+      C_list[d](i, j) += C_i_j[d];
+      for (ulong j1 = 0; j1 < n_nodes; j1++) E_list[d](j1, i * n_nodes + j) += E_i_j[d];
+    }
+  }
+}
+
+bool ModelHawkesFixedExpKernLeastSq::load_cached_weights() {
+  if (cached_decays.size() == 0 || decays == nullptr || decays->size() == 0) return false;
+  const double decay = (*decays)[0];
+  for (ulong k = 1; k < decays->size(); k++) {
+    if ((*decays)[k] != decay) return false;
+  }
+
+  for (ulong d = 0; d < cached_decays.size(); d++) {
+    if (cached_decays[d] != decay) continue;
+
+    E = view(cached_E[d]);
+    Dg = view(cached_Dg[d]);
+    Dg2 = view(cached_Dg2[d]);
+    C = view(cached_C[d]);
+    weights_computed = true;
+    return true;
+  }
+  return false;
+}
+
+SArrayDoublePtr ModelHawkesFixedExpKernLeastSq::get_cached_decays() const {
+  SArrayDoublePtr decays = SArrayDouble::new_ptr(cached_decays.size());
+  if (cached_decays.size() > 0) decays->mult_fill(cached_decays, 1.);
+  return decays;
+}
+
 ulong ModelHawkesFixedExpKernLeastSq::get_n_coeffs() const {
   return n_nodes + n_nodes * n_nodes;
 }
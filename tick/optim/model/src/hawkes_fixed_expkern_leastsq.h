@@ -26,6 +26,33 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLeastSq : public ModelHawkesSingle {
   //! @brief The 2d array of decays (remember that the decays are fixed!)
   SArrayDouble2dPtr decays;
 
+  //! @brief Decays for which weights have been precomputed by compute_weights_for_decays
+  ArrayDouble cached_decays;
+
+  //! @brief E, Dg, Dg2 and C precomputed for each decay of cached_decays
+  std::vector<ArrayDouble2d> cached_E, cached_Dg, cached_Dg2, cached_C;
+
+  /**
+   * @brief Precomputations of intermediate values for dimension i and several decays, each
+   * decay being shared by all kernels
+   * \param i : selected dimension
+   * \param decays : decays for which weights are computed
+   * \param E_list, Dg_list, Dg2_list, C_list : arrays to which the weights of each decay are
+   * added. For two different values of i, different coordinates are modified
+   */
+  void compute_weights_i_for_decays(const ulong i, const ArrayDouble &decays,
+                                    std::vector<ArrayDouble2d> &E_list,
+                                    std::vector<ArrayDouble2d> &Dg_list,
+                                    std::vector<ArrayDouble2d> &Dg2_list,
+                                    std::vector<ArrayDouble2d> &C_list) const;
+
+  /**
+   * @brief Make E, Dg, Dg2 and C point to the weights precomputed for the current decays
+   * \return false if decays are not all equal or if weights have not been precomputed for
+   * their value
+   */
+  bool load_cached_weights();
+
  public:
   //! @brief Default constructor
   //! @note This constructor is only used to create vectors of ModelHawkesFixedExpKernLeastSq
@@ -45,6 +72,24 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLeastSq : public ModelHawkesSingle {
    */
   void compute_weights();
 
+  /**
+   * @brief Precomputations of intermediate values for several decays in a single pass over
+   * the timestamps, each decay being shared by all kernels.
+   * Afterwards, setting decays to a matrix filled with one of these values does not trigger
+   * any computation.
+   * \param decays : decays for which weights are precomputed
+   * \note Exponentials are always computed exactly, whatever optimization_level is
+   */
+  void compute_weights_for_decays(const ArrayDouble &decays);
+
+  /**
+   * @brief Set the data of the model
+   * \param timestamps : the timestamps of each node
+   * \param end_time : end time of the realization
+   * \note Weights precomputed by compute_weights_for_decays are discarded
+   */
+  void set_data(const SArrayDoublePtrList1D &timestamps, const double end_time);
+
   /**
    * @brief Compute loss
    * \param coeffs : Point in which loss is computed
@@ -81,7 +126,7 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLeastSq : public ModelHawkesSingle {
    * \param out : Array in which the value of the hessian is stored
    * \note : We only fill data, python code takes care of creating index and indexptr
    */
-  void hessian(ArrayDouble &out);
+  void hessian(ArrayDouble &out) override;
 
   /**
    * @brief Compute loss and gradient
@@ -91,10 +136,16 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLeastSq : public ModelHawkesSingle {
    */
   double loss_and_grad(const ArrayDouble &coeffs, ArrayDouble &out);
 
-  void set_decays(const SArrayDouble2dPtr decays) {
-    this->decays = decays;
-    weights_computed = false;
-  }
+  /**
+   * @brief Set new decays
+   * \param decays : the 2d array of the decays
+   * \note Weights will need to be recomputed, unless they have been precomputed for this
+   * decay with compute_weights_for_decays
+   */
+  void set_decays(const SArrayDouble2dPtr decays);
+
+  //! @brief Returns the decays for which weights have been precomputed
+  SArrayDoublePtr get_cached_decays() const;
 
   ulong get_n_coeffs() const override;
 
@@ -108,6 +159,8 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLeastSq : public ModelHawkesSingle {
   void hessian_i(const ulong i, ArrayDouble &out);
 
   friend class ModelHawkesFixedExpKernLeastSqList;
+  friend class ModelHawkesFixedExpKernLeastSqOnline;
+  friend class ModelHawkesFixedExpKernLeastSqBinned;
 };
 
 #endif  // TICK_OPTIM_MODEL_SRC_HAWKES_FIXED_EXPKERN_LEASTSQ_H_
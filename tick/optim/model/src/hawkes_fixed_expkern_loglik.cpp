@@ -6,14 +6,147 @@
 ModelHawkesFixedExpKernLogLik::ModelHawkesFixedExpKernLogLik(
     const double decay, const int max_n_threads) :
     ModelHawkesSingle(max_n_threads, 0),
-    decay(decay) {}
+    decay(decay), weights_threshold(0) {}
+
+void ModelHawkesFixedExpKernLogLik::set_data(const SArrayDoublePtrList1D &timestamps,
+                                             const double end_time) {
+  ModelHawkesSingle::set_data(timestamps, end_time);
+  cached_decays = ArrayDouble(0);
+  cached_g.clear();
+  cached_G.clear();
+  cached_sum_G.clear();
+}
 
 void ModelHawkesFixedExpKernLogLik::compute_weights() {
+  if (load_cached_weights()) return;
   allocate_weights();
   parallel_run(get_n_threads(), n_nodes, &ModelHawkesFixedExpKernLogLik::compute_weights_dim_i, this);
   weights_computed = true;
 }
 
+void ModelHawkesFixedExpKernLogLik::compute_weights_for_decays(const ArrayDouble &decays) {
+  allocate_weights_for_decays(decays);
+  parallel_run(get_n_threads(), n_nodes,
+               &ModelHawkesFixedExpKernLogLik::compute_weights_dim_i_for_decays, this);
+  load_cached_weights();
+}
+
+void ModelHawkesFixedExpKernLogLik::allocate_weights_for_decays(const ArrayDouble &decays) {
+  if (n_nodes == 0) {
+    TICK_ERROR("Please provide valid timestamps before allocating weights")
+  }
+  if (weights_threshold > 0) {
+    TICK_ERROR("Weights can be precomputed for several decays only if weights_threshold is 0");
+  }
+  for (ulong d = 0; d < decays.size(); d++) {
+    if (decays[d] <= 0) TICK_ERROR("decays must be positive, got " << decays[d]);
+  }
+
+  const ulong n_decays = decays.size();
+  cached_decays = decays;
+  cached_g = std::vector<ArrayDouble2dList1D>(n_decays, ArrayDouble2dList1D(n_nodes));
+  cached_G = std::vector<ArrayDouble2dList1D>(n_decays, ArrayDouble2dList1D(n_nodes));
+  cached_sum_G = std::vector<ArrayDoubleList1D>(n_decays, ArrayDoubleList1D(n_nodes));
+  for (ulong d = 0; d < n_decays; d++) {
+    for (ulong i = 0; i < n_nodes; i++) {
+      cached_g[d][i] = ArrayDouble2d((*n_jumps_per_node)[i], n_nodes);
+      cached_G[d][i] = ArrayDouble2d((*n_jumps_per_node)[i] + 1, n_nodes);
+      cached_sum_G[d][i] = ArrayDouble(n_nodes);
+      cached_sum_G[d][i].init_to_zero();
+    }
+  }
+}
+
+void ModelHawkesFixedExpKernLogLik::compute_weights_dim_i_for_decays(const ulong i) {
+  const ArrayDouble &t_i = *timestamps[i];
+  const ulong n_jumps_i = (*n_jumps_per_node)[i];
+  const ulong n_decays = cached_decays.size();
+  const double *decays = cached_decays.data();
+
+  // Rows are filled one after the other, as in compute_compressed_weights_dim_i, so that the
+  // decay between two jumps of component i is computed once for all components j. Entries
+  // (k, j) of all decays are stored contiguously so that the loops over decays vectorize
+  std::vector<double> g_k(n_nodes * n_decays, 0.), G_k(n_nodes * n_decays, 0.);
+  std::vector<double> ebt_k(n_decays), ebt(n_decays);
+  std::vector<ulong> ij(n_nodes, 0);
+
+  for (ulong k = 0; k < n_jumps_i + 1; k++) {
+    const double t_i_k = k < n_jumps_i ? t_i[k] : end_time;
+    if (k > 0) {
+      const double dt = t_i_k - t_i[k - 1];
+      for (ulong d = 0; d < n_decays; d++) ebt_k[d] = std::exp(-decays[d] * dt);
+    }
+
+    for (ulong j = 0; j < n_nodes; j++) {
+      const ArrayDouble &t_j = *timestamps[j];
+      double *g_k_j = g_k.data() + j * n_decays;
+      double *G_k_j = G_k.data() + j * n_decays;
+      if (k > 0) {
+        for (ulong d = 0; d < n_decays; d++) {
+          G_k_j[d] = g_k_j[d] * (1 - ebt_k[d]) / decays[d];
+          g_k_j[d] *= ebt_k[d];
+        }
+      }
+
+      while ((ij[j] < (*n_jumps_per_node)[j]) && (t_j[ij[j]] < t_i_k)) {
+        const double dt = t_i_k - t_j[ij[j]];
+        for (ulong d = 0; d < n_decays; d++) ebt[d] = std::exp(-decays[d] * dt);
+        for (ulong d = 0; d < n_decays; d++) {
+          g_k_j[d] += decays[d] * ebt[d];
+          G_k_j[d] += 1 - ebt[d];
+        }
+        ij[j]++;
+      }
+    }
+
+    for (ulong d = 0; d < n_decays; d++) {
+      if (k < n_jumps_i) {
+        double *g_d_k = cached_g[d][i].data() + k * n_nodes;
+        for (ulong j = 0; j < n_nodes; j++) g_d_k[j] = g_k[j * n_decays + d];
+      }
+      double *G_d_k = cached_G[d][i].data() + k * n_nodes;
+      double *sum_G_d = cached_sum_G[d][i].data();
+      for (ulong j = 0; j < n_nodes; j++) {
+        G_d_k[j] = G_k[j * n_decays + d];
+        sum_G_d[j] += G_d_k[j];
+      }
+    }
+  }
+}
+
+bool ModelHawkesFixedExpKernLogLik::load_cached_weights() {
+  if (weights_threshold > 0) return false;
+  for (ulong d = 0; d < cached_decays.size(); d++) {
+    if (cached_decays[d] != decay) continue;
+
+    g = ArrayDouble2dList1D(n_nodes);
+    G = ArrayDouble2dList1D(n_nodes);
+    sum_G = ArrayDoubleList1D(n_nodes);
+    for (ulong i = 0; i < n_nodes; i++) {
+      g[i] = view(cached_g[d][i]);
+      G[i] = view(cached_G[d][i]);
+      sum_G[i] = view(cached_sum_G[d][i]);
+    }
+    g_compressed.clear();
+    G_compressed.clear();
+    weights_computed = true;
+    return true;
+  }
+  return false;
+}
+
+void ModelHawkesFixedExpKernLogLik::set_decay(double decay) {
+  this->decay = decay;
+  weights_computed = false;
+  load_cached_weights();
+}
+
+SArrayDoublePtr ModelHawkesFixedExpKernLogLik::get_cached_decays() const {
+  SArrayDoublePtr decays = SArrayDouble::new_ptr(cached_decays.size());
+  if (cached_decays.size() > 0) decays->mult_fill(cached_decays, 1.);
+  return decays;
+}
+
 void ModelHawkesFixedExpKernLogLik::allocate_weights() {
   if (n_nodes == 0) {
     TICK_ERROR("Please provide valid timestamps before allocating weights")
@@ -22,6 +155,15 @@ void ModelHawkesFixedExpKernLogLik::allocate_weights() {
   G = ArrayDouble2dList1D(n_nodes);
   sum_G = ArrayDoubleList1D(n_nodes);
 
+  if (weights_threshold > 0) {
+    g_compressed = std::vector<CompressedWeights>(n_nodes, CompressedWeights(n_nodes));
+    G_compressed = std::vector<CompressedWeights>(n_nodes, CompressedWeights(n_nodes));
+    for (ulong i = 0; i < n_nodes; i++) sum_G[i] = ArrayDouble(n_nodes);
+    return;
+  }
+  g_compressed.clear();
+  G_compressed.clear();
+
   for (ulong i = 0; i < n_nodes; i++) {
     g[i] = ArrayDouble2d((*n_jumps_per_node)[i], n_nodes);
     g[i].init_to_zero();
@@ -32,6 +174,10 @@ void ModelHawkesFixedExpKernLogLik::allocate_weights() {
 }
 
 void ModelHawkesFixedExpKernLogLik::compute_weights_dim_i(const ulong i) {
+  if (weights_threshold > 0) {
+    compute_compressed_weights_dim_i(i);
+    return;
+  }
   const ArrayDouble t_i = view(*timestamps[i]);
   ArrayDouble2d g_i = view(g[i]);
   ArrayDouble2d G_i = view(G[i]);
@@ -66,6 +212,80 @@ void ModelHawkesFixedExpKernLogLik::compute_weights_dim_i(const ulong i) {
   }
 }
 
+void ModelHawkesFixedExpKernLogLik::compute_compressed_weights_dim_i(const ulong i) {
+  const ArrayDouble t_i = view(*timestamps[i]);
+  ArrayDouble sum_G_i = view(sum_G[i]);
+  sum_G_i.init_to_zero();
+
+  const ulong n_jumps_i = (*n_jumps_per_node)[i];
+  const double g_threshold = weights_threshold;
+  const double G_threshold = weights_threshold / decay;
+
+  CompressedWeights &g_i = g_compressed[i];
+  CompressedWeights &G_i = G_compressed[i];
+  g_i = CompressedWeights(n_nodes);
+  G_i = CompressedWeights(n_nodes);
+
+  // Exact values of the previous row of g and index of the next jump of each component, as
+  // rows are filled one after the other
+  ArrayDouble g_i_prev(n_nodes);
+  g_i_prev.init_to_zero();
+  ArrayULong ij(n_nodes);
+  ij.init_to_zero();
+
+  for (ulong k = 0; k < n_jumps_i + 1; k++) {
+    const double t_i_k = k < n_jumps_i ? t_i[k] : end_time;
+    const double ebt_k = k > 0 ? std::exp(-decay * (t_i_k - t_i[k - 1])) : 0;
+
+    for (ulong j = 0; j < n_nodes; j++) {
+      const ArrayDouble &t_j = *timestamps[j];
+      double g_i_k_j = 0;
+      double G_i_k_j = 0;
+      if (k > 0) {
+        g_i_k_j = g_i_prev[j] * ebt_k;
+        G_i_k_j = g_i_prev[j] * (1 - ebt_k) / decay;
+      }
+
+      while ((ij[j] < (*n_jumps_per_node)[j]) && (t_j[ij[j]] < t_i_k)) {
+        const double ebt = std::exp(-decay * (t_i_k - t_j[ij[j]]));
+        g_i_k_j += decay * ebt;
+        G_i_k_j += 1 - ebt;
+        ij[j]++;
+      }
+      sum_G_i[j] += G_i_k_j;
+
+      if (k < n_jumps_i) {
+        g_i_prev[j] = g_i_k_j;
+        if (g_i_k_j > 0 && g_i_k_j >= g_threshold) g_i.push_back(j, g_i_k_j);
+      }
+      if (G_i_k_j > 0 && G_i_k_j >= G_threshold) G_i.push_back(j, G_i_k_j);
+    }
+    if (k < n_jumps_i) g_i.end_row();
+    G_i.end_row();
+  }
+  g_i.shrink_to_fit();
+  G_i.shrink_to_fit();
+}
+
+void ModelHawkesFixedExpKernLogLik::set_weights_threshold(double weights_threshold) {
+  if (weights_threshold < 0) {
+    TICK_ERROR("weights_threshold must be non negative, got " << weights_threshold);
+  }
+  this->weights_threshold = weights_threshold;
+  weights_computed = false;
+}
+
+ulong ModelHawkesFixedExpKernLogLik::get_n_stored_weights() const {
+  ulong n_stored_weights = 0;
+  for (ulong i = 0; i < g_compressed.size(); i++) {
+    n_stored_weights += g_compressed[i].size_sparse() + G_compressed[i].size_sparse();
+  }
+  for (ulong i = 0; i < g.size(); i++) {
+    n_stored_weights += g[i].size() + G[i].size();
+  }
+  return n_stored_weights;
+}
+
 double ModelHawkesFixedExpKernLogLik::loss(const ArrayDouble &coeffs) {
   if (!weights_computed) compute_weights();
 
@@ -139,6 +359,18 @@ double ModelHawkesFixedExpKernLogLik::hessian_norm(const ArrayDouble &coeffs,
   return norm_sum / n_total_jumps;
 }
 
+void ModelHawkesFixedExpKernLogLik::hessian_vector_product(const ArrayDouble &coeffs,
+                                                           const ArrayDouble &vector,
+                                                           ArrayDouble &out) {
+  if (!weights_computed) compute_weights();
+  out.fill(0);
+
+  parallel_run(get_n_threads(), n_nodes,
+               &ModelHawkesFixedExpKernLogLik::hessian_vector_product_dim_i,
+               this, coeffs, vector, out);
+  out /= n_total_jumps;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //                                    PRIVATE METHODS
@@ -158,21 +390,56 @@ void ModelHawkesFixedExpKernLogLik::sampled_i_to_index(const ulong sampled_i,
   }
 }
 
+// Rows of g and G have n_nodes entries at most, plain loops are cheaper than BLAS calls here
+
+double ModelHawkesFixedExpKernLogLik::g_row_dot(const ulong i, const ulong k,
+                                                const ArrayDouble &x) const {
+  if (weights_threshold > 0) return g_compressed[i].row_dot(k, x.data());
+  const double *g_i_k = g[i].data() + k * n_nodes;
+  double result = 0;
+  for (ulong j = 0; j < n_nodes; j++) result += x[j] * g_i_k[j];
+  return result;
+}
+
+void ModelHawkesFixedExpKernLogLik::g_row_mult_incr(const ulong i, const ulong k,
+                                                    ArrayDouble &x, const double a) const {
+  if (weights_threshold > 0) {
+    g_compressed[i].row_mult_incr(k, x.data(), a);
+    return;
+  }
+  const double *g_i_k = g[i].data() + k * n_nodes;
+  for (ulong j = 0; j < n_nodes; j++) x[j] += a * g_i_k[j];
+}
+
+double ModelHawkesFixedExpKernLogLik::G_row_dot(const ulong i, const ulong k,
+                                                const ArrayDouble &x) const {
+  if (weights_threshold > 0) return G_compressed[i].row_dot(k, x.data());
+  const double *G_i_k = G[i].data() + k * n_nodes;
+  double result = 0;
+  for (ulong j = 0; j < n_nodes; j++) result += x[j] * G_i_k[j];
+  return result;
+}
+
+void ModelHawkesFixedExpKernLogLik::G_row_mult_incr(const ulong i, const ulong k,
+                                                    ArrayDouble &x, const double a) const {
+  if (weights_threshold > 0) {
+    G_compressed[i].row_mult_incr(k, x.data(), a);
+    return;
+  }
+  const double *G_i_k = G[i].data() + k * n_nodes;
+  for (ulong j = 0; j < n_nodes; j++) x[j] += a * G_i_k[j];
+}
+
 double ModelHawkesFixedExpKernLogLik::loss_dim_i(const ulong i,
                                                  const ArrayDouble &coeffs) {
   const ArrayDouble mu = view(coeffs, 0, n_nodes);
-  const ArrayDouble alpha = view(coeffs, n_nodes, n_nodes + n_nodes * n_nodes);
+  const ArrayDouble alpha_i = view(coeffs, n_nodes + i * n_nodes, n_nodes + (i + 1) * n_nodes);
 
   double loss = 0;
   loss += end_time * mu[i];
 
   for (ulong k = 0; k < (*n_jumps_per_node)[i]; ++k) {
-    const ArrayDouble g_i_k = view_row(g[i], k);
-
-    double s = mu[i];
-    for (ulong j = 0; j < n_nodes; j++) {
-      s += alpha[j + i * n_nodes] * g_i_k[j];
-    }
+    const double s = mu[i] + g_row_dot(i, k, alpha_i);
     if (s <= 0) {
       TICK_ERROR("The sum of the influence on someone cannot be negative. "
                      "Maybe did you forget to add a positive constraint to "
@@ -181,9 +448,7 @@ double ModelHawkesFixedExpKernLogLik::loss_dim_i(const ulong i,
     loss -= log(s);
   }
 
-  for (ulong j = 0; j < n_nodes; j++) {
-    loss += alpha[j + i * n_nodes] * sum_G[i][j];
-  }
+  loss += alpha_i.dot(sum_G[i]);
   return loss;
 }
 
@@ -191,11 +456,9 @@ double ModelHawkesFixedExpKernLogLik::loss_i_k(const ulong i,
                                                const ulong k,
                                                const ArrayDouble &coeffs) {
   const ArrayDouble mu = view(coeffs, 0, n_nodes);
-  const ArrayDouble alpha = view(coeffs, n_nodes, n_nodes + n_nodes * n_nodes);
+  const ArrayDouble alpha_i = view(coeffs, n_nodes + i * n_nodes, n_nodes + (i + 1) * n_nodes);
   double loss = 0;
 
-  const ArrayDouble g_i_k = view_row(g[i], k);
-  const ArrayDouble G_i_k = view_row(G[i], k);
 
   // Both are correct, just a question of point of view
   const double t_i_k = k == (*n_jumps_per_node)[i] - 1 ? end_time : (*timestamps[i])[k];
@@ -203,10 +466,7 @@ double ModelHawkesFixedExpKernLogLik::loss_i_k(const ulong i,
   loss += (t_i_k - t_i_k_minus_one) * mu[i];
   //  loss += end_time * mu[i] / (*n_jumps_per_node)[i];
 
-  double s = mu[i];
-  for (ulong j = 0; j < n_nodes; j++) {
-    s += alpha[j + i * n_nodes] * g_i_k[j];
-  }
+  const double s = mu[i] + g_row_dot(i, k, alpha_i);
 
   if (s <= 0) {
     TICK_ERROR("The sum of the influence on someone cannot be negative. Maybe did "
@@ -215,11 +475,8 @@ double ModelHawkesFixedExpKernLogLik::loss_i_k(const ulong i,
   }
   loss -= log(s);
 
-  for (ulong j = 0; j < n_nodes; j++) {
-    double G_i_k_j = G_i_k[j];
-    if (k == (*n_jumps_per_node)[i] - 1) G_i_k_j += G[i](k + 1, j);
-    loss += alpha[j + i * n_nodes] * G_i_k_j;
-  }
+  loss += G_row_dot(i, k, alpha_i);
+  if (k == (*n_jumps_per_node)[i] - 1) loss += G_row_dot(i, k + 1, alpha_i);
   return loss;
 }
 
@@ -227,41 +484,30 @@ void ModelHawkesFixedExpKernLogLik::grad_dim_i(const ulong i,
                                                const ArrayDouble &coeffs,
                                                ArrayDouble &out) {
   const ArrayDouble mu = view(coeffs, 0, n_nodes);
-  const ArrayDouble alpha = view(coeffs, n_nodes, n_nodes + n_nodes * n_nodes);
+  const ArrayDouble alpha_i = view(coeffs, n_nodes + i * n_nodes, n_nodes + (i + 1) * n_nodes);
   ArrayDouble grad_mu = view(out, 0, n_nodes);
-  ArrayDouble grad_alpha = view(out, n_nodes, n_nodes + n_nodes * n_nodes);
+  ArrayDouble grad_alpha_i = view(out, n_nodes + i * n_nodes, n_nodes + (i + 1) * n_nodes);
 
   grad_mu[i] += end_time;
 
   for (ulong k = 0; k < (*n_jumps_per_node)[i]; ++k) {
-    const ArrayDouble g_i_k = view_row(g[i], k);
-    double s = mu[i];
-
-    for (ulong j = 0; j < n_nodes; j++) {
-      s += alpha[j + i * n_nodes] * g_i_k[j];
-    }
+    const double s = mu[i] + g_row_dot(i, k, alpha_i);
 
     grad_mu[i] -= 1. / s;
-    for (ulong j = 0; j < n_nodes; j++) {
-      grad_alpha[j + i * n_nodes] -= g_i_k[j] / s;
-    }
+    g_row_mult_incr(i, k, grad_alpha_i, -1. / s);
   }
 
-  for (ulong j = 0; j < n_nodes; j++) {
-    grad_alpha[j + i * n_nodes] += sum_G[i][j];
-  }
+  grad_alpha_i.mult_incr(sum_G[i], 1.);
 }
 
 void ModelHawkesFixedExpKernLogLik::grad_i_k(const ulong i, const ulong k,
                                              const ArrayDouble &coeffs,
                                              ArrayDouble &out) {
   const ArrayDouble mu = view(coeffs, 0, n_nodes);
-  const ArrayDouble alpha = view(coeffs, n_nodes, n_nodes + n_nodes * n_nodes);
+  const ArrayDouble alpha_i = view(coeffs, n_nodes + i * n_nodes, n_nodes + (i + 1) * n_nodes);
   ArrayDouble grad_mu = view(out, 0, n_nodes);
-  ArrayDouble grad_alpha = view(out, n_nodes, n_nodes + n_nodes * n_nodes);
+  ArrayDouble grad_alpha_i = view(out, n_nodes + i * n_nodes, n_nodes + (i + 1) * n_nodes);
 
-  const ArrayDouble g_i_k = view_row(g[i], k);
-  const ArrayDouble G_i_k = view_row(G[i], k);
 
   // Both are correct, just a question of point of view
   const double t_i_k = k == (*n_jumps_per_node)[i] - 1 ? end_time : (*timestamps[i])[k];
@@ -269,41 +515,30 @@ void ModelHawkesFixedExpKernLogLik::grad_i_k(const ulong i, const ulong k,
   grad_mu[i] += t_i_k - t_i_k_minus_one;
   //  grad_mu[i] += end_time / (*n_jumps_per_node)[i];
 
-  double s = mu[i];
-
-  for (ulong j = 0; j < n_nodes; j++) {
-    s += alpha[j + i * n_nodes] * g_i_k[j];
-  }
+  const double s = mu[i] + g_row_dot(i, k, alpha_i);
 
   grad_mu[i] -= 1. / s;
 
-  for (ulong j = 0; j < n_nodes; j++) {
-    double G_i_k_j = G_i_k[j];
-    if (k == (*n_jumps_per_node)[i] - 1) G_i_k_j += G[i](k + 1, j);
-    grad_alpha[j + i * n_nodes] += G_i_k_j - g_i_k[j] / s;
-  }
+  G_row_mult_incr(i, k, grad_alpha_i, 1.);
+  if (k == (*n_jumps_per_node)[i] - 1) G_row_mult_incr(i, k + 1, grad_alpha_i, 1.);
+  g_row_mult_incr(i, k, grad_alpha_i, -1. / s);
 }
 
 double ModelHawkesFixedExpKernLogLik::loss_and_grad_dim_i(const ulong i,
                                                           const ArrayDouble &coeffs,
                                                           ArrayDouble &out) {
   const ArrayDouble mu = view(coeffs, 0, n_nodes);
-  const ArrayDouble alpha = view(coeffs, n_nodes, n_nodes + n_nodes * n_nodes);
+  const ArrayDouble alpha_i = view(coeffs, n_nodes + i * n_nodes, n_nodes + (i + 1) * n_nodes);
 
   ArrayDouble grad_mu = view(out, 0, n_nodes);
-  ArrayDouble grad_alpha = view(out, n_nodes, n_nodes + n_nodes * n_nodes);
+  ArrayDouble grad_alpha_i = view(out, n_nodes + i * n_nodes, n_nodes + (i + 1) * n_nodes);
 
   double loss = 0;
 
   grad_mu[i] += end_time;
   loss += end_time * mu[i];
   for (ulong k = 0; k < (*n_jumps_per_node)[i]; k++) {
-    const ArrayDouble g_i_k = view_row(g[i], k);
-
-    double s = mu[i];
-    for (ulong j = 0; j < n_nodes; j++) {
-      s += alpha[j + i * n_nodes] * g_i_k[j];
-    }
+    const double s = mu[i] + g_row_dot(i, k, alpha_i);
 
     if (s <= 0) {
       TICK_ERROR("The sum of the influence on someone cannot be negative. Maybe did "
@@ -313,15 +548,11 @@ double ModelHawkesFixedExpKernLogLik::loss_and_grad_dim_i(const ulong i,
     loss -= log(s);
     grad_mu[i] -= 1. / s;
 
-    for (ulong j = 0; j < n_nodes; j++) {
-      grad_alpha[j + i * n_nodes] -= g_i_k[j] / s;
-    }
+    g_row_mult_incr(i, k, grad_alpha_i, -1. / s);
   }
 
-  for (ulong j = 0; j < n_nodes; j++) {
-    grad_alpha[j + i * n_nodes] += sum_G[i][j];
-    loss += alpha[j + i * n_nodes] * sum_G[i][j];
-  }
+  grad_alpha_i.mult_incr(sum_G[i], 1.);
+  loss += alpha_i.dot(sum_G[i]);
 
   return loss;
 }
@@ -330,27 +561,44 @@ double ModelHawkesFixedExpKernLogLik::hessian_norm_dim_i(const ulong i,
                                                          const ArrayDouble &coeffs,
                                                          const ArrayDouble &vector) {
   const ArrayDouble mu = view(coeffs, 0, n_nodes);
-  const ArrayDouble alpha = view(coeffs, n_nodes, n_nodes + n_nodes * n_nodes);
+  const ArrayDouble alpha_i = view(coeffs, n_nodes + i * n_nodes, n_nodes + (i + 1) * n_nodes);
   ArrayDouble d_mu = view(vector, 0, n_nodes);
-  ArrayDouble d_alpha = view(vector, n_nodes, n_nodes + n_nodes * n_nodes);
+  ArrayDouble d_alpha_i = view(vector, n_nodes + i * n_nodes, n_nodes + (i + 1) * n_nodes);
 
   double hess_norm = 0;
 
   for (ulong k = 0; k < (*n_jumps_per_node)[i]; k++) {
-    const ArrayDouble g_i_k = view_row(g[i], k);
-
-    double S = d_mu[i];
-    double s = mu[i];
-    for (ulong j = 0; j < n_nodes; j++) {
-      S += d_alpha[j + i * n_nodes] * g_i_k[j];
-      s += alpha[j + i * n_nodes] * g_i_k[j];
-    }
+    const double S = d_mu[i] + g_row_dot(i, k, d_alpha_i);
+    const double s = mu[i] + g_row_dot(i, k, alpha_i);
     double tmp = S / s;
     hess_norm += tmp * tmp;
   }
   return hess_norm;
 }
 
+// The loss of component i only involves mu_i and alpha_i, and its hessian with respect to them
+// is the sum over the jumps of i of (1, g_k) (1, g_k)^T / s_k^2
+void ModelHawkesFixedExpKernLogLik::hessian_vector_product_dim_i(const ulong i,
+                                                                 const ArrayDouble &coeffs,
+                                                                 const ArrayDouble &vector,
+                                                                 ArrayDouble &out) {
+  const ArrayDouble mu = view(coeffs, 0, n_nodes);
+  const ArrayDouble alpha_i = view(coeffs, n_nodes + i * n_nodes, n_nodes + (i + 1) * n_nodes);
+  const ArrayDouble d_mu = view(vector, 0, n_nodes);
+  const ArrayDouble d_alpha_i = view(vector, n_nodes + i * n_nodes, n_nodes + (i + 1) * n_nodes);
+  ArrayDouble out_mu = view(out, 0, n_nodes);
+  ArrayDouble out_alpha_i = view(out, n_nodes + i * n_nodes, n_nodes + (i + 1) * n_nodes);
+
+  for (ulong k = 0; k < (*n_jumps_per_node)[i]; k++) {
+    const double S = d_mu[i] + g_row_dot(i, k, d_alpha_i);
+    const double s = mu[i] + g_row_dot(i, k, alpha_i);
+    const double tmp = S / (s * s);
+
+    out_mu[i] += tmp;
+    g_row_mult_incr(i, k, out_alpha_i, tmp);
+  }
+}
+
 ulong ModelHawkesFixedExpKernLogLik::get_n_coeffs() const {
   return n_nodes + n_nodes * n_nodes;
 }
@@ -10,6 +10,7 @@
 #include "base.h"
 
 #include "base/hawkes_single.h"
+#include "hawkes_utils.h"
 
 class ModelHawkesFixedExpKernLogLikList;
 
@@ -29,10 +30,26 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLogLik : public ModelHawkesSingle {
   ArrayDouble2dList1D G;
   ArrayDoubleList1D sum_G;
 
+  //! @brief Entries of g (resp. G) below this threshold (resp. threshold / decay) are not
+  //! stored. If it is 0, g and G are stored as dense arrays
+  double weights_threshold;
+
+  //! @brief Compressed versions of g and G, used instead of g and G if weights_threshold > 0
+  std::vector<CompressedWeights> g_compressed;
+  std::vector<CompressedWeights> G_compressed;
+
+  //! @brief Decays for which weights have been precomputed by compute_weights_for_decays
+  ArrayDouble cached_decays;
+
+  //! @brief Dense g, G and sum_G precomputed for each decay of cached_decays
+  std::vector<ArrayDouble2dList1D> cached_g;
+  std::vector<ArrayDouble2dList1D> cached_G;
+  std::vector<ArrayDoubleList1D> cached_sum_G;
+
  public:
   //! @brief Default constructor
   //! @note This constructor is only used to create vectors of ModelHawkesFixedExpKernLeastSq
-  ModelHawkesFixedExpKernLogLik() : ModelHawkesSingle() {}
+  ModelHawkesFixedExpKernLogLik() : ModelHawkesSingle(), weights_threshold(0) {}
 
   /**
    * @brief Constructor
@@ -48,6 +65,24 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLogLik : public ModelHawkesSingle {
    */
   void compute_weights();
 
+  /**
+   * @brief Precomputations of intermediate values for several decays in a single pass over
+   * the timestamps.
+   * Afterwards, setting decay to one of these values does not trigger any computation.
+   * \param decays : decays for which weights are precomputed
+   * \note Weights of all decays are kept in dense arrays, which requires
+   * decays.size() times the memory of compute_weights
+   */
+  void compute_weights_for_decays(const ArrayDouble &decays);
+
+  /**
+   * @brief Set the data of the model
+   * \param timestamps : the timestamps of each node
+   * \param end_time : end time of the realization
+   * \note Weights precomputed by compute_weights_for_decays are discarded
+   */
+  void set_data(const SArrayDoublePtrList1D &timestamps, const double end_time);
+
   /**
    * @brief Compute loss and gradient
    * \param coeffs : Point in which loss and gradient are computed
@@ -97,6 +132,16 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLogLik : public ModelHawkesSingle {
    */
   double hessian_norm(const ArrayDouble &coeffs, const ArrayDouble &vector);
 
+  /**
+   * @brief Compute the product of the hessian with a vector \f$ \nabla^2 f(x) d \f$
+   * \param coeffs : Point in which the hessian is computed (\f$ x \f$)
+   * \param vector : Vector multiplied by the hessian (\f$ d \f$)
+   * \param out : Array in which the product is stored
+   * \note Nodes are computed in parallel, the hessian is never formed
+   */
+  void hessian_vector_product(const ArrayDouble &coeffs, const ArrayDouble &vector,
+                              ArrayDouble &out) override;
+
  private:
   void allocate_weights();
   /**
@@ -105,6 +150,40 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLogLik : public ModelHawkesSingle {
    */
   void compute_weights_dim_i(const ulong i);
 
+  /**
+   * @brief Precomputations of intermediate values for component i in compressed storage
+   * \param i : selected component
+   * \note Weights are computed exactly, only the stored entries are truncated
+   */
+  void compute_compressed_weights_dim_i(const ulong i);
+
+  /**
+   * @brief Precomputations of intermediate values for component i and all cached decays
+   * \param i : selected component
+   */
+  void compute_weights_dim_i_for_decays(const ulong i);
+
+  //! @brief Allocate the arrays in which weights are precomputed for each decay of decays
+  void allocate_weights_for_decays(const ArrayDouble &decays);
+
+  /**
+   * @brief Make g, G and sum_G point to the weights precomputed for the current decay
+   * \return false if they have not been precomputed for this decay
+   */
+  bool load_cached_weights();
+
+  //! @brief Dot product of x with row k of g for component i, dense or compressed
+  double g_row_dot(const ulong i, const ulong k, const ArrayDouble &x) const;
+
+  //! @brief Add a times row k of g for component i to x, dense or compressed
+  void g_row_mult_incr(const ulong i, const ulong k, ArrayDouble &x, const double a) const;
+
+  //! @brief Dot product of x with row k of G for component i, dense or compressed
+  double G_row_dot(const ulong i, const ulong k, const ArrayDouble &x) const;
+
+  //! @brief Add a times row k of G for component i to x, dense or compressed
+  void G_row_mult_incr(const ulong i, const ulong k, ArrayDouble &x, const double a) const;
+
   /**
    * @brief Convert sample i (between 0 and rand_max) to a tuple component, timestamp index
    * \param samples_d : selected sample
@@ -170,6 +249,18 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLogLik : public ModelHawkesSingle {
    */
   double hessian_norm_dim_i(const ulong i, const ArrayDouble &coeffs, const ArrayDouble &vector);
 
+  /**
+   * @brief Compute the product of the hessian with a vector corresponding to component i
+   * \param i : selected component
+   * \param coeffs : Point in which the hessian is computed (\f$ x \f$)
+   * \param vector : Vector multiplied by the hessian (\f$ d \f$)
+   * \param out : Array which the result of the product will be added to
+   * \note For two different values of i, this function will modify different coordinates of
+   * out. Hence, it is thread safe.
+   */
+  void hessian_vector_product_dim_i(const ulong i, const ArrayDouble &coeffs,
+                                    const ArrayDouble &vector, ArrayDouble &out);
+
  public:
   ulong get_n_coeffs() const override;
 
@@ -185,13 +276,33 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLogLik : public ModelHawkesSingle {
   /**
    * @brief Set new decay
    * \param decay : new decay
-   * \note Weights will need to be recomputed
+   * \note Weights will need to be recomputed, unless they have been precomputed for this decay
+   * with compute_weights_for_decays
    */
-  void set_decay(double decay) {
-    this->decay = decay;
-    weights_computed = false;
+  void set_decay(double decay);
+
+  //! @brief Returns the decays for which weights have been precomputed
+  SArrayDoublePtr get_cached_decays() const;
+
+  //! @brief Returns the threshold under which weights are not stored
+  double get_weights_threshold() const {
+    return weights_threshold;
   }
 
+  /**
+   * @brief Set the threshold under which weights are not stored.
+   * Entries of g that are below this threshold, and entries of G that are below this
+   * threshold divided by decay, are dropped. The intensity of each event is then underestimated
+   * by at most weights_threshold * sum_j alpha_ij. With threshold 0 (default), weights are
+   * stored in dense arrays of size n_total_jumps * n_nodes.
+   * \param weights_threshold : non negative threshold
+   * \note Weights will need to be recomputed
+   */
+  void set_weights_threshold(double weights_threshold);
+
+  //! @brief Returns the number of weights currently stored in g and G
+  ulong get_n_stored_weights() const;
+
   friend ModelHawkesFixedExpKernLogLikList;
 };
 
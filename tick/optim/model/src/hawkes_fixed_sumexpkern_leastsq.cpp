@@ -8,10 +8,11 @@ ModelHawkesFixedSumExpKernLeastSq::ModelHawkesFixedSumExpKernLeastSq(
     const ulong n_baselines,
     const double period_length,
     const unsigned int max_n_threads,
-    const unsigned int optimization_level)
+    const unsigned int optimization_level,
+    const bool float_weights)
     : ModelHawkesSingle(max_n_threads, optimization_level),
       n_baselines(n_baselines), period_length(period_length),
-      decays(decays), n_decays(decays.size()) {}
+      decays(decays), n_decays(decays.size()), float_weights(float_weights) {}
 
 // Method that computes the value
 double ModelHawkesFixedSumExpKernLeastSq::loss(const ArrayDouble &coeffs) {
@@ -30,6 +31,54 @@ double ModelHawkesFixedSumExpKernLeastSq::loss(const ArrayDouble &coeffs) {
   return values->sum() / n_total_jumps;
 }
 
+namespace {
+
+/**
+ * @brief Compute alpha^T Q alpha for a quadratic form Q stored by blocks as in
+ * ModelHawkesFixedSumExpKernLeastSq, and add its gradient to grad_alpha if it is not null
+ */
+template <typename T>
+double quadratic_form(const Array<T> &Q, const ArrayDouble &alpha, const ulong n_nodes,
+                      const ulong n_decays, ArrayDouble *grad_alpha) {
+  double value = 0;
+  const T *block = Q.data();
+  for (ulong j = 0; j < n_nodes; ++j) {
+    const double *alpha_j = alpha.data() + j * n_decays;
+    for (ulong j1 = j; j1 < n_nodes; ++j1, block += n_decays * n_decays) {
+      const double *alpha_j1 = alpha.data() + j1 * n_decays;
+
+      double block_value = 0;
+      for (ulong u = 0; u < n_decays; ++u) {
+        double Q_alpha_j1_u = 0;
+        for (ulong u1 = 0; u1 < n_decays; ++u1) {
+          Q_alpha_j1_u += block[u * n_decays + u1] * alpha_j1[u1];
+        }
+        block_value += alpha_j[u] * Q_alpha_j1_u;
+        if (grad_alpha != nullptr) (*grad_alpha)[j * n_decays + u] += 2 * Q_alpha_j1_u;
+      }
+
+      // Off diagonal blocks appear twice in the quadratic form, as (j, j1) and (j1, j)
+      if (j1 == j) {
+        value += block_value;
+      } else {
+        value += 2 * block_value;
+        if (grad_alpha != nullptr) {
+          for (ulong u1 = 0; u1 < n_decays; ++u1) {
+            double Q_alpha_j_u1 = 0;
+            for (ulong u = 0; u < n_decays; ++u) {
+              Q_alpha_j_u1 += block[u * n_decays + u1] * alpha_j[u];
+            }
+            (*grad_alpha)[j1 * n_decays + u1] += 2 * Q_alpha_j_u1;
+          }
+        }
+      }
+    }
+  }
+  return value;
+}
+
+}  // namespace
+
 // Performs the computation of the contribution of the i component to the value
 double ModelHawkesFixedSumExpKernLeastSq::loss_i(const ulong i,
                                                  const ArrayDouble &coeffs) {
@@ -42,14 +91,10 @@ double ModelHawkesFixedSumExpKernLeastSq::loss_i(const ulong i,
 
   double C_sum = 0;
   double Dg_sum = 0;
-  double Dgg_sum = 0;
-  double E_sum = 0;
 
   ArrayDouble2d &C_i = C[i];
   for (ulong j = 0; j < n_nodes; ++j) {
     ArrayDouble2d &Dg_j = Dg[j];
-    ArrayDouble2d &Dgg_j = Dgg[j];
-    ArrayDouble2d &E_j = E[j];
 
     for (ulong u = 0; u < n_decays; ++u) {
       double alpha_i_j_u = alpha_i[j * n_decays + u];
@@ -58,16 +103,6 @@ double ModelHawkesFixedSumExpKernLeastSq::loss_i(const ulong i,
       for (ulong p = 0; p < n_baselines; ++p) {
         Dg_sum += alpha_i_j_u * mu_i[p] * Dg_j[u * n_baselines + p];
       }
-
-      for (ulong u1 = 0; u1 < n_decays; ++u1) {
-        double alpha_i_j_u1 = alpha_i[j * n_decays + u1];
-        Dgg_sum += alpha_i_j_u * alpha_i_j_u1 * Dgg_j(u, u1);
-
-        for (ulong j1 = 0; j1 < n_nodes; ++j1) {
-          double alpha_i_j1_u1 = alpha_i[j1 * n_decays + u1];
-          E_sum += alpha_i_j_u * alpha_i_j1_u1 * E_j(j1, u * n_decays + u1);
-        }
-      }
     }
   }
 
@@ -81,8 +116,11 @@ double ModelHawkesFixedSumExpKernLeastSq::loss_i(const ulong i,
   }
 
   A_i += 2 * Dg_sum;
-  A_i += Dgg_sum;
-  A_i += 2 * E_sum;
+  if (float_weights) {
+    A_i += quadratic_form(Q_float, alpha_i, n_nodes, n_decays, nullptr);
+  } else {
+    A_i += quadratic_form(Q, alpha_i, n_nodes, n_decays, nullptr);
+  }
 
   B_i += C_sum;
 
@@ -128,8 +166,6 @@ void ModelHawkesFixedSumExpKernLeastSq::grad_i(const ulong i,
   ArrayDouble2d &C_i = C[i];
   for (ulong j = 0; j < n_nodes; ++j) {
     ArrayDouble2d &Dg_j = Dg[j];
-    ArrayDouble2d &Dgg_j = Dgg[j];
-    ArrayDouble2d &E_j = E[j];
 
     for (ulong u = 0; u < n_decays; ++u) {
       double alpha_i_j_u = alpha_i[j * n_decays + u];
@@ -141,23 +177,14 @@ void ModelHawkesFixedSumExpKernLeastSq::grad_i(const ulong i,
         grad_mu_i[p] += 2 * alpha_i_j_u * Dg_j[u * n_baselines + p];
         grad_alpha_i_j_u += 2 * mu_i[p] * Dg_j[u * n_baselines + p];
       }
-
-      for (ulong u1 = 0; u1 < n_decays; ++u1) {
-        double alpha_i_j_u1 = alpha_i[j * n_decays + u1];
-
-        grad_alpha_i_j_u += 2 * alpha_i_j_u1 * Dgg_j(u , u1);
-
-        for (ulong j1 = 0; j1 < n_nodes; ++j1) {
-          double alpha_i_j1_u1 = alpha_i[j1 * n_decays + u1];
-          double &grad_alpha_i_j1_u1 = grad_alpha_i[j1 * n_decays + u1];
-          double E_j_j1_u_u1 = E_j(j1, u * n_decays + u1);
-
-          grad_alpha_i_j_u += 2 * alpha_i_j1_u1 * E_j_j1_u_u1;
-          grad_alpha_i_j1_u1 += 2 * alpha_i_j_u * E_j_j1_u_u1;
-        }
-      }
     }
   }
+
+  if (float_weights) {
+    quadratic_form(Q_float, alpha_i, n_nodes, n_decays, &grad_alpha_i);
+  } else {
+    quadratic_form(Q, alpha_i, n_nodes, n_decays, &grad_alpha_i);
+  }
 }
 
 // Computes both gradient and value
@@ -168,80 +195,172 @@ double ModelHawkesFixedSumExpKernLeastSq::loss_and_grad(const ArrayDouble &coeff
   return loss(coeffs);
 }
 
-// Contribution of the ith component to the initialization
-// Computation of the arrays H, Dg, Dg2 and C
-void ModelHawkesFixedSumExpKernLeastSq::compute_weights_i(const ulong i) {
-  for (ulong p = 0; p < n_baselines; ++p) {
-    // dispatch interval length computation among threads
-    if (p % n_nodes == i)
-      L[p] = get_baseline_interval_length(p);
-  }
+ulong ModelHawkesFixedSumExpKernLeastSq::get_Q_block_start(const ulong j,
+                                                           const ulong j1) const {
+  // Blocks (j, j1) of rows j' < j are stored before, there are n_nodes - j' of them per row
+  return (j * n_nodes - (j * (j - 1)) / 2 + j1 - j) * n_decays * n_decays;
+}
 
-  ulong n_decays = decays.size();
+ulong ModelHawkesFixedSumExpKernLeastSq::get_n_nodes_per_block() const {
+  // Blocks are small enough for their weights to stay in cache, and numerous enough to give
+  // many tiles to share between threads
+  return std::max(std::min(n_nodes / 8, static_cast<ulong>(16)), static_cast<ulong>(1));
+}
 
-  ArrayDouble &timestamps_i = *timestamps[i];
-  ArrayDouble2d H(n_nodes, n_decays);
-  H.init_to_zero();
-  ArrayULong l = ArrayULong(n_nodes);
-  l.init_to_zero();
+ulong ModelHawkesFixedSumExpKernLeastSq::get_n_tiles() const {
+  const ulong n_nodes_per_block = get_n_nodes_per_block();
+  const ulong n_blocks = (n_nodes + n_nodes_per_block - 1) / n_nodes_per_block;
+  return n_blocks * (n_blocks + 1) / 2;
+}
 
-  ArrayDouble2d &C_i = C[i];
-  ArrayDouble2d &Dg_i = Dg[i];
-  ArrayDouble2d &Dgg_i = Dgg[i];
-  ArrayDouble2d &E_i = E[i];
-  ArrayDouble &K_i = K[i];
+// Tile (b, b1) computes the weights of all pairs of nodes (i, j) with i in block b and j in
+// block b1 or the reverse. Hence it is the only one to write blocks (i, j) of Q and rows j of C_i
+void ModelHawkesFixedSumExpKernLeastSq::compute_weights_tile(const ulong tile) {
+  const ulong n_nodes_per_block = get_n_nodes_per_block();
+  const ulong n_blocks = (n_nodes + n_nodes_per_block - 1) / n_nodes_per_block;
 
-  ulong N_i = timestamps_i.size();
-  for (ulong k = 0; k < N_i; ++k) {
-    double t_k_i = timestamps_i[k];
+  ulong block = 0, block1 = tile;
+  while (block1 >= n_blocks - block) {
+    block1 -= n_blocks - block;
+    ++block;
+  }
+  block1 += block;
 
-    const ulong p_interval = get_baseline_interval(t_k_i);
-    K_i[p_interval] += 1;
+  const ulong start = block * n_nodes_per_block;
+  const ulong end = std::min(start + n_nodes_per_block, n_nodes);
+  const ulong start1 = block1 * n_nodes_per_block;
+  const ulong end1 = std::min(start1 + n_nodes_per_block, n_nodes);
+
+  if (tile == 0) {
+    for (ulong p = 0; p < n_baselines; ++p) L[p] += get_baseline_interval_length(p);
+  }
+
+  compute_weights_pairs(start, end, start1, end1);
+  if (block != block1) {
+    compute_weights_pairs(start1, end1, start, end);
+  } else {
+    for (ulong i = start; i < end; ++i) compute_weights_node(i);
+  }
+}
 
-    for (ulong j = 0; j < n_nodes; ++j) {
-      ArrayDouble &timestamps_j = *timestamps[j];
-      ulong N_j = timestamps_j.size();
+void ModelHawkesFixedSumExpKernLeastSq::compute_weights_pairs(const ulong start_i,
+                                                              const ulong end_i,
+                                                              const ulong start_j,
+                                                              const ulong end_j) {
+  const ulong n_decays_sq = n_decays * n_decays;
+  const ulong n_j = end_j - start_j;
+
+  ArrayDouble2d H(n_j, n_decays);
+  ArrayULong l(n_j);
+  // E(j, u * n_decays + u1) stores the contribution of the events of i to Q((i, u), (j, u1))
+  ArrayDouble2d E(n_j, n_decays_sq);
+
+  // These factors only depend on the event time, they are shared by all nodes j
+  ArrayDouble decay_factors(n_decays);
+  ArrayDouble end_factors(n_decays_sq);
+
+  for (ulong i = start_i; i < end_i; ++i) {
+    ArrayDouble &timestamps_i = *timestamps[i];
+    ArrayDouble2d &C_i = C[i];
+    H.init_to_zero();
+    l.init_to_zero();
+    E.init_to_zero();
+
+    ulong N_i = timestamps_i.size();
+    for (ulong k = 0; k < N_i; ++k) {
+      double t_k_i = timestamps_i[k];
 
       if (k > 0) {
         double t_k_minus_one_i = timestamps_i[k - 1];
-
         for (ulong u = 0; u < n_decays; ++u) {
-          double decay_u = decays[u];
-          H(j, u) *= cexp(-decay_u * (t_k_i - t_k_minus_one_i));
+          decay_factors[u] = cexp(-decays[u] * (t_k_i - t_k_minus_one_i));
+        }
+      }
+
+      for (ulong u = 0; u < n_decays; ++u) {
+        for (ulong u1 = u; u1 < n_decays; ++u1) {
+          double decay_sum = decays[u] + decays[u1];
+          double tmp = 1 - cexp(-decay_sum * (end_time - t_k_i));
+          end_factors[u * n_decays + u1] = decays[u] / decay_sum * tmp;
+          end_factors[u1 * n_decays + u] = decays[u1] / decay_sum * tmp;
         }
       }
 
-      while (l[j] < N_j && timestamps_j[l[j]] < t_k_i) {
-        double t_l_j = timestamps_j[l[j]];
+      for (ulong j = start_j; j < end_j; ++j) {
+        const ulong local_j = j - start_j;
+        ArrayDouble &timestamps_j = *timestamps[j];
+        ulong N_j = timestamps_j.size();
+        double *H_j = H.data() + local_j * n_decays;
 
-        for (ulong u = 0; u < n_decays; ++u) {
-          double decay_u = decays[u];
-          H(j, u) += decay_u * cexp(-decay_u * (t_k_i - t_l_j));
+        if (k > 0) {
+          for (ulong u = 0; u < n_decays; ++u) H_j[u] *= decay_factors[u];
         }
 
-        l[j] += 1;
+        while (l[local_j] < N_j && timestamps_j[l[local_j]] < t_k_i) {
+          double t_l_j = timestamps_j[l[local_j]];
+
+          for (ulong u = 0; u < n_decays; ++u) {
+            double decay_u = decays[u];
+            H_j[u] += decay_u * cexp(-decay_u * (t_k_i - t_l_j));
+          }
+
+          l[local_j] += 1;
+        }
+
+        double *E_j = E.data() + local_j * n_decays_sq;
+        for (ulong u = 0; u < n_decays; ++u) {
+          C_i(j, u) += H_j[u];
+
+          for (ulong u1 = 0; u1 < n_decays; ++u1) {
+            E_j[u * n_decays + u1] += end_factors[u * n_decays + u1] * H_j[u1];
+          }
+        }
       }
+    }
 
+    // Q is the symmetrized version of E: Q((i, u), (j, u1)) += E(j, u * n_decays + u1) and
+    // Q((j, u1), (i, u)) += E(j, u * n_decays + u1), which is stored in block (min(i, j), max(i, j))
+    for (ulong j = start_j; j < end_j; ++j) {
+      const double *E_j = E.data() + (j - start_j) * n_decays_sq;
+      const ulong block_start = i <= j ? get_Q_block_start(i, j) : get_Q_block_start(j, i);
       for (ulong u = 0; u < n_decays; ++u) {
-        double decay_u = decays[u];
-        C_i(j, u) += H(j, u);
-
         for (ulong u1 = 0; u1 < n_decays; ++u1) {
-          double decay_u1 = decays[u1];
-
-          // we fill E_i,j,u',u
-          double ratio = decay_u1 / (decay_u1 + decay_u);
-          double tmp = 1 - cexp(-(decay_u1 + decay_u) * (end_time - t_k_i));
-          E_i(j, u1 * n_decays + u) += ratio * tmp * H(j, u);
+          const double value = E_j[u * n_decays + u1];
+          const ulong index = block_start + (i <= j ? u * n_decays + u1 : u1 * n_decays + u);
+          const ulong transposed_index = block_start + u1 * n_decays + u;
+          if (float_weights) {
+            Q_float[index] += value;
+            if (i == j) Q_float[transposed_index] += value;
+          } else {
+            Q[index] += value;
+            if (i == j) Q[transposed_index] += value;
+          }
         }
       }
     }
+  }
+}
+
+void ModelHawkesFixedSumExpKernLeastSq::compute_weights_node(const ulong i) {
+  ArrayDouble &timestamps_i = *timestamps[i];
+  ArrayDouble2d &Dg_i = Dg[i];
+  ArrayDouble &K_i = K[i];
+
+  ArrayDouble2d Dgg_i(n_decays, n_decays);
+  Dgg_i.init_to_zero();
 
+  ulong N_i = timestamps_i.size();
+  for (ulong k = 0; k < N_i; ++k) {
+    double t_k_i = timestamps_i[k];
+
+    const ulong p_interval = get_baseline_interval(t_k_i);
+    K_i[p_interval] += 1;
+
+    const ulong n_passed_periods = static_cast<ulong>(std::floor(t_k_i / period_length));
     for (ulong u = 0; u < n_decays; ++u) {
       double decay_u = decays[u];
       ArrayDouble Dg_i_u = view_row(Dg_i, u);
       for (ulong p = 0; p < n_baselines; ++p) {
-        ulong n_passed_periods = static_cast<ulong>(std::floor(t_k_i / period_length));
         double lower = n_passed_periods * period_length + (p * period_length) / n_baselines;
         while (lower < end_time) {
           const double shift_lower = std::max(t_k_i, lower);
@@ -251,7 +370,7 @@ void ModelHawkesFixedSumExpKernLeastSq::compute_weights_i(const ulong i) {
           lower += period_length;
         }
       }
-      for (ulong u1 = 0; u1 < n_decays; ++u1) {
+      for (ulong u1 = u; u1 < n_decays; ++u1) {
         double decay_u1 = decays[u1];
 
         double ratio = decay_u * decay_u1 / (decay_u + decay_u1);
@@ -259,6 +378,19 @@ void ModelHawkesFixedSumExpKernLeastSq::compute_weights_i(const ulong i) {
       }
     }
   }
+
+  // Dgg_i is symmetric and adds to the diagonal block (i, i) of Q
+  const ulong block_start = get_Q_block_start(i, i);
+  for (ulong u = 0; u < n_decays; ++u) {
+    for (ulong u1 = 0; u1 < n_decays; ++u1) {
+      const double value = u <= u1 ? Dgg_i(u, u1) : Dgg_i(u1, u);
+      if (float_weights) {
+        Q_float[block_start + u * n_decays + u1] += value;
+      } else {
+        Q[block_start + u * n_decays + u1] += value;
+      }
+    }
+  }
 }
 
 void ModelHawkesFixedSumExpKernLeastSq::allocate_weights() {
@@ -269,9 +401,18 @@ void ModelHawkesFixedSumExpKernLeastSq::allocate_weights() {
   L = ArrayDouble(n_baselines);
   L.init_to_zero();
 
+  const ulong Q_size = n_nodes * (n_nodes + 1) / 2 * n_decays * n_decays;
+  if (float_weights) {
+    Q = ArrayDouble();
+    Q_float = ArrayFloat(Q_size);
+    Q_float.init_to_zero();
+  } else {
+    Q = ArrayDouble(Q_size);
+    Q.init_to_zero();
+    Q_float = ArrayFloat();
+  }
+
   C = ArrayDouble2dList1D(n_nodes);
-  Dgg = ArrayDouble2dList1D(n_nodes);
-  E = ArrayDouble2dList1D(n_nodes);
   Dg = ArrayDouble2dList1D(n_nodes);
   K = ArrayDoubleList1D(n_nodes);
   for (ulong i = 0; i < n_nodes; ++i) {
@@ -279,27 +420,35 @@ void ModelHawkesFixedSumExpKernLeastSq::allocate_weights() {
     C[i].init_to_zero();
     Dg[i] = ArrayDouble2d(n_decays, n_baselines);
     Dg[i].init_to_zero();
-    Dgg[i] = ArrayDouble2d(n_decays, n_decays);
-    Dgg[i].init_to_zero();
-    E[i] = ArrayDouble2d(n_nodes, n_decays * n_decays);
-    E[i].init_to_zero();
     K[i] = ArrayDouble(n_baselines);
     K[i].init_to_zero();
   }
 }
 
-// Full initialization of the arrays H, Dg, Dg2 and C
+void ModelHawkesFixedSumExpKernLeastSq::compute_weights_worker(const ulong /*thread*/,
+                                                               std::atomic<ulong> &next_tile) {
+  const ulong n_tiles = get_n_tiles();
+  ulong tile;
+  while ((tile = next_tile++) < n_tiles) compute_weights_tile(tile);
+}
+
+// Full initialization of the arrays Q, C, Dg, K and L
 // Must be performed just once
 void ModelHawkesFixedSumExpKernLeastSq::compute_weights() {
   allocate_weights();
-
-  // Multithreaded computation of the arrays
-  parallel_run(get_n_threads(), n_nodes,
-               &ModelHawkesFixedSumExpKernLeastSq::compute_weights_i,
-               this);
+  accumulate_weights();
   weights_computed = true;
 }
 
+void ModelHawkesFixedSumExpKernLeastSq::accumulate_weights() {
+  // The cost of a tile depends on the number of events of its nodes. Hence, tiles are not
+  // split evenly in advance: each thread picks the next tile left as soon as it is done
+  std::atomic<ulong> next_tile(0);
+  parallel_run(get_n_threads(), get_n_threads(),
+               &ModelHawkesFixedSumExpKernLeastSq::compute_weights_worker,
+               this, next_tile);
+}
+
 ulong ModelHawkesFixedSumExpKernLeastSq::get_n_coeffs() const {
   return n_nodes * n_baselines + n_nodes * n_nodes * n_decays;
 }
@@ -337,3 +486,12 @@ void ModelHawkesFixedSumExpKernLeastSq::set_period_length(double period_length)
   this->period_length = period_length;
   weights_computed = false;
 }
+
+bool ModelHawkesFixedSumExpKernLeastSq::get_float_weights() const {
+  return float_weights;
+}
+
+void ModelHawkesFixedSumExpKernLeastSq::set_float_weights(bool float_weights) {
+  this->float_weights = float_weights;
+  weights_computed = false;
+}
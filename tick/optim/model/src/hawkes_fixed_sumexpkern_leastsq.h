@@ -3,6 +3,8 @@
 
 // License: BSD 3 clause
 
+#include <atomic>
+
 #include "base.h"
 #include "base/hawkes_single.h"
 
@@ -12,8 +14,16 @@
  * with fixed beta)
  */
 class DLL_PUBLIC ModelHawkesFixedSumExpKernLeastSq : public ModelHawkesSingle {
+  //! @brief Quadratic form in the adjacency coefficients of a node, indexed by (node, decay)
+  //! pairs. As it is symmetric, only its blocks (j, j1) with j <= j1 are stored, one after the
+  //! other, each block being a n_decays x n_decays matrix stored row by row
+  ArrayDouble Q;
+
+  //! @brief Single precision storage of Q, used instead of Q if float_weights is true
+  ArrayFloat Q_float;
+
   //! @brief Some arrays used for intermediate computings.
-  ArrayDouble2dList1D E, Dgg, C;
+  ArrayDouble2dList1D C;
 
   //! @brief some arrays used for intermediate computings in varying baseline case
   ArrayDouble L;
@@ -29,10 +39,14 @@ class DLL_PUBLIC ModelHawkesFixedSumExpKernLeastSq : public ModelHawkesSingle {
   //! @brief n_decays (number of decays in the sum exponential kernel)
   ulong n_decays;
 
+  //! @brief If true, the quadratic form Q, which is the largest of the weights, is stored in
+  //! single precision
+  bool float_weights;
+
  public:
   //! @brief Default constructor
   //! @note This constructor is only used to create vectors of ModelHawkesFixedExpKernLeastSq
-  ModelHawkesFixedSumExpKernLeastSq() {}
+  ModelHawkesFixedSumExpKernLeastSq() : float_weights(false) {}
 
   //! @brief Constructor
   //! \param timestamps : a list of arrays representing the realization
@@ -41,11 +55,13 @@ class DLL_PUBLIC ModelHawkesFixedSumExpKernLeastSq : public ModelHawkesSingle {
   //! \param max_n_threads : maximum number of threads to be used for multithreading
   //! \param optimization_level : 0 corresponds to no optimization and 1 to use of faster
   //! (approximated) exponential function
+  //! \param float_weights : if true, the largest weights are stored in single precision
   ModelHawkesFixedSumExpKernLeastSq(const ArrayDouble &decays,
                                     const ulong n_baselines,
                                     const double period_length,
                                     const unsigned int max_n_threads = 1,
-                                    const unsigned int optimization_level = 0);
+                                    const unsigned int optimization_level = 0,
+                                    const bool float_weights = false);
 
 
   /**
@@ -101,14 +117,55 @@ class DLL_PUBLIC ModelHawkesFixedSumExpKernLeastSq : public ModelHawkesSingle {
   void set_n_baselines(ulong n_baselines);
   void set_period_length(double period_length);
 
+  bool get_float_weights() const;
+  void set_float_weights(bool float_weights);
+
  private:
   void allocate_weights();
 
   /**
-   * @brief Precomputations of intermediate values for component i
+   * @brief Add the weights of the current data to the allocated weights
+   * \note Weights are computed by tiles of pairs of blocks of nodes, which are distributed
+   * among threads
+   */
+  void accumulate_weights();
+
+  //! @brief Number of nodes in each block of nodes
+  ulong get_n_nodes_per_block() const;
+
+  //! @brief Number of tiles, i.e. of pairs of blocks (b, b1) with b <= b1
+  ulong get_n_tiles() const;
+
+  /**
+   * @brief Add to the weights the contribution of the pairs of nodes of a tile
+   * \param tile : selected tile, between 0 and get_n_tiles()
+   * \note Tiles write disjoint parts of the weights, they can be computed concurrently
+   */
+  void compute_weights_tile(const ulong tile);
+
+  /**
+   * @brief Compute tiles until all of them have been picked
+   * \param thread : index of the thread running this function
+   * \param next_tile : index of the next tile to compute, shared between all threads
+   */
+  void compute_weights_worker(const ulong thread, std::atomic<ulong> &next_tile);
+
+  /**
+   * @brief Add the weights of pairs (i, j) obtained by looping over the events of nodes i
+   * \param start_i, end_i : range of nodes i whose events are looped over
+   * \param start_j, end_j : range of nodes j whose influence is computed at these events
+   */
+  void compute_weights_pairs(const ulong start_i, const ulong end_i,
+                             const ulong start_j, const ulong end_j);
+
+  /**
+   * @brief Add the weights that only depend on the events of node i
    * \param i : selected component
    */
-  void compute_weights_i(const ulong i);
+  void compute_weights_node(const ulong i);
+
+  //! @brief Index in Q of the first element of the block (j, j1), j <= j1
+  ulong get_Q_block_start(const ulong j, const ulong j1) const;
 
   ulong get_baseline_interval(const double t);
   double get_baseline_interval_length(const ulong interval_p);
@@ -0,0 +1,352 @@
+// License: BSD 3 clause
+
+
+#include "hawkes_fixed_sumexpkern_loglik.h"
+
+ModelHawkesFixedSumExpKernLogLik::ModelHawkesFixedSumExpKernLogLik(
+    const ArrayDouble &decays, const int max_n_threads) :
+    ModelHawkesSingle(max_n_threads, 0),
+    decays(decays), n_decays(decays.size()) {}
+
+void ModelHawkesFixedSumExpKernLogLik::compute_weights() {
+  allocate_weights();
+  parallel_run(get_n_threads(), n_nodes,
+               &ModelHawkesFixedSumExpKernLogLik::compute_weights_dim_i, this);
+  weights_computed = true;
+}
+
+void ModelHawkesFixedSumExpKernLogLik::allocate_weights() {
+  if (n_nodes == 0) {
+    TICK_ERROR("Please provide valid timestamps before allocating weights")
+  }
+  g = ArrayDouble2dList1D(n_nodes);
+  G = ArrayDouble2dList1D(n_nodes);
+  sum_G = ArrayDoubleList1D(n_nodes);
+
+  for (ulong i = 0; i < n_nodes; i++) {
+    g[i] = ArrayDouble2d((*n_jumps_per_node)[i], n_nodes * n_decays);
+    G[i] = ArrayDouble2d((*n_jumps_per_node)[i] + 1, n_nodes * n_decays);
+    sum_G[i] = ArrayDouble(n_nodes * n_decays);
+  }
+}
+
+void ModelHawkesFixedSumExpKernLogLik::compute_weights_dim_i(const ulong i) {
+  const ArrayDouble &t_i = *timestamps[i];
+  ArrayDouble2d &g_i = g[i];
+  ArrayDouble2d &G_i = G[i];
+  ArrayDouble &sum_G_i = sum_G[i];
+  sum_G_i.init_to_zero();
+
+  const ulong n_jumps_i = (*n_jumps_per_node)[i];
+  const ulong row_size = n_nodes * n_decays;
+
+  // Rows are filled one after the other: row k is obtained from row k - 1 and the jumps that
+  // occurred in between, hence ij stores the index of the next jump of each component
+  ArrayDouble ebt_k(n_decays);
+  ArrayDouble ebt(n_decays);
+  ArrayULong ij(n_nodes);
+  ij.init_to_zero();
+
+  for (ulong k = 0; k < n_jumps_i + 1; k++) {
+    const double t_i_k = k < n_jumps_i ? t_i[k] : end_time;
+    // G has one more row than g, corresponding to end_time
+    double *g_i_k = k < n_jumps_i ? g_i.data() + k * row_size : nullptr;
+    const double *g_i_k_prev = k > 0 ? g_i.data() + (k - 1) * row_size : nullptr;
+    double *G_i_k = G_i.data() + k * row_size;
+
+    if (k > 0) {
+      const double dt = t_i_k - t_i[k - 1];
+      for (ulong u = 0; u < n_decays; u++) ebt_k[u] = std::exp(-decays[u] * dt);
+    }
+
+    for (ulong j = 0; j < n_nodes; j++) {
+      const ArrayDouble &t_j = *timestamps[j];
+      const ulong j_u = j * n_decays;
+
+      for (ulong u = 0; u < n_decays; u++) {
+        const double g_prev = k > 0 ? g_i_k_prev[j_u + u] : 0;
+        if (g_i_k != nullptr) g_i_k[j_u + u] = g_prev * ebt_k[u];
+        G_i_k[j_u + u] = k > 0 ? g_prev * (1 - ebt_k[u]) / decays[u] : 0;
+      }
+
+      while ((ij[j] < (*n_jumps_per_node)[j]) && (t_j[ij[j]] < t_i_k)) {
+        const double dt = t_i_k - t_j[ij[j]];
+        for (ulong u = 0; u < n_decays; u++) ebt[u] = std::exp(-decays[u] * dt);
+        for (ulong u = 0; u < n_decays; u++) {
+          if (g_i_k != nullptr) g_i_k[j_u + u] += decays[u] * ebt[u];
+          G_i_k[j_u + u] += 1 - ebt[u];
+        }
+        ij[j]++;
+      }
+    }
+
+    for (ulong j_u = 0; j_u < row_size; j_u++) sum_G_i[j_u] += G_i_k[j_u];
+  }
+}
+
+double ModelHawkesFixedSumExpKernLogLik::loss(const ArrayDouble &coeffs) {
+  if (!weights_computed) compute_weights();
+
+  const double loss =
+      parallel_map_additive_reduce(get_n_threads(), n_nodes,
+                                   &ModelHawkesFixedSumExpKernLogLik::loss_dim_i,
+                                   this,
+                                   coeffs);
+  return loss / n_total_jumps;
+}
+
+double ModelHawkesFixedSumExpKernLogLik::loss_i(const ulong sampled_i,
+                                                const ArrayDouble &coeffs) {
+  if (!weights_computed) compute_weights();
+  ulong i = 0;
+  ulong k = 0;
+  sampled_i_to_index(sampled_i, &i, &k);
+
+  return loss_i_k(i, k, coeffs);
+}
+
+void ModelHawkesFixedSumExpKernLogLik::grad(const ArrayDouble &coeffs,
+                                            ArrayDouble &out) {
+  if (!weights_computed) compute_weights();
+  out.fill(0);
+
+  // This allows to run in a multithreaded environment the computation of each component
+  parallel_run(get_n_threads(), n_nodes,
+               &ModelHawkesFixedSumExpKernLogLik::grad_dim_i, this, coeffs, out);
+  out /= n_total_jumps;
+}
+
+void ModelHawkesFixedSumExpKernLogLik::grad_i(const ulong sampled_i,
+                                              const ArrayDouble &coeffs,
+                                              ArrayDouble &out) {
+  if (!weights_computed) compute_weights();
+
+  ulong i = 0;
+  ulong k = 0;
+  sampled_i_to_index(sampled_i, &i, &k);
+
+  // set grad to zero
+  out.fill(0);
+
+  grad_i_k(i, k, coeffs, out);
+}
+
+double ModelHawkesFixedSumExpKernLogLik::loss_and_grad(const ArrayDouble &coeffs,
+                                                       ArrayDouble &out) {
+  if (!weights_computed) compute_weights();
+  out.fill(0);
+
+  const double loss =
+      parallel_map_additive_reduce(get_n_threads(), n_nodes,
+                                   &ModelHawkesFixedSumExpKernLogLik::loss_and_grad_dim_i,
+                                   this,
+                                   coeffs, out);
+  out /= n_total_jumps;
+  return loss / n_total_jumps;
+}
+
+double ModelHawkesFixedSumExpKernLogLik::hessian_norm(const ArrayDouble &coeffs,
+                                                      const ArrayDouble &vector) {
+  if (!weights_computed) compute_weights();
+
+  const double norm_sum =
+      parallel_map_additive_reduce(get_n_threads(), n_nodes,
+                                   &ModelHawkesFixedSumExpKernLogLik::hessian_norm_dim_i,
+                                   this,
+                                   coeffs, vector);
+
+  return norm_sum / n_total_jumps;
+}
+
+void ModelHawkesFixedSumExpKernLogLik::set_decays(const ArrayDouble &decays) {
+  this->decays = decays;
+  n_decays = decays.size();
+  weights_computed = false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                    PRIVATE METHODS
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ModelHawkesFixedSumExpKernLogLik::sampled_i_to_index(const ulong sampled_i,
+                                                          ulong *i,
+                                                          ulong *k) {
+  ulong cum_N_i = 0;
+  for (ulong d = 0; d < n_nodes; d++) {
+    cum_N_i += (*n_jumps_per_node)[d];
+    if (sampled_i < cum_N_i) {
+      *i = d;
+      *k = sampled_i - cum_N_i + (*n_jumps_per_node)[d];
+      break;
+    }
+  }
+}
+
+// Rows of g and G have n_nodes * n_decays entries, plain loops are cheaper than BLAS calls here
+
+double ModelHawkesFixedSumExpKernLogLik::row_dot(const ArrayDouble2d &weights_i, const ulong k,
+                                                 const ArrayDouble &x) const {
+  const ulong row_size = n_nodes * n_decays;
+  const double *weights_i_k = weights_i.data() + k * row_size;
+  double result = 0;
+  for (ulong j_u = 0; j_u < row_size; j_u++) result += x[j_u] * weights_i_k[j_u];
+  return result;
+}
+
+void ModelHawkesFixedSumExpKernLogLik::row_mult_incr(const ArrayDouble2d &weights_i,
+                                                     const ulong k, ArrayDouble &x,
+                                                     const double a) const {
+  const ulong row_size = n_nodes * n_decays;
+  const double *weights_i_k = weights_i.data() + k * row_size;
+  for (ulong j_u = 0; j_u < row_size; j_u++) x[j_u] += a * weights_i_k[j_u];
+}
+
+ArrayDouble ModelHawkesFixedSumExpKernLogLik::get_alpha_i(const ulong i,
+                                                          const ArrayDouble &coeffs) const {
+  const ulong start_alpha_i = n_nodes + i * n_nodes * n_decays;
+  return view(coeffs, start_alpha_i, start_alpha_i + n_nodes * n_decays);
+}
+
+double ModelHawkesFixedSumExpKernLogLik::loss_dim_i(const ulong i,
+                                                    const ArrayDouble &coeffs) {
+  const ArrayDouble mu = view(coeffs, 0, n_nodes);
+  const ArrayDouble alpha_i = get_alpha_i(i, coeffs);
+
+  double loss = 0;
+  loss += end_time * mu[i];
+
+  for (ulong k = 0; k < (*n_jumps_per_node)[i]; ++k) {
+    const double s = mu[i] + row_dot(g[i], k, alpha_i);
+    if (s <= 0) {
+      TICK_ERROR("The sum of the influence on someone cannot be negative. "
+                     "Maybe did you forget to add a positive constraint to "
+                     "your proximal operator");
+    }
+    loss -= log(s);
+  }
+
+  loss += alpha_i.dot(sum_G[i]);
+  return loss;
+}
+
+double ModelHawkesFixedSumExpKernLogLik::loss_i_k(const ulong i,
+                                                  const ulong k,
+                                                  const ArrayDouble &coeffs) {
+  const ArrayDouble mu = view(coeffs, 0, n_nodes);
+  const ArrayDouble alpha_i = get_alpha_i(i, coeffs);
+  double loss = 0;
+
+  const double t_i_k = k == (*n_jumps_per_node)[i] - 1 ? end_time : (*timestamps[i])[k];
+  const double t_i_k_minus_one = k == 0 ? 0 : (*timestamps[i])[k - 1];
+  loss += (t_i_k - t_i_k_minus_one) * mu[i];
+
+  const double s = mu[i] + row_dot(g[i], k, alpha_i);
+
+  if (s <= 0) {
+    TICK_ERROR("The sum of the influence on someone cannot be negative. Maybe did "
+                   "you forget to add a positive constraint to your "
+                   "proximal operator");
+  }
+  loss -= log(s);
+
+  loss += row_dot(G[i], k, alpha_i);
+  if (k == (*n_jumps_per_node)[i] - 1) loss += row_dot(G[i], k + 1, alpha_i);
+  return loss;
+}
+
+void ModelHawkesFixedSumExpKernLogLik::grad_dim_i(const ulong i,
+                                                  const ArrayDouble &coeffs,
+                                                  ArrayDouble &out) {
+  const ArrayDouble mu = view(coeffs, 0, n_nodes);
+  const ArrayDouble alpha_i = get_alpha_i(i, coeffs);
+  ArrayDouble grad_mu = view(out, 0, n_nodes);
+  ArrayDouble grad_alpha_i = get_alpha_i(i, out);
+
+  grad_mu[i] += end_time;
+
+  for (ulong k = 0; k < (*n_jumps_per_node)[i]; ++k) {
+    const double s = mu[i] + row_dot(g[i], k, alpha_i);
+
+    grad_mu[i] -= 1. / s;
+    row_mult_incr(g[i], k, grad_alpha_i, -1. / s);
+  }
+
+  grad_alpha_i.mult_incr(sum_G[i], 1.);
+}
+
+void ModelHawkesFixedSumExpKernLogLik::grad_i_k(const ulong i, const ulong k,
+                                                const ArrayDouble &coeffs,
+                                                ArrayDouble &out) {
+  const ArrayDouble mu = view(coeffs, 0, n_nodes);
+  const ArrayDouble alpha_i = get_alpha_i(i, coeffs);
+  ArrayDouble grad_mu = view(out, 0, n_nodes);
+  ArrayDouble grad_alpha_i = get_alpha_i(i, out);
+
+  const double t_i_k = k == (*n_jumps_per_node)[i] - 1 ? end_time : (*timestamps[i])[k];
+  const double t_i_k_minus_one = k == 0 ? 0 : (*timestamps[i])[k - 1];
+  grad_mu[i] += t_i_k - t_i_k_minus_one;
+
+  const double s = mu[i] + row_dot(g[i], k, alpha_i);
+
+  grad_mu[i] -= 1. / s;
+
+  row_mult_incr(G[i], k, grad_alpha_i, 1.);
+  if (k == (*n_jumps_per_node)[i] - 1) row_mult_incr(G[i], k + 1, grad_alpha_i, 1.);
+  row_mult_incr(g[i], k, grad_alpha_i, -1. / s);
+}
+
+double ModelHawkesFixedSumExpKernLogLik::loss_and_grad_dim_i(const ulong i,
+                                                             const ArrayDouble &coeffs,
+                                                             ArrayDouble &out) {
+  const ArrayDouble mu = view(coeffs, 0, n_nodes);
+  const ArrayDouble alpha_i = get_alpha_i(i, coeffs);
+  ArrayDouble grad_mu = view(out, 0, n_nodes);
+  ArrayDouble grad_alpha_i = get_alpha_i(i, out);
+
+  double loss = 0;
+
+  grad_mu[i] += end_time;
+  loss += end_time * mu[i];
+  for (ulong k = 0; k < (*n_jumps_per_node)[i]; k++) {
+    const double s = mu[i] + row_dot(g[i], k, alpha_i);
+
+    if (s <= 0) {
+      TICK_ERROR("The sum of the influence on someone cannot be negative. Maybe did "
+                     "you forget to add a positive constraint to your "
+                     "proximal operator");
+    }
+    loss -= log(s);
+    grad_mu[i] -= 1. / s;
+
+    row_mult_incr(g[i], k, grad_alpha_i, -1. / s);
+  }
+
+  grad_alpha_i.mult_incr(sum_G[i], 1.);
+  loss += alpha_i.dot(sum_G[i]);
+
+  return loss;
+}
+
+double ModelHawkesFixedSumExpKernLogLik::hessian_norm_dim_i(const ulong i,
+                                                            const ArrayDouble &coeffs,
+                                                            const ArrayDouble &vector) {
+  const ArrayDouble mu = view(coeffs, 0, n_nodes);
+  const ArrayDouble alpha_i = get_alpha_i(i, coeffs);
+  const ArrayDouble d_mu = view(vector, 0, n_nodes);
+  const ArrayDouble d_alpha_i = get_alpha_i(i, vector);
+
+  double hess_norm = 0;
+
+  for (ulong k = 0; k < (*n_jumps_per_node)[i]; k++) {
+    const double S = d_mu[i] + row_dot(g[i], k, d_alpha_i);
+    const double s = mu[i] + row_dot(g[i], k, alpha_i);
+    double tmp = S / s;
+    hess_norm += tmp * tmp;
+  }
+  return hess_norm;
+}
+
+ulong ModelHawkesFixedSumExpKernLogLik::get_n_coeffs() const {
+  return n_nodes + n_nodes * n_nodes * n_decays;
+}
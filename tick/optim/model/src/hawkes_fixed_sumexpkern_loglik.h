@@ -0,0 +1,208 @@
+#ifndef TICK_OPTIM_MODEL_SRC_HAWKES_FIXED_SUMEXPKERN_LOGLIK_H_
+#define TICK_OPTIM_MODEL_SRC_HAWKES_FIXED_SUMEXPKERN_LOGLIK_H_
+
+// License: BSD 3 clause
+
+#include "base.h"
+
+#include "base/hawkes_single.h"
+
+class ModelHawkesFixedSumExpKernLogLikList;
+
+/**
+ * \class ModelHawkesFixedSumExpKernLogLik
+ * \brief Class for computing loglikelihood function and gradient for Hawkes processes with
+ * sum exponential kernels with fixed exponent (i.e., \f$ \sum_u \alpha_u \beta_u
+ * e^{-\beta_u t} \f$, with fixed decays)
+ * \note Coefficients are stored as the baselines followed by the adjacency, where
+ * \f$ \alpha^u_{ij} \f$ is stored at index n_nodes + i * n_nodes * n_decays + j * n_decays + u
+ */
+class DLL_PUBLIC ModelHawkesFixedSumExpKernLogLik : public ModelHawkesSingle {
+ private:
+  //! @brief The array of decays (remember that the decays are fixed!)
+  ArrayDouble decays;
+
+  //! @brief n_decays (number of decays in the sum exponential kernel)
+  ulong n_decays;
+
+  //! @brief Some arrays used for intermediate computings. For component i, row k of g[i]
+  //! (resp. G[i]) is indexed as alpha_i, that is by j * n_decays + u
+  ArrayDouble2dList1D g;
+  ArrayDouble2dList1D G;
+  ArrayDoubleList1D sum_G;
+
+ public:
+  //! @brief Default constructor
+  //! @note This constructor is only used to create vectors of ModelHawkesFixedSumExpKernLogLik
+  ModelHawkesFixedSumExpKernLogLik() : ModelHawkesSingle(), n_decays(0) {}
+
+  /**
+   * @brief Constructor
+   * \param decays : decays of the sum exponential kernels (remember that decays are fixed!)
+   * \param max_n_threads : number of threads that will be used for parallel computations
+   */
+  explicit ModelHawkesFixedSumExpKernLogLik(const ArrayDouble &decays,
+                                            const int max_n_threads = 1);
+
+  /**
+   * @brief Precomputations of intermediate values
+   * They will be used to compute faster loss, gradient and hessian norm.
+   * \note This computation will be needed again if user modifies decays afterwards.
+   */
+  void compute_weights();
+
+  /**
+   * @brief Compute loss and gradient in a single pass over the weights
+   * \param coeffs : Point in which loss and gradient are computed
+   * \param out : Array in which the value of the gradient is stored
+   * \return Loss' value
+   */
+  double loss_and_grad(const ArrayDouble &coeffs, ArrayDouble &out);
+
+  /**
+   * @brief Compute loss
+   * \param coeffs : Point in which loss is computed
+   * \return Loss' value
+   */
+  double loss(const ArrayDouble &coeffs) override;
+
+  /**
+   * @brief Compute loss corresponding to sample i (between 0 and rand_max)
+   * \param i : selected sample
+   * \param coeffs : Point in which loss is computed
+   * \return Loss' value
+   * \note The sample i corresponds to the ith timestamp when looking component per component,
+   * each component being sorted in temporal order
+   */
+  double loss_i(const ulong i, const ArrayDouble &coeffs) override;
+
+  /**
+   * @brief Compute gradient
+   * \param coeffs : Point in which gradient is computed
+   * \param out : Array in which the value of the gradient is stored
+   */
+  void grad(const ArrayDouble &coeffs, ArrayDouble &out) override;
+
+  /**
+   * @brief Compute gradient corresponding to sample i (between 0 and rand_max)
+   * \param i : selected sample
+   * \param coeffs : Point in which gradient is computed
+   * \param out : Array in which the value of the gradient is stored
+   * \note The sample i corresponds to the ith timestamp when looking component per component,
+   * each component being sorted in temporal order
+   */
+  void grad_i(const ulong i, const ArrayDouble &coeffs, ArrayDouble &out) override;
+
+  /**
+   * @brief Compute the hessian norm \f$ \sqrt{ d^T \nabla^2 f(x) d} \f$
+   * \param coeffs : Point in which the hessian is computed (\f$ x \f$)
+   * \param vector : Point of which the norm is computed (\f$ d \f$)
+   */
+  double hessian_norm(const ArrayDouble &coeffs, const ArrayDouble &vector);
+
+ private:
+  void allocate_weights();
+
+  /**
+   * @brief Precomputations of intermediate values for component i
+   * \param i : selected component
+   * \note Rows are computed recursively, which costs O(n_decays) per jump of each component
+   */
+  void compute_weights_dim_i(const ulong i);
+
+  /**
+   * @brief Convert sample i (between 0 and rand_max) to a tuple component, timestamp index
+   * \param samples_d : selected sample
+   * \param i : Where the component will be stored
+   * \param k : Where the timestamp index will be stored
+   */
+  void sampled_i_to_index(const ulong sampled_i, ulong *i, ulong *k);
+
+  //! @brief Dot product of x with row k of g (or G) for component i
+  double row_dot(const ArrayDouble2d &weights_i, const ulong k, const ArrayDouble &x) const;
+
+  //! @brief Add a times row k of g (or G) for component i to x
+  void row_mult_incr(const ArrayDouble2d &weights_i, const ulong k, ArrayDouble &x,
+                     const double a) const;
+
+  //! @brief Returns the adjacency coefficients \f$ \alpha^u_{ij} \f$ of component i
+  ArrayDouble get_alpha_i(const ulong i, const ArrayDouble &coeffs) const;
+
+  /**
+   * @brief Compute loss corresponding to component i
+   * \param i : selected component
+   * \param coeffs : Point in which loss is computed
+   * \return Loss' value
+   */
+  double loss_dim_i(const ulong i, const ArrayDouble &coeffs);
+
+  /**
+   * @brief Compute loss corresponding to timestamp k of component i
+   * \param i : selected component
+   * \param k : selected timestamp index
+   * \param coeffs : Point in which loss is computed
+   * \return Loss' value
+   */
+  double loss_i_k(const ulong i, const ulong k, const ArrayDouble &coeffs);
+
+  /**
+   * @brief Compute gradient corresponding to component i
+   * \param i : selected component
+   * \param coeffs : Point in which gradient is computed
+   * \param out : Array which the result of the gradient will be added to
+   * \note For two different values of i, this function will modify different coordinates of
+   * out. Hence, it is thread safe.
+   */
+  void grad_dim_i(const ulong i, const ArrayDouble &coeffs, ArrayDouble &out);
+
+  /**
+   * @brief Compute gradient corresponding to timestamp k of component i
+   * \param i : selected component
+   * \param k : selected timestamp index
+   * \param coeffs : Point in which gradient is computed
+   * \param out : Array which the result of the gradient will be added to
+   */
+  void grad_i_k(const ulong i, const ulong k, const ArrayDouble &coeffs, ArrayDouble &out);
+
+  /**
+   * @brief Compute loss and gradient corresponding to component i
+   * \param i : selected component
+   * \param coeffs : Point in which loss and gradient are computed
+   * \param out : Array which the result of the gradient will be added to
+   * \return Loss' value
+   * \note For two different values of i, this function will modify different coordinates of
+   * out. Hence, it is thread safe.
+   */
+  double loss_and_grad_dim_i(const ulong i, const ArrayDouble &coeffs, ArrayDouble &out);
+
+  /**
+   * @brief Compute the hessian norm corresponding to component i
+   * \param i : selected component
+   * \param coeffs : Point in which the hessian is computed (\f$ x \f$)
+   * \param vector : Point of which the norm is computed (\f$ d \f$)
+   */
+  double hessian_norm_dim_i(const ulong i, const ArrayDouble &coeffs, const ArrayDouble &vector);
+
+ public:
+  ulong get_n_coeffs() const override;
+
+  //! @brief Returns max of the range of feasible grad_i and loss_i (total number of timestamps)
+  inline ulong get_rand_max() const {
+    return n_total_jumps;
+  }
+
+  /**
+   * @brief Set new decays
+   * \param decays : new decays
+   * \note Weights will need to be recomputed
+   */
+  void set_decays(const ArrayDouble &decays);
+
+  ulong get_n_decays() const {
+    return n_decays;
+  }
+
+  friend ModelHawkesFixedSumExpKernLogLikList;
+};
+
+#endif  // TICK_OPTIM_MODEL_SRC_HAWKES_FIXED_SUMEXPKERN_LOGLIK_H_
@@ -3,6 +3,9 @@
 
 #include "hawkes_utils.h"
 
+#include <functional>
+#include <queue>
+
 
 TimestampListDescriptor describe_timestamps_list(const SArrayDoublePtrList2D &timestamps_list) {
   // Check the number of realizations
@@ -66,3 +69,37 @@ TimestampListDescriptor describe_timestamps_list(const SArrayDoublePtrList2D &ti
 
   return timestamps_list_descriptor;
 }
+
+HawkesEventStream::HawkesEventStream(const SArrayDoublePtrList1D &timestamps) {
+  const ulong n_nodes = timestamps.size();
+  ulong n_events = 0;
+  positions = ArrayULongList1D(n_nodes);
+  for (ulong i = 0; i < n_nodes; ++i) {
+    positions[i] = ArrayULong(timestamps[i]->size());
+    n_events += timestamps[i]->size();
+  }
+  times = ArrayDouble(n_events);
+  nodes = ArrayULong(n_events);
+  indices = ArrayULong(n_events);
+
+  // Nodes are merged with a heap holding the next event of each node, ordered by time and
+  // then by node
+  typedef std::pair<double, ulong> TimeNode;
+  std::priority_queue<TimeNode, std::vector<TimeNode>, std::greater<TimeNode> > next_events;
+  ArrayULong next_indices(n_nodes);
+  next_indices.init_to_zero();
+  for (ulong i = 0; i < n_nodes; ++i) {
+    if (timestamps[i]->size() > 0) next_events.push(TimeNode((*timestamps[i])[0], i));
+  }
+
+  for (ulong e = 0; e < n_events; ++e) {
+    const ulong i = next_events.top().second;
+    next_events.pop();
+    const ulong k = next_indices[i]++;
+    times[e] = (*timestamps[i])[k];
+    nodes[e] = i;
+    indices[e] = k;
+    positions[i][k] = e;
+    if (k + 1 < timestamps[i]->size()) next_events.push(TimeNode((*timestamps[i])[k + 1], i));
+  }
+}
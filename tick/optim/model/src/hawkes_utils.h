@@ -18,4 +18,90 @@ TimestampListDescriptor describe_timestamps_list(const SArrayDoublePtrList2D &ti
 TimestampListDescriptor describe_timestamps_list(const SArrayDoublePtrList2D &timestamps_list,
                                                  const VArrayDoublePtr end_times);
 
+/**
+ * \class CompressedWeights
+ * \brief Row by row compressed storage of Hawkes weights of shape (n_rows, n_cols) in which
+ * only non negligible entries are kept
+ * \note Rows are appended one after the other with push_back and end_row
+ */
+class CompressedWeights {
+  ulong n_cols;
+  std::vector<ulong> row_indices;
+  std::vector<INDICE_TYPE> indices;
+  std::vector<double> data;
+
+ public:
+  explicit CompressedWeights(const ulong n_cols = 0)
+      : n_cols(n_cols), row_indices(1, 0) {}
+
+  //! @brief Add entry (j, value) to the row being filled, j must be increasing within a row
+  inline void push_back(const ulong j, const double value) {
+    indices.push_back(static_cast<INDICE_TYPE>(j));
+    data.push_back(value);
+  }
+
+  //! @brief Close the row being filled
+  inline void end_row() {
+    row_indices.push_back(data.size());
+  }
+
+  //! @brief Release the memory reserved while appending
+  void shrink_to_fit() {
+    row_indices.shrink_to_fit();
+    indices.shrink_to_fit();
+    data.shrink_to_fit();
+  }
+
+  ulong n_rows() const { return row_indices.size() - 1; }
+
+  ulong size_sparse() const { return data.size(); }
+
+  //! @brief Dot product of row k with x
+  inline double row_dot(const ulong k, const double *x) const {
+    double result = 0;
+    for (ulong l = row_indices[k]; l < row_indices[k + 1]; l++) result += x[indices[l]] * data[l];
+    return result;
+  }
+
+  //! @brief Add a times row k to x
+  inline void row_mult_incr(const ulong k, double *x, const double a) const {
+    for (ulong l = row_indices[k]; l < row_indices[k + 1]; l++) x[indices[l]] += a * data[l];
+  }
+};
+
+/**
+ * \class HawkesEventStream
+ * \brief Events of all the nodes of a realization merged in a single stream sorted by time
+ * \note Simultaneous events are sorted by node, events of a node keep their order in the stream.
+ * Back-pointers give the position in the stream of each event of each node
+ */
+class HawkesEventStream {
+  //! @brief Time of each event of the stream
+  ArrayDouble times;
+
+  //! @brief Node of each event of the stream
+  ArrayULong nodes;
+
+  //! @brief Index of each event of the stream among the events of its node
+  ArrayULong indices;
+
+  //! @brief positions[i][k] is the position in the stream of the k-th event of node i
+  ArrayULongList1D positions;
+
+ public:
+  HawkesEventStream() {}
+
+  explicit HawkesEventStream(const SArrayDoublePtrList1D &timestamps);
+
+  ulong size() const { return times.size(); }
+
+  double get_time(const ulong e) const { return times[e]; }
+
+  ulong get_node(const ulong e) const { return nodes[e]; }
+
+  ulong get_index(const ulong e) const { return indices[e]; }
+
+  ulong get_position(const ulong i, const ulong k) const { return positions[i][k]; }
+};
+
 #endif  // TICK_OPTIM_MODEL_SRC_HAWKES_UTILS_H_
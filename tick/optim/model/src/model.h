@@ -46,6 +46,23 @@ class Model {
     TICK_CLASS_DOES_NOT_IMPLEMENT(get_class_name());
   }
 
+  /**
+   * @brief Compute the values of the hessian of a quadratic model, in a layout which is
+   * specific to the model
+   */
+  virtual void hessian(ArrayDouble & /*out*/) {
+    TICK_CLASS_DOES_NOT_IMPLEMENT(get_class_name());
+  }
+
+  /**
+   * @brief Compute the product of the hessian of the model in coeffs with a vector, without
+   * forming the hessian
+   */
+  virtual void hessian_vector_product(const ArrayDouble & /*coeffs*/,
+                                      const ArrayDouble & /*vector*/, ArrayDouble & /*out*/) {
+    TICK_CLASS_DOES_NOT_IMPLEMENT(get_class_name());
+  }
+
   virtual ulong get_epoch_size() const {
     TICK_CLASS_DOES_NOT_IMPLEMENT(get_class_name());
   }
@@ -13,16 +13,23 @@
 ModelSCCS::ModelSCCS(const SBaseArrayDouble2dPtrList1D &features,
                      const SArrayIntPtrList1D &labels,
                      const SBaseArrayULongPtr censoring,
-                     ulong n_lags)
+                     ulong n_lags,
+                     const int n_threads,
+                     const bool implicit_lags)
     : n_intervals(features[0]->n_rows()),
       n_lags(n_lags),
       n_samples(features.size()),
       n_observations(n_samples * n_intervals),
-      n_lagged_features(features[0]->n_cols()),
+      n_lagged_features(implicit_lags ? features[0]->n_cols() * (n_lags + 1)
+                                      : features[0]->n_cols()),
       n_features(n_lags > 0 ? n_lagged_features / (n_lags + 1) : n_lagged_features),
       labels(labels),
       features(features),
-      censoring(censoring) {
+      censoring(censoring),
+      n_threads(n_threads >= 1 ? n_threads : std::thread::hardware_concurrency()),
+      implicit_lags(implicit_lags) {
+  const ulong n_cols = implicit_lags ? n_features : n_lagged_features;
+
   if (n_lags >= n_intervals)
     TICK_ERROR("ModelSCCS requires n_lags < n_intervals");
 
@@ -36,8 +43,8 @@ ModelSCCS::ModelSCCS(const SBaseArrayDouble2dPtrList1D &features,
     if (features[i]->n_rows() != n_intervals)
       TICK_ERROR("All feature matrices should have " << n_intervals << " rows");
 
-    if (features[i]->n_cols() != n_lagged_features)
-      TICK_ERROR("All feature matrices should have " << n_lagged_features << " cols");
+    if (features[i]->n_cols() != n_cols)
+      TICK_ERROR("All feature matrices should have " << n_cols << " cols");
 
     if (labels[i]->size() != n_intervals)
       TICK_ERROR("All labels should have " << n_intervals << " rows");
@@ -45,78 +52,134 @@ ModelSCCS::ModelSCCS(const SBaseArrayDouble2dPtrList1D &features,
 }
 
 double ModelSCCS::loss(const ArrayDouble &coeffs) {
-  double loss = 0;
-  for (ulong i = 0; i < n_samples; ++i)
-    loss += loss_i(i, coeffs);
+  Workspace workspace(n_intervals, 0);
+
+  parallel_map_array<Workspace>(n_threads,
+                                n_samples,
+                                [](Workspace &r, const Workspace &s) { r.loss += s.loss; },
+                                &ModelSCCS::inc_loss_i,
+                                this,
+                                workspace,
+                                coeffs);
 
-  return loss / n_samples;
+  return workspace.loss / n_samples;
 }
 
 double ModelSCCS::loss_i(const ulong i, const ArrayDouble &coeffs) {
-  double loss = 0;
-  ArrayDouble inner_prod(n_intervals), softmax(n_intervals);
-  ulong max_interval = get_max_interval(i);
-
-  for (ulong t = 0; t < max_interval; t++)
-    inner_prod[t] = get_inner_prod(i, t, coeffs);
-  for (ulong t = max_interval; t < n_intervals; t++)
-    inner_prod[t] = 0;
-
-  softMax(inner_prod, softmax);
-
-  for (ulong t = 0; t < max_interval; t++)
-    loss -= get_longitudinal_label(i, t) * log(softmax[t]);
-
-  return loss;
+  ArrayDouble inner_prod(n_intervals);
+  return compute_loss_i(i, coeffs, inner_prod);
 }
 
 void ModelSCCS::grad(const ArrayDouble &coeffs, ArrayDouble &out) {
-  out.init_to_zero();
-  ArrayDouble buffer(out.size());  // is init to 0 in grad_i
+  Workspace workspace(n_intervals, out.size());
 
-  for (ulong i = 0; i < n_samples; ++i) {
-    grad_i(i, coeffs, buffer);
-    out.mult_incr(buffer, 1);
-  }
+  parallel_map_array<Workspace>(n_threads,
+                                n_samples,
+                                [](Workspace &r, const Workspace &s) { r.grad.mult_incr(s.grad, 1.); },
+                                &ModelSCCS::inc_grad_i,
+                                this,
+                                workspace,
+                                coeffs);
 
-  for (ulong j = 0; j < out.size(); ++j) {
-    out[j] /= n_samples;
-  }
+  out.mult_fill(workspace.grad, 1. / n_samples);
 }
 
 void ModelSCCS::grad_i(const ulong i,
                        const ArrayDouble &coeffs,
                        ArrayDouble &out) {
-  out.init_to_zero();
   ArrayDouble inner_prod(n_intervals);
-  ArrayDouble buffer(n_lagged_features);
-  buffer.init_to_zero();
-  ulong max_interval = get_max_interval(i);
+  out.init_to_zero();
+  compute_grad_i(i, coeffs, inner_prod, out);
+}
+
+void ModelSCCS::compute_inner_prods_i(const ulong i, const ArrayDouble &coeffs,
+                                      ArrayDouble &inner_prod) const {
+  const ulong max_interval = get_max_interval(i);
+
+  if (implicit_lags) {
+    inner_prod.init_to_zero();
+    // The exposure of interval s contributes with lag l to interval s + l, hence the inner
+    // products are obtained with a sliding window over the intervals
+    const double *w = coeffs.data();
+    for (ulong s = 0; s < max_interval; s++) {
+      const ulong window = std::min(n_lags + 1, max_interval - s);
+      double *inner_prod_s = inner_prod.data() + s;
+      for_each_exposure(i, s, [=](const ulong feature, const double value) {
+        const double *w_feature = w + feature * (n_lags + 1);
+        for (ulong l = 0; l < window; l++) inner_prod_s[l] += value * w_feature[l];
+      });
+    }
+  } else {
+    for (ulong t = 0; t < max_interval; t++)
+      inner_prod[t] = get_inner_prod(i, t, coeffs);
+    for (ulong t = max_interval; t < n_intervals; t++)
+      inner_prod[t] = 0;
+  }
+}
+
+void ModelSCCS::inc_loss_i(const ulong i, Workspace &workspace, const ArrayDouble &coeffs) {
+  workspace.loss += compute_loss_i(i, coeffs, workspace.inner_prod);
+}
+
+void ModelSCCS::inc_grad_i(const ulong i, Workspace &workspace, const ArrayDouble &coeffs) {
+  compute_grad_i(i, coeffs, workspace.inner_prod, workspace.grad);
+}
 
+double ModelSCCS::compute_loss_i(const ulong i, const ArrayDouble &coeffs,
+                                 ArrayDouble &inner_prod) const {
+  compute_inner_prods_i(i, coeffs, inner_prod);
+
+  // - log(softmax[t]) = log_sum_exp - inner_prod[t]
+  const double log_sum_exp = logSumExp(inner_prod);
+  const ulong max_interval = get_max_interval(i);
+
+  double loss = 0;
   for (ulong t = 0; t < max_interval; t++)
-    inner_prod[t] = get_inner_prod(i, t, coeffs);
+    loss += get_longitudinal_label(i, t) * (log_sum_exp - inner_prod[t]);
 
-  if (max_interval < n_intervals)
-    view(inner_prod, max_interval, n_intervals).fill(0);  // TODO
+  return loss;
+}
 
-  double x_max = inner_prod.max();
-  double sum_exp = sumExpMinusMax(inner_prod, x_max);
+void ModelSCCS::compute_grad_i(const ulong i, const ArrayDouble &coeffs,
+                               ArrayDouble &inner_prod, ArrayDouble &out) const {
+  compute_inner_prods_i(i, coeffs, inner_prod);
+  // Softmax is computed in place
+  ArrayDouble &softmax = inner_prod;
+  softMax(inner_prod, softmax);
 
-  double multiplier = 0;  // need a double instead of long double for mult_incr
-  for (ulong t = 0; t < max_interval; t++) {
-    multiplier =
-        exp(inner_prod[t] - x_max) / sum_exp;  // overflow-proof
-    buffer.mult_incr(get_longitudinal_features(i, t), multiplier);
-  }
+  const ulong max_interval = get_max_interval(i);
 
-  double label = 0;
-  for (ulong t = 0; t < max_interval; t++) {
-    label = get_longitudinal_label(i, t);
-    if (label != 0) {
-      out.mult_add_mult_incr(get_longitudinal_features(i, t),
-                             -label,
-                             buffer,
-                             label);
+  double sum_labels = 0;
+  for (ulong t = 0; t < max_interval; t++)
+    sum_labels += get_longitudinal_label(i, t);
+
+  if (sum_labels == 0) return;
+
+  // The gradient sum_t y_t (sum_s softmax_s x_s - x_t) is accumulated as
+  // sum_t (softmax_t sum_s y_s - y_t) x_t, hence without any dense buffer and only
+  // touching the non-zero entries of each x_t
+  if (implicit_lags) {
+    // Multipliers are stored in place of the softmax
+    ArrayDouble &multipliers = softmax;
+    for (ulong t = 0; t < max_interval; t++)
+      multipliers[t] = softmax[t] * sum_labels - get_longitudinal_label(i, t);
+
+    // Lagged column feature * (n_lags + 1) + l of interval s + l is the raw exposure of
+    // interval s
+    double *out_data = out.data();
+    for (ulong s = 0; s < max_interval; s++) {
+      const ulong window = std::min(n_lags + 1, max_interval - s);
+      const double *multipliers_s = multipliers.data() + s;
+      for_each_exposure(i, s, [=](const ulong feature, const double value) {
+        double *out_feature = out_data + feature * (n_lags + 1);
+        for (ulong l = 0; l < window; l++) out_feature[l] += value * multipliers_s[l];
+      });
+    }
+  } else {
+    for (ulong t = 0; t < max_interval; t++) {
+      const double multiplier = softmax[t] * sum_labels - get_longitudinal_label(i, t);
+      if (multiplier != 0)
+        out.mult_incr(get_longitudinal_features(i, t), multiplier);
     }
   }
 }
@@ -136,10 +199,14 @@ void ModelSCCS::compute_lip_consts() {
       // Lipschitz constant = 0 if Y_{sample, t} = 0
       if (get_longitudinal_label(sample, t) > 0) {
         for (ulong k = 0; k < max_interval; k++) {
-          other_row = get_longitudinal_features(sample, k);
-          sq_norm = 0;
-          for (ulong feature = 0; feature < n_lagged_features; feature++) {
-            sq_norm += pow(row.value(feature) - other_row.value(feature), 2.0);
+          if (implicit_lags) {
+            sq_norm = lagged_sq_dist(sample, t, k);
+          } else {
+            other_row = get_longitudinal_features(sample, k);
+            sq_norm = 0;
+            for (ulong feature = 0; feature < n_lagged_features; feature++) {
+              sq_norm += pow(row.value(feature) - other_row.value(feature), 2.0);
+            }
           }
           max_sq_norm = sq_norm > max_sq_norm ? sq_norm : max_sq_norm;
         }
@@ -149,9 +216,39 @@ void ModelSCCS::compute_lip_consts() {
   }
 }
 
+double ModelSCCS::lagged_sq_dist(const ulong i, const ulong t, const ulong k) const {
+  // Lag l of intervals t and k are the raw exposures of intervals t - l and k - l (zero if
+  // these intervals are negative)
+  double sq_norm = 0;
+  for (ulong l = 0; l <= n_lags; l++) {
+    const bool has_t = l <= t, has_k = l <= k;
+    if (!has_t && !has_k) break;
+    BaseArrayDouble row, other_row;
+    if (has_t) row = get_longitudinal_features(i, t - l);
+    if (has_k) other_row = get_longitudinal_features(i, k - l);
+    for (ulong feature = 0; feature < n_features; feature++) {
+      const double diff = (has_t ? row.value(feature) : 0) -
+          (has_k ? other_row.value(feature) : 0);
+      sq_norm += diff * diff;
+    }
+  }
+  return sq_norm;
+}
+
 double ModelSCCS::get_inner_prod(const ulong i,
                                  const ulong t,
                                  const ArrayDouble &coeffs) const {
+  if (implicit_lags) {
+    // As with LongitudinalFeaturesLagger, lagged features are zero after censoring
+    if (t >= get_max_interval(i)) return 0;
+    double inner_prod = 0;
+    for (ulong l = 0; l <= std::min(n_lags, t); l++) {
+      for_each_exposure(i, t - l, [&](const ulong feature, const double value) {
+        inner_prod += value * coeffs[feature * (n_lags + 1) + l];
+      });
+    }
+    return inner_prod;
+  }
   BaseArrayDouble sample = get_longitudinal_features(i, t);
   return sample.dot(coeffs);
 }
@@ -28,11 +28,92 @@ class DLL_PUBLIC ModelSCCS : public ModelLipschitz  {
   // Censoring vectors
   SBaseArrayULongPtr censoring;
 
+  unsigned int n_threads;
+
+  /**
+   * If true, features are the raw exposures of shape (n_intervals, n_features) and the lagged
+   * features (of shape (n_intervals, n_features * (n_lags + 1))) are never materialized: the
+   * column feature * (n_lags + 1) + lag of the lagged row t is the raw exposure of row t - lag.
+   */
+  bool implicit_lags;
+
+  /**
+   * Calls f(feature, value) for each non-zero entry of the features of patient i at interval t
+   */
+  template <typename F>
+  inline void for_each_exposure(const ulong i, const ulong t, F f) const {
+    const BaseArrayDouble x_t = get_longitudinal_features(i, t);
+    const ulong n_values = x_t.size_data();
+    const double *values = x_t.data();
+    const INDICE_TYPE *indices = x_t.is_sparse() ? x_t.indices() : nullptr;
+    for (ulong k = 0; k < n_values; ++k) {
+      if (values[k] != 0) f(indices == nullptr ? k : indices[k], values[k]);
+    }
+  }
+
+  /**
+   * Squared euclidean distance between the lagged features of patient i at intervals t and k,
+   * computed from the raw exposures (used when implicit_lags is true)
+   */
+  double lagged_sq_dist(const ulong i, const ulong t, const ulong k) const;
+
+  /**
+   * Thread local buffers used to compute the loss and the gradient of a patient. They are
+   * allocated once per thread instead of once per patient.
+   */
+  struct Workspace {
+    //! Inner products of the patient intervals, then their softmax
+    ArrayDouble inner_prod;
+    //! Accumulated gradient (empty when only the loss is computed)
+    ArrayDouble grad;
+    //! Accumulated loss
+    double loss;
+
+    Workspace() : loss(0) {}
+    Workspace(ulong n_intervals, ulong n_coeffs)
+        : inner_prod(n_intervals), grad(n_coeffs), loss(0) {
+      grad.init_to_zero();
+    }
+  };
+
+  /**
+   * Fills inner_prod with the inner products of the intervals of patient i (0 for censored
+   * intervals)
+   */
+  void compute_inner_prods_i(const ulong i, const ArrayDouble &coeffs,
+                             ArrayDouble &inner_prod) const;
+
+  /**
+   * Computes the loss of patient i, using inner_prod (of size n_intervals) as buffer
+   */
+  double compute_loss_i(const ulong i, const ArrayDouble &coeffs, ArrayDouble &inner_prod) const;
+
+  /**
+   * Increments out with the gradient of patient i, using inner_prod (of size n_intervals)
+   * as buffer
+   */
+  void compute_grad_i(const ulong i, const ArrayDouble &coeffs, ArrayDouble &inner_prod,
+                      ArrayDouble &out) const;
+
+  /**
+   * Adds the loss of patient i to workspace.loss
+   * \note workspace is the second argument as this is necessary for parallel_map_array
+   */
+  void inc_loss_i(const ulong i, Workspace &workspace, const ArrayDouble &coeffs);
+
+  /**
+   * Adds the gradient of patient i to workspace.grad
+   * \note workspace is the second argument as this is necessary for parallel_map_array
+   */
+  void inc_grad_i(const ulong i, Workspace &workspace, const ArrayDouble &coeffs);
+
  public:
   ModelSCCS(const SBaseArrayDouble2dPtrList1D &features,
                           const SArrayIntPtrList1D &labels,
                           const SBaseArrayULongPtr censoring,
-                          ulong n_lags);
+                          ulong n_lags,
+                          const int n_threads = 1,
+                          const bool implicit_lags = false);
 
   const char *get_class_name() const override {
     return "LongitudinalMultinomial";
@@ -68,6 +149,12 @@ class DLL_PUBLIC ModelSCCS : public ModelLipschitz  {
 
   bool is_sparse() const override { return false; }
 
+  bool get_implicit_lags() const { return implicit_lags; }
+
+  /**
+   * Returns the features of patient i at interval t, namely the raw exposures (not lagged) if
+   * implicit_lags is true
+   */
   inline BaseArrayDouble get_longitudinal_features(ulong i,
                                                    ulong t) const {
     return view_row(*features[i], t);
@@ -81,9 +168,15 @@ class DLL_PUBLIC ModelSCCS : public ModelLipschitz  {
                         const ulong t,
                         const ArrayDouble &coeffs) const;
 
+  unsigned int get_n_threads() const { return n_threads; }
+
+  void set_n_threads(unsigned int n_threads) { this->n_threads = n_threads; }
+
   static inline double sumExpMinusMax(ArrayDouble &x, double x_max) {
+    const double *x_data = x.data();
+    const ulong size = x.size();
     double sum = 0;
-    for (ulong i = 0; i < x.size(); ++i) sum += exp(x[i] - x_max);  // overflow-proof
+    for (ulong i = 0; i < size; ++i) sum += exp(x_data[i] - x_max);  // overflow-proof
     return sum;
   }
 
@@ -92,12 +185,23 @@ class DLL_PUBLIC ModelSCCS : public ModelLipschitz  {
     return x_max + log(sumExpMinusMax(x, x_max));
   }
 
-  static inline void softMax(ArrayDouble &x, ArrayDouble &out) {
-    double x_max = x.max();
-    double sum = sumExpMinusMax(x, x_max);
-    for (ulong i = 0; i < x.size(); i++) {
-      out[i] = exp(x[i] - x_max) / sum;  // overflow-proof
+  /**
+   * Computes the softmax of x in out (which can be x itself) and returns the log-sum-exp of x.
+   * Exponentials are computed only once, in branch-free loops so that they can be vectorized.
+   */
+  static inline double softMax(ArrayDouble &x, ArrayDouble &out) {
+    const double x_max = x.max();
+    const double *x_data = x.data();
+    double *out_data = out.data();
+    const ulong size = x.size();
+    double sum = 0;
+    for (ulong i = 0; i < size; i++) {
+      out_data[i] = exp(x_data[i] - x_max);  // overflow-proof
+      sum += out_data[i];
     }
+    const double one_over_sum = 1. / sum;
+    for (ulong i = 0; i < size; i++) out_data[i] *= one_over_sum;
+    return x_max + log(sum);
   }
 };
 
@@ -0,0 +1,249 @@
+// License: BSD 3 clause
+
+#include "hawkes_fixed_expkern_leastsq_binned.h"
+#include "hawkes_utils.h"
+
+namespace {
+
+//! @brief Expected value of e^{-beta (b - t)} for t uniformly distributed in [b - dt, b]
+double expected_bin_decay(const double beta, const double dt) {
+  const double x = beta * dt;
+  return x < 1e-8 ? 1 - x / 2 : -std::expm1(-x) / x;
+}
+
+//! @brief Add the events to the counts of the bins dividing [0, end_time] in which they occur
+void count_events(const ArrayDouble &timestamps, const double end_time, ArrayDouble &counts) {
+  const ulong n_bins = counts.size();
+  const double dt = end_time / n_bins;
+  for (ulong k = 0; k < timestamps.size(); ++k) {
+    counts[std::min(static_cast<ulong>(timestamps[k] / dt), n_bins - 1)] += 1;
+  }
+}
+
+/**
+ * @brief Sum over the bins of counts[b] * E[e^{-beta (end_time - t)}], t being uniformly
+ * distributed in bin b
+ */
+double binned_decayed_sum(const ArrayDouble &counts, const double dt, const double beta) {
+  const double bin_decay = std::exp(-beta * dt);
+  // Sum decayed up to the end of the current bin
+  double sum = 0;
+  for (ulong b = 0; b < counts.size(); ++b) sum = sum * bin_decay + counts[b];
+  return sum * expected_bin_decay(beta, dt);
+}
+
+/**
+ * @brief Binned approximation of \sum_{t_k^i} \sum_{t_l^j < t_k^i} beta e^{-beta (t_k^i - t_l^j)}
+ * computed by recursive filtering over the bins
+ * \param counts_i, counts_j : number of events of nodes i and j in each bin
+ * \param same_node : true if i == j, events are then not paired with themselves
+ * \param dt : size of the bins
+ * \param beta : decay of the kernel
+ * \param gamma : if positive, the same sum in which each term is also multiplied by
+ * e^{-gamma (end_time - t_k^i)} is stored in decayed_convolution
+ * \return the sum
+ */
+double binned_convolution(const ArrayDouble &counts_i, const ArrayDouble &counts_j,
+                          const bool same_node, const double dt, const double beta,
+                          const double gamma, double &decayed_convolution) {
+  const double x = beta * dt;
+  const double bin_decay = std::exp(-x);
+  // Expected value of beta e^{-beta (t - s)} 1_{s < t} for s and t uniformly distributed in the
+  // same bin
+  const double same_bin_weight =
+      x < 1e-3 ? beta * (0.5 - x / 6 + x * x / 24) : beta * (x + std::expm1(-x)) / (x * x);
+  // Expected value of beta e^{-beta (t - s)} for s and t uniformly distributed in consecutive
+  // bins, farther bins being accounted for with bin_decay
+  const double bin_weight = expected_bin_decay(beta, dt);
+  const double other_bin_weight = beta * bin_weight * bin_weight;
+
+  const double gamma_bin_decay = std::exp(-gamma * dt);
+  const double self_pair = same_node ? 1 : 0;
+
+  double convolution = 0;
+  decayed_convolution = 0;
+  // Counts of node j in previous bins, decayed up to the previous bin
+  double previous_counts_j = 0;
+  for (ulong b = 0; b < counts_i.size(); ++b) {
+    double term = 0;
+    if (counts_i[b] > 0) {
+      term = counts_i[b] * (same_bin_weight * (counts_j[b] - self_pair)
+          + other_bin_weight * previous_counts_j);
+      convolution += term;
+    }
+    // Sum decayed up to the end of the current bin
+    decayed_convolution = decayed_convolution * gamma_bin_decay + term;
+    previous_counts_j = previous_counts_j * bin_decay + counts_j[b];
+  }
+  decayed_convolution *= expected_bin_decay(gamma, dt);
+  return convolution;
+}
+
+}  // namespace
+
+ModelHawkesFixedExpKernLeastSqBinned::ModelHawkesFixedExpKernLeastSqBinned(
+    const SArrayDouble2dPtr decays,
+    const double bin_size,
+    const int max_n_threads)
+    : ModelHawkesLeastSqList(max_n_threads, 0),
+      decays(decays), bin_size(bin_size) {
+  if (bin_size <= 0) TICK_ERROR("bin_size must be positive, got " << bin_size);
+  aggregated_model = std::unique_ptr<ModelHawkesFixedExpKernLeastSq>(
+      new ModelHawkesFixedExpKernLeastSq(decays, max_n_threads, 0));
+}
+
+void ModelHawkesFixedExpKernLeastSqBinned::hessian(ArrayDouble &out) {
+  if (!weights_computed) compute_weights();
+  auto *casted_model = static_cast<ModelHawkesFixedExpKernLeastSq *>(aggregated_model.get());
+  casted_model->hessian(out);
+}
+
+void ModelHawkesFixedExpKernLeastSqBinned::set_decays(const SArrayDouble2dPtr decays) {
+  weights_computed = false;
+  if (decays->n_rows() != n_nodes || decays->n_cols() != n_nodes) {
+    TICK_ERROR("decays must be (" << n_nodes << ", " << n_nodes << ") array"
+                                  << " but recevied a (" << decays->n_rows() << ", "
+                                  << decays->n_cols() << ") array");
+  }
+  this->decays = decays;
+}
+
+void ModelHawkesFixedExpKernLeastSqBinned::set_decays(const double decay) {
+  SArrayDouble2dPtr decays = SArrayDouble2d::new_ptr(n_nodes, n_nodes);
+  decays->fill(decay);
+  set_decays(decays);
+}
+
+ulong ModelHawkesFixedExpKernLeastSqBinned::get_n_bins(const double end_time) const {
+  return std::max(static_cast<ulong>(std::ceil(end_time / bin_size)), 1ul);
+}
+
+void ModelHawkesFixedExpKernLeastSqBinned::set_data(const SArrayDoublePtrList2D &timestamps_list,
+                                                    const VArrayDoublePtr end_times) {
+  const auto timestamps_list_descriptor = describe_timestamps_list(timestamps_list, end_times);
+  n_realizations = timestamps_list_descriptor.n_realizations;
+  set_n_nodes(timestamps_list_descriptor.n_nodes);
+  n_jumps_per_node = timestamps_list_descriptor.n_jumps_per_node;
+  n_jumps_per_realization = timestamps_list_descriptor.n_jumps_per_realization;
+  this->end_times = end_times;
+
+  // Only the counts of events in each bin are kept
+  counts_list = ArrayDouble2dList1D(n_realizations);
+  for (ulong r = 0; r < n_realizations; ++r) {
+    counts_list[r] = ArrayDouble2d(n_nodes, get_n_bins((*end_times)[r]));
+    counts_list[r].init_to_zero();
+  }
+  parallel_run(get_n_threads(), n_realizations * n_nodes,
+               &ModelHawkesFixedExpKernLeastSqBinned::count_events_ri, this, timestamps_list);
+
+  weights_computed = false;
+}
+
+void ModelHawkesFixedExpKernLeastSqBinned::count_events_ri(
+    const ulong r_i, const SArrayDoublePtrList2D &timestamps_list) {
+  const ulong r = r_i / n_nodes;
+  const ulong i = r_i % n_nodes;
+  ArrayDouble counts_ri = view_row(counts_list[r], i);
+  count_events(*timestamps_list[r][i], (*end_times)[r], counts_ri);
+}
+
+// Nodes are computed in parallel, realizations being summed one after the other
+void ModelHawkesFixedExpKernLeastSqBinned::compute_weights_timestamps_list() {
+  parallel_run(std::min(max_n_threads, static_cast<unsigned int>(n_nodes)), n_nodes,
+               &ModelHawkesFixedExpKernLeastSqBinned::compute_weights_i, this);
+}
+
+void ModelHawkesFixedExpKernLeastSqBinned::compute_weights_i(const ulong i) {
+  for (ulong r = 0; r < counts_list.size(); ++r) {
+    add_weights_i(i, counts_list[r], (*end_times)[r]);
+  }
+}
+
+void ModelHawkesFixedExpKernLeastSqBinned::compute_weights_timestamps(
+    const SArrayDoublePtrList1D &timestamps, double end_time) {
+  ArrayDouble2d counts(n_nodes, get_n_bins(end_time));
+  counts.init_to_zero();
+  for (ulong i = 0; i < n_nodes; ++i) {
+    ArrayDouble counts_i = view_row(counts, i);
+    count_events(*timestamps[i], end_time, counts_i);
+  }
+  parallel_run(std::min(max_n_threads, static_cast<unsigned int>(n_nodes)), n_nodes,
+               &ModelHawkesFixedExpKernLeastSqBinned::add_weights_i, this, counts, end_time);
+}
+
+// Binned counterpart of ModelHawkesFixedExpKernLeastSq::compute_weights_i
+void ModelHawkesFixedExpKernLeastSqBinned::add_weights_i(const ulong i,
+                                                         ArrayDouble2d &counts,
+                                                         const double end_time) {
+  const double dt = end_time / counts.n_cols();
+  const ArrayDouble counts_i = view_row(counts, i);
+  ArrayDouble Dg_i = view_row(Dg, i);
+  ArrayDouble Dg2_i = view_row(Dg2, i);
+  ArrayDouble C_i = view_row(C, i);
+
+  for (ulong j = 0; j < n_nodes; ++j) {
+    const ArrayDouble counts_j = view_row(counts, j);
+    const double n_events_j = counts_j.sum();
+    const double beta_ij = (*decays)(i, j);
+
+    Dg_i[j] += n_events_j - binned_decayed_sum(counts_j, dt, beta_ij);
+    Dg2_i[j] += beta_ij * (n_events_j - binned_decayed_sum(counts_j, dt, 2 * beta_ij)) / 2;
+
+    double unused;
+    C_i[j] += binned_convolution(counts_i, counts_j, i == j, dt, beta_ij, 0, unused);
+
+    // Here we compute E(j1,i,j), which only depends on the decays of j1 with i and j
+    const ulong index = i * n_nodes + j;
+    double last_beta_j1_i = 0, last_beta_j1_j = 0, last_E_j1_ij = 0;
+    for (ulong j1 = 0; j1 < n_nodes; j1++) {
+      const double beta_j1_i = (*decays)(j1, i);
+      const double beta_j1_j = (*decays)(j1, j);
+      if (j1 == 0 || beta_j1_i != last_beta_j1_i || beta_j1_j != last_beta_j1_j) {
+        double decayed_convolution;
+        const double convolution = binned_convolution(counts_i, counts_j, i == j, dt, beta_j1_j,
+                                                      beta_j1_i + beta_j1_j, decayed_convolution);
+        const double r = beta_j1_i / (beta_j1_i + beta_j1_j);
+        last_E_j1_ij = r * (convolution - decayed_convolution);
+        last_beta_j1_i = beta_j1_i;
+        last_beta_j1_j = beta_j1_j;
+      }
+      E(j1, index) += last_E_j1_ij;
+    }
+  }
+}
+
+void ModelHawkesFixedExpKernLeastSqBinned::allocate_weights() {
+  Dg = ArrayDouble2d(n_nodes, n_nodes);
+  Dg.init_to_zero();
+  Dg2 = ArrayDouble2d(n_nodes, n_nodes);
+  Dg2.init_to_zero();
+  C = ArrayDouble2d(n_nodes, n_nodes);
+  C.init_to_zero();
+  E = ArrayDouble2d(n_nodes, n_nodes * n_nodes);
+  E.init_to_zero();
+
+  weights_allocated = true;
+}
+
+void ModelHawkesFixedExpKernLeastSqBinned::synchronize_aggregated_model() {
+  auto *casted_model = static_cast<ModelHawkesFixedExpKernLeastSq *>(aggregated_model.get());
+
+  casted_model->set_n_nodes(n_nodes);
+  casted_model->max_n_threads = max_n_threads;
+
+  // We make views to avoid copies
+  casted_model->Dg = view(Dg);
+  casted_model->Dg2 = view(Dg2);
+  casted_model->C = view(C);
+  casted_model->E = view(E);
+  casted_model->end_time = end_times->sum();
+
+  casted_model->n_total_jumps = n_jumps_per_realization->sum();
+  casted_model->n_jumps_per_node = n_jumps_per_node;
+
+  casted_model->weights_computed = weights_computed;
+}
+
+ulong ModelHawkesFixedExpKernLeastSqBinned::get_n_coeffs() const {
+  return n_nodes + n_nodes * n_nodes;
+}
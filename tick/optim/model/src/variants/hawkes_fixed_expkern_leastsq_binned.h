@@ -0,0 +1,109 @@
+#ifndef TICK_OPTIM_MODEL_SRC_VARIANTS_HAWKES_FIXED_EXPKERN_LEASTSQ_BINNED_H_
+#define TICK_OPTIM_MODEL_SRC_VARIANTS_HAWKES_FIXED_EXPKERN_LEASTSQ_BINNED_H_
+
+// License: BSD 3 clause
+
+#include "base.h"
+#include "hawkes_leastsq_list.h"
+#include "../hawkes_fixed_expkern_leastsq.h"
+
+/** \class ModelHawkesFixedExpKernLeastSqBinned
+ * \brief Approximation of the L2 Contrast function of ModelHawkesFixedExpKernLeastSqList
+ * computed from the number of events of each node on a uniform grid, instead of the events
+ * themselves
+ * \note Each realization is divided in bins of equal size, events being considered as uniformly
+ * distributed in their bin. Weights are then computed by recursive filtering over the grid, in
+ * O(n_bins) per pair of nodes whatever the number of events. The bias of the approximation
+ * vanishes as the size of the bins goes to 0
+ */
+class DLL_PUBLIC ModelHawkesFixedExpKernLeastSqBinned : public ModelHawkesLeastSqList {
+  //! @brief Some arrays used for intermediate computings. They are initialized in init()
+  ArrayDouble2d E, Dg, Dg2, C;
+
+  //! @brief The 2d array of decays (remember that the decays are fixed!)
+  SArrayDouble2dPtr decays;
+
+  //! @brief Maximum size of the bins, each realization is divided in bins of equal size
+  double bin_size;
+
+  //! @brief Number of events of each node (rows) in each bin (columns) of each realization
+  ArrayDouble2dList1D counts_list;
+
+ public:
+  //! @brief Constructor
+  //! \param decays : the 2d array of the decays
+  //! \param bin_size : maximum size of the bins
+  //! \param max_n_threads : number of cores to be used for multithreading. If negative,
+  //! the number of physical cores will be used
+  ModelHawkesFixedExpKernLeastSqBinned(const SArrayDouble2dPtr decays,
+                                       const double bin_size,
+                                       const int max_n_threads = 1);
+
+  /**
+   * @brief Compute the hessian of the loss, which does not depend on the coefficients
+   * \param out : Array of size n_nodes * (n_nodes + 1)^2 in which the non-zero values of the
+   * hessian are added, row by row in the order of the coefficients (all baselines, then the
+   * adjacency matrix row by row). The row of mu_i or of alpha_ij holds n_nodes + 1 values, its
+   * derivatives with respect to mu_i, alpha_i1, ..., alpha_in
+   * \note : We only fill data, python code takes care of creating index and indexptr
+   */
+  void hessian(ArrayDouble &out) override;
+
+  /**
+   * @brief Set decays and reset weights computing
+   * @param decays : new decays to be set
+   */
+  void set_decays(const SArrayDouble2dPtr decays);
+
+  /**
+   * @brief Set the same decay for all kernels and reset weights computing
+   * @param decay : new decay to be set
+   */
+  void set_decays(const double decay);
+
+  /**
+   * @brief Set the data of the model
+   * \param timestamps_list : the timestamps of each node of each realization
+   * \param end_times : end time of each realization
+   * \note Events are counted in each bin, in parallel, and are not kept afterwards
+   */
+  void set_data(const SArrayDoublePtrList2D &timestamps_list, const VArrayDoublePtr end_times);
+
+  double get_bin_size() const { return bin_size; }
+
+  //! @brief Returns the number of bins in which a realization ending at end_time is divided
+  ulong get_n_bins(const double end_time) const;
+
+  ulong get_n_coeffs() const override;
+
+ private:
+  /**
+   * @brief Count the events of a node of a realization in each bin
+   * \param r_i : r * n_nodes + i, tells which realization and which node
+   * \param timestamps_list : the timestamps of each node of each realization
+   */
+  void count_events_ri(const ulong r_i, const SArrayDoublePtrList2D &timestamps_list);
+
+  //! @brief Compute the weights of node i, summed over all realizations
+  void compute_weights_i(const ulong i);
+
+  /**
+   * @brief Add the weights of node i on a realization to the weights of this instance
+   * \param i : selected node
+   * \param counts : number of events of each node in each bin of the realization
+   * \param end_time : end time of the realization
+   */
+  void add_weights_i(const ulong i, ArrayDouble2d &counts, const double end_time);
+
+  //! @brief allocate arrays to store precomputations
+  void allocate_weights() override;
+
+  //! @brief synchronize aggregate_model with this instance
+  void synchronize_aggregated_model() override;
+
+  void compute_weights_timestamps_list() override;
+  void compute_weights_timestamps(const SArrayDoublePtrList1D &timestamps,
+                                  double end_time) override;
+};
+
+#endif  // TICK_OPTIM_MODEL_SRC_VARIANTS_HAWKES_FIXED_EXPKERN_LEASTSQ_BINNED_H_
@@ -18,46 +18,173 @@ void ModelHawkesFixedExpKernLeastSqList::hessian(ArrayDouble &out) {
   casted_model->hessian(out);
 }
 
-void ModelHawkesFixedExpKernLeastSqList::compute_weights_i_r(
-    const ulong i_r, std::vector<ModelHawkesFixedExpKernLeastSq> &model_list) {
-  const ulong r = static_cast<const ulong>(i_r / n_nodes);
-  const ulong i = i_r % n_nodes;
+void ModelHawkesFixedExpKernLeastSqList::set_decays(const SArrayDouble2dPtr decays) {
+  weights_computed = false;
+  if (decays->n_rows() != n_nodes || decays->n_cols() != n_nodes) {
+    TICK_ERROR("decays must be (" << n_nodes << ", " << n_nodes << ") array"
+                                  << " but recevied a (" << decays->n_rows() << ", "
+                                  << decays->n_cols() << ") array");
+  }
+  this->decays = decays;
+  if (load_cached_weights()) synchronize_aggregated_model();
+}
 
-  model_list[r].compute_weights_i(i);
+void ModelHawkesFixedExpKernLeastSqList::set_decays(const double decay) {
+  SArrayDouble2dPtr decays = SArrayDouble2d::new_ptr(n_nodes, n_nodes);
+  decays->fill(decay);
+  set_decays(decays);
 }
 
-void ModelHawkesFixedExpKernLeastSqList::compute_weights_timestamps_list() {
-  auto model_list =
-      std::vector<ModelHawkesFixedExpKernLeastSq>(n_realizations);
+void ModelHawkesFixedExpKernLeastSqList::set_data(const SArrayDoublePtrList2D &timestamps_list,
+                                                  const VArrayDoublePtr end_times) {
+  ModelHawkesList::set_data(timestamps_list, end_times);
+  cached_decays = ArrayDouble(0);
+  cached_E.clear();
+  cached_Dg.clear();
+  cached_Dg2.clear();
+  cached_C.clear();
+}
 
+void ModelHawkesFixedExpKernLeastSqList::compute_weights_for_decays(const ArrayDouble &decays) {
+  if (n_realizations == 0 || timestamps_list.size() != n_realizations) {
+    TICK_ERROR("Weights can be precomputed for several decays only for data given with "
+                   "set_data");
+  }
+  for (ulong d = 0; d < decays.size(); d++) {
+    if (decays[d] <= 0) TICK_ERROR("decays must be positive, got " << decays[d]);
+  }
+
+  auto model_list = std::vector<ModelHawkesFixedExpKernLeastSq>(n_realizations);
   for (ulong r = 0; r < n_realizations; ++r) {
-    model_list[r] = ModelHawkesFixedExpKernLeastSq(decays, 1, optimization_level);
+    model_list[r] = ModelHawkesFixedExpKernLeastSq(this->decays, 1, optimization_level);
     model_list[r].set_data(timestamps_list[r], (*end_times)[r]);
-    model_list[r].allocate_weights();
   }
 
-  // Multithreaded computation of the arrays
-  parallel_run(get_n_threads(), n_realizations * n_nodes,
-               &ModelHawkesFixedExpKernLeastSqList::compute_weights_i_r, this, model_list);
+  cached_decays = decays;
+  const auto zeros = [this](const ulong n_cols) {
+    ArrayDouble2d array(n_nodes, n_cols);
+    array.init_to_zero();
+    return array;
+  };
+  cached_E = std::vector<ArrayDouble2d>(decays.size(), zeros(n_nodes * n_nodes));
+  cached_Dg = std::vector<ArrayDouble2d>(decays.size(), zeros(n_nodes));
+  cached_Dg2 = std::vector<ArrayDouble2d>(decays.size(), zeros(n_nodes));
+  cached_C = std::vector<ArrayDouble2d>(decays.size(), zeros(n_nodes));
+
+  // Nodes are computed in parallel, realizations being summed one after the other
+  parallel_run(std::min(max_n_threads, static_cast<unsigned int>(n_nodes)), n_nodes,
+               &ModelHawkesFixedExpKernLeastSqList::compute_weights_for_decays_i, this,
+               model_list);
+
+  if (load_cached_weights()) synchronize_aggregated_model();
+}
+
+void ModelHawkesFixedExpKernLeastSqList::compute_weights_for_decays_i(
+    const ulong i, std::vector<ModelHawkesFixedExpKernLeastSq> &model_list) {
+  for (auto &model : model_list) {
+    model.compute_weights_i_for_decays(i, cached_decays, cached_E, cached_Dg, cached_Dg2,
+                                       cached_C);
+  }
+}
+
+bool ModelHawkesFixedExpKernLeastSqList::load_cached_weights() {
+  if (cached_decays.size() == 0 || decays == nullptr || decays->size() == 0) return false;
+  const double decay = (*decays)[0];
+  for (ulong k = 1; k < decays->size(); k++) {
+    if ((*decays)[k] != decay) return false;
+  }
 
-  for (ulong r = 0; r < n_realizations; ++r) {
-    Dg.mult_incr(model_list[r].Dg, 1);
-    Dg2.mult_incr(model_list[r].Dg2, 1);
-    C.mult_incr(model_list[r].C, 1);
-    E.mult_incr(model_list[r].E, 1);
+  for (ulong d = 0; d < cached_decays.size(); d++) {
+    if (cached_decays[d] != decay) continue;
+
+    // Copies, as E, Dg, Dg2 and C are incremented by incremental_set_data
+    E = cached_E[d];
+    Dg = cached_Dg[d];
+    Dg2 = cached_Dg2[d];
+    C = cached_C[d];
+    weights_allocated = true;
+    weights_computed = true;
+    return true;
+  }
+  return false;
+}
+
+SArrayDoublePtr ModelHawkesFixedExpKernLeastSqList::get_cached_decays() const {
+  SArrayDoublePtr decays = SArrayDouble::new_ptr(cached_decays.size());
+  if (cached_decays.size() > 0) decays->mult_fill(cached_decays, 1.);
+  return decays;
+}
+
+// Each task accumulates the weights of a contiguous block of (realization, node) pairs in its
+// own model, as compute_weights_i only adds to the weights. Partial weights are then summed
+// pairwise, hence memory depends on the number of threads but not on the number of
+// realizations
+void ModelHawkesFixedExpKernLeastSqList::compute_weights_timestamps_list() {
+  const unsigned int n_tasks = get_n_threads();
+
+  auto partial_models = std::vector<ModelHawkesFixedExpKernLeastSq>(n_tasks);
+  for (unsigned int task = 0; task < n_tasks; ++task) {
+    ModelHawkesFixedExpKernLeastSq &model = partial_models[task];
+    model = ModelHawkesFixedExpKernLeastSq(decays, 1, optimization_level);
+    model.set_n_nodes(n_nodes);
+    // The first model directly accumulates in the weights of this instance, hence with one
+    // thread weights are the same as the ones obtained with incremental_set_data
+    if (task == 0) {
+      set_weights_views(model);
+    } else {
+      model.allocate_weights();
+    }
+  }
+
+  parallel_run(n_tasks, n_tasks,
+               &ModelHawkesFixedExpKernLeastSqList::compute_weights_task, this, partial_models);
+
+  for (ulong step = 1; step < n_tasks; step *= 2) {
+    const ulong n_sums = (n_tasks + 2 * step - 1) / (2 * step);
+    parallel_run(n_tasks, n_sums, &ModelHawkesFixedExpKernLeastSqList::sum_partial_weights,
+                 this, step, partial_models);
+  }
+}
+
+void ModelHawkesFixedExpKernLeastSqList::compute_weights_task(
+    const ulong task, std::vector<ModelHawkesFixedExpKernLeastSq> &partial_models) {
+  ulong min_i_r{}, max_i_r{};
+  std::tie(min_i_r, max_i_r) =
+      tick::get_thread_indices(task, partial_models.size(), n_realizations * n_nodes);
+
+  ModelHawkesFixedExpKernLeastSq &model = partial_models[task];
+  for (ulong i_r = min_i_r; i_r < max_i_r; ++i_r) {
+    const ulong r = i_r / n_nodes;
+    const ulong i = i_r % n_nodes;
+
+    // Only the data changes, weights keep on being accumulated
+    if (i_r == min_i_r || i == 0) model.set_data(timestamps_list[r], (*end_times)[r]);
+    model.compute_weights_i(i);
   }
 }
 
+void ModelHawkesFixedExpKernLeastSqList::sum_partial_weights(
+    const ulong k, const ulong step, std::vector<ModelHawkesFixedExpKernLeastSq> &partial_models) {
+  const ulong task = 2 * step * k;
+  if (task + step >= partial_models.size()) return;
+
+  ModelHawkesFixedExpKernLeastSq &model = partial_models[task];
+  ModelHawkesFixedExpKernLeastSq &other_model = partial_models[task + step];
+  model.Dg.mult_incr(other_model.Dg, 1);
+  model.Dg2.mult_incr(other_model.Dg2, 1);
+  model.C.mult_incr(other_model.C, 1);
+  model.E.mult_incr(other_model.E, 1);
+}
+
 void ModelHawkesFixedExpKernLeastSqList::compute_weights_timestamps(
     const SArrayDoublePtrList1D &timestamps, double end_time) {
   auto model = ModelHawkesFixedExpKernLeastSq(decays, get_n_threads(), optimization_level);
   model.set_data(timestamps, end_time);
-  model.compute_weights();
 
-  Dg.mult_incr(model.Dg, 1);
-  Dg2.mult_incr(model.Dg2, 1);
-  C.mult_incr(model.C, 1);
-  E.mult_incr(model.E, 1);
+  // The weights of this realization are directly added to the weights of this instance
+  set_weights_views(model);
+  parallel_run(model.get_n_threads(), n_nodes, &ModelHawkesFixedExpKernLeastSq::compute_weights_i,
+               &model);
 }
 
 void ModelHawkesFixedExpKernLeastSqList::allocate_weights() {
@@ -73,17 +200,21 @@ void ModelHawkesFixedExpKernLeastSqList::allocate_weights() {
   weights_allocated = true;
 }
 
+// We make views to avoid copies
+void ModelHawkesFixedExpKernLeastSqList::set_weights_views(ModelHawkesFixedExpKernLeastSq &model) {
+  model.Dg = view(Dg);
+  model.Dg2 = view(Dg2);
+  model.C = view(C);
+  model.E = view(E);
+}
+
 void ModelHawkesFixedExpKernLeastSqList::synchronize_aggregated_model() {
   auto *casted_model = static_cast<ModelHawkesFixedExpKernLeastSq *>(aggregated_model.get());
 
   casted_model->set_n_nodes(n_nodes);
   casted_model->max_n_threads = max_n_threads;
 
-  // We make views to avoid copies
-  casted_model->Dg = view(Dg);
-  casted_model->Dg2 = view(Dg2);
-  casted_model->C = view(C);
-  casted_model->E = view(E);
+  set_weights_views(*casted_model);
   casted_model->end_time = end_times->sum();
 
   casted_model->n_total_jumps = n_jumps_per_realization->sum();
@@ -19,6 +19,13 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLeastSqList : public ModelHawkesLeastSqL
   //! @brief The 2d array of decays (remember that the decays are fixed!)
   SArrayDouble2dPtr decays;
 
+  //! @brief Decays for which weights have been precomputed by compute_weights_for_decays
+  ArrayDouble cached_decays;
+
+  //! @brief E, Dg, Dg2 and C precomputed for each decay of cached_decays, summed over all
+  //! realizations
+  std::vector<ArrayDouble2d> cached_E, cached_Dg, cached_Dg2, cached_C;
+
  public:
   //! @brief Constructor
   //! \param decays : the 2d array of the decays
@@ -35,33 +42,71 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLeastSqList : public ModelHawkesLeastSqL
    * \param out : Array in which the value of the hessian is stored
    * \note : We only fill data, python code takes care of creating index and indexptr
    */
-  void hessian(ArrayDouble &out);
+  void hessian(ArrayDouble &out) override;
 
   /**
    * @brief Set decays and reset weights computing
    * @param decays : new decays to be set
    */
-  void set_decays(const SArrayDouble2dPtr decays) {
-    weights_computed = false;
-    if (decays->n_rows() != n_nodes || decays->n_cols() != n_nodes) {
-      TICK_ERROR("decays must be (" << n_nodes << ", " << n_nodes << ") array"
-                                    << " but recevied a (" << decays->n_rows() << ", "
-                                    << decays->n_cols() << ") array");
-    }
-    this->decays = decays;
-  }
+  void set_decays(const SArrayDouble2dPtr decays);
+
+  /**
+   * @brief Set the same decay for all kernels and reset weights computing
+   * @param decay : new decay to be set
+   */
+  void set_decays(const double decay);
+
+  void set_data(const SArrayDoublePtrList2D &timestamps_list, const VArrayDoublePtr end_times);
+
+  /**
+   * @brief Precomputations of intermediate values for several decays in a single pass over
+   * each realization, each decay being shared by all kernels.
+   * Afterwards, setting decays to one of these values does not trigger any computation.
+   * \param decays : decays for which weights are precomputed
+   * \note Exponentials are always computed exactly, whatever optimization_level is
+   */
+  void compute_weights_for_decays(const ArrayDouble &decays);
+
+  //! @brief Returns the decays for which weights have been precomputed
+  SArrayDoublePtr get_cached_decays() const;
 
   ulong get_n_coeffs() const override;
 
  private:
   /**
-   * @brief Compute weights for one index between 0 and n_realizations * n_nodes
-   * @param i_r : r * n_realizations + i, tells which realization and which node
-   * @param model_list : list of models on which to compute and store weights. Only model_list[r]
-   * will be modified
+   * @brief Compute weights of a block of indices between 0 and n_realizations * n_nodes
+   * (r * n_nodes + i tells which realization and which node)
+   * @param task : index of the block, between 0 and partial_models.size()
+   * @param partial_models : models in which weights are accumulated, one per block. Only
+   * partial_models[task] will be modified
    */
-  void compute_weights_i_r(const ulong i_r,
-                           std::vector<ModelHawkesFixedExpKernLeastSq> &model_list);
+  void compute_weights_task(const ulong task,
+                            std::vector<ModelHawkesFixedExpKernLeastSq> &partial_models);
+
+  /**
+   * @brief Add the weights of partial_models[2 * step * k + step] to those of
+   * partial_models[2 * step * k], if it exists
+   */
+  void sum_partial_weights(const ulong k, const ulong step,
+                           std::vector<ModelHawkesFixedExpKernLeastSq> &partial_models);
+
+  /**
+   * @brief Compute weights of all cached decays for node i, summed over all realizations
+   * @param i : selected node
+   * @param model_list : list of models holding each realization
+   */
+  void compute_weights_for_decays_i(const ulong i,
+                                    std::vector<ModelHawkesFixedExpKernLeastSq> &model_list);
+
+  /**
+   * @brief Copy the weights precomputed for the current decays in E, Dg, Dg2 and C
+   * \return false if decays are not all equal or if weights have not been precomputed for
+   * their value
+   */
+  bool load_cached_weights();
+
+  //! @brief Make the weights of the given model views on the weights of this instance
+  void set_weights_views(ModelHawkesFixedExpKernLeastSq &model);
 
   //! @brief allocate arrays to store precomputations
   void allocate_weights() override;
@@ -0,0 +1,261 @@
+// License: BSD 3 clause
+
+#include "hawkes_fixed_expkern_leastsq_online.h"
+
+ModelHawkesFixedExpKernLeastSqOnline::ModelHawkesFixedExpKernLeastSqOnline(
+    const double decay, const double window_length, const int max_n_threads)
+    : ModelHawkes(max_n_threads, 0), decay(decay), window_length(window_length),
+      end_time(0) {
+  if (decay <= 0) TICK_ERROR("decay must be positive, got " << decay);
+}
+
+void ModelHawkesFixedExpKernLeastSqOnline::clear() {
+  end_time = 0;
+  head.init(n_nodes);
+  tail.init(n_nodes);
+  window_events.clear();
+
+  n_jumps_per_node = SArrayULong::new_ptr(n_nodes);
+  n_jumps_per_node->init_to_zero();
+
+  SArrayDouble2dPtr decays = SArrayDouble2d::new_ptr(n_nodes, n_nodes);
+  decays->fill(decay);
+  aggregated_model = ModelHawkesFixedExpKernLeastSq(decays, max_n_threads);
+  weights_computed = false;
+}
+
+void ModelHawkesFixedExpKernLeastSqOnline::set_data(const SArrayDoublePtrList1D &timestamps,
+                                                    const double end_time) {
+  set_n_nodes(timestamps.size());
+  clear();
+  append(timestamps, end_time);
+}
+
+void ModelHawkesFixedExpKernLeastSqOnline::append(const SArrayDoublePtrList1D &timestamps,
+                                                  const double end_time) {
+  if (n_nodes == 0) {
+    set_n_nodes(timestamps.size());
+    clear();
+  }
+  if (timestamps.size() != n_nodes) {
+    TICK_ERROR("Your realization should have " << n_nodes << " nodes but has "
+                                               << timestamps.size() << ".");
+  }
+  if (end_time < this->end_time) {
+    TICK_ERROR("Provided end_time (" << end_time << ") is smaller than previous end_time ("
+                                     << this->end_time << ")");
+  }
+  for (ulong i = 0; i < n_nodes; ++i) {
+    const ArrayDouble &timestamps_i = *timestamps[i];
+    if (timestamps_i.size() == 0) continue;
+    if (timestamps_i[0] < this->end_time) {
+      TICK_ERROR("Appended timestamps of component " << i << " start at " << timestamps_i[0]
+                                                     << ", before previous end_time ("
+                                                     << this->end_time << ")");
+    }
+    if (timestamps_i[timestamps_i.size() - 1] > end_time) {
+      TICK_ERROR("Provided end_time (" << end_time << ") is smaller than last time of "
+                                       << "component " << i << " ("
+                                       << timestamps_i[timestamps_i.size() - 1] << ")");
+    }
+  }
+
+  // Events of all nodes are added in temporal order
+  std::vector<ulong> next(n_nodes, 0);
+  while (true) {
+    ulong node = n_nodes;
+    double t = 0;
+    for (ulong i = 0; i < n_nodes; ++i) {
+      if (next[i] < timestamps[i]->size()
+          && (node == n_nodes || (*timestamps[i])[next[i]] < t)) {
+        node = i;
+        t = (*timestamps[i])[next[i]];
+      }
+    }
+    if (node == n_nodes) break;
+
+    if (next[node] > 0 && t < (*timestamps[node])[next[node] - 1]) {
+      TICK_ERROR("Appended timestamps of component " << node << " are not sorted");
+    }
+    head.add_event(node, t, decay);
+    if (window_length > 0) window_events.emplace_back(t, node);
+    (*n_jumps_per_node)[node] += 1;
+    next[node]++;
+  }
+
+  this->end_time = end_time;
+
+  // Events leaving the window are removed from the loss
+  while (!window_events.empty() && window_events.front().first <= end_time - window_length) {
+    const ulong node = window_events.front().second;
+    tail.add_event(node, window_events.front().first, decay);
+    (*n_jumps_per_node)[node] -= 1;
+    window_events.pop_front();
+  }
+
+  weights_computed = false;
+}
+
+void ModelHawkesFixedExpKernLeastSqOnline::compute_weights() {
+  if (n_nodes == 0) {
+    TICK_ERROR("Please provide valid timestamps before computing weights")
+  }
+
+  Dg = ArrayDouble2d(n_nodes, n_nodes);
+  Dg.init_to_zero();
+  Dg2 = ArrayDouble2d(n_nodes, n_nodes);
+  Dg2.init_to_zero();
+  C = ArrayDouble2d(n_nodes, n_nodes);
+  C.init_to_zero();
+  E = ArrayDouble2d(n_nodes, n_nodes * n_nodes);
+  E.init_to_zero();
+
+  // Weights are integrals over [0, end_time] hence weights of the window are the difference
+  // of the weights of all events and of the weights of the events that have left the window
+  head.add_weights(end_time, decay, 1., Dg, Dg2, C, E);
+  if (window_length > 0 && end_time > window_length) {
+    tail.add_weights(end_time - window_length, decay, -1., Dg, Dg2, C, E);
+  }
+
+  weights_computed = true;
+  synchronize_aggregated_model();
+}
+
+void ModelHawkesFixedExpKernLeastSqOnline::synchronize_aggregated_model() {
+  aggregated_model.set_n_nodes(n_nodes);
+  aggregated_model.max_n_threads = max_n_threads;
+
+  // We make views to avoid copies
+  aggregated_model.Dg = view(Dg);
+  aggregated_model.Dg2 = view(Dg2);
+  aggregated_model.C = view(C);
+  aggregated_model.E = view(E);
+  aggregated_model.end_time =
+      window_length > 0 ? std::min(end_time, window_length) : end_time;
+
+  aggregated_model.n_total_jumps = n_jumps_per_node->sum();
+  aggregated_model.n_jumps_per_node = n_jumps_per_node;
+
+  aggregated_model.weights_computed = weights_computed;
+}
+
+double ModelHawkesFixedExpKernLeastSqOnline::loss(const ArrayDouble &coeffs) {
+  if (!weights_computed) compute_weights();
+  return aggregated_model.loss(coeffs);
+}
+
+double ModelHawkesFixedExpKernLeastSqOnline::loss_i(const ulong i, const ArrayDouble &coeffs) {
+  if (!weights_computed) compute_weights();
+  return aggregated_model.loss_i(i, coeffs);
+}
+
+void ModelHawkesFixedExpKernLeastSqOnline::grad(const ArrayDouble &coeffs, ArrayDouble &out) {
+  if (!weights_computed) compute_weights();
+  aggregated_model.grad(coeffs, out);
+}
+
+void ModelHawkesFixedExpKernLeastSqOnline::grad_i(const ulong i, const ArrayDouble &coeffs,
+                                                  ArrayDouble &out) {
+  if (!weights_computed) compute_weights();
+  aggregated_model.grad_i(i, coeffs, out);
+}
+
+double ModelHawkesFixedExpKernLeastSqOnline::loss_and_grad(const ArrayDouble &coeffs,
+                                                           ArrayDouble &out) {
+  if (!weights_computed) compute_weights();
+  return aggregated_model.loss_and_grad(coeffs, out);
+}
+
+void ModelHawkesFixedExpKernLeastSqOnline::hessian(ArrayDouble &out) {
+  if (!weights_computed) compute_weights();
+  aggregated_model.hessian(out);
+}
+
+ulong ModelHawkesFixedExpKernLeastSqOnline::get_n_coeffs() const {
+  return n_nodes + n_nodes * n_nodes;
+}
+
+void ModelHawkesFixedExpKernLeastSqOnline::RunningWeights::init(const ulong n_nodes) {
+  time = 0;
+  n_jumps = ArrayULong(n_nodes);
+  n_jumps.init_to_zero();
+  decayed_sum = ArrayDouble(n_nodes);
+  decayed_sum.init_to_zero();
+  decayed_sum_2 = ArrayDouble(n_nodes);
+  decayed_sum_2.init_to_zero();
+  pending_nodes.clear();
+  influence_sum = ArrayDouble2d(n_nodes, n_nodes);
+  influence_sum.init_to_zero();
+  decayed_influence_sum = ArrayDouble2d(n_nodes, n_nodes);
+  decayed_influence_sum.init_to_zero();
+  row_time = ArrayDouble(n_nodes);
+  row_time.init_to_zero();
+}
+
+// Same computations as ModelHawkesFixedExpKernLeastSq::compute_weights_i_for_decays, event per
+// event: the influence of node j on an event at time t only involves the events of node j
+// strictly before t, which are accumulated in decayed_sum[j]
+void ModelHawkesFixedExpKernLeastSqOnline::RunningWeights::add_event(const ulong node,
+                                                                     const double t,
+                                                                     const double decay) {
+  const ulong n_nodes = n_jumps.size();
+  if (t > time) {
+    for (const ulong j : pending_nodes) {
+      decayed_sum[j] += 1;
+      decayed_sum_2[j] += 1;
+    }
+    pending_nodes.clear();
+
+    const double ebt = std::exp(-decay * (t - time));
+    decayed_sum *= ebt;
+    decayed_sum_2 *= ebt * ebt;
+    time = t;
+  }
+
+  ArrayDouble influence_sum_node = view_row(influence_sum, node);
+  ArrayDouble decayed_influence_sum_node = view_row(decayed_influence_sum, node);
+  const double row_decay = std::exp(-2 * decay * (t - row_time[node]));
+  for (ulong j = 0; j < n_nodes; ++j) {
+    const double influence = decay * decayed_sum[j];
+    influence_sum_node[j] += influence;
+    decayed_influence_sum_node[j] = decayed_influence_sum_node[j] * row_decay + influence;
+  }
+  row_time[node] = t;
+
+  n_jumps[node] += 1;
+  pending_nodes.push_back(node);
+}
+
+void ModelHawkesFixedExpKernLeastSqOnline::RunningWeights::add_weights(
+    const double t, const double decay, const double sign, ArrayDouble2d &Dg,
+    ArrayDouble2d &Dg2, ArrayDouble2d &C, ArrayDouble2d &E) const {
+  const ulong n_nodes = n_jumps.size();
+
+  ArrayDouble sum_t = decayed_sum;
+  ArrayDouble sum_2_t = decayed_sum_2;
+  for (const ulong j : pending_nodes) {
+    sum_t[j] += 1;
+    sum_2_t[j] += 1;
+  }
+  const double ebt = std::exp(-decay * (t - time));
+
+  // Dg and Dg2 do not depend on i, E(j1, i * n_nodes + j) does not depend on j1
+  ArrayDouble Dg_j(n_nodes), Dg2_j(n_nodes), E_i_j(n_nodes * n_nodes);
+  for (ulong j = 0; j < n_nodes; ++j) {
+    Dg_j[j] = n_jumps[j] - sum_t[j] * ebt;
+    Dg2_j[j] = decay * (n_jumps[j] - sum_2_t[j] * ebt * ebt) / 2;
+  }
+  for (ulong i = 0; i < n_nodes; ++i) {
+    const double row_decay = std::exp(-2 * decay * (t - row_time[i]));
+    for (ulong j = 0; j < n_nodes; ++j) {
+      C(i, j) += sign * influence_sum(i, j);
+      E_i_j[i * n_nodes + j] =
+          (influence_sum(i, j) - decayed_influence_sum(i, j) * row_decay) / 2;
+    }
+    view_row(Dg, i).mult_incr(Dg_j, sign);
+    view_row(Dg2, i).mult_incr(Dg2_j, sign);
+  }
+  for (ulong j1 = 0; j1 < n_nodes; ++j1) {
+    view_row(E, j1).mult_incr(E_i_j, sign);
+  }
+}
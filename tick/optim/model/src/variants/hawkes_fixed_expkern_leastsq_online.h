@@ -0,0 +1,187 @@
+#ifndef TICK_OPTIM_MODEL_SRC_VARIANTS_HAWKES_FIXED_EXPKERN_LEASTSQ_ONLINE_H_
+#define TICK_OPTIM_MODEL_SRC_VARIANTS_HAWKES_FIXED_EXPKERN_LEASTSQ_ONLINE_H_
+
+// License: BSD 3 clause
+
+#include <deque>
+
+#include "base.h"
+#include "../base/hawkes_model.h"
+#include "../hawkes_fixed_expkern_leastsq.h"
+
+/** \class ModelHawkesFixedExpKernLeastSqOnline
+ * \brief Class for computing L2 Contrast function and gradient for Hawkes processes with
+ * exponential kernels with fixed exponent (i.e., alpha*beta*e^{-beta t}, with fixed beta) on a
+ * realization whose events are appended while it is being observed
+ * \note All kernels share the same decay. The weights E, Dg, Dg2 and C of
+ * ModelHawkesFixedExpKernLeastSq are then additive over time and are derived from a few
+ * running sums, updated in O(n_nodes) per appended event. If a window length is given, only
+ * the events (and the integral of the intensity) of the last window_length units of time are
+ * accounted for in the loss, the intensity still depending on all past events.
+ */
+class DLL_PUBLIC ModelHawkesFixedExpKernLeastSqOnline : public ModelHawkes {
+  /**
+   * Running sums describing the events observed up to a given time, from which the weights
+   * of the least squares loss are derived at any later time
+   */
+  struct RunningWeights {
+    //! @brief Time of the last event added
+    double time;
+
+    //! @brief Number of events of each node added so far
+    ArrayULong n_jumps;
+
+    //! @brief For each node j, \f$ \sum_l e^{-\beta (time - t^j_l)} \f$ and
+    //! \f$ \sum_l e^{-2 \beta (time - t^j_l)} \f$ over its events strictly before time
+    ArrayDouble decayed_sum, decayed_sum_2;
+
+    //! @brief Nodes having an event at time, that are not yet in the decayed sums
+    std::vector<ulong> pending_nodes;
+
+    //! @brief For each event \f$ t^i_k \f$ of node i, sum over k of the influence of node j at
+    //! \f$ t^i_k \f$ (row i, column j), without decay and with a decay of rate 2 beta
+    //! accumulated up to row_time[i]
+    ArrayDouble2d influence_sum, decayed_influence_sum;
+    ArrayDouble row_time;
+
+    void init(const ulong n_nodes);
+
+    void add_event(const ulong node, const double t, const double decay);
+
+    /**
+     * @brief Add the weights of a model fitted on the events added so far, with end_time t,
+     * multiplied by sign, to Dg, Dg2, C and E (in the layout of ModelHawkesFixedExpKernLeastSq)
+     */
+    void add_weights(const double t, const double decay, const double sign,
+                     ArrayDouble2d &Dg, ArrayDouble2d &Dg2, ArrayDouble2d &C,
+                     ArrayDouble2d &E) const;
+  };
+
+  //! @brief The decay shared by all kernels (remember that the decay is fixed!)
+  double decay;
+
+  //! @brief Length of the window of events taken into account, if positive
+  double window_length;
+
+  //! @brief Current end time of the observation
+  double end_time;
+
+  //! @brief Running sums of all events appended so far
+  RunningWeights head;
+
+  //! @brief Running sums of the events that have left the window
+  RunningWeights tail;
+
+  //! @brief Events (time, node) appended that have not left the window yet
+  std::deque<std::pair<double, ulong>> window_events;
+
+  //! @brief Weights in the layout of ModelHawkesFixedExpKernLeastSq
+  ArrayDouble2d E, Dg, Dg2, C;
+
+  //! @brief model used to compute loss, gradient and hessian from the weights
+  ModelHawkesFixedExpKernLeastSq aggregated_model;
+
+ public:
+  //! @brief Constructor
+  //! \param decay : the decay shared by all kernels
+  //! \param window_length : length of the sliding window of events used in the loss. If not
+  //! positive, all events since time 0 are used
+  //! \param max_n_threads : maximum number of threads to be used for multithreading
+  explicit ModelHawkesFixedExpKernLeastSqOnline(const double decay,
+                                                const double window_length = 0,
+                                                const int max_n_threads = 1);
+
+  /**
+   * @brief Set the data of the model, discarding all events appended so far
+   * \param timestamps : the timestamps of each node
+   * \param end_time : end time of the observation
+   */
+  void set_data(const SArrayDoublePtrList1D &timestamps, const double end_time);
+
+  /**
+   * @brief Append newly observed events and move forward the end time of the observation
+   * \param timestamps : the new timestamps of each node, sorted and not smaller than the
+   * previous end time
+   * \param end_time : new end time of the observation
+   * \note This costs O(n_nodes) per appended event, whatever the number of events observed
+   * before
+   */
+  void append(const SArrayDoublePtrList1D &timestamps, const double end_time);
+
+  /**
+   * @brief Derive the weights of the least squares loss from the running sums
+   * \note This costs O(n_nodes^3), whatever the number of events observed
+   */
+  void compute_weights();
+
+  /**
+   * @brief Compute loss
+   * \param coeffs : Point in which loss is computed
+   * \return Loss' value
+   */
+  double loss(const ArrayDouble &coeffs) override;
+
+  /**
+   * @brief Compute loss corresponding to sample i (between 0 and rand_max = dim)
+   * \param i : selected dimension
+   * \param coeffs : Point in which loss is computed
+   * \return Loss' value
+   */
+  double loss_i(const ulong i, const ArrayDouble &coeffs) override;
+
+  /**
+   * @brief Compute gradient
+   * \param coeffs : Point in which gradient is computed
+   * \param out : Array in which the value of the gradient is stored
+   */
+  void grad(const ArrayDouble &coeffs, ArrayDouble &out) override;
+
+  /**
+   * @brief Compute gradient corresponding to sample i (between 0 and rand_max = dim)
+   * \param i : selected dimension
+   * \param coeffs : Point in which gradient is computed
+   * \param out : Array in which the value of the gradient is stored
+   */
+  void grad_i(const ulong i, const ArrayDouble &coeffs, ArrayDouble &out) override;
+
+  /**
+   * @brief Compute loss and gradient
+   * \param coeffs : Point in which loss and gradient are computed
+   * \param out : Array in which the value of the gradient is stored
+   * \return Loss' value
+   */
+  double loss_and_grad(const ArrayDouble &coeffs, ArrayDouble &out);
+
+  /**
+   * @brief Compute hessian
+   * \param out : Array in which the value of the hessian is stored
+   * \note : We only fill data, python code takes care of creating index and indexptr
+   */
+  void hessian(ArrayDouble &out) override;
+
+  double get_decay() const {
+    return decay;
+  }
+
+  double get_window_length() const {
+    return window_length;
+  }
+
+  double get_end_time() const {
+    return end_time;
+  }
+
+  ulong get_rand_max() const {
+    return n_nodes;
+  }
+
+  ulong get_n_coeffs() const override;
+
+ private:
+  void clear();
+
+  //! @brief synchronize aggregated_model with this instance
+  void synchronize_aggregated_model();
+};
+
+#endif  // TICK_OPTIM_MODEL_SRC_VARIANTS_HAWKES_FIXED_EXPKERN_LEASTSQ_ONLINE_H_
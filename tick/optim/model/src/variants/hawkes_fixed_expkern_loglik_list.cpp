@@ -5,7 +5,41 @@
 
 ModelHawkesFixedExpKernLogLikList::ModelHawkesFixedExpKernLogLikList(
     const double decay, const int max_n_threads) :
-    ModelHawkesList(max_n_threads, 0), decay(decay) {}
+    ModelHawkesList(max_n_threads, 0), decay(decay), weights_threshold(0) {}
+
+void ModelHawkesFixedExpKernLogLikList::set_weights_threshold(const double weights_threshold) {
+  if (weights_threshold < 0) {
+    TICK_ERROR("weights_threshold must be non negative, got " << weights_threshold);
+  }
+  weights_computed = false;
+  this->weights_threshold = weights_threshold;
+}
+
+ulong ModelHawkesFixedExpKernLogLikList::get_n_stored_weights() const {
+  ulong n_stored_weights = 0;
+  for (auto &model : model_list) n_stored_weights += model.get_n_stored_weights();
+  return n_stored_weights;
+}
+
+void ModelHawkesFixedExpKernLogLikList::set_data(const SArrayDoublePtrList2D &timestamps_list,
+                                                 const VArrayDoublePtr end_times) {
+  ModelHawkesList::set_data(timestamps_list, end_times);
+  model_list.clear();
+}
+
+void ModelHawkesFixedExpKernLogLikList::set_decay(const double decay) {
+  this->decay = decay;
+  weights_computed = model_list.size() > 0 && model_list.size() == n_realizations;
+  for (auto &model : model_list) {
+    model.set_decay(decay);
+    weights_computed = weights_computed && model.weights_computed;
+  }
+}
+
+SArrayDoublePtr ModelHawkesFixedExpKernLogLikList::get_cached_decays() const {
+  if (model_list.size() == 0) return SArrayDouble::new_ptr(0);
+  return model_list[0].get_cached_decays();
+}
 
 void ModelHawkesFixedExpKernLogLikList::incremental_set_data(
     const SArrayDoublePtrList1D &timestamps, double end_time) {
@@ -36,6 +70,7 @@ void ModelHawkesFixedExpKernLogLikList::incremental_set_data(
   n_jumps_per_realization->append1(n_total_jumps);
 
   auto model = ModelHawkesFixedExpKernLogLik(decay, get_n_threads());
+  model.set_weights_threshold(weights_threshold);
   model.set_data(timestamps, end_time);
   model.compute_weights();
   model_list.push_back(model);
@@ -43,13 +78,25 @@ void ModelHawkesFixedExpKernLogLikList::incremental_set_data(
   weights_computed = true;
 }
 
-void ModelHawkesFixedExpKernLogLikList::compute_weights() {
-  model_list = std::vector<ModelHawkesFixedExpKernLogLik>(n_realizations);
+void ModelHawkesFixedExpKernLogLikList::init_model_list() {
+  // Models are kept as long as data is unchanged, with the weights they might have
+  // precomputed for several decays
+  if (model_list.size() == n_realizations) return;
 
+  model_list = std::vector<ModelHawkesFixedExpKernLogLik>(n_realizations);
   for (ulong r = 0; r < n_realizations; ++r) {
     model_list[r] = ModelHawkesFixedExpKernLogLik(decay, 1);
     model_list[r].set_data(timestamps_list[r], (*end_times)[r]);
-    model_list[r].allocate_weights();
+  }
+}
+
+void ModelHawkesFixedExpKernLogLikList::compute_weights() {
+  init_model_list();
+
+  for (auto &model : model_list) {
+    model.set_weights_threshold(weights_threshold);
+    model.set_decay(decay);
+    if (!model.weights_computed) model.allocate_weights();
   }
 
   parallel_run(get_n_threads(), n_realizations * n_nodes,
@@ -61,6 +108,21 @@ void ModelHawkesFixedExpKernLogLikList::compute_weights() {
   weights_computed = true;
 }
 
+void ModelHawkesFixedExpKernLogLikList::compute_weights_for_decays(const ArrayDouble &decays) {
+  init_model_list();
+
+  for (auto &model : model_list) {
+    model.set_weights_threshold(weights_threshold);
+    model.allocate_weights_for_decays(decays);
+  }
+
+  parallel_run(get_n_threads(), n_realizations * n_nodes,
+               &ModelHawkesFixedExpKernLogLikList::compute_weights_for_decays_i_r, this);
+
+  // Weights of the current decay are available only if it belongs to decays
+  set_decay(decay);
+}
+
 std::tuple<ulong, ulong> ModelHawkesFixedExpKernLogLikList::get_realization_node(ulong i_r) {
   const ulong r = static_cast<const ulong>(i_r / n_nodes);
   const ulong i = i_r % n_nodes;
@@ -70,7 +132,13 @@ std::tuple<ulong, ulong> ModelHawkesFixedExpKernLogLikList::get_realization_node
 void ModelHawkesFixedExpKernLogLikList::compute_weights_i_r(const ulong i_r) {
   ulong r, i;
   std::tie(r, i) = get_realization_node(i_r);
-  model_list[r].compute_weights_dim_i(i);
+  if (!model_list[r].weights_computed) model_list[r].compute_weights_dim_i(i);
+}
+
+void ModelHawkesFixedExpKernLogLikList::compute_weights_for_decays_i_r(const ulong i_r) {
+  ulong r, i;
+  std::tie(r, i) = get_realization_node(i_r);
+  model_list[r].compute_weights_dim_i_for_decays(i);
 }
 
 double ModelHawkesFixedExpKernLogLikList::loss_i_r(const ulong i_r, const ArrayDouble &coeffs) {
@@ -150,6 +218,26 @@ double ModelHawkesFixedExpKernLogLikList::hessian_norm(const ArrayDouble &coeffs
       / get_n_total_jumps();
 }
 
+void ModelHawkesFixedExpKernLogLikList::hessian_vector_product_i(const ulong i,
+                                                                 const ArrayDouble &coeffs,
+                                                                 const ArrayDouble &vector,
+                                                                 ArrayDouble &out) {
+  for (auto &model : model_list) model.hessian_vector_product_dim_i(i, coeffs, vector, out);
+}
+
+// Realizations are summed by each node, hence nodes write different coordinates of out and no
+// reduction is needed
+void ModelHawkesFixedExpKernLogLikList::hessian_vector_product(const ArrayDouble &coeffs,
+                                                               const ArrayDouble &vector,
+                                                               ArrayDouble &out) {
+  if (!weights_computed) compute_weights();
+  out.init_to_zero();
+  parallel_run(std::min(get_n_threads(), static_cast<unsigned int>(n_nodes)), n_nodes,
+               &ModelHawkesFixedExpKernLogLikList::hessian_vector_product_i,
+               this, coeffs, vector, out);
+  out /= get_n_total_jumps();
+}
+
 std::pair<ulong, ulong> ModelHawkesFixedExpKernLogLikList::sampled_i_to_realization(
     const ulong sampled_i) {
   ulong cum_n_jumps = 0;
@@ -16,6 +16,10 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLogLikList : public ModelHawkesList {
   //! @brief Value of decay for this model. Shared by all kernels
   double decay;
 
+  //! @brief Threshold under which weights are not stored, see
+  //! ModelHawkesFixedExpKernLogLik::set_weights_threshold
+  double weights_threshold;
+
   std::vector<ModelHawkesFixedExpKernLogLik> model_list;
 
  public:
@@ -28,6 +32,8 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLogLikList : public ModelHawkesList {
   ModelHawkesFixedExpKernLogLikList(const double decay,
                                     const int max_n_threads = 1);
 
+  void set_data(const SArrayDoublePtrList2D &timestamps_list, const VArrayDoublePtr end_times);
+
   void incremental_set_data(const SArrayDoublePtrList1D &timestamps, double end_time);
 
   /**
@@ -36,6 +42,13 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLogLikList : public ModelHawkesList {
    */
   void compute_weights();
 
+  /**
+   * @brief Precomputations of intermediate values for several decays in a single pass over
+   * each realization, see ModelHawkesFixedExpKernLogLik::compute_weights_for_decays
+   * \param decays : decays for which weights are precomputed
+   */
+  void compute_weights_for_decays(const ArrayDouble &decays);
+
   /**
    * @brief Compute loss
    * \param coeffs : Point in which loss is computed
@@ -82,14 +95,34 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLogLikList : public ModelHawkesList {
   double hessian_norm(const ArrayDouble &coeffs, const ArrayDouble &vector);
 
   /**
-   * @brief Set decays and reset weights computing
-   * @param decays : new decays to be set
+   * @brief Compute the product of the hessian with a vector \f$ \nabla^2 f(x) d \f$
+   * \param coeffs : Point in which the hessian is computed (\f$ x \f$)
+   * \param vector : Vector multiplied by the hessian (\f$ d \f$)
+   * \param out : Array in which the product is stored
+   * \note Nodes are computed in parallel, each one summing over all realizations
    */
-  void set_decay(const double decay) {
-    weights_computed = false;
-    this->decay = decay;
+  void hessian_vector_product(const ArrayDouble &coeffs, const ArrayDouble &vector,
+                              ArrayDouble &out) override;
+
+  /**
+   * @brief Set decay and reset weights computing, unless weights have been precomputed for
+   * this decay with compute_weights_for_decays
+   * @param decay : new decay to be set
+   */
+  void set_decay(const double decay);
+
+  //! @brief Returns the decays for which weights have been precomputed
+  SArrayDoublePtr get_cached_decays() const;
+
+  double get_weights_threshold() const {
+    return weights_threshold;
   }
 
+  void set_weights_threshold(const double weights_threshold);
+
+  //! @brief Returns the number of weights currently stored by all realizations
+  ulong get_n_stored_weights() const;
+
   ulong get_rand_max() const {
     return get_n_total_jumps();
   }
@@ -105,12 +138,22 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLogLikList : public ModelHawkesList {
    */
   std::tuple<ulong, ulong> get_realization_node(ulong i_r);
 
+  //! @brief Create one model per realization, unless they already exist
+  void init_model_list();
+
   /**
    * @brief Compute weights for one index between 0 and n_realizations * n_nodes
    * @param i_r : r * n_realizations + i, tells which realization and which node
    */
   void compute_weights_i_r(const ulong i_r);
 
+  /**
+   * @brief Compute weights of all cached decays for one index between 0 and
+   * n_realizations * n_nodes
+   * @param i_r : r * n_realizations + i, tells which realization and which node
+   */
+  void compute_weights_for_decays_i_r(const ulong i_r);
+
   /**
    * @brief Compute loss for one index between 0 and n_realizations * n_nodes
    * @param i_r : r * n_realizations + i, tells which realization and which node
@@ -135,6 +178,16 @@ class DLL_PUBLIC ModelHawkesFixedExpKernLogLikList : public ModelHawkesList {
   double hessian_norm_i_r(const ulong i_r, const ArrayDouble &coeffs,
                           const ArrayDouble &vector);
 
+  /**
+   * @brief Compute the product of the hessian with a vector for node i, over all realizations
+   * \param i : selected node
+   * \param coeffs : Point in which the hessian is computed
+   * \param vector : Vector multiplied by the hessian
+   * \param out : Array which the result of the product will be added to
+   */
+  void hessian_vector_product_i(const ulong i, const ArrayDouble &coeffs,
+                                const ArrayDouble &vector, ArrayDouble &out);
+
   std::pair<ulong, ulong> sampled_i_to_realization(const ulong sampled_i);
 };
 
@@ -9,74 +9,117 @@ ModelHawkesFixedSumExpKernLeastSqList::ModelHawkesFixedSumExpKernLeastSqList(
     const ulong n_baselines,
     const double period_length,
     const unsigned int max_n_threads,
-    const unsigned int optimization_level)
+    const unsigned int optimization_level,
+    const bool float_weights)
     : ModelHawkesLeastSqList(max_n_threads, optimization_level),
       n_baselines(n_baselines), period_length(period_length),
-      decays(decays), n_decays(decays.size()) {
+      decays(decays), n_decays(decays.size()), float_weights(float_weights) {
   aggregated_model = std::unique_ptr<ModelHawkesFixedSumExpKernLeastSq>(
       new ModelHawkesFixedSumExpKernLeastSq(decays, n_baselines, period_length,
-                                            max_n_threads, optimization_level));
+                                            max_n_threads, optimization_level, float_weights));
 }
 
-void ModelHawkesFixedSumExpKernLeastSqList::compute_weights_i_r(
-    const ulong i_r, std::vector<ModelHawkesFixedSumExpKernLeastSq> &model_list) {
-  const ulong r = static_cast<const ulong>(i_r / n_nodes);
-  const ulong i = i_r % n_nodes;
-
-  model_list[r].compute_weights_i(i);
+void ModelHawkesFixedSumExpKernLeastSqList::compute_weights_worker(
+    const ulong thread, std::vector<ModelHawkesFixedSumExpKernLeastSq> &model_list,
+    std::atomic<ulong> &next_task) {
+  ModelHawkesFixedSumExpKernLeastSq &model = model_list[thread];
+  const ulong n_tiles = model.get_n_tiles();
+
+  // Tasks are ordered by realization, hence a thread usually computes several tiles of the same
+  // realization in a row
+  ulong current_r = n_realizations;
+  ulong task;
+  while ((task = next_task++) < n_realizations * n_tiles) {
+    const ulong r = task / n_tiles;
+    if (r != current_r) {
+      model.set_data(timestamps_list[r], (*end_times)[r]);
+      current_r = r;
+    }
+    model.compute_weights_tile(task % n_tiles);
+  }
 }
 
+// Weights are additive over realizations: each thread accumulates the weights of the tasks it
+// computes in its own model. Partial weights are then summed pairwise, hence memory depends on
+// the number of threads but not on the number of realizations
 void ModelHawkesFixedSumExpKernLeastSqList::compute_weights_timestamps_list() {
-  auto model_list =
-      std::vector<ModelHawkesFixedSumExpKernLeastSq>(n_realizations);
-
-  for (ulong r = 0; r < n_realizations; ++r) {
-    model_list[r] = ModelHawkesFixedSumExpKernLeastSq(decays, n_baselines, period_length,
-                                                      1, optimization_level);
-    model_list[r].set_data(timestamps_list[r], (*end_times)[r]);
-    model_list[r].allocate_weights();
+  const unsigned int n_threads = get_n_threads();
+
+  auto model_list = std::vector<ModelHawkesFixedSumExpKernLeastSq>(n_threads);
+  for (unsigned int thread = 0; thread < n_threads; ++thread) {
+    ModelHawkesFixedSumExpKernLeastSq &model = model_list[thread];
+    model = ModelHawkesFixedSumExpKernLeastSq(decays, n_baselines, period_length,
+                                              1, optimization_level, float_weights);
+    model.set_n_nodes(n_nodes);
+    // The first model directly accumulates in the weights of this instance, hence with one
+    // thread weights are the same as the ones obtained with incremental_set_data
+    if (thread == 0) {
+      set_weights_views(model);
+    } else {
+      model.allocate_weights();
+    }
   }
 
-  // Multithreaded computation of the arrays
-  parallel_run(get_n_threads(), n_realizations * n_nodes,
-               &ModelHawkesFixedSumExpKernLeastSqList::compute_weights_i_r, this, model_list);
-
-  for (ulong r = 0; r < n_realizations; ++r) {
-    L.mult_incr(model_list[r].L, 1);
-    for (ulong i = 0; i < n_nodes; ++i) {
-      Dg[i].mult_incr(model_list[r].Dg[i], 1);
-      Dgg[i].mult_incr(model_list[r].Dgg[i], 1);
-      C[i].mult_incr(model_list[r].C[i], 1);
-      E[i].mult_incr(model_list[r].E[i], 1);
-      K[i].mult_incr(model_list[r].K[i], 1);
-    }
+  std::atomic<ulong> next_task(0);
+  parallel_run(n_threads, n_threads,
+               &ModelHawkesFixedSumExpKernLeastSqList::compute_weights_worker, this,
+               model_list, next_task);
+
+  for (ulong step = 1; step < n_threads; step *= 2) {
+    const ulong n_sums = (n_threads + 2 * step - 1) / (2 * step);
+    parallel_run(n_threads, n_sums, &ModelHawkesFixedSumExpKernLeastSqList::sum_partial_weights,
+                 this, step, model_list);
+  }
+}
+
+void ModelHawkesFixedSumExpKernLeastSqList::sum_partial_weights(
+    const ulong k, const ulong step, std::vector<ModelHawkesFixedSumExpKernLeastSq> &model_list) {
+  const ulong index = 2 * step * k;
+  if (index + step >= model_list.size()) return;
+
+  ModelHawkesFixedSumExpKernLeastSq &model = model_list[index];
+  ModelHawkesFixedSumExpKernLeastSq &other_model = model_list[index + step];
+  model.L.mult_incr(other_model.L, 1);
+  if (float_weights) {
+    model.Q_float.mult_incr(other_model.Q_float, 1);
+  } else {
+    model.Q.mult_incr(other_model.Q, 1);
+  }
+  for (ulong i = 0; i < n_nodes; ++i) {
+    model.Dg[i].mult_incr(other_model.Dg[i], 1);
+    model.C[i].mult_incr(other_model.C[i], 1);
+    model.K[i].mult_incr(other_model.K[i], 1);
   }
 }
 
 void ModelHawkesFixedSumExpKernLeastSqList::compute_weights_timestamps(
     const SArrayDoublePtrList1D &timestamps, double end_time) {
   auto model = ModelHawkesFixedSumExpKernLeastSq(decays, n_baselines, period_length,
-                                                 get_n_threads(), optimization_level);
+                                                 get_n_threads(), optimization_level,
+                                                 float_weights);
   model.set_data(timestamps, end_time);
-  model.compute_weights();
 
-  L.mult_incr(model.L, 1);
-  for (ulong i = 0; i < n_nodes; ++i) {
-    Dg[i].mult_incr(model.Dg[i], 1);
-    Dgg[i].mult_incr(model.Dgg[i], 1);
-    C[i].mult_incr(model.C[i], 1);
-    E[i].mult_incr(model.E[i], 1);
-    K[i].mult_incr(model.K[i], 1);
-  }
+  // The weights of this realization are directly added to the weights of this instance
+  set_weights_views(model);
+  model.accumulate_weights();
 }
 
 void ModelHawkesFixedSumExpKernLeastSqList::allocate_weights() {
   L = ArrayDouble(n_baselines);
   L.init_to_zero();
 
+  const ulong Q_size = n_nodes * (n_nodes + 1) / 2 * n_decays * n_decays;
+  if (float_weights) {
+    Q = ArrayDouble();
+    Q_float = ArrayFloat(Q_size);
+    Q_float.init_to_zero();
+  } else {
+    Q = ArrayDouble(Q_size);
+    Q.init_to_zero();
+    Q_float = ArrayFloat();
+  }
+
   C = std::vector<ArrayDouble2d>(n_nodes);
-  Dgg = std::vector<ArrayDouble2d>(n_nodes);
-  E = std::vector<ArrayDouble2d>(n_nodes);
   Dg = ArrayDouble2dList1D(n_nodes);
   K = ArrayDoubleList1D(n_nodes);
   for (ulong i = 0; i < n_nodes; ++i) {
@@ -84,16 +127,32 @@ void ModelHawkesFixedSumExpKernLeastSqList::allocate_weights() {
     C[i].init_to_zero();
     Dg[i] = ArrayDouble2d(n_decays, n_baselines);
     Dg[i].init_to_zero();
-    Dgg[i] = ArrayDouble2d(n_decays, n_decays);
-    Dgg[i].init_to_zero();
-    E[i] = ArrayDouble2d(n_nodes, n_decays * n_decays);
-    E[i].init_to_zero();
     K[i] = ArrayDouble(n_baselines);
     K[i].init_to_zero();
   }
   weights_allocated = true;
 }
 
+// We make views to avoid copies
+void ModelHawkesFixedSumExpKernLeastSqList::set_weights_views(
+    ModelHawkesFixedSumExpKernLeastSq &model) {
+  model.float_weights = float_weights;
+  model.L = view(L);
+  if (float_weights) {
+    model.Q_float = view(Q_float);
+  } else {
+    model.Q = view(Q);
+  }
+  model.C = ArrayDouble2dList1D(n_nodes);
+  model.Dg = ArrayDouble2dList1D(n_nodes);
+  model.K = ArrayDoubleList1D(n_nodes);
+  for (ulong i = 0; i < n_nodes; ++i) {
+    model.Dg[i] = view(Dg[i]);
+    model.C[i] = view(C[i]);
+    model.K[i] = view(K[i]);
+  }
+}
+
 void ModelHawkesFixedSumExpKernLeastSqList::synchronize_aggregated_model() {
   auto *casted_model = static_cast<ModelHawkesFixedSumExpKernLeastSq *>(aggregated_model.get());
 
@@ -103,20 +162,7 @@ void ModelHawkesFixedSumExpKernLeastSqList::synchronize_aggregated_model() {
   casted_model->period_length = period_length;
   casted_model->max_n_threads = max_n_threads;
 
-  casted_model->L = view(L);
-  casted_model->C = ArrayDouble2dList1D(n_nodes);
-  casted_model->Dg = ArrayDouble2dList1D(n_nodes);
-  casted_model->Dgg = ArrayDouble2dList1D(n_nodes);
-  casted_model->E = ArrayDouble2dList1D(n_nodes);
-  casted_model->K = ArrayDoubleList1D(n_nodes);
-  // We make views to avoid copies
-  for (ulong i = 0; i < n_nodes; ++i) {
-    casted_model->Dg[i] = view(Dg[i]);
-    casted_model->Dgg[i] = view(Dgg[i]);
-    casted_model->C[i] = view(C[i]);
-    casted_model->E[i] = view(E[i]);
-    casted_model->K[i] = view(K[i]);
-  }
+  set_weights_views(*casted_model);
   casted_model->end_time = end_times->sum();
 
   casted_model->n_total_jumps = n_jumps_per_realization->sum();
@@ -146,3 +192,12 @@ void ModelHawkesFixedSumExpKernLeastSqList::set_period_length(double period_leng
   this->period_length = period_length;
   weights_computed = false;
 }
+
+bool ModelHawkesFixedSumExpKernLeastSqList::get_float_weights() const {
+  return float_weights;
+}
+
+void ModelHawkesFixedSumExpKernLeastSqList::set_float_weights(bool float_weights) {
+  this->float_weights = float_weights;
+  weights_computed = false;
+}
@@ -14,7 +14,9 @@
  */
 class DLL_PUBLIC ModelHawkesFixedSumExpKernLeastSqList : public ModelHawkesLeastSqList {
   //! @brief Some arrays used for intermediate computings.
-  std::vector<ArrayDouble2d> E, Dgg, C;
+  ArrayDouble Q;
+  ArrayFloat Q_float;
+  std::vector<ArrayDouble2d> C;
   ArrayDouble2dList1D Dg;
 
   //! @brief some arrays used for intermediate computings in varying baseline case
@@ -30,17 +32,22 @@ class DLL_PUBLIC ModelHawkesFixedSumExpKernLeastSqList : public ModelHawkesLeast
   //! @brief n_decays (number of decays in the sum exponential kernel)
   ulong n_decays;
 
+  //! @brief If true, the largest weights are stored in single precision
+  bool float_weights;
+
  public:
   //! @brief Constructor
   //! \param timestamps : a list of arrays representing the realization
   //! \param decays : the 2d array of the decays
   //! \param n_cores : number of cores to be used for multithreading
   //! \param optimization_level : 0 corresponds to no optimization and 1 to use of faster (approximated) exponential function
+  //! \param float_weights : if true, the largest weights are stored in single precision
   ModelHawkesFixedSumExpKernLeastSqList(const ArrayDouble &decays,
                                         const ulong n_baselines,
                                         const double period_length,
                                         const unsigned int max_n_threads = 1,
-                                        const unsigned int optimization_level = 0);
+                                        const unsigned int optimization_level = 0,
+                                        const bool float_weights = false);
 
   void set_decays(const ArrayDouble &decays) {
     weights_computed = false;
@@ -59,16 +66,33 @@ class DLL_PUBLIC ModelHawkesFixedSumExpKernLeastSqList : public ModelHawkesLeast
   void set_n_baselines(ulong n_baselines);
   void set_period_length(double period_length);
 
+  bool get_float_weights() const;
+  void set_float_weights(bool float_weights);
+
  private:
   /**
-   * @brief Compute weights for one index between 0 and n_realizations * n_nodes
-   * @param i_r : r * n_realizations + i, tells which realization and which node
-   * @param model_list : list of models on which to compute and store weights. Only model_list[r]
-   * will be modified
+   * @brief Compute weights of (realization, tile) tasks until all of them have been picked
+   * @param thread : index of the thread running this function
+   * @param model_list : one model per thread, in which each thread accumulates the weights of
+   * the tasks it computes. Only model_list[thread] will be modified
+   * @param next_task : index of the next task to compute, shared between all threads
+   */
+  void compute_weights_worker(const ulong thread,
+                              std::vector<ModelHawkesFixedSumExpKernLeastSq> &model_list,
+                              std::atomic<ulong> &next_task);
+
+  /**
+   * @brief Sum the weights of two models of model_list, for pairwise summation
+   * @param k : index of the sum, models 2 * step * k and 2 * step * k + step are summed
+   * @param step : distance between the two summed models
+   * @param model_list : models to sum, the sum is stored in the first one
    */
-  void compute_weights_i_r(const ulong i_r,
+  void sum_partial_weights(const ulong k, const ulong step,
                            std::vector<ModelHawkesFixedSumExpKernLeastSq> &model_list);
 
+  //! @brief Make the weights of the given model views on the weights of this instance
+  void set_weights_views(ModelHawkesFixedSumExpKernLeastSq &model);
+
   //! @brief allocate arrays to store precomputations
   void allocate_weights() override;
 
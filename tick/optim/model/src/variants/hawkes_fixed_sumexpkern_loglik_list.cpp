@@ -0,0 +1,171 @@
+// License: BSD 3 clause
+
+
+#include "hawkes_fixed_sumexpkern_loglik_list.h"
+
+ModelHawkesFixedSumExpKernLogLikList::ModelHawkesFixedSumExpKernLogLikList(
+    const ArrayDouble &decays, const int max_n_threads) :
+    ModelHawkesList(max_n_threads, 0), decays(decays), n_decays(decays.size()) {}
+
+void ModelHawkesFixedSumExpKernLogLikList::set_data(
+    const SArrayDoublePtrList2D &timestamps_list, const VArrayDoublePtr end_times) {
+  ModelHawkesList::set_data(timestamps_list, end_times);
+  model_list.clear();
+}
+
+void ModelHawkesFixedSumExpKernLogLikList::incremental_set_data(
+    const SArrayDoublePtrList1D &timestamps, double end_time) {
+  weights_computed = false;
+  if (model_list.size() == 0) {
+    set_n_nodes(timestamps.size());
+
+    n_realizations = 0;
+    end_times = VArrayDouble::new_ptr(0);
+    n_jumps_per_realization = VArrayULong::new_ptr(0);
+    n_jumps_per_node = SArrayULong::new_ptr(n_nodes);
+    n_jumps_per_node->init_to_zero();
+  } else {
+    if (n_nodes != timestamps.size()) {
+      TICK_ERROR("Your realization should have " << n_nodes << " nodes but has "
+                                                 << timestamps.size() << ".");
+    }
+  }
+
+  n_realizations += 1;
+  end_times->append1(end_time);
+
+  ulong n_total_jumps = 0;
+  for (ulong i = 0; i < n_nodes; ++i) {
+    n_total_jumps += timestamps[i]->size();
+    (*n_jumps_per_node)[i] += timestamps[i]->size();
+  }
+  n_jumps_per_realization->append1(n_total_jumps);
+
+  auto model = ModelHawkesFixedSumExpKernLogLik(decays, get_n_threads());
+  model.set_data(timestamps, end_time);
+  model.compute_weights();
+  model_list.push_back(model);
+
+  weights_computed = true;
+}
+
+void ModelHawkesFixedSumExpKernLogLikList::compute_weights() {
+  model_list = std::vector<ModelHawkesFixedSumExpKernLogLik>(n_realizations);
+
+  for (ulong r = 0; r < n_realizations; ++r) {
+    model_list[r] = ModelHawkesFixedSumExpKernLogLik(decays, 1);
+    model_list[r].set_data(timestamps_list[r], (*end_times)[r]);
+    model_list[r].allocate_weights();
+  }
+
+  parallel_run(get_n_threads(), n_realizations * n_nodes,
+               &ModelHawkesFixedSumExpKernLogLikList::compute_weights_i_r, this);
+
+  for (auto &model : model_list) {
+    model.weights_computed = true;
+  }
+  weights_computed = true;
+}
+
+void ModelHawkesFixedSumExpKernLogLikList::compute_weights_i_r(const ulong i_r) {
+  const ulong r = i_r / n_nodes;
+  const ulong i = i_r % n_nodes;
+  model_list[r].compute_weights_dim_i(i);
+}
+
+// Loss and gradient are computed per node and summed over realizations inside each task, so
+// that each task writes to its own block of the gradient and no reduction of gradients is needed
+
+double ModelHawkesFixedSumExpKernLogLikList::loss_dim_i(const ulong i,
+                                                        const ArrayDouble &coeffs) {
+  double loss = 0;
+  for (auto &model : model_list) loss += model.loss_dim_i(i, coeffs);
+  return loss;
+}
+
+void ModelHawkesFixedSumExpKernLogLikList::grad_dim_i(const ulong i,
+                                                      const ArrayDouble &coeffs,
+                                                      ArrayDouble &out) {
+  for (auto &model : model_list) model.grad_dim_i(i, coeffs, out);
+}
+
+double ModelHawkesFixedSumExpKernLogLikList::loss_and_grad_dim_i(const ulong i,
+                                                                 const ArrayDouble &coeffs,
+                                                                 ArrayDouble &out) {
+  double loss = 0;
+  for (auto &model : model_list) loss += model.loss_and_grad_dim_i(i, coeffs, out);
+  return loss;
+}
+
+double ModelHawkesFixedSumExpKernLogLikList::hessian_norm_dim_i(const ulong i,
+                                                                const ArrayDouble &coeffs,
+                                                                const ArrayDouble &vector) {
+  double hess_norm = 0;
+  for (auto &model : model_list) hess_norm += model.hessian_norm_dim_i(i, coeffs, vector);
+  return hess_norm;
+}
+
+double ModelHawkesFixedSumExpKernLogLikList::loss(const ArrayDouble &coeffs) {
+  if (!weights_computed) compute_weights();
+  return parallel_map_additive_reduce(
+      std::min(get_n_threads(), static_cast<unsigned int>(n_nodes)), n_nodes,
+      &ModelHawkesFixedSumExpKernLogLikList::loss_dim_i, this, coeffs) / get_n_total_jumps();
+}
+
+double ModelHawkesFixedSumExpKernLogLikList::loss_i(const ulong i, const ArrayDouble &coeffs) {
+  if (!weights_computed) compute_weights();
+  const auto r_i = sampled_i_to_realization(i);
+  return model_list[r_i.first].loss_i(r_i.second, coeffs);
+}
+
+void ModelHawkesFixedSumExpKernLogLikList::grad(const ArrayDouble &coeffs, ArrayDouble &out) {
+  if (!weights_computed) compute_weights();
+  out.init_to_zero();
+  parallel_run(std::min(get_n_threads(), static_cast<unsigned int>(n_nodes)), n_nodes,
+               &ModelHawkesFixedSumExpKernLogLikList::grad_dim_i, this, coeffs, out);
+  out /= get_n_total_jumps();
+}
+
+void ModelHawkesFixedSumExpKernLogLikList::grad_i(const ulong i, const ArrayDouble &coeffs,
+                                                  ArrayDouble &out) {
+  if (!weights_computed) compute_weights();
+  const auto r_i = sampled_i_to_realization(i);
+  model_list[r_i.first].grad_i(r_i.second, coeffs, out);
+}
+
+double ModelHawkesFixedSumExpKernLogLikList::loss_and_grad(const ArrayDouble &coeffs,
+                                                           ArrayDouble &out) {
+  if (!weights_computed) compute_weights();
+  out.init_to_zero();
+  const double loss = parallel_map_additive_reduce(
+      std::min(get_n_threads(), static_cast<unsigned int>(n_nodes)), n_nodes,
+      &ModelHawkesFixedSumExpKernLogLikList::loss_and_grad_dim_i, this, coeffs, out);
+  out /= get_n_total_jumps();
+  return loss / get_n_total_jumps();
+}
+
+double ModelHawkesFixedSumExpKernLogLikList::hessian_norm(const ArrayDouble &coeffs,
+                                                          const ArrayDouble &vector) {
+  if (!weights_computed) compute_weights();
+  return parallel_map_additive_reduce(
+      std::min(get_n_threads(), static_cast<unsigned int>(n_nodes)), n_nodes,
+      &ModelHawkesFixedSumExpKernLogLikList::hessian_norm_dim_i, this, coeffs, vector)
+      / get_n_total_jumps();
+}
+
+std::pair<ulong, ulong> ModelHawkesFixedSumExpKernLogLikList::sampled_i_to_realization(
+    const ulong sampled_i) {
+  ulong cum_n_jumps = 0;
+  for (ulong r = 0; r < n_realizations; r++) {
+    cum_n_jumps += (*n_jumps_per_realization)[r];
+    if (sampled_i < cum_n_jumps) {
+      const ulong i_in_realization_r = sampled_i - cum_n_jumps + (*n_jumps_per_realization)[r];
+      return std::pair<ulong, ulong>(r, i_in_realization_r);
+    }
+  }
+  TICK_ERROR("sampled_i out of range");
+}
+
+ulong ModelHawkesFixedSumExpKernLogLikList::get_n_coeffs() const {
+  return n_nodes + n_nodes * n_nodes * n_decays;
+}
@@ -0,0 +1,154 @@
+#ifndef TICK_OPTIM_MODEL_SRC_VARIANTS_HAWKES_FIXED_SUMEXPKERN_LOGLIK_LIST_H_
+#define TICK_OPTIM_MODEL_SRC_VARIANTS_HAWKES_FIXED_SUMEXPKERN_LOGLIK_LIST_H_
+
+// License: BSD 3 clause
+
+#include "base.h"
+#include "../base/hawkes_list.h"
+#include "../hawkes_fixed_sumexpkern_loglik.h"
+
+/** \class ModelHawkesFixedSumExpKernLogLikList
+ * \brief Class for computing loglikelihood function and gradient for Hawkes processes with
+ * sum exponential kernels with fixed exponent (i.e., \sum_u alpha_u*beta_u*e^{-beta_u t},
+ * with fixed beta) on a list of realizations
+ */
+class DLL_PUBLIC ModelHawkesFixedSumExpKernLogLikList : public ModelHawkesList {
+  //! @brief The array of decays (remember that the decays are fixed!)
+  ArrayDouble decays;
+
+  //! @brief n_decays (number of decays in the sum exponential kernel)
+  ulong n_decays;
+
+  std::vector<ModelHawkesFixedSumExpKernLogLik> model_list;
+
+ public:
+  /**
+   * @brief Constructor
+   * \param decays : decays of the sum exponential kernels (remember that decays are fixed!)
+   * \param max_n_threads : number of cores to be used for multithreading. If negative,
+   * the number of physical cores will be used
+   */
+  ModelHawkesFixedSumExpKernLogLikList(const ArrayDouble &decays,
+                                       const int max_n_threads = 1);
+
+  void set_data(const SArrayDoublePtrList2D &timestamps_list, const VArrayDoublePtr end_times);
+
+  void incremental_set_data(const SArrayDoublePtrList1D &timestamps, double end_time);
+
+  /**
+   * @brief Precomputations of intermediate values
+   * They will be used to compute faster loss and gradient
+   */
+  void compute_weights();
+
+  /**
+   * @brief Compute loss
+   * \param coeffs : Point in which loss is computed
+   * \return Loss' value
+   */
+  double loss(const ArrayDouble &coeffs) override;
+
+  /**
+   * @brief Compute loss corresponding to sample i (between 0 and rand_max = dim)
+   * \param i : selected dimension
+   * \param coeffs : Point in which loss is computed
+   * \return Loss' value
+   */
+  double loss_i(const ulong i, const ArrayDouble &coeffs) override;
+
+  /**
+   * @brief Compute gradient
+   * \param coeffs : Point in which gradient is computed
+   * \param out : Array in which the value of the gradient is stored
+   */
+  void grad(const ArrayDouble &coeffs, ArrayDouble &out) override;
+
+  /**
+   * @brief Compute gradient corresponding to sample i (between 0 and rand_max = dim)
+   * \param i : selected dimension
+   * \param coeffs : Point in which gradient is computed
+   * \param out : Array in which the value of the gradient is stored
+   */
+  void grad_i(const ulong i, const ArrayDouble &coeffs, ArrayDouble &out) override;
+
+  /**
+   * @brief Compute loss and gradient in a single pass over the weights
+   * \param coeffs : Point in which loss and gradient are computed
+   * \param out : Array in which the value of the gradient is stored
+   * \return Loss' value
+   */
+  double loss_and_grad(const ArrayDouble &coeffs, ArrayDouble &out);
+
+  /**
+   * @brief Compute the hessian norm \f$ \sqrt{ d^T \nabla^2 f(x) d} \f$
+   * \param coeffs : Point in which the hessian is computed (\f$ x \f$)
+   * \param vector : Point of which the norm is computed (\f$ d \f$)
+   */
+  double hessian_norm(const ArrayDouble &coeffs, const ArrayDouble &vector);
+
+  /**
+   * @brief Set decays and reset weights computing
+   * @param decays : new decays to be set
+   */
+  void set_decays(const ArrayDouble &decays) {
+    weights_computed = false;
+    this->decays = decays;
+    n_decays = decays.size();
+  }
+
+  ulong get_n_decays() const {
+    return n_decays;
+  }
+
+  ulong get_rand_max() const {
+    return get_n_total_jumps();
+  }
+
+  ulong get_n_coeffs() const override;
+
+ private:
+  /**
+   * @brief Compute weights for one index between 0 and n_realizations * n_nodes
+   * @param i_r : r * n_nodes + i, tells which realization and which node
+   */
+  void compute_weights_i_r(const ulong i_r);
+
+  /**
+   * @brief Compute loss of node i, summed over all realizations
+   * \param i : selected node
+   * \param coeffs : Point in which loss is computed
+   */
+  double loss_dim_i(const ulong i, const ArrayDouble &coeffs);
+
+  /**
+   * @brief Compute gradient of node i, summed over all realizations
+   * \param i : selected node
+   * \param coeffs : Point in which gradient is computed
+   * \param out : Array which the result of the gradient will be added to
+   * \note For two different values of i, this function will modify different coordinates of
+   * out. Hence, it is thread safe.
+   */
+  void grad_dim_i(const ulong i, const ArrayDouble &coeffs, ArrayDouble &out);
+
+  /**
+   * @brief Compute loss and gradient of node i, summed over all realizations
+   * \param i : selected node
+   * \param coeffs : Point in which loss and gradient are computed
+   * \param out : Array which the result of the gradient will be added to
+   * \note For two different values of i, this function will modify different coordinates of
+   * out. Hence, it is thread safe.
+   */
+  double loss_and_grad_dim_i(const ulong i, const ArrayDouble &coeffs, ArrayDouble &out);
+
+  /**
+   * @brief Compute the hessian norm of node i, summed over all realizations
+   * \param i : selected node
+   * \param coeffs : Point in which the hessian is computed
+   * \param vector : Point of which the norm is computed
+   */
+  double hessian_norm_dim_i(const ulong i, const ArrayDouble &coeffs, const ArrayDouble &vector);
+
+  std::pair<ulong, ulong> sampled_i_to_realization(const ulong sampled_i);
+};
+
+#endif  // TICK_OPTIM_MODEL_SRC_VARIANTS_HAWKES_FIXED_SUMEXPKERN_LOGLIK_LIST_H_
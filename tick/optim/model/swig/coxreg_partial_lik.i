@@ -10,5 +10,11 @@ class ModelCoxRegPartialLik : public Model {
 
   ModelCoxRegPartialLik(const SBaseArrayDouble2dPtr features,
                         const SArrayDoublePtr times,
-                        const SArrayUShortPtr censoring);
+                        const SArrayUShortPtr censoring,
+                        const int n_threads = 1);
+
+  double loss_and_grad(const ArrayDouble &coeffs, ArrayDouble &out);
+
+  unsigned int get_n_threads() const;
+  void set_n_threads(unsigned int n_threads);
 };
@@ -4,9 +4,12 @@
 %include hawkes_fixed_expkern_leastsq.i
 %include hawkes_fixed_sumexpkern_leastsq.i
 %include hawkes_fixed_expkern_loglik.i
+%include hawkes_fixed_sumexpkern_loglik.i
 
 %include variants/hawkes_list.i
 %include variants/hawkes_leastsq_list.i
 %include variants/hawkes_fixed_expkern_leastsq_list.i
+%include variants/hawkes_fixed_expkern_leastsq_online.i
+%include variants/hawkes_fixed_expkern_leastsq_binned.i
 %include variants/hawkes_fixed_sumexpkern_leastsq_list.i
 %include variants/hawkes_fixed_expkern_loglik_list.i
\ No newline at end of file
@@ -18,6 +18,8 @@ class ModelHawkesFixedExpKernLeastSq : public Model {
   void set_data(const SArrayDoublePtrList1D &timestamps, const double end_time);
   void set_decays(const SArrayDouble2dPtr decays);
   void compute_weights();
+  void compute_weights_for_decays(const ArrayDouble &decays);
+  SArrayDoublePtr get_cached_decays() const;
 
   double loss_and_grad(const ArrayDouble &coeffs, ArrayDouble &out);
   void hessian(ArrayDouble &out);
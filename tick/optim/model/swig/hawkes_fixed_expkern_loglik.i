@@ -14,14 +14,22 @@ class ModelHawkesFixedExpKernLogLik : public Model {
   void set_data(const SArrayDoublePtrList1D &timestamps, const double end_time);
 
   void compute_weights();
+  void compute_weights_for_decays(const ArrayDouble &decays);
 
   inline unsigned long get_rand_max() const;
 
   double loss_and_grad(const ArrayDouble &coeffs, ArrayDouble &out_grad);
   double hessian_norm(const ArrayDouble &coeffs, const ArrayDouble &vector);
+  void hessian_vector_product(const ArrayDouble &coeffs, const ArrayDouble &vector,
+                              ArrayDouble &out);
 
   double get_decay() const;
   void set_decay(double decay);
+  SArrayDoublePtr get_cached_decays() const;
+
+  double get_weights_threshold() const;
+  void set_weights_threshold(double weights_threshold);
+  ulong get_n_stored_weights() const;
 
   unsigned int get_n_threads() const;
   void set_n_threads(unsigned int n_threads);
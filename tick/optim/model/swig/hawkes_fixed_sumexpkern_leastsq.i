@@ -15,7 +15,8 @@ class ModelHawkesFixedSumExpKernLeastSq : public Model {
                                     const ulong n_baselines,
                                     const double period_length,
                                     const unsigned int max_n_threads = 1,
-                                    const unsigned int optimization_level = 0);
+                                    const unsigned int optimization_level = 0,
+                                    const bool float_weights = false);
 
   void set_data(const SArrayDoublePtrList1D &timestamps, const double end_time);
 
@@ -32,4 +33,7 @@ class ModelHawkesFixedSumExpKernLeastSq : public Model {
 
   void set_n_baselines(ulong n_baselines);
   void set_period_length(double period_length);
+
+  bool get_float_weights() const;
+  void set_float_weights(bool float_weights);
 };
\ No newline at end of file
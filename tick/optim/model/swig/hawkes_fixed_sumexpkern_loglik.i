@@ -0,0 +1,32 @@
+// License: BSD 3 clause
+
+%{
+#include "hawkes_fixed_sumexpkern_loglik.h"
+%}
+
+class ModelHawkesFixedSumExpKernLogLik : public Model {
+
+ public:
+
+  ModelHawkesFixedSumExpKernLogLik(const ArrayDouble &decays,
+                                   const int max_n_threads = 1);
+
+  void set_data(const SArrayDoublePtrList1D &timestamps, const double end_time);
+
+  void compute_weights();
+
+  inline unsigned long get_rand_max() const;
+
+  double loss_and_grad(const ArrayDouble &coeffs, ArrayDouble &out_grad);
+  double hessian_norm(const ArrayDouble &coeffs, const ArrayDouble &vector);
+
+  void set_decays(const ArrayDouble &decays);
+  ulong get_n_decays() const;
+
+  unsigned int get_n_threads() const;
+  void set_n_threads(unsigned int n_threads);
+
+  ulong get_n_total_jumps() const;
+  ulong get_n_coeffs() const;
+  ulong get_n_nodes() const;
+};
@@ -14,7 +14,9 @@ class ModelSCCS : public Model {
   ModelSCCS(const SBaseArrayDouble2dPtrList1D &features,
             const SArrayIntPtrList1D &labels,
             const SBaseArrayULongPtr censoring,
-            ulong n_lags);
+            ulong n_lags,
+            const int n_threads = 1,
+            const bool implicit_lags = false);
 
   double loss(ArrayDouble &coeffs);
 
@@ -31,4 +33,9 @@ class ModelSCCS : public Model {
   unsigned long get_n_coeffs() const;
 
   double get_lip_max();
+
+  bool get_implicit_lags() const;
+
+  unsigned int get_n_threads() const;
+  void set_n_threads(unsigned int n_threads);
 };
\ No newline at end of file
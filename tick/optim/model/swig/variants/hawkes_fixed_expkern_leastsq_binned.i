@@ -0,0 +1,24 @@
+// License: BSD 3 clause
+
+
+%{
+#include "variants/hawkes_fixed_expkern_leastsq_binned.h"
+%}
+
+
+class ModelHawkesFixedExpKernLeastSqBinned : public ModelHawkesLeastSqList {
+
+ public:
+
+  ModelHawkesFixedExpKernLeastSqBinned(const SArrayDouble2dPtr decays,
+                                       const double bin_size,
+                                       const int max_n_threads = 1);
+
+  void hessian(ArrayDouble &out);
+  void set_decays(const SArrayDouble2dPtr decays);
+  void set_decays(const double decay);
+
+  void set_data(const SArrayDoublePtrList2D &timestamps_list, const VArrayDoublePtr end_times);
+
+  double get_bin_size() const;
+};
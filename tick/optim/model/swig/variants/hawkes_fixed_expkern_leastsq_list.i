@@ -16,4 +16,10 @@ public:
 
   void hessian(ArrayDouble &out);
   void set_decays(const SArrayDouble2dPtr decays);
+  void set_decays(const double decay);
+
+  void set_data(const SArrayDoublePtrList2D &timestamps_list, const VArrayDoublePtr end_times);
+
+  void compute_weights_for_decays(const ArrayDouble &decays);
+  SArrayDoublePtr get_cached_decays() const;
 };
@@ -0,0 +1,35 @@
+// License: BSD 3 clause
+
+
+%{
+#include "variants/hawkes_fixed_expkern_leastsq_online.h"
+%}
+
+
+class ModelHawkesFixedExpKernLeastSqOnline : public Model {
+
+ public:
+
+  ModelHawkesFixedExpKernLeastSqOnline(const double decay,
+                                       const double window_length = 0,
+                                       const int max_n_threads = 1);
+
+  void set_data(const SArrayDoublePtrList1D &timestamps, const double end_time);
+  void append(const SArrayDoublePtrList1D &timestamps, const double end_time);
+
+  void compute_weights();
+  double loss_and_grad(const ArrayDouble &coeffs, ArrayDouble &out);
+  void hessian(ArrayDouble &out);
+
+  double get_decay() const;
+  double get_window_length() const;
+  double get_end_time() const;
+
+  ulong get_rand_max() const;
+  ulong get_n_coeffs() const;
+  ulong get_n_nodes() const;
+  ulong get_n_total_jumps() const;
+  SArrayULongPtr get_n_jumps_per_node() const;
+
+  void set_n_threads(const int max_n_threads);
+};
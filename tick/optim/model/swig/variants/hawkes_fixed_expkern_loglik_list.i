@@ -15,10 +15,19 @@ public:
 
   double loss_and_grad(const ArrayDouble &coeffs, ArrayDouble &out);
   double hessian_norm(const ArrayDouble &coeffs, const ArrayDouble &vector);
+  void hessian_vector_product(const ArrayDouble &coeffs, const ArrayDouble &vector,
+                              ArrayDouble &out);
 
   void set_decay(const double decay);
+  SArrayDoublePtr get_cached_decays() const;
 
+  double get_weights_threshold() const;
+  void set_weights_threshold(const double weights_threshold);
+  ulong get_n_stored_weights() const;
+
+  void set_data(const SArrayDoublePtrList2D &timestamps_list, const VArrayDoublePtr end_times);
   void incremental_set_data(const SArrayDoublePtrList1D &timestamps, double end_time);
 
   void compute_weights();
+  void compute_weights_for_decays(const ArrayDouble &decays);
 };
@@ -14,7 +14,8 @@ public:
                                         const ulong n_baselines,
                                         const double period_length,
                                         const unsigned int max_n_threads = 1,
-                                        const unsigned int optimization_level = 0);
+                                        const unsigned int optimization_level = 0,
+                                        const bool float_weights = false);
 
   void set_decays(const ArrayDouble &decays);
 
@@ -25,4 +26,7 @@ public:
 
   void set_n_baselines(ulong n_baselines);
   void set_period_length(double period_length);
+
+  bool get_float_weights() const;
+  void set_float_weights(bool float_weights);
 };
@@ -0,0 +1,26 @@
+// License: BSD 3 clause
+
+
+%{
+#include "variants/hawkes_fixed_sumexpkern_loglik_list.h"
+%}
+
+
+class ModelHawkesFixedSumExpKernLogLikList : public ModelHawkesList {
+    
+public:
+    
+  ModelHawkesFixedSumExpKernLogLikList(const ArrayDouble &decays,
+                                       const int max_n_threads = 1);
+
+  double loss_and_grad(const ArrayDouble &coeffs, ArrayDouble &out);
+  double hessian_norm(const ArrayDouble &coeffs, const ArrayDouble &vector);
+
+  void set_decays(const ArrayDouble &decays);
+  ulong get_n_decays() const;
+
+  void set_data(const SArrayDoublePtrList2D &timestamps_list, const VArrayDoublePtr end_times);
+  void incremental_set_data(const SArrayDoublePtrList1D &timestamps, double end_time);
+
+  void compute_weights();
+};
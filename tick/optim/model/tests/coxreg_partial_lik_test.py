@@ -26,6 +26,30 @@ class Test(TestGLM):
         model_spars.fit(csr_matrix(features), times, censoring)
         self.run_test_for_glm(model, model_spars, 1e-5, 1e-4)
 
+    def test_ModelCoxRegPartialLik_loss_and_grad(self):
+        """...Test that loss_and_grad of Cox Regression agrees with loss and
+        grad, for dense and sparse features and several threads
+        """
+        np.random.seed(123)
+        n_samples, n_features = 100, 5
+        w0 = np.random.randn(n_features)
+        features, times, censoring = SimuCoxReg(w0, n_samples=n_samples,
+                                                verbose=False,
+                                                seed=1234).simulate()
+        coeffs = np.random.randn(n_features)
+        model = ModelCoxRegPartialLik().fit(features, times, censoring)
+        loss = model.loss(coeffs)
+        grad = model.grad(coeffs)
+        for n_threads in [1, 3]:
+            for X in [features, csr_matrix(features)]:
+                model_threads = ModelCoxRegPartialLik(n_threads=n_threads)
+                model_threads.fit(X, times, censoring)
+                loss_threads, grad_threads = \
+                    model_threads.loss_and_grad(coeffs)
+                self.assertAlmostEqual(loss, loss_threads)
+                np.testing.assert_almost_equal(grad, grad_threads,
+                                               decimal=10)
+
 
 if __name__ == '__main__':
     unittest.main()
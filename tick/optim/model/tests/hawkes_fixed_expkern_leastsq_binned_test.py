@@ -0,0 +1,85 @@
+# License: BSD 3 clause
+
+import unittest
+import numpy as np
+from scipy.optimize import check_grad
+
+from tick.optim.model import ModelHawkesFixedExpKernLeastSq, \
+    ModelHawkesFixedExpKernLeastSqBinned
+
+
+class Test(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(30732)
+
+        self.n_nodes = 3
+        self.n_realizations = 2
+        self.decays = np.random.rand(self.n_nodes, self.n_nodes) + 0.5
+
+        self.timestamps_list = [
+            [np.cumsum(np.random.random(np.random.randint(20, 40)))
+             for _ in range(self.n_nodes)]
+            for _ in range(self.n_realizations)]
+        self.end_times = np.array([max(map(max, timestamps)) + 1.
+                                   for timestamps in self.timestamps_list])
+
+        self.baseline = np.random.rand(self.n_nodes)
+        self.adjacency = np.random.rand(self.n_nodes, self.n_nodes)
+        self.coeffs = np.hstack((self.baseline, self.adjacency.ravel()))
+
+        self.model = ModelHawkesFixedExpKernLeastSq(self.decays)
+        self.model.fit(self.timestamps_list, end_times=self.end_times)
+
+    def test_model_hawkes_binned_bias(self):
+        """...Test that the loss of ModelHawkesFixedExpKernLeastSqBinned gets
+        closer to the one of ModelHawkesFixedExpKernLeastSq as bins get
+        smaller
+        """
+        loss = self.model.loss(self.coeffs)
+        errors = []
+        for bin_size in [1., 1e-2, 1e-4]:
+            model_binned = ModelHawkesFixedExpKernLeastSqBinned(
+                self.decays, bin_size=bin_size, n_threads=2)
+            model_binned.fit(self.timestamps_list, end_times=self.end_times)
+            self.assertEqual(model_binned.n_jumps, self.model.n_jumps)
+            errors.append(abs(model_binned.loss(self.coeffs) - loss))
+
+        self.assertLess(errors[-1], errors[0])
+        self.assertLess(errors[-1], 1e-3 * abs(loss))
+
+    def test_model_hawkes_binned_grad(self):
+        """...Test that ModelHawkesFixedExpKernLeastSqBinned gradient and
+        hessian are consistent with its loss
+        """
+        model_binned = ModelHawkesFixedExpKernLeastSqBinned(
+            self.decays, bin_size=0.1)
+        model_binned.fit(self.timestamps_list, end_times=self.end_times)
+
+        self.assertLess(check_grad(model_binned.loss, model_binned.grad,
+                                   self.coeffs), 1e-5)
+        hessian = model_binned.hessian(self.coeffs).toarray()
+        np.testing.assert_array_almost_equal(
+            hessian.dot(self.coeffs),
+            model_binned.grad(self.coeffs) -
+            model_binned.grad(np.zeros_like(self.coeffs)))
+
+    def test_model_hawkes_binned_incremental_fit(self):
+        """...Test that incremental_fit of ModelHawkesFixedExpKernLeastSqBinned
+        gives the same loss as fit
+        """
+        model_binned = ModelHawkesFixedExpKernLeastSqBinned(
+            self.decays, bin_size=0.1)
+        model_binned.fit(self.timestamps_list, end_times=self.end_times)
+
+        model_incremental = ModelHawkesFixedExpKernLeastSqBinned(
+            self.decays, bin_size=0.1)
+        for timestamps, end_time in zip(self.timestamps_list,
+                                        self.end_times):
+            model_incremental.incremental_fit(timestamps, end_time=end_time)
+
+        self.assertEqual(model_incremental.loss(self.coeffs),
+                         model_binned.loss(self.coeffs))
+
+
+if __name__ == '__main__':
+    unittest.main()
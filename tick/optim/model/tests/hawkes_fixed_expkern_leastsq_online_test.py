@@ -0,0 +1,91 @@
+# License: BSD 3 clause
+
+import unittest
+import numpy as np
+from scipy.optimize import check_grad
+
+from tick.optim.model import ModelHawkesFixedExpKernLeastSq, \
+    ModelHawkesFixedExpKernLeastSqOnline
+
+
+class Test(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(30732)
+
+        self.n_nodes = 3
+        self.decay = np.random.rand() + 0.5
+
+        self.timestamps = [np.cumsum(np.random.random(np.random.randint(6, 12)))
+                           for _ in range(self.n_nodes)]
+        self.end_time = max(map(max, self.timestamps)) + 1.
+
+        self.baseline = np.random.rand(self.n_nodes)
+        self.adjacency = np.random.rand(self.n_nodes, self.n_nodes)
+        self.coeffs = np.hstack((self.baseline, self.adjacency.ravel()))
+
+        self.model = ModelHawkesFixedExpKernLeastSq(self.decay)
+        self.model.fit(self.timestamps, end_times=self.end_time)
+
+    def test_model_hawkes_online_fit(self):
+        """...Test that ModelHawkesFixedExpKernLeastSqOnline fitted on all
+        events matches ModelHawkesFixedExpKernLeastSq
+        """
+        model_online = ModelHawkesFixedExpKernLeastSqOnline(self.decay)
+        model_online.fit(self.timestamps, end_times=self.end_time)
+
+        self.assertEqual(model_online.n_jumps, self.model.n_jumps)
+        self.assertAlmostEqual(model_online.loss(self.coeffs),
+                               self.model.loss(self.coeffs), places=10)
+        np.testing.assert_array_almost_equal(model_online.grad(self.coeffs),
+                                             self.model.grad(self.coeffs),
+                                             decimal=10)
+
+    def test_model_hawkes_online_append(self):
+        """...Test that appending events by batches to
+        ModelHawkesFixedExpKernLeastSqOnline gives the same loss as
+        giving them at once
+        """
+        model_online = ModelHawkesFixedExpKernLeastSqOnline(self.decay)
+        split_times = np.linspace(0, self.end_time, 4)[1:]
+        previous_time = -1.
+        for split_time in split_times:
+            batch = [t[(t > previous_time) & (t <= split_time)]
+                     for t in self.timestamps]
+            model_online.append(batch, end_time=split_time)
+            previous_time = split_time
+
+        self.assertEqual(model_online.end_time, self.end_time)
+        self.assertAlmostEqual(model_online.loss(self.coeffs),
+                               self.model.loss(self.coeffs), places=10)
+        np.testing.assert_array_almost_equal(model_online.grad(self.coeffs),
+                                             self.model.grad(self.coeffs),
+                                             decimal=10)
+
+    def test_model_hawkes_online_window(self):
+        """...Test that ModelHawkesFixedExpKernLeastSqOnline with a window
+        only counts the events of the window and has a consistent gradient
+        """
+        window_length = self.end_time / 2
+        model_online = ModelHawkesFixedExpKernLeastSqOnline(
+            self.decay, window_length=window_length)
+        model_online.fit(self.timestamps, end_times=self.end_time)
+
+        n_jumps_in_window = sum(np.sum(t > self.end_time - window_length)
+                                for t in self.timestamps)
+        self.assertEqual(model_online.n_jumps, n_jumps_in_window)
+        self.assertLess(check_grad(model_online.loss, model_online.grad,
+                                   self.coeffs), 1e-5)
+
+    def test_model_hawkes_online_append_errors(self):
+        """...Test that ModelHawkesFixedExpKernLeastSqOnline refuses events
+        older than its end time
+        """
+        model_online = ModelHawkesFixedExpKernLeastSqOnline(self.decay)
+        model_online.fit(self.timestamps, end_times=self.end_time)
+
+        with self.assertRaisesRegex(RuntimeError, "before previous end_time"):
+            model_online.append(self.timestamps, self.end_time + 1.)
+
+
+if __name__ == '__main__':
+    unittest.main()
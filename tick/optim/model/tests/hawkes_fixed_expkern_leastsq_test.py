@@ -145,6 +145,32 @@ class Test(unittest.TestCase):
         self.assertEqual(self.model_list.loss(self.coeffs),
                          model_change_decay.loss(self.coeffs))
 
+    def test_model_hawkes_least_sq_weights_for_decays(self):
+        """...Test that ModelHawkesFixedExpKernLeastSq with weights
+        precomputed for several decays is consistent with a model fitted with
+        each decay
+        """
+        decays = [0.5, 1.3, 2.]
+        model = ModelHawkesFixedExpKernLeastSq(decays=1.)
+        model.fit(self.timestamps_list)
+        model.compute_weights_for_decays(decays)
+        np.testing.assert_array_equal(model.cached_decays, decays)
+
+        for decay in decays:
+            model.decays = decay
+            model_decay = ModelHawkesFixedExpKernLeastSq(decays=decay)
+            model_decay.fit(self.timestamps_list)
+            self.assertAlmostEqual(model.loss(self.coeffs),
+                                   model_decay.loss(self.coeffs), places=10)
+            np.testing.assert_array_almost_equal(
+                model.grad(self.coeffs), model_decay.grad(self.coeffs),
+                decimal=10)
+
+        # Non constant decays are computed as usual
+        model.decays = self.decays
+        self.assertEqual(model.loss(self.coeffs),
+                         self.model_list.loss(self.coeffs))
+
     def test_hawkes_list_n_threads(self):
         """...Test that the number of used threads is as expected
         """
@@ -124,6 +124,22 @@ class Test(unittest.TestCase):
         self.assertAlmostEqual(finite_diff_result,
                                self.model.hessian_norm(hessian_point, vector))
 
+    def test_model_hawkes_loglik_hessian_vector_product(self):
+        """...Test that ModelHawkesFixedExpKernLogLik hessian vector product
+        is consistent with gradient and hessian norm
+        """
+        hessian_point = np.random.rand(self.model.n_coeffs)
+        vector = np.random.rand(self.model.n_coeffs)
+        product = self.model.hessian_vector_product(hessian_point, vector)
+
+        delta = 1e-7
+        finite_diff_result = self.model.grad(hessian_point + delta * vector)
+        finite_diff_result -= self.model.grad(hessian_point - delta * vector)
+        finite_diff_result /= (2 * delta)
+        np.testing.assert_array_almost_equal(product, finite_diff_result)
+        self.assertAlmostEqual(vector.dot(product),
+                               self.model.hessian_norm(hessian_point, vector))
+
     def test_model_hawkes_loglik_change_decays(self):
         """...Test that loss is still consistent after decays modification in
         ModelHawkesFixedExpKernLogLik
@@ -144,6 +160,51 @@ class Test(unittest.TestCase):
         self.assertEqual(self.model_list.loss(self.coeffs),
                          model_change_decay.loss(self.coeffs))
 
+    def test_model_hawkes_loglik_weights_threshold(self):
+        """...Test that ModelHawkesFixedExpKernLogLik with truncated weights
+        approximates the full model and stores fewer weights
+        """
+        model_threshold = ModelHawkesFixedExpKernLogLik(
+            self.decay, weights_threshold=1e-300)
+        model_threshold.fit(self.timestamps_list)
+        self.assertAlmostEqual(model_threshold.loss(self.coeffs),
+                               self.model_list.loss(self.coeffs), places=12)
+        np.testing.assert_array_almost_equal(
+            model_threshold.grad(self.coeffs),
+            self.model_list.grad(self.coeffs), decimal=12)
+        self.assertLess(model_threshold.n_stored_weights,
+                        self.model_list.n_stored_weights)
+
+        model_threshold.weights_threshold = 0.1
+        self.assertAlmostEqual(model_threshold.loss(self.coeffs),
+                               self.model_list.loss(self.coeffs), places=1)
+        self.assertLess(check_grad(model_threshold.loss, model_threshold.grad,
+                                   self.coeffs), 1e-5)
+
+    def test_model_hawkes_loglik_weights_for_decays(self):
+        """...Test that ModelHawkesFixedExpKernLogLik with weights precomputed
+        for several decays is consistent with a model fitted with each decay
+        """
+        decays = [0.5, 1.3, 2.]
+        model = ModelHawkesFixedExpKernLogLik(self.decay)
+        model.fit(self.timestamps_list)
+        model.compute_weights_for_decays(decays)
+        np.testing.assert_array_equal(model.cached_decays, decays)
+
+        for decay in decays + [self.decay]:
+            model.decay = decay
+            model_decay = ModelHawkesFixedExpKernLogLik(decay)
+            model_decay.fit(self.timestamps_list)
+            self.assertAlmostEqual(model.loss(self.coeffs),
+                                   model_decay.loss(self.coeffs), places=12)
+            np.testing.assert_array_almost_equal(
+                model.grad(self.coeffs), model_decay.grad(self.coeffs),
+                decimal=12)
+
+        # Cached weights are discarded with the data
+        model.fit(self.timestamps_list)
+        self.assertEqual(len(model.cached_decays), 0)
+
     def test_hawkes_list_n_threads(self):
         """...Test that the number of used threads is as expected
         """
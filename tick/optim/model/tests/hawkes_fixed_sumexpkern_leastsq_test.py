@@ -82,6 +82,26 @@ class Test(InferenceTest):
         model.period_length = new_period_length
         np.testing.assert_array_equal(model.period_length, new_period_length)
 
+    def test_model_hawkes_least_sq_float_weights(self):
+        """...Test that ModelHawkesFixedSumExpKernLeastSq loss and gradient
+        are barely changed when weights are stored in single precision
+        """
+        model_float = ModelHawkesFixedSumExpKernLeastSq(
+            decays=self.decays, float_weights=True)
+        model_float.fit(self.timestamps_list)
+        self.assertTrue(model_float._model.get_float_weights())
+
+        loss = self.model_list.loss(self.coeffs)
+        self.assertAlmostEqual(model_float.loss(self.coeffs) / loss, 1,
+                               places=6)
+        np.testing.assert_array_almost_equal(
+            model_float.grad(self.coeffs), self.model_list.grad(self.coeffs),
+            decimal=5)
+
+        # Weights are computed again in double precision
+        model_float.float_weights = False
+        self.assertEqual(model_float.loss(self.coeffs), loss)
+
     def test_baseline_intervals(self):
         """...Test baseline intervals property of 
         ModelHawkesFixedSumExpKernLeastSq
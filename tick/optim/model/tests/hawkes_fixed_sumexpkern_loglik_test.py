@@ -0,0 +1,186 @@
+# License: BSD 3 clause
+
+import unittest
+import numpy as np
+from scipy.optimize import check_grad
+
+from tick.optim.model import ModelHawkesFixedSumExpKernLogLik, \
+    ModelHawkesFixedExpKernLogLik
+from tick.optim.model.tests.hawkes_utils import hawkes_log_likelihood, \
+    hawkes_sumexp_kernel_intensities
+
+
+class Test(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(30732)
+
+        self.n_nodes = 3
+        self.n_realizations = 2
+        self.n_decays = 2
+
+        self.decays = np.random.rand(self.n_decays)
+
+        self.timestamps_list = [
+            [np.cumsum(np.random.random(np.random.randint(3, 7)))
+             for _ in range(self.n_nodes)]
+            for _ in range(self.n_realizations)]
+
+        self.end_time = 10
+
+        self.baseline = np.random.rand(self.n_nodes)
+        self.adjacency = np.random.rand(self.n_nodes, self.n_nodes,
+                                        self.n_decays)
+        self.coeffs = np.hstack((self.baseline, self.adjacency.ravel()))
+
+        self.realization = 0
+        self.model = ModelHawkesFixedSumExpKernLogLik(self.decays)
+        self.model.fit(self.timestamps_list[self.realization],
+                       end_times=self.end_time)
+
+        self.model_list = ModelHawkesFixedSumExpKernLogLik(self.decays)
+        self.model_list.fit(self.timestamps_list)
+
+    def test_model_hawkes_losses(self):
+        """...Test that computed losses are consistent with approximated
+        theoretical values
+        """
+        timestamps = self.timestamps_list[self.realization]
+
+        intensities = hawkes_sumexp_kernel_intensities(
+            self.baseline, self.decays, self.adjacency, timestamps)
+
+        precision = 3
+        integral_approx = hawkes_log_likelihood(
+            intensities, timestamps, self.end_time, precision=precision)
+        integral_approx /= self.model.n_jumps
+
+        self.assertAlmostEqual(integral_approx, self.model.loss(self.coeffs),
+                               places=precision)
+
+    def test_model_hawkes_loglik_multiple_events(self):
+        """...Test that multiple events list for
+        ModelHawkesFixedSumExpKernLogLik is consistent with direct integral
+        estimation
+        """
+        end_times = np.array([max(map(max, e)) for e in self.timestamps_list])
+        end_times += 1.
+        self.model_list.fit(self.timestamps_list, end_times=end_times)
+
+        intensities_list = [
+            hawkes_sumexp_kernel_intensities(self.baseline, self.decays,
+                                             self.adjacency, timestamps)
+            for timestamps in self.timestamps_list
+        ]
+
+        integral_approx = sum([hawkes_log_likelihood(intensities,
+                                                     timestamps, end_time)
+                               for (intensities, timestamps, end_time) in zip(
+                intensities_list, self.timestamps_list,
+                self.model_list.end_times
+            )])
+
+        integral_approx /= self.model_list.n_jumps
+        self.assertAlmostEqual(integral_approx,
+                               self.model_list.loss(self.coeffs),
+                               places=2)
+
+    def test_model_hawkes_loglik_incremental_fit(self):
+        """...Test that multiple events list for
+        ModelHawkesFixedSumExpKernLogLik are correctly handle with
+        incremental_fit
+        """
+        model_incremental_fit = ModelHawkesFixedSumExpKernLogLik(self.decays)
+
+        for timestamps in self.timestamps_list:
+            model_incremental_fit.incremental_fit(timestamps)
+
+        self.assertAlmostEqual(model_incremental_fit.loss(self.coeffs),
+                               self.model_list.loss(self.coeffs), places=12)
+
+    def test_model_hawkes_loglik_grad(self):
+        """...Test that ModelHawkesFixedSumExpKernLogLik gradient is
+        consistent with loss
+        """
+        self.assertLess(check_grad(self.model.loss, self.model.grad,
+                                   self.coeffs),
+                        1e-5)
+        self.assertLess(check_grad(self.model_list.loss, self.model_list.grad,
+                                   self.coeffs),
+                        1e-5)
+
+    def test_model_hawkes_loglik_loss_and_grad(self):
+        """...Test that ModelHawkesFixedSumExpKernLogLik fused loss and
+        gradient are consistent with loss and gradient
+        """
+        grad = np.empty(self.model_list.n_coeffs)
+        loss = self.model_list._model.loss_and_grad(self.coeffs, grad)
+        self.assertAlmostEqual(loss, self.model_list.loss(self.coeffs))
+        np.testing.assert_array_almost_equal(
+            grad, self.model_list.grad(self.coeffs))
+
+    def test_hawkesgrad_hess_norm(self):
+        """...Test if grad and log likelihood are correctly computed
+        """
+        hessian_point = np.random.rand(self.model.n_coeffs)
+        vector = np.random.rand(self.model.n_coeffs)
+
+        delta = 1e-7
+        grad_point_minus = self.model.grad(hessian_point + delta * vector)
+        grad_point_plus = self.model.grad(hessian_point - delta * vector)
+        finite_diff_result = vector.dot(grad_point_minus - grad_point_plus)
+        finite_diff_result /= (2 * delta)
+        self.assertAlmostEqual(finite_diff_result,
+                               self.model.hessian_norm(hessian_point, vector))
+
+    def test_model_hawkes_loglik_single_decay(self):
+        """...Test that ModelHawkesFixedSumExpKernLogLik with a single decay
+        matches ModelHawkesFixedExpKernLogLik
+        """
+        decay = self.decays[0]
+        coeffs = np.hstack((self.baseline, self.adjacency[:, :, 0].ravel()))
+
+        model_sumexp = ModelHawkesFixedSumExpKernLogLik([decay])
+        model_sumexp.fit(self.timestamps_list)
+        model_exp = ModelHawkesFixedExpKernLogLik(decay)
+        model_exp.fit(self.timestamps_list)
+
+        self.assertAlmostEqual(model_sumexp.loss(coeffs),
+                               model_exp.loss(coeffs), places=12)
+        np.testing.assert_array_almost_equal(model_sumexp.grad(coeffs),
+                                             model_exp.grad(coeffs),
+                                             decimal=12)
+
+    def test_model_hawkes_loglik_change_decays(self):
+        """...Test that loss is still consistent after decays modification in
+        ModelHawkesFixedSumExpKernLogLik
+        """
+        decays = np.random.rand(self.n_decays)
+
+        model_change_decay = ModelHawkesFixedSumExpKernLogLik(decays)
+        model_change_decay.fit(self.timestamps_list)
+        loss_old_decay = model_change_decay.loss(self.coeffs)
+
+        model_change_decay.decays = self.decays
+
+        self.assertNotEqual(loss_old_decay,
+                            model_change_decay.loss(self.coeffs))
+
+        self.assertEqual(self.model_list.loss(self.coeffs),
+                         model_change_decay.loss(self.coeffs))
+
+    def test_model_hawkes_loglik_n_threads(self):
+        """...Test that ModelHawkesFixedSumExpKernLogLik gives the same
+        result with several threads
+        """
+        model_threads = ModelHawkesFixedSumExpKernLogLik(self.decays,
+                                                         n_threads=3)
+        model_threads.fit(self.timestamps_list)
+        self.assertAlmostEqual(model_threads.loss(self.coeffs),
+                               self.model_list.loss(self.coeffs), places=12)
+        np.testing.assert_array_almost_equal(
+            model_threads.grad(self.coeffs), self.model_list.grad(self.coeffs),
+            decimal=12)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -67,6 +67,47 @@ class ModelSCCSTest(unittest.TestCase):
             .fit(X_sparse, y, censoring)
         self._test_grad(model, coeffs)
 
+    def test_n_threads(self):
+        """Test longitudinal multinomial model loss and gradient do not
+        depend on the number of threads."""
+        sim = SimuSCCS(100, 10, 3, 2, None, True, "short", seed=42,
+                       verbose=False)
+        X, y, censoring, coeffs = sim.simulate()
+        X = LongitudinalFeaturesLagger(n_lags=2) \
+            .fit_transform(X, censoring)
+        model = ModelSCCS(n_intervals=10, n_lags=2)\
+            .fit(X, y, censoring)
+        model_threads = ModelSCCS(n_intervals=10, n_lags=2, n_threads=4)\
+            .fit(X, y, censoring)
+        self.assertAlmostEqual(model.loss(coeffs),
+                               model_threads.loss(coeffs))
+        np.testing.assert_almost_equal(model.grad(coeffs),
+                                       model_threads.grad(coeffs),
+                                       decimal=10)
+
+    def test_implicit_lags(self):
+        """Test longitudinal multinomial model with lags computed on the fly
+        gives the same results as with lagged features."""
+        sim = SimuSCCS(100, 10, 3, 2, None, True, "short", seed=42,
+                       verbose=False)
+        X, y, censoring, coeffs = sim.simulate()
+        X_lagged = LongitudinalFeaturesLagger(n_lags=2) \
+            .fit_transform(X, censoring)
+        model = ModelSCCS(n_intervals=10, n_lags=2)\
+            .fit(X_lagged, y, censoring)
+        for features in [X, [csr_matrix(x) for x in X]]:
+            model_implicit = ModelSCCS(n_intervals=10, n_lags=2,
+                                       implicit_lags=True)\
+                .fit(features, y, censoring)
+            self.assertEqual(model.n_coeffs, model_implicit.n_coeffs)
+            self.assertAlmostEqual(model.loss(coeffs),
+                                   model_implicit.loss(coeffs))
+            np.testing.assert_almost_equal(model.grad(coeffs),
+                                           model_implicit.grad(coeffs),
+                                           decimal=10)
+            self.assertAlmostEqual(model.get_lip_max(),
+                                   model_implicit.get_lip_max())
+
     def test_lipschitz_constant(self):
         """Test longitudinal multinomial model Lipschitz constant."""
         X = [np.array([[0, 0, 1],
@@ -12,10 +12,15 @@
 #include "hawkes_fixed_expkern_loglik.h"
 #include "hawkes_fixed_expkern_leastsq.h"
 #include "hawkes_fixed_sumexpkern_leastsq.h"
+#include "hawkes_fixed_sumexpkern_loglik.h"
+#include "hawkes_utils.h"
 
 #include "variants/hawkes_fixed_expkern_leastsq_list.h"
+#include "variants/hawkes_fixed_expkern_leastsq_online.h"
+#include "variants/hawkes_fixed_expkern_leastsq_binned.h"
 #include "variants/hawkes_fixed_sumexpkern_leastsq_list.h"
 #include "variants/hawkes_fixed_expkern_loglik_list.h"
+#include "variants/hawkes_fixed_sumexpkern_loglik_list.h"
 
 
 class HawkesModelTest : public ::testing::Test {
@@ -32,6 +37,34 @@ class HawkesModelTest : public ::testing::Test {
   }
 };
 
+TEST_F(HawkesModelTest, event_stream){
+  // Third node has events simultaneous with the other nodes and with itself
+  ArrayDouble timestamps_2 = ArrayDouble {0.12, 2.41, 2.41, 4.5};
+  timestamps.push_back(timestamps_2.as_sarray_ptr());
+
+  HawkesEventStream stream(timestamps);
+  ASSERT_EQ(stream.size(), 15u);
+
+  ArrayDouble expected_times {0.12, 0.12, 0.31, 0.93, 1.19, 1.29, 2.12, 2.32, 2.41, 2.41, 2.41,
+                              3.35, 4.21, 4.25, 4.5};
+  ArrayULong expected_nodes {1, 2, 0, 0, 1, 0, 1, 0, 1, 2, 2, 1, 1, 0, 2};
+  ArrayULong expected_indices {0, 0, 0, 1, 1, 2, 2, 3, 3, 1, 2, 4, 5, 4, 3};
+  for (ulong e = 0; e < stream.size(); ++e) {
+    SCOPED_TRACE(e);
+    EXPECT_EQ(stream.get_time(e), expected_times[e]);
+    EXPECT_EQ(stream.get_node(e), expected_nodes[e]);
+    EXPECT_EQ(stream.get_index(e), expected_indices[e]);
+  }
+
+  for (ulong i = 0; i < timestamps.size(); ++i) {
+    for (ulong k = 0; k < timestamps[i]->size(); ++k) {
+      const ulong e = stream.get_position(i, k);
+      EXPECT_EQ(stream.get_node(e), i);
+      EXPECT_EQ(stream.get_index(e), k);
+    }
+  }
+}
+
 TEST_F(HawkesModelTest, compute_weights_loglikelihood){
   ModelHawkesFixedExpKernLogLik model(2);
   model.set_data(timestamps, 4.25);
@@ -81,6 +114,233 @@ TEST_F(HawkesModelTest, check_sto_loglikelihood){
   }
 }
 
+TEST_F(HawkesModelTest, hessian_vector_product_loglikelihood){
+  ModelHawkesFixedExpKernLogLik model(2, 2);
+  model.set_data(timestamps, 6.);
+  ArrayDouble coeffs = ArrayDouble {1., 3., 2., 3., 4., 1};
+  ArrayDouble vector = ArrayDouble {1, 3., 3., 7., 8., 1};
+
+  ArrayDouble product(model.get_n_coeffs());
+  model.hessian_vector_product(coeffs, vector, product);
+  EXPECT_DOUBLE_EQ(vector.dot(product), model.hessian_norm(coeffs, vector));
+
+  // The loss being smooth, the product is the derivative of the gradient along vector
+  const double epsilon = 1e-6;
+  ArrayDouble coeffs_plus = coeffs, coeffs_minus = coeffs;
+  coeffs_plus.mult_incr(vector, epsilon);
+  coeffs_minus.mult_incr(vector, -epsilon);
+  ArrayDouble grad_plus(model.get_n_coeffs()), grad_minus(model.get_n_coeffs());
+  model.grad(coeffs_plus, grad_plus);
+  model.grad(coeffs_minus, grad_minus);
+  for (ulong i = 0; i < model.get_n_coeffs(); ++i) {
+    SCOPED_TRACE(i);
+    EXPECT_NEAR(product[i], (grad_plus[i] - grad_minus[i]) / (2 * epsilon), 1e-6);
+  }
+}
+
+TEST_F(HawkesModelTest, compressed_weights_loglikelihood){
+  ModelHawkesFixedExpKernLogLik dense_model(2);
+  dense_model.set_data(timestamps, 6.);
+  ArrayDouble coeffs = ArrayDouble {1., 3., 2., 3., 4., 1};
+  ArrayDouble vector = ArrayDouble {1, 3., 3., 7., 8., 1};
+
+  ArrayDouble dense_grad(dense_model.get_n_coeffs());
+  const double dense_loss = dense_model.loss_and_grad(coeffs, dense_grad);
+
+  // A tiny threshold only drops zero weights and leaves the model unchanged
+  ModelHawkesFixedExpKernLogLik model(2);
+  model.set_data(timestamps, 6.);
+  model.set_weights_threshold(1e-300);
+  ArrayDouble grad(model.get_n_coeffs());
+  EXPECT_DOUBLE_EQ(model.loss_and_grad(coeffs, grad), dense_loss);
+  for (ulong i = 0; i < model.get_n_coeffs(); ++i) {
+    SCOPED_TRACE(i);
+    EXPECT_DOUBLE_EQ(grad[i], dense_grad[i]);
+  }
+  EXPECT_DOUBLE_EQ(model.hessian_norm(coeffs, vector),
+                   dense_model.hessian_norm(coeffs, vector));
+  for (ulong i = 0; i < model.get_rand_max(); ++i) {
+    SCOPED_TRACE(i);
+    EXPECT_NEAR(model.loss_i(i, coeffs), dense_model.loss_i(i, coeffs), 1e-12);
+  }
+  EXPECT_LT(model.get_n_stored_weights(), dense_model.get_n_stored_weights());
+
+  // Dropping weights lowers intensities, hence stored weights and loss
+  const ulong n_stored_weights = model.get_n_stored_weights();
+  model.set_weights_threshold(0.5);
+  const double truncated_loss = model.loss(coeffs);
+  EXPECT_LT(model.get_n_stored_weights(), n_stored_weights);
+  EXPECT_GT(truncated_loss, dense_loss);
+  EXPECT_NEAR(truncated_loss, dense_loss, 0.5);
+}
+
+TEST_F(HawkesModelTest, weights_for_decays_loglikelihood){
+  ArrayDouble decays = ArrayDouble {0.5, 2., 3.};
+  ArrayDouble coeffs = ArrayDouble {1., 3., 2., 3., 4., 1};
+  ArrayDouble vector = ArrayDouble {1, 3., 3., 7., 8., 1};
+
+  ModelHawkesFixedExpKernLogLik model(2);
+  model.set_data(timestamps, 6.);
+  model.compute_weights_for_decays(decays);
+  EXPECT_EQ(model.get_cached_decays()->size(), 3);
+
+  for (ulong d = 0; d < decays.size(); ++d) {
+    SCOPED_TRACE(d);
+    ModelHawkesFixedExpKernLogLik fresh_model(decays[d]);
+    fresh_model.set_data(timestamps, 6.);
+    ArrayDouble fresh_grad(fresh_model.get_n_coeffs());
+    const double fresh_loss = fresh_model.loss_and_grad(coeffs, fresh_grad);
+
+    model.set_decay(decays[d]);
+    ArrayDouble grad(model.get_n_coeffs());
+    EXPECT_NEAR(model.loss_and_grad(coeffs, grad), fresh_loss, 1e-12);
+    for (ulong i = 0; i < model.get_n_coeffs(); ++i) {
+      EXPECT_NEAR(grad[i], fresh_grad[i], 1e-12);
+    }
+    EXPECT_NEAR(model.hessian_norm(coeffs, vector),
+                fresh_model.hessian_norm(coeffs, vector), 1e-12);
+  }
+
+  // A decay outside of the grid is computed as usual
+  ModelHawkesFixedExpKernLogLik fresh_model(1.);
+  fresh_model.set_data(timestamps, 6.);
+  model.set_decay(1.);
+  EXPECT_DOUBLE_EQ(model.loss(coeffs), fresh_model.loss(coeffs));
+
+  // Cached weights are discarded with the data
+  model.set_data(timestamps, 6.);
+  EXPECT_EQ(model.get_cached_decays()->size(), 0);
+}
+
+TEST_F(HawkesModelTest, sum_exp_kern_single_decay_loglikelihood){
+  ArrayDouble coeffs = ArrayDouble {1., 3., 2., 3., 4., 1};
+  ArrayDouble vector = ArrayDouble {1, 3., 3., 7., 8., 1};
+
+  ModelHawkesFixedExpKernLogLik exp_model(2);
+  exp_model.set_data(timestamps, 6.);
+  ArrayDouble exp_grad(exp_model.get_n_coeffs());
+  const double exp_loss = exp_model.loss_and_grad(coeffs, exp_grad);
+
+  ModelHawkesFixedSumExpKernLogLik model(ArrayDouble {2.}, 2);
+  model.set_data(timestamps, 6.);
+  EXPECT_EQ(model.get_n_coeffs(), exp_model.get_n_coeffs());
+
+  ArrayDouble grad(model.get_n_coeffs());
+  EXPECT_NEAR(model.loss_and_grad(coeffs, grad), exp_loss, 1e-12);
+  for (ulong i = 0; i < model.get_n_coeffs(); ++i) {
+    SCOPED_TRACE(i);
+    EXPECT_NEAR(grad[i], exp_grad[i], 1e-12);
+  }
+  EXPECT_NEAR(model.hessian_norm(coeffs, vector), exp_model.hessian_norm(coeffs, vector),
+              1e-12);
+  for (ulong i = 0; i < model.get_rand_max(); ++i) {
+    SCOPED_TRACE(i);
+    EXPECT_NEAR(model.loss_i(i, coeffs), exp_model.loss_i(i, coeffs), 1e-12);
+  }
+}
+
+TEST_F(HawkesModelTest, sum_exp_kern_loglikelihood){
+  ArrayDouble decays = ArrayDouble {0.5, 2., 3.};
+  // Kernel with decay 2 only, and all three decays
+  ArrayDouble coeffs_decay_2 = ArrayDouble {1., 3., 0., 2., 0., 0., 3., 0.,
+                                            0., 4., 0., 0., 1., 0.};
+  ArrayDouble coeffs = ArrayDouble {1., 3., 0.2, 2., 0.5, 0.1, 3., 0.7,
+                                    0.4, 4., 0.3, 0.6, 1., 0.8};
+
+  ModelHawkesFixedExpKernLogLik exp_model(2);
+  exp_model.set_data(timestamps, 6.);
+  ModelHawkesFixedSumExpKernLogLik model(decays);
+  model.set_data(timestamps, 6.);
+  EXPECT_EQ(model.get_n_coeffs(), 14);
+  EXPECT_NEAR(model.loss(coeffs_decay_2), exp_model.loss(ArrayDouble {1., 3., 2., 3., 4., 1}),
+              1e-12);
+
+  const double loss = model.loss(coeffs);
+  ArrayDouble grad(model.get_n_coeffs());
+  model.grad(coeffs, grad);
+
+  ArrayDouble fused_grad(model.get_n_coeffs());
+  EXPECT_DOUBLE_EQ(model.loss_and_grad(coeffs, fused_grad), loss);
+
+  double sum_sto_loss = 0;
+  ArrayDouble sto_grad(model.get_n_coeffs());
+  sto_grad.init_to_zero();
+  ArrayDouble tmp_sto_grad(model.get_n_coeffs());
+  for (ulong i = 0; i < model.get_rand_max(); ++i) {
+    sum_sto_loss += model.loss_i(i, coeffs) / model.get_rand_max();
+    tmp_sto_grad.init_to_zero();
+    model.grad_i(i, coeffs, tmp_sto_grad);
+    sto_grad.mult_incr(tmp_sto_grad, 1. / model.get_rand_max());
+  }
+  EXPECT_NEAR(loss, sum_sto_loss, 1e-12);
+
+  // Gradient is checked against finite differences
+  const double eps = 1e-6;
+  for (ulong i = 0; i < model.get_n_coeffs(); ++i) {
+    SCOPED_TRACE(i);
+    EXPECT_DOUBLE_EQ(fused_grad[i], grad[i]);
+    EXPECT_NEAR(sto_grad[i], grad[i], 1e-12);
+    ArrayDouble coeffs_plus = coeffs;
+    coeffs_plus[i] += eps;
+    ArrayDouble coeffs_minus = coeffs;
+    coeffs_minus[i] -= eps;
+    EXPECT_NEAR((model.loss(coeffs_plus) - model.loss(coeffs_minus)) / (2 * eps), grad[i],
+                1e-6);
+  }
+}
+
+TEST_F(HawkesModelTest, sum_exp_kern_loglikelihood_list){
+  ArrayDouble decays = ArrayDouble {0.5, 2., 3.};
+  ArrayDouble coeffs = ArrayDouble {1., 3., 0.2, 2., 0.5, 0.1, 3., 0.7,
+                                    0.4, 4., 0.3, 0.6, 1., 0.8};
+  ArrayDouble vector = ArrayDouble {1., 3., 3., 7., 8., 1., 2., 0.5,
+                                    1., 2., 3., 1., 0.5, 1.};
+
+  auto timestamps_list = SArrayDoublePtrList2D(0);
+  timestamps_list.push_back(timestamps);
+  timestamps_list.push_back(timestamps);
+  auto end_times = VArrayDouble::new_ptr(2);
+  (*end_times)[0] = 5.65; (*end_times)[1] = 5.87;
+
+  ModelHawkesFixedSumExpKernLogLik model_0(decays);
+  model_0.set_data(timestamps, 5.65);
+  ModelHawkesFixedSumExpKernLogLik model_1(decays);
+  model_1.set_data(timestamps, 5.87);
+  const ulong n_jumps = model_0.get_n_total_jumps() + model_1.get_n_total_jumps();
+
+  ModelHawkesFixedSumExpKernLogLikList model(decays, 2);
+  model.set_data(timestamps_list, end_times);
+
+  ModelHawkesFixedSumExpKernLogLikList incremental_model(decays, 1);
+  incremental_model.incremental_set_data(timestamps, 5.65);
+  incremental_model.incremental_set_data(timestamps, 5.87);
+
+  ArrayDouble grad_0(model.get_n_coeffs()), grad_1(model.get_n_coeffs());
+  const double expected_loss = (model_0.loss_and_grad(coeffs, grad_0)
+      * model_0.get_n_total_jumps() + model_1.loss_and_grad(coeffs, grad_1)
+      * model_1.get_n_total_jumps()) / n_jumps;
+
+  ArrayDouble grad(model.get_n_coeffs());
+  EXPECT_NEAR(model.loss_and_grad(coeffs, grad), expected_loss, 1e-12);
+  EXPECT_NEAR(model.loss(coeffs), expected_loss, 1e-12);
+  EXPECT_NEAR(incremental_model.loss(coeffs), expected_loss, 1e-12);
+  for (ulong i = 0; i < model.get_n_coeffs(); ++i) {
+    SCOPED_TRACE(i);
+    const double expected_grad = (grad_0[i] * model_0.get_n_total_jumps()
+        + grad_1[i] * model_1.get_n_total_jumps()) / n_jumps;
+    EXPECT_NEAR(grad[i], expected_grad, 1e-12);
+  }
+
+  const double expected_hessian_norm = (model_0.hessian_norm(coeffs, vector)
+      * model_0.get_n_total_jumps() + model_1.hessian_norm(coeffs, vector)
+      * model_1.get_n_total_jumps()) / n_jumps;
+  EXPECT_NEAR(model.hessian_norm(coeffs, vector), expected_hessian_norm, 1e-12);
+
+  EXPECT_DOUBLE_EQ(model.loss_i(0, coeffs), model_0.loss_i(0, coeffs));
+  EXPECT_DOUBLE_EQ(model.loss_i(n_jumps - 1, coeffs),
+                   model_1.loss_i(model_1.get_rand_max() - 1, coeffs));
+}
+
 TEST_F(HawkesModelTest, compute_loss_least_squares){
   ArrayDouble2d decays(2, 2);
   decays.fill(2);
@@ -99,6 +359,134 @@ TEST_F(HawkesModelTest, compute_loss_least_squares){
   EXPECT_DOUBLE_EQ(model.get_n_coeffs(), 6);
 }
 
+TEST_F(HawkesModelTest, weights_for_decays_least_squares){
+  ArrayDouble decays = ArrayDouble {0.5, 2., 3.};
+  ArrayDouble coeffs = ArrayDouble {1., 3., 2., 3., 4., 1};
+
+  ModelHawkesFixedExpKernLeastSq model(SArrayDouble2d::new_ptr(2, 2), 2);
+  model.set_data(timestamps, 5.65);
+  model.compute_weights_for_decays(decays);
+
+  for (ulong d = 0; d < decays.size(); ++d) {
+    SCOPED_TRACE(d);
+    ArrayDouble2d decays_d(2, 2);
+    decays_d.fill(decays[d]);
+    ModelHawkesFixedExpKernLeastSq fresh_model(decays_d.as_sarray2d_ptr(), 2);
+    fresh_model.set_data(timestamps, 5.65);
+    ArrayDouble fresh_grad(fresh_model.get_n_coeffs());
+    const double fresh_loss = fresh_model.loss_and_grad(coeffs, fresh_grad);
+
+    decays_d = ArrayDouble2d(2, 2);
+    decays_d.fill(decays[d]);
+    model.set_decays(decays_d.as_sarray2d_ptr());
+    ArrayDouble grad(model.get_n_coeffs());
+    EXPECT_NEAR(model.loss_and_grad(coeffs, grad), fresh_loss, 1e-10);
+    for (ulong i = 0; i < model.get_n_coeffs(); ++i) {
+      EXPECT_NEAR(grad[i], fresh_grad[i], 1e-10);
+    }
+  }
+}
+
+TEST_F(HawkesModelTest, weights_for_decays_least_squares_list){
+  auto timestamps_list = SArrayDoublePtrList2D(0);
+  timestamps_list.push_back(timestamps);
+  timestamps_list.push_back(timestamps);
+
+  auto end_times = VArrayDouble::new_ptr(2);
+  (*end_times)[0] = 5.65; (*end_times)[1] = 5.87;
+
+  ModelHawkesFixedExpKernLeastSqList model(SArrayDouble2d::new_ptr(2, 2), 2);
+  model.set_data(timestamps_list, end_times);
+  model.compute_weights_for_decays(ArrayDouble {1., 2.});
+  model.set_decays(2.);
+
+  ArrayDouble coeffs = ArrayDouble {1., 3., 2., 3., 4., 1};
+
+  EXPECT_NEAR(model.loss_i(0, coeffs), 356.00492335074784, 1e-10);
+  EXPECT_NEAR(model.loss_i(1, coeffs), 603.45311621338624, 1e-10);
+  EXPECT_NEAR(model.loss(coeffs), 43.611729071097002, 1e-12);
+}
+
+TEST_F(HawkesModelTest, online_least_squares){
+  const double decay = 2.;
+  auto decays = SArrayDouble2d::new_ptr(2, 2);
+  decays->fill(decay);
+  ArrayDouble coeffs = ArrayDouble {1., 3., 2., 3., 4., 1};
+
+  ModelHawkesFixedExpKernLeastSq model(decays);
+  model.set_data(timestamps, 5.);
+  ArrayDouble grad(model.get_n_coeffs());
+  model.grad(coeffs, grad);
+
+  // Events are appended in three batches, the second one being empty for the first node
+  ModelHawkesFixedExpKernLeastSqOnline online_model(decay, 0., 2);
+  SArrayDoublePtrList1D batch_1 = {ArrayDouble {0.31, 0.93}.as_sarray_ptr(),
+                                   ArrayDouble {0.12}.as_sarray_ptr()};
+  SArrayDoublePtrList1D batch_2 = {ArrayDouble(0).as_sarray_ptr(),
+                                   ArrayDouble {1.19}.as_sarray_ptr()};
+  SArrayDoublePtrList1D batch_3 = {ArrayDouble {1.29, 2.32, 4.25}.as_sarray_ptr(),
+                                   ArrayDouble {2.12, 2.41, 3.35, 4.21}.as_sarray_ptr()};
+  online_model.append(batch_1, 1.);
+  online_model.append(batch_2, 1.19);
+  const double early_loss = online_model.loss(coeffs);
+  online_model.append(batch_3, 5.);
+  EXPECT_NE(online_model.loss(coeffs), early_loss);
+
+  EXPECT_EQ(online_model.get_n_total_jumps(), model.get_n_total_jumps());
+  EXPECT_NEAR(online_model.loss(coeffs), model.loss(coeffs), 1e-12);
+  ArrayDouble online_grad(online_model.get_n_coeffs());
+  online_model.grad(coeffs, online_grad);
+  for (ulong i = 0; i < model.get_n_coeffs(); ++i) {
+    SCOPED_TRACE(i);
+    EXPECT_NEAR(online_grad[i], grad[i], 1e-12);
+  }
+
+  EXPECT_THROW(online_model.append(batch_1, 6.), std::runtime_error);
+}
+
+TEST_F(HawkesModelTest, online_least_squares_window){
+  const double decay = 2.;
+  const double window_length = 2.5;
+  auto decays = SArrayDouble2d::new_ptr(2, 2);
+  decays->fill(decay);
+  ArrayDouble coeffs = ArrayDouble {1., 3., 2., 3., 4., 1};
+
+  // The loss on the window is the difference of the losses up to its end and its start
+  ModelHawkesFixedExpKernLeastSq model(decays);
+  model.set_data(timestamps, 5.);
+  ModelHawkesFixedExpKernLeastSq model_before_window(decays);
+  SArrayDoublePtrList1D timestamps_before_window = {
+      ArrayDouble {0.31, 0.93, 1.29, 2.32}.as_sarray_ptr(),
+      ArrayDouble {0.12, 1.19, 2.12, 2.41}.as_sarray_ptr()};
+  model_before_window.set_data(timestamps_before_window, 5. - window_length);
+  model.compute_weights();
+  model_before_window.compute_weights();
+
+  ModelHawkesFixedExpKernLeastSqOnline online_model(decay, window_length);
+  online_model.set_data(timestamps, 5.);
+  EXPECT_EQ(online_model.get_n_total_jumps(), 3);
+
+  for (ulong i = 0; i < 2; ++i) {
+    SCOPED_TRACE(i);
+    EXPECT_NEAR(online_model.loss_i(i, coeffs),
+                model.loss_i(i, coeffs) - model_before_window.loss_i(i, coeffs), 1e-12);
+  }
+
+  // Gradient is checked against finite differences
+  ArrayDouble grad(online_model.get_n_coeffs());
+  online_model.grad(coeffs, grad);
+  const double eps = 1e-6;
+  for (ulong i = 0; i < online_model.get_n_coeffs(); ++i) {
+    SCOPED_TRACE(i);
+    ArrayDouble coeffs_plus = coeffs;
+    coeffs_plus[i] += eps;
+    ArrayDouble coeffs_minus = coeffs;
+    coeffs_minus[i] -= eps;
+    EXPECT_NEAR((online_model.loss(coeffs_plus) - online_model.loss(coeffs_minus)) / (2 * eps),
+                grad[i], 1e-6);
+  }
+}
+
 TEST_F(HawkesModelTest, compute_loss_least_square_sum_exp_kern){
   ArrayDouble decays(2);
   decays.fill(2);
@@ -137,6 +525,103 @@ TEST_F(HawkesModelTest, compute_loss_least_square_sum_exp_varying_baseline){
   EXPECT_DOUBLE_EQ(model.get_n_coeffs(), 14);
 }
 
+TEST_F(HawkesModelTest, compute_loss_least_square_sum_exp_tiles){
+  ArrayDouble decays {1., 2., 3.};
+  const ulong n_decays = decays.size();
+
+  // With 20 nodes, weights are computed by tiles of pairs of blocks of 2 nodes. Nodes are shifted
+  // copies of the two nodes of the fixture
+  const ulong n_nodes = 20;
+  const double end_time = 6.;
+  SArrayDoublePtrList1D timestamps_20;
+  for (ulong j = 0; j < n_nodes; ++j) {
+    ArrayDouble &timestamps_j = *timestamps[j % 2];
+    ArrayDouble shifted_timestamps_j(timestamps_j.size());
+    for (ulong k = 0; k < timestamps_j.size(); ++k) {
+      shifted_timestamps_j[k] = timestamps_j[k] + 0.013 * j;
+    }
+    timestamps_20.push_back(shifted_timestamps_j.as_sarray_ptr());
+  }
+
+  // The loss of node i only depends on the nodes it is excited by: with a model restricted to
+  // nodes i and j, which is computed in a single tile, it must be the same
+  const ArrayDouble self_excitation {0.3, 0.1, 0.2};
+  const ArrayDouble cross_excitation {0.2, 0.4, 0.1};
+  for (auto &pair : std::vector<std::pair<ulong, ulong>> {{3, 17}, {17, 3}, {8, 9}, {5, 5}}) {
+    const ulong i = pair.first, j = pair.second;
+    SCOPED_TRACE(std::to_string(i) + ", " + std::to_string(j));
+
+    ModelHawkesFixedSumExpKernLeastSq model_ij(decays, 1, end_time);
+    model_ij.set_data(SArrayDoublePtrList1D {timestamps_20[i], timestamps_20[j]}, end_time);
+    model_ij.compute_weights();
+    ArrayDouble coeffs_ij(model_ij.get_n_coeffs());
+    coeffs_ij.init_to_zero();
+    coeffs_ij[0] = 0.5;
+    for (ulong u = 0; u < n_decays; ++u) {
+      coeffs_ij[2 + u] += self_excitation[u];
+      coeffs_ij[2 + (i == j ? 0 : n_decays) + u] += cross_excitation[u];
+    }
+    const double expected_loss = model_ij.loss_i(0, coeffs_ij);
+
+    for (bool float_weights : {false, true}) {
+      for (unsigned int n_threads : {1, 4}) {
+        SCOPED_TRACE(n_threads);
+        ModelHawkesFixedSumExpKernLeastSq model(decays, 1, end_time, n_threads, 0, float_weights);
+        model.set_data(timestamps_20, end_time);
+        model.compute_weights();
+        ArrayDouble coeffs(model.get_n_coeffs());
+        coeffs.init_to_zero();
+        coeffs[i] = 0.5;
+        for (ulong u = 0; u < n_decays; ++u) {
+          coeffs[n_nodes + (i * n_nodes + i) * n_decays + u] += self_excitation[u];
+          coeffs[n_nodes + (i * n_nodes + j) * n_decays + u] += cross_excitation[u];
+        }
+        EXPECT_NEAR(model.loss_i(i, coeffs), expected_loss,
+                    (float_weights ? 1e-6 : 1e-12) * std::abs(expected_loss));
+      }
+    }
+  }
+}
+
+TEST_F(HawkesModelTest, compute_loss_least_square_sum_exp_list_threads){
+  ArrayDouble decays {1., 3.};
+  ArrayDouble coeffs = ArrayDouble {1., 3., 2., 3., 4., 1., 5., 3., 2., 4.};
+
+  auto timestamps_list = SArrayDoublePtrList2D(0);
+  timestamps_list.push_back(timestamps);
+  timestamps_list.push_back(timestamps);
+  auto end_times = VArrayDouble::new_ptr(2);
+  (*end_times)[0] = 5.65; (*end_times)[1] = 5.87;
+
+  ModelHawkesFixedSumExpKernLeastSqList reference_model(decays, 1, 1e300, 1);
+  reference_model.incremental_set_data(timestamps, (*end_times)[0]);
+  reference_model.incremental_set_data(timestamps, (*end_times)[1]);
+  ArrayDouble reference_grad(reference_model.get_n_coeffs());
+  reference_model.grad(coeffs, reference_grad);
+
+  for (bool float_weights : {false, true}) {
+    for (unsigned int n_threads : {1, 3, 8}) {
+      SCOPED_TRACE(n_threads);
+      ModelHawkesFixedSumExpKernLeastSqList model(decays, 1, 1e300, n_threads, 0, float_weights);
+      model.set_data(timestamps_list, end_times);
+
+      const double tolerance = float_weights ? 1e-6 : 1e-12;
+      const double reference_loss = reference_model.loss(coeffs);
+      EXPECT_NEAR(model.loss(coeffs), reference_loss, tolerance * std::abs(reference_loss));
+      // A single thread walks the node block pairs realization by realization, exactly as
+      // the reference model does, so double weights must match bit for bit
+      if (n_threads == 1 && !float_weights) {
+        EXPECT_EQ(model.loss(coeffs), reference_loss);
+      }
+      ArrayDouble grad(model.get_n_coeffs());
+      model.grad(coeffs, grad);
+      for (ulong k = 0; k < grad.size(); ++k) {
+        EXPECT_NEAR(grad[k], reference_grad[k], tolerance * std::abs(reference_grad[k]));
+      }
+    }
+  }
+}
+
 TEST_F(HawkesModelTest, compute_loss_least_square_list){
   ArrayDouble2d decays(2, 2);
   decays.fill(2);
@@ -163,6 +648,102 @@ TEST_F(HawkesModelTest, compute_loss_least_square_list){
   EXPECT_DOUBLE_EQ(model.get_n_coeffs(), 6);
 }
 
+TEST_F(HawkesModelTest, compute_loss_least_square_list_threads){
+  auto decays = SArrayDouble2d::new_ptr(2, 2);
+  decays->fill(2);
+  ArrayDouble coeffs = ArrayDouble {1., 3., 2., 3., 4., 1};
+
+  // Realizations are shifted copies of the same timestamps
+  const ulong n_realizations = 7;
+  auto timestamps_list = SArrayDoublePtrList2D(0);
+  auto end_times = VArrayDouble::new_ptr(n_realizations);
+  double sum_losses = 0;
+  ulong n_total_jumps = 0;
+  for (ulong r = 0; r < n_realizations; ++r) {
+    SArrayDoublePtrList1D timestamps_r;
+    for (auto &timestamps_i : timestamps) {
+      ArrayDouble shifted_timestamps_i(timestamps_i->size());
+      for (ulong k = 0; k < shifted_timestamps_i.size(); ++k) {
+        shifted_timestamps_i[k] = (*timestamps_i)[k] + 0.1 * r;
+      }
+      timestamps_r.push_back(shifted_timestamps_i.as_sarray_ptr());
+    }
+    timestamps_list.push_back(timestamps_r);
+    (*end_times)[r] = 5. + 0.3 * r;
+
+    ModelHawkesFixedExpKernLeastSq model_r(decays);
+    model_r.set_data(timestamps_r, (*end_times)[r]);
+    sum_losses += model_r.loss(coeffs) * model_r.get_n_total_jumps();
+    n_total_jumps += model_r.get_n_total_jumps();
+  }
+
+  ModelHawkesFixedExpKernLeastSqList incremental_model(decays, 1);
+  for (ulong r = 0; r < n_realizations; ++r) {
+    incremental_model.incremental_set_data(timestamps_list[r], (*end_times)[r]);
+  }
+
+  // Weights are accumulated by 1, 3 (odd number of partial sums) and more threads than
+  // (realization, node) pairs
+  for (int n_threads : {1, 3, 4, 20}) {
+    SCOPED_TRACE(n_threads);
+    ModelHawkesFixedExpKernLeastSqList model(decays, n_threads);
+    model.set_data(timestamps_list, end_times);
+    EXPECT_NEAR(model.loss(coeffs), sum_losses / n_total_jumps, 1e-12);
+    // With one thread, weights are summed in the same order as with incremental_set_data
+    if (n_threads == 1) {
+      EXPECT_EQ(model.loss(coeffs), incremental_model.loss(coeffs));
+    }
+  }
+}
+
+TEST_F(HawkesModelTest, compute_loss_least_square_binned){
+  SArrayDoublePtrList2D timestamps_list;
+  timestamps_list.push_back(timestamps);
+  timestamps_list.push_back(timestamps);
+  auto end_times = VArrayDouble::new_ptr(2);
+  (*end_times)[0] = 4.5;
+  (*end_times)[1] = 6.;
+
+  auto decays = SArrayDouble2d::new_ptr(2, 2);
+  (*decays)[0] = 1.;
+  (*decays)[1] = 2.;
+  (*decays)[2] = 3.;
+  (*decays)[3] = 0.5;
+
+  ArrayDouble coeffs = ArrayDouble {1., 3., 2., 3., 4., 1};
+
+  ModelHawkesFixedExpKernLeastSqList model(decays, 1);
+  model.set_data(timestamps_list, end_times);
+  const double loss = model.loss(coeffs);
+  ArrayDouble grad(model.get_n_coeffs());
+  model.grad(coeffs, grad);
+
+  // The bias of the binned loss vanishes with the size of the bins
+  double previous_error = std::abs(loss);
+  for (double bin_size : {0.1, 0.01, 1e-4}) {
+    SCOPED_TRACE(bin_size);
+    ModelHawkesFixedExpKernLeastSqBinned binned_model(decays, bin_size, 2);
+    binned_model.set_data(timestamps_list, end_times);
+    const double error = std::abs(binned_model.loss(coeffs) - loss);
+    EXPECT_LT(error, previous_error);
+    previous_error = error;
+
+    ArrayDouble binned_grad(model.get_n_coeffs());
+    binned_model.grad(coeffs, binned_grad);
+    for (ulong k = 0; k < model.get_n_coeffs(); ++k) {
+      EXPECT_NEAR(binned_grad[k], grad[k], 20 * bin_size);
+    }
+  }
+  EXPECT_LT(previous_error, 1e-3);
+
+  ModelHawkesFixedExpKernLeastSqBinned binned_model(decays, 0.01, 1);
+  binned_model.set_data(timestamps_list, end_times);
+  ModelHawkesFixedExpKernLeastSqBinned incremental_model(decays, 0.01, 1);
+  incremental_model.incremental_set_data(timestamps_list[0], (*end_times)[0]);
+  incremental_model.incremental_set_data(timestamps_list[1], (*end_times)[1]);
+  EXPECT_DOUBLE_EQ(incremental_model.loss(coeffs), binned_model.loss(coeffs));
+}
+
 TEST_F(HawkesModelTest, compute_loss_least_square_sum_exp_list){
   ArrayDouble decays(2);
   decays.fill(2);
@@ -226,6 +807,9 @@ TEST_F(HawkesModelTest, compute_loss_loglik_list){
 
   ArrayDouble vector = ArrayDouble {1, 3., 3., 7., 8., 1};
   EXPECT_DOUBLE_EQ(model.hessian_norm(coeffs, vector), 2.7963385385715074);
+  ArrayDouble product(model.get_n_coeffs());
+  model.hessian_vector_product(coeffs, vector, product);
+  EXPECT_DOUBLE_EQ(vector.dot(product), 2.7963385385715074);
   EXPECT_DOUBLE_EQ(model.get_n_coeffs(), 6);
 }
 
@@ -97,6 +97,10 @@ ulong Prox::get_end() const {
   return end;
 }
 
+bool Prox::get_has_range() const {
+  return has_range;
+}
+
 bool Prox::get_positive() const {
   return positive;
 }
@@ -64,6 +64,9 @@ class DLL_PUBLIC Prox {
 
   virtual ulong get_end() const;
 
+  //! @brief Returns true if the prox is only applied from index start to index end
+  virtual bool get_has_range() const;
+
   virtual void set_start_end(ulong start,
                              ulong end);
 
@@ -11,6 +11,8 @@ from .svrg import SVRG
 from .sdca import SDCA
 from .gfb import GFB
 from .adagrad import AdaGrad
+from .hawkes_leastsq_newton import HawkesLeastSqNewton
+from .hawkes_loglik_newton_cg import HawkesLogLikNewtonCG
 
 __all__ = ["GD", "AGD", "BFGS", "SCPG", "SGD", "SVRG", "SDCA", "GFB",
-           "AdaGrad"]
+           "AdaGrad", "HawkesLeastSqNewton", "HawkesLogLikNewtonCG"]
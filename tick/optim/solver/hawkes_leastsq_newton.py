@@ -0,0 +1,193 @@
+# License: BSD 3 clause
+
+import numpy as np
+
+from tick.optim.model import ModelHawkesFixedExpKernLeastSq, \
+    ModelHawkesFixedExpKernLeastSqOnline
+from tick.optim.model.base import Model
+from tick.optim.prox import ProxZero, ProxPositive, ProxL1, ProxL2Sq, \
+    ProxElasticNet
+from tick.optim.prox.base import Prox
+from tick.optim.solver.base import SolverFirstOrder
+from tick.optim.solver.base.utils import relative_distance
+from .build.solver import HawkesLeastSqNewton as _HawkesLeastSqNewton
+
+
+class HawkesLeastSqNewton(SolverFirstOrder):
+    """Active set Newton solver for the least squares goodness-of-fit of
+    Hawkes processes with exponential kernels
+
+    The least squares loss of `ModelHawkesFixedExpKernLeastSq` is quadratic
+    and separates over nodes: the loss of node i only depends on its
+    baseline and on the i-th row of the adjacency matrix. Each node is
+    solved independently (nodes are solved in parallel) with an active set
+    method: a coordinate descent sweep identifies the coefficients that are
+    zero, then the linear system restricted to the other coefficients is
+    solved exactly. The exact minimizer is usually reached in a few
+    iterations.
+
+    `ModelHawkesFixedExpKernLeastSq` may be fitted on several realizations,
+    in which case the loss of each node is read from the weights summed over
+    realizations.
+
+    Parameters
+    ----------
+    tol : `float`, default=0
+        Tolerance on the optimality conditions of the coefficients equal to
+        zero. Iterations also stop when the relative decrease of the
+        objective is below it
+
+    max_iter : `int`, default=100
+        Maximum number of iterations of the solver
+
+    verbose : `bool`, default=True
+        If `True`, we verbose things, otherwise the solver does not
+        print anything (but records information in history anyway)
+
+    print_every : `int`, default=10
+        Print history information when ``n_iter`` (iteration number) is
+        a multiple of ``print_every``
+
+    record_every : `int`, default=1
+        Record history information when ``n_iter`` (iteration number) is
+        a multiple of ``record_every``
+
+    n_threads : `int`, default=1
+        Number of threads used to solve nodes in parallel
+
+    Attributes
+    ----------
+    model : `Model`
+        The model to solve, either `ModelHawkesFixedExpKernLeastSq` or
+        `ModelHawkesFixedExpKernLeastSqOnline`
+
+    prox : `Prox`
+        Proximal operator to solve, among `ProxZero`, `ProxPositive`,
+        `ProxL1`, `ProxL2Sq` and `ProxElasticNet`
+    """
+
+    _attrinfos = {
+        "_solver": {
+            "writable": False
+        },
+        "tol": {
+            "cpp_setter": "set_tol"
+        }
+    }
+
+    # The name of the attribute that might contain the C++ solver object
+    _cpp_obj_name = "_solver"
+
+    def __init__(self, tol: float = 0., max_iter: int = 100,
+                 verbose: bool = True, print_every: int = 10,
+                 record_every: int = 1, n_threads: int = 1):
+        self._solver = None
+        SolverFirstOrder.__init__(self, step=None, tol=tol,
+                                  max_iter=max_iter, verbose=verbose,
+                                  print_every=print_every,
+                                  record_every=record_every)
+        self._solver = _HawkesLeastSqNewton(tol, n_threads)
+
+    def set_model(self, model: Model):
+        """Set model in the solver
+
+        Parameters
+        ----------
+        model : `Model`
+            Sets the model in the solver, either
+            `ModelHawkesFixedExpKernLeastSq` or
+            `ModelHawkesFixedExpKernLeastSqOnline`
+
+        Returns
+        -------
+        output : `Solver`
+            The `Solver` with given model
+        """
+        if not isinstance(model, (ModelHawkesFixedExpKernLeastSq,
+                                  ModelHawkesFixedExpKernLeastSqOnline)):
+            raise ValueError("HawkesLeastSqNewton only accepts "
+                             "ModelHawkesFixedExpKernLeastSq and "
+                             "ModelHawkesFixedExpKernLeastSqOnline, got %s"
+                             % model.name)
+        SolverFirstOrder.set_model(self, model)
+        self._solver.set_model(model._model)
+        return self
+
+    def set_prox(self, prox: Prox):
+        """Set proximal operator in the solver
+
+        Parameters
+        ----------
+        prox : `Prox`
+            The proximal operator of the penalization function
+
+        Returns
+        -------
+        output : `Solver`
+            The `Solver` with given prox
+        """
+        if type(prox) not in (ProxZero, ProxPositive, ProxL1, ProxL2Sq,
+                              ProxElasticNet):
+            raise ValueError("HawkesLeastSqNewton only accepts ProxZero, "
+                             "ProxPositive, ProxL1, ProxL2Sq and "
+                             "ProxElasticNet, got %s" % prox.name)
+        SolverFirstOrder.set_prox(self, prox)
+        self._solver.set_prox(prox._prox)
+        return self
+
+    def solve(self, x0=None):
+        """Launch the solver
+
+        Parameters
+        ----------
+        x0 : `np.array`, shape=(n_coeffs,), default=`None`
+            Starting point of the solver
+
+        Returns
+        -------
+        output : `np.array`, shape=(n_coeffs,)
+            Obtained minimizer for the problem
+        """
+        if self.model is None:
+            raise ValueError('You must first set the model using '
+                             '``set_model``.')
+        if self.prox is None:
+            raise ValueError('You must first set the prox using '
+                             '``set_prox``.')
+        self._start_solve()
+        self._solve(x0)
+        self._end_solve()
+        return self.solution
+
+    def _solve(self, x0: np.ndarray = None):
+        if x0 is None:
+            x0 = np.zeros(self.model.n_coeffs)
+        minimizer = x0.copy()
+        prev_minimizer = np.empty_like(minimizer)
+        obj = self.objective(minimizer)
+
+        self._solver.set_starting_iterate(minimizer)
+        for n_iter in range(self.max_iter + 1):
+            prev_minimizer[:] = minimizer
+            prev_obj = obj
+
+            # Each iteration solves all nodes that have not reached their
+            # exact minimizer yet
+            self._solver.solve()
+            self._solver.get_minimizer(minimizer)
+
+            obj = self.objective(minimizer)
+            rel_delta = relative_distance(minimizer, prev_minimizer)
+            # The least squares loss is zero at zero
+            rel_obj = abs(obj - prev_obj) / abs(prev_obj) if prev_obj != 0 \
+                else abs(obj)
+            converged = self._solver.is_solved() or rel_obj < self.tol
+
+            self._handle_history(n_iter, force=converged, obj=obj,
+                                 x=minimizer.copy(), rel_delta=rel_delta,
+                                 rel_obj=rel_obj)
+            if converged:
+                break
+
+        self._set("solution", minimizer)
+        return minimizer
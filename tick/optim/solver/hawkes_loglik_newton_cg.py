@@ -0,0 +1,208 @@
+# License: BSD 3 clause
+
+import numpy as np
+
+from tick.optim.model import ModelHawkesFixedExpKernLogLik
+from tick.optim.model.base import Model
+from tick.optim.prox import ProxPositive, ProxL1, ProxL2Sq, ProxElasticNet
+from tick.optim.prox.base import Prox
+from tick.optim.solver.base import SolverFirstOrder
+from tick.optim.solver.base.utils import relative_distance
+from .build.solver import HawkesLogLikNewtonCG as _HawkesLogLikNewtonCG
+
+
+class HawkesLogLikNewtonCG(SolverFirstOrder):
+    """Projected truncated Newton solver for the log-likelihood of Hawkes
+    processes with exponential kernels
+
+    The log-likelihood of `ModelHawkesFixedExpKernLogLik` is smooth and
+    convex, and the product of its hessian with a vector is computed from
+    the same weights as its gradient. At each iteration, coefficients that
+    are zero and whose gradient is positive are frozen, the Newton direction
+    on the other ones is approximated by a few conjugate gradient
+    iterations, and the step is chosen by backtracking along the projection
+    of this direction on non-negative coefficients. Baselines are kept
+    positive so that the log-likelihood remains finite. It usually
+    converges in a few tens of iterations. If the Newton step fails to
+    decrease the objective, a projected gradient step is taken instead. If
+    this also fails, iterations stop and ``stalled`` is recorded as `True` in
+    history, while the solver is not considered as solved.
+
+    All coefficients are constrained to be non-negative, hence the prox
+    must be `ProxPositive`, or `ProxL1`, `ProxL2Sq` or `ProxElasticNet` with
+    ``positive=True``, applied to all coefficients.
+
+    Parameters
+    ----------
+    tol : `float`, default=1e-8
+        Tolerance on the infinity norm of the projected gradient. Iterations
+        also stop when the relative decrease of the objective is below it
+
+    max_iter : `int`, default=100
+        Maximum number of iterations of the solver
+
+    max_cg_iter : `int`, default=50
+        Maximum number of conjugate gradient iterations, hence of hessian
+        vector products, per iteration
+
+    verbose : `bool`, default=True
+        If `True`, we verbose things, otherwise the solver does not
+        print anything (but records information in history anyway)
+
+    print_every : `int`, default=10
+        Print history information when ``n_iter`` (iteration number) is
+        a multiple of ``print_every``
+
+    record_every : `int`, default=1
+        Record history information when ``n_iter`` (iteration number) is
+        a multiple of ``record_every``
+
+    Attributes
+    ----------
+    model : `Model`
+        The model to solve, `ModelHawkesFixedExpKernLogLik`
+
+    prox : `Prox`
+        Proximal operator to solve, either `ProxPositive` or a positive
+        `ProxL1`, `ProxL2Sq` or `ProxElasticNet`
+    """
+
+    _attrinfos = {
+        "_solver": {
+            "writable": False
+        },
+        "tol": {
+            "cpp_setter": "set_tol"
+        },
+        "max_cg_iter": {
+            "cpp_setter": "set_max_cg_iter"
+        }
+    }
+
+    # The name of the attribute that might contain the C++ solver object
+    _cpp_obj_name = "_solver"
+
+    def __init__(self, tol: float = 1e-8, max_iter: int = 100,
+                 max_cg_iter: int = 50, verbose: bool = True,
+                 print_every: int = 10, record_every: int = 1):
+        self._solver = None
+        SolverFirstOrder.__init__(self, step=None, tol=tol,
+                                  max_iter=max_iter, verbose=verbose,
+                                  print_every=print_every,
+                                  record_every=record_every)
+        self._solver = _HawkesLogLikNewtonCG(tol, max_cg_iter)
+        self.max_cg_iter = max_cg_iter
+
+    def set_model(self, model: Model):
+        """Set model in the solver
+
+        Parameters
+        ----------
+        model : `Model`
+            Sets the model in the solver, `ModelHawkesFixedExpKernLogLik`
+
+        Returns
+        -------
+        output : `Solver`
+            The `Solver` with given model
+        """
+        if not isinstance(model, ModelHawkesFixedExpKernLogLik):
+            raise ValueError("HawkesLogLikNewtonCG only accepts "
+                             "ModelHawkesFixedExpKernLogLik, got %s"
+                             % model.name)
+        SolverFirstOrder.set_model(self, model)
+        self._solver.set_model(model._model)
+        return self
+
+    def set_prox(self, prox: Prox):
+        """Set proximal operator in the solver
+
+        Parameters
+        ----------
+        prox : `Prox`
+            The proximal operator of the penalization function
+
+        Returns
+        -------
+        output : `Solver`
+            The `Solver` with given prox
+        """
+        if type(prox) not in (ProxPositive, ProxL1, ProxL2Sq,
+                              ProxElasticNet):
+            raise ValueError("HawkesLogLikNewtonCG only accepts "
+                             "ProxPositive, ProxL1, ProxL2Sq and "
+                             "ProxElasticNet, got %s" % prox.name)
+        if not isinstance(prox, ProxPositive) and not prox.positive:
+            raise ValueError("HawkesLogLikNewtonCG constrains all "
+                             "coefficients to be non-negative, %s must be "
+                             "positive" % prox.name)
+        if prox.range is not None:
+            raise ValueError("HawkesLogLikNewtonCG constrains all "
+                             "coefficients to be non-negative, %s cannot "
+                             "have a range" % prox.name)
+        SolverFirstOrder.set_prox(self, prox)
+        self._solver.set_prox(prox._prox)
+        return self
+
+    def solve(self, x0=None):
+        """Launch the solver
+
+        Parameters
+        ----------
+        x0 : `np.array`, shape=(n_coeffs,), default=`None`
+            Starting point of the solver, whose baselines must be positive.
+            If `None`, all coefficients start at one
+
+        Returns
+        -------
+        output : `np.array`, shape=(n_coeffs,)
+            Obtained minimizer for the problem
+        """
+        if self.model is None:
+            raise ValueError('You must first set the model using '
+                             '``set_model``.')
+        if self.prox is None:
+            raise ValueError('You must first set the prox using '
+                             '``set_prox``.')
+        self._start_solve()
+        self._solve(x0)
+        self._end_solve()
+        return self.solution
+
+    def _solve(self, x0: np.ndarray = None):
+        if x0 is None:
+            x0 = np.ones(self.model.n_coeffs)
+        minimizer = x0.copy()
+        self._solver.set_starting_iterate(minimizer)
+        self._solver.get_minimizer(minimizer)
+        prev_minimizer = np.empty_like(minimizer)
+        obj = self.objective(minimizer)
+
+        for n_iter in range(self.max_iter + 1):
+            prev_minimizer[:] = minimizer
+            prev_obj = obj
+
+            self._solver.solve()
+            self._solver.get_minimizer(minimizer)
+
+            obj = self.objective(minimizer)
+            rel_delta = relative_distance(minimizer, prev_minimizer)
+            rel_obj = abs(obj - prev_obj) / abs(prev_obj) if prev_obj != 0 \
+                else abs(obj)
+            # A stalled iteration does not move, which says nothing about
+            # convergence
+            stalled = self._solver.is_stalled()
+            converged = self._solver.is_solved() or \
+                (not stalled and rel_obj < self.tol)
+
+            self._handle_history(n_iter, force=converged or stalled, obj=obj,
+                                 x=minimizer.copy(), rel_delta=rel_delta,
+                                 rel_obj=rel_obj, stalled=stalled)
+            if stalled and not converged and self.verbose:
+                print('Objective cannot be decreased anymore... at %i'
+                      % n_iter)
+            if converged or stalled:
+                break
+
+        self._set("solution", minimizer)
+        return minimizer
@@ -0,0 +1,242 @@
+// License: BSD 3 clause
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "hawkes_leastsq_newton.h"
+
+namespace {
+
+/**
+ * @brief Solve in place the linear system matrix x = vector with a Cholesky decomposition
+ * \param matrix : symmetric positive definite matrix stored row by row, overwritten
+ * \param vector : right hand side, in which the solution is stored
+ * \return false if the matrix is not numerically positive definite
+ */
+bool cholesky_solve(std::vector<double> &matrix, std::vector<double> &vector) {
+  const ulong dim = vector.size();
+  for (ulong k = 0; k < dim; ++k) {
+    const double diagonal = matrix[k * dim + k];
+    double pivot = diagonal;
+    for (ulong l = 0; l < k; ++l) pivot -= matrix[k * dim + l] * matrix[k * dim + l];
+    if (pivot <= 1e-12 * diagonal) return false;
+    pivot = std::sqrt(pivot);
+    matrix[k * dim + k] = pivot;
+    for (ulong m = k + 1; m < dim; ++m) {
+      double value = matrix[m * dim + k];
+      for (ulong l = 0; l < k; ++l) value -= matrix[m * dim + l] * matrix[k * dim + l];
+      matrix[m * dim + k] = value / pivot;
+    }
+  }
+  for (ulong k = 0; k < dim; ++k) {
+    for (ulong l = 0; l < k; ++l) vector[k] -= matrix[k * dim + l] * vector[l];
+    vector[k] /= matrix[k * dim + k];
+  }
+  for (ulong k = dim; k-- > 0;) {
+    for (ulong l = k + 1; l < dim; ++l) vector[k] -= matrix[l * dim + k] * vector[l];
+    vector[k] /= matrix[k * dim + k];
+  }
+  return true;
+}
+
+}  // namespace
+
+HawkesLeastSqNewton::HawkesLeastSqNewton(const double tol, const int max_n_threads)
+    : max_n_threads(max_n_threads), tol(tol), n_nodes(0) {}
+
+void HawkesLeastSqNewton::set_model(ModelPtr model) {
+  const ulong n_coeffs = model->get_n_coeffs();
+  n_nodes = static_cast<ulong>(std::round((std::sqrt(1. + 4. * n_coeffs) - 1) / 2));
+  if (n_nodes + n_nodes * n_nodes != n_coeffs) {
+    TICK_ERROR("HawkesLeastSqNewton cannot be used with a model with " << n_coeffs
+                                                                         << " coefficients");
+  }
+  this->model = model;
+  iterate = ArrayDouble(n_coeffs);
+  iterate.init_to_zero();
+  update_objective();
+}
+
+void HawkesLeastSqNewton::set_prox(ProxPtr prox) {
+  this->prox = prox;
+  update_objective();
+}
+
+void HawkesLeastSqNewton::update_objective() {
+  const bool quadratic_terms_changed = update_quadratic_terms();
+  const bool penalization_changed =
+      penalization.update(prox, iterate.size(), "HawkesLeastSqNewton");
+  if (quadratic_terms_changed || penalization_changed) {
+    node_solved = std::vector<char>(n_nodes, false);
+  }
+}
+
+bool HawkesLeastSqNewton::update_quadratic_terms() {
+  if (model == nullptr) return false;
+  const ulong n_coeffs = iterate.size();
+  if (model->get_n_coeffs() != n_coeffs) {
+    TICK_ERROR("The number of coefficients of the model has changed, please set it again");
+  }
+  const ulong dim = n_nodes + 1;
+
+  // The hessian of the model is made of the hessians of the loss of each node, mu_i row
+  // first and then alpha_i rows
+  ArrayDouble hessian_values(n_nodes * dim * dim);
+  hessian_values.init_to_zero();
+  model->hessian(hessian_values);
+  ArrayDouble2d new_hessians(n_nodes, dim * dim);
+  for (ulong i = 0; i < n_nodes; ++i) {
+    for (ulong m = 0; m < dim; ++m) {
+      new_hessians(i, m) = hessian_values[i * dim + m];
+      for (ulong l = 0; l < n_nodes; ++l) {
+        new_hessians(i, (l + 1) * dim + m) =
+            hessian_values[(i + 1) * n_nodes * dim + l * dim + m];
+      }
+    }
+  }
+
+  // The loss being quadratic, its gradient in zero gives its linear part
+  ArrayDouble zero(n_coeffs), grad_zero(n_coeffs);
+  zero.init_to_zero();
+  model->grad(zero, grad_zero);
+  ArrayDouble2d new_linear_terms(n_nodes, dim);
+  for (ulong i = 0; i < n_nodes; ++i) {
+    for (ulong k = 0; k < dim; ++k) new_linear_terms(i, k) = grad_zero[coeff_index(i, k)];
+  }
+
+  bool changed = hessians.size() != new_hessians.size();
+  for (ulong k = 0; !changed && k < new_hessians.size(); ++k) {
+    changed = hessians.data()[k] != new_hessians.data()[k];
+  }
+  for (ulong k = 0; !changed && k < new_linear_terms.size(); ++k) {
+    changed = linear_terms.data()[k] != new_linear_terms.data()[k];
+  }
+  if (changed) {
+    hessians = std::move(new_hessians);
+    linear_terms = std::move(new_linear_terms);
+  }
+  return changed;
+}
+
+void HawkesLeastSqNewton::solve() {
+  if (model == nullptr) TICK_ERROR("Please set a model before calling solve");
+  update_objective();
+  parallel_run(max_n_threads, n_nodes, &HawkesLeastSqNewton::solve_node, this);
+  t += 1;
+}
+
+void HawkesLeastSqNewton::solve_node(const ulong i) {
+  if (node_solved[i]) return;
+
+  const ulong dim = n_nodes + 1;
+  const ArrayDouble hessian_i = view_row(hessians, i);
+  const ArrayDouble linear_term_i = view_row(linear_terms, i);
+
+  ArrayDouble x(dim), l1(dim), l2sq(dim), curvature(dim);
+  std::vector<bool> positive_i(dim);
+  for (ulong k = 0; k < dim; ++k) {
+    const ulong index = coeff_index(i, k);
+    x[k] = iterate[index];
+    l1[k] = penalization.l_l1[index];
+    l2sq[k] = penalization.l_l2sq[index];
+    positive_i[k] = penalization.positive[index];
+    curvature[k] = hessian_i[k * dim + k] + l2sq[k];
+  }
+
+  // Gradient of the smooth part of the objective (loss and L2Sq penalization)
+  ArrayDouble grad(dim);
+  const auto compute_grad = [&]() {
+    for (ulong k = 0; k < dim; ++k) {
+      grad[k] = linear_term_i[k] + l2sq[k] * x[k];
+      for (ulong l = 0; l < dim; ++l) grad[k] += hessian_i[k * dim + l] * x[l];
+    }
+  };
+  compute_grad();
+
+  // Coordinate descent sweep: each coordinate is minimized exactly
+  for (ulong k = 0; k < dim; ++k) {
+    // A coordinate with no curvature does not appear in the loss
+    if (curvature[k] <= 0) continue;
+    const double threshold = l1[k] / curvature[k];
+    double x_k = x[k] - grad[k] / curvature[k];
+    x_k = x_k > threshold ? x_k - threshold : (x_k < -threshold ? x_k + threshold : 0);
+    if (positive_i[k] && x_k < 0) x_k = 0;
+
+    const double delta = x_k - x[k];
+    if (delta == 0) continue;
+    for (ulong l = 0; l < dim; ++l) grad[l] += delta * hessian_i[l * dim + k];
+    grad[k] += delta * l2sq[k];
+    x[k] = x_k;
+  }
+
+  // Newton step on non-zero coordinates: as long as they keep their sign, the objective is
+  // quadratic with respect to them and its minimizer is given by a linear system
+  std::vector<ulong> free_coords;
+  for (ulong k = 0; k < dim; ++k) {
+    if (x[k] != 0 && curvature[k] > 0) free_coords.push_back(k);
+  }
+  const ulong n_free = free_coords.size();
+  std::vector<double> system(n_free * n_free), direction(n_free);
+  for (ulong a = 0; a < n_free; ++a) {
+    const ulong k = free_coords[a];
+    for (ulong b = 0; b < n_free; ++b) {
+      system[a * n_free + b] = hessian_i[k * dim + free_coords[b]];
+    }
+    system[a * n_free + a] += l2sq[k];
+    direction[a] = -(grad[k] + (x[k] > 0 ? l1[k] : -l1[k]));
+  }
+
+  bool full_step = n_free == 0;
+  if (n_free > 0 && cholesky_solve(system, direction)) {
+    // The step is shortened so that no coordinate changes sign, the first one to reach zero
+    // leaves the set of free coordinates
+    double step = 1;
+    ulong blocking = n_free;
+    for (ulong a = 0; a < n_free; ++a) {
+      const double x_k = x[free_coords[a]];
+      if ((x_k > 0 && direction[a] < -x_k) || (x_k < 0 && direction[a] > -x_k)) {
+        if (-x_k / direction[a] < step) {
+          step = -x_k / direction[a];
+          blocking = a;
+        }
+      }
+    }
+    for (ulong a = 0; a < n_free; ++a) x[free_coords[a]] += step * direction[a];
+    if (blocking < n_free) x[free_coords[blocking]] = 0;
+    full_step = blocking == n_free;
+    compute_grad();
+  }
+
+  // After a full Newton step, non-zero coordinates are optimal and the iterate is the minimizer
+  // if zero coordinates satisfy the optimality conditions
+  double violation = 0;
+  for (ulong k = 0; k < dim; ++k) {
+    if (x[k] != 0 || curvature[k] <= 0) continue;
+    const double violation_k = positive_i[k] ? -grad[k] - l1[k] : std::abs(grad[k]) - l1[k];
+    violation = std::max(violation, violation_k);
+  }
+  node_solved[i] = full_step && violation <= tol;
+
+  for (ulong k = 0; k < dim; ++k) iterate[coeff_index(i, k)] = x[k];
+}
+
+bool HawkesLeastSqNewton::is_solved() const {
+  return std::all_of(node_solved.begin(), node_solved.end(), [](char solved) { return solved; });
+}
+
+void HawkesLeastSqNewton::get_minimizer(ArrayDouble &out) {
+  for (ulong i = 0; i < iterate.size(); ++i)
+    out[i] = iterate[i];
+}
+
+void HawkesLeastSqNewton::get_iterate(ArrayDouble &out) {
+  for (ulong i = 0; i < iterate.size(); ++i)
+    out[i] = iterate[i];
+}
+
+void HawkesLeastSqNewton::set_starting_iterate(ArrayDouble &new_iterate) {
+  for (ulong i = 0; i < new_iterate.size(); ++i)
+    iterate[i] = new_iterate[i];
+  node_solved = std::vector<char>(n_nodes, false);
+}
@@ -0,0 +1,115 @@
+#ifndef TICK_OPTIM_SOLVER_SRC_HAWKES_LEASTSQ_NEWTON_H_
+#define TICK_OPTIM_SOLVER_SRC_HAWKES_LEASTSQ_NEWTON_H_
+
+// License: BSD 3 clause
+
+#include "base.h"
+#include "model.h"
+#include "prox.h"
+#include "separable_penalization.h"
+
+/** \class HawkesLeastSqNewton
+ * \brief Solver for the least squares models of Hawkes processes with fixed exponential kernels
+ * \note These losses are quadratic and separate over nodes: the loss of node i only involves
+ * mu_i and the i-th row of adjacency, that is n_nodes + 1 coefficients. Each node is solved
+ * independently (and nodes are solved in parallel) with an active set method: a coordinate
+ * descent sweep identifies which coefficients are zero, then the linear system restricted to
+ * the non-zero coefficients is solved exactly by a Cholesky decomposition. Supported
+ * penalizations are ProxZero, ProxPositive, ProxL1, ProxL2Sq and ProxElasticNet.
+ * The loss of each node and the penalization strengths are read again at each call to solve,
+ * so that fitting the model on new data or changing the prox strength is taken into account.
+ */
+class HawkesLeastSqNewton {
+ protected:
+  ModelPtr model;
+
+  ProxPtr prox;
+
+  //! @brief Maximum number of threads used to solve nodes in parallel
+  int max_n_threads;
+
+  //! @brief Tolerance on the optimality conditions of the zero coefficients
+  double tol;
+
+  //! @brief Iteration counter
+  ulong t = 1;
+
+  ulong n_nodes;
+
+  //! @brief Iterate, in the layout of the model coefficients
+  ArrayDouble iterate;
+
+  //! @brief For each node i, the hessian of its loss with respect to (mu_i, alpha_i1, ...,
+  //! alpha_in) stored row by row (row i) and the gradient of its loss in zero
+  ArrayDouble2d hessians, linear_terms;
+
+  //! @brief Penalization of each coefficient, in the layout of the model coefficients
+  SeparablePenalization penalization;
+
+  //! @brief Nodes for which the current iterate is the exact minimizer (a char per node, so
+  //! that nodes can be flagged from different threads)
+  std::vector<char> node_solved;
+
+ public:
+  /**
+   * @brief Constructor
+   * \param tol : tolerance on the optimality conditions of the coefficients equal to zero
+   * \param max_n_threads : maximum number of threads used to solve nodes in parallel
+   */
+  explicit HawkesLeastSqNewton(double tol = 0., int max_n_threads = 1);
+
+  /**
+   * @brief Set the model and retrieve the quadratic loss of each node
+   * \param model : a least squares model of Hawkes processes implementing hessian
+   */
+  void set_model(ModelPtr model);
+
+  void set_prox(ProxPtr prox);
+
+  /**
+   * @brief Run one iteration (a coordinate descent sweep followed by a Newton step on the
+   * non-zero coefficients) on all nodes that are not solved yet
+   */
+  void solve();
+
+  void get_minimizer(ArrayDouble &out);
+
+  void get_iterate(ArrayDouble &out);
+
+  void set_starting_iterate(ArrayDouble &new_iterate);
+
+  //! @brief Returns true if the iterate is the exact minimizer for all nodes
+  bool is_solved() const;
+
+  inline ulong get_t() const {
+    return t;
+  }
+
+  inline double get_tol() const {
+    return tol;
+  }
+
+  inline void set_tol(double tol) {
+    this->tol = tol;
+  }
+
+ private:
+  //! @brief Run one iteration on node i
+  void solve_node(const ulong i);
+
+  //! @brief Index in iterate of the k-th coefficient of node i
+  inline ulong coeff_index(const ulong i, const ulong k) const {
+    return k == 0 ? i : n_nodes + i * n_nodes + k - 1;
+  }
+
+  /**
+   * @brief Read the quadratic loss of each node and the penalization strengths, all nodes
+   * are flagged as not solved if any of them changed
+   */
+  void update_objective();
+
+  //! @brief Read the quadratic loss of each node, returns true if it changed
+  bool update_quadratic_terms();
+};
+
+#endif  // TICK_OPTIM_SOLVER_SRC_HAWKES_LEASTSQ_NEWTON_H_
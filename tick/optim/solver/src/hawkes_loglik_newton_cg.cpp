@@ -0,0 +1,200 @@
+// License: BSD 3 clause
+
+#include <algorithm>
+#include <cmath>
+
+#include "hawkes_loglik_newton_cg.h"
+
+namespace {
+
+//! @brief In a line search, baselines cannot decrease by more than this ratio of their value,
+//! which keeps the intensities, hence the log-likelihood, finite
+const double max_baseline_decrease = 0.99;
+
+//! @brief Parameters of the Armijo backtracking line search
+const double armijo_slope = 1e-4;
+const ulong max_line_search_iter = 50;
+
+//! @brief Below this relative decrease, the objective cannot be compared reliably and full
+//! Newton steps are accepted without line search
+const double objective_precision = 1e-12;
+
+//! @brief Coefficients closer to zero than this (or than the projected gradient, if smaller)
+//! with a positive gradient are frozen during the Newton iteration
+const double max_active_threshold = 1e-3;
+
+double dot(const ArrayDouble &x, const ArrayDouble &y) {
+  double result = 0;
+  for (ulong k = 0; k < x.size(); ++k) result += x[k] * y[k];
+  return result;
+}
+
+}  // namespace
+
+HawkesLogLikNewtonCG::HawkesLogLikNewtonCG(const double tol, const ulong max_cg_iter)
+    : tol(tol), max_cg_iter(max_cg_iter), n_nodes(0), objective(0) {}
+
+void HawkesLogLikNewtonCG::set_model(ModelPtr model) {
+  const ulong n_coeffs = model->get_n_coeffs();
+  n_nodes = static_cast<ulong>(std::round((std::sqrt(1. + 4. * n_coeffs) - 1) / 2));
+  if (n_nodes + n_nodes * n_nodes != n_coeffs) {
+    TICK_ERROR("HawkesLogLikNewtonCG cannot be used with a model with " << n_coeffs
+                                                                          << " coefficients");
+  }
+  this->model = model;
+
+  iterate = ArrayDouble(n_coeffs);
+  iterate.fill(1.);
+  grad = ArrayDouble(n_coeffs);
+  update_penalization();
+  objective = compute_objective(iterate, &grad);
+}
+
+void HawkesLogLikNewtonCG::set_prox(ProxPtr prox) {
+  this->prox = prox;
+  if (update_penalization() && model != nullptr) objective = compute_objective(iterate, &grad);
+}
+
+bool HawkesLogLikNewtonCG::update_penalization() {
+  const bool changed = penalization.update(prox, iterate.size(), "HawkesLogLikNewtonCG");
+  if (prox != nullptr && std::find(penalization.positive.begin(), penalization.positive.end(),
+                                   false) != penalization.positive.end()) {
+    TICK_ERROR("HawkesLogLikNewtonCG constrains all coefficients to be non-negative, its prox "
+               "must be ProxPositive or positive, and apply to all coefficients");
+  }
+  return changed;
+}
+
+double HawkesLogLikNewtonCG::compute_objective(const ArrayDouble &coeffs,
+                                               ArrayDouble *grad_out) {
+  const ArrayDouble &l_l1 = penalization.l_l1;
+  const ArrayDouble &l_l2sq = penalization.l_l2sq;
+  // Coefficients being non-negative, the L1 penalization is linear
+  double value = model->loss(coeffs);
+  for (ulong k = 0; k < coeffs.size(); ++k) {
+    value += coeffs[k] * (l_l1[k] + 0.5 * l_l2sq[k] * coeffs[k]);
+  }
+  if (grad_out != nullptr) {
+    model->grad(coeffs, *grad_out);
+    for (ulong k = 0; k < coeffs.size(); ++k) (*grad_out)[k] += l_l1[k] + l_l2sq[k] * coeffs[k];
+  }
+  return value;
+}
+
+void HawkesLogLikNewtonCG::hessian_vector_product(const ArrayDouble &vector, ArrayDouble &out) {
+  model->hessian_vector_product(iterate, vector, out);
+  for (ulong k = 0; k < vector.size(); ++k) out[k] += penalization.l_l2sq[k] * vector[k];
+  n_hessian_vector_products++;
+}
+
+void HawkesLogLikNewtonCG::solve() {
+  if (model == nullptr) TICK_ERROR("Please set a model before calling solve");
+  if (update_penalization()) objective = compute_objective(iterate, &grad);
+  const ulong n_coeffs = iterate.size();
+
+  // Coefficients stuck at zero are frozen, baselines are never frozen
+  const double active_threshold = std::min(max_active_threshold, get_projected_grad_norm());
+  std::vector<bool> free(n_coeffs, true);
+  for (ulong k = n_nodes; k < n_coeffs; ++k) {
+    free[k] = !(iterate[k] <= active_threshold && grad[k] > 0);
+  }
+
+  // Truncated conjugate gradient on the free coefficients, the residual being reduced
+  // superlinearly as the gradient goes to zero
+  ArrayDouble direction(n_coeffs), residual(n_coeffs), conjugate(n_coeffs), product(n_coeffs);
+  direction.init_to_zero();
+  for (ulong k = 0; k < n_coeffs; ++k) residual[k] = free[k] ? -grad[k] : 0;
+  conjugate.mult_fill(residual, 1.);
+  double residual_sq_norm = dot(residual, residual);
+  const double grad_norm = std::sqrt(residual_sq_norm);
+  const double cg_tol = std::min(0.5, std::sqrt(grad_norm)) * grad_norm;
+
+  for (ulong cg_iter = 0; cg_iter < max_cg_iter && std::sqrt(residual_sq_norm) > cg_tol;
+       ++cg_iter) {
+    hessian_vector_product(conjugate, product);
+    for (ulong k = 0; k < n_coeffs; ++k) {
+      if (!free[k]) product[k] = 0;
+    }
+    const double curvature = dot(conjugate, product);
+    if (curvature <= 0) {
+      // The loss is convex, this only happens numerically: fall back on the gradient
+      if (cg_iter == 0) direction.mult_fill(residual, 1.);
+      break;
+    }
+    const double step = residual_sq_norm / curvature;
+    direction.mult_incr(conjugate, step);
+    residual.mult_incr(product, -step);
+    const double new_residual_sq_norm = dot(residual, residual);
+    const double beta = new_residual_sq_norm / residual_sq_norm;
+    for (ulong k = 0; k < n_coeffs; ++k) conjugate[k] = residual[k] + beta * conjugate[k];
+    residual_sq_norm = new_residual_sq_norm;
+  }
+
+  // If the projected Newton direction does not decrease the objective, which may happen when
+  // the hessian is badly conditioned, we fall back on a projected gradient step
+  stalled = !line_search(direction, free);
+  if (stalled) {
+    direction.mult_fill(grad, -1.);
+    stalled = !line_search(direction, std::vector<bool>(n_coeffs, true));
+  }
+  t += 1;
+}
+
+bool HawkesLogLikNewtonCG::line_search(const ArrayDouble &direction,
+                                       const std::vector<bool> &free) {
+  // Backtracking along the projection of the direction, frozen coefficients being set to zero
+  const ulong n_coeffs = iterate.size();
+  ArrayDouble candidate(n_coeffs);
+  double step = 1;
+  for (ulong ls_iter = 0; ls_iter < max_line_search_iter; ++ls_iter, step /= 2) {
+    double expected_decrease = 0;
+    for (ulong k = 0; k < n_coeffs; ++k) {
+      const double lower_bound = k < n_nodes ? (1 - max_baseline_decrease) * iterate[k] : 0;
+      candidate[k] = free[k] ? std::max(lower_bound, iterate[k] + step * direction[k]) : 0;
+      expected_decrease += grad[k] * (candidate[k] - iterate[k]);
+    }
+    if (expected_decrease >= 0) return false;
+
+    const bool negligible_decrease = -expected_decrease <= objective_precision * std::abs(objective);
+    if (negligible_decrease ||
+        compute_objective(candidate) <= objective + armijo_slope * expected_decrease) {
+      iterate.mult_fill(candidate, 1.);
+      objective = compute_objective(iterate, &grad);
+      return true;
+    }
+  }
+  return false;
+}
+
+double HawkesLogLikNewtonCG::get_projected_grad_norm() const {
+  double norm = 0;
+  for (ulong k = 0; k < iterate.size(); ++k) {
+    norm = std::max(norm, std::abs(iterate[k] - std::max(0., iterate[k] - grad[k])));
+  }
+  return norm;
+}
+
+bool HawkesLogLikNewtonCG::is_solved() const {
+  return get_projected_grad_norm() <= tol;
+}
+
+void HawkesLogLikNewtonCG::get_minimizer(ArrayDouble &out) {
+  for (ulong i = 0; i < iterate.size(); ++i)
+    out[i] = iterate[i];
+}
+
+void HawkesLogLikNewtonCG::get_iterate(ArrayDouble &out) {
+  for (ulong i = 0; i < iterate.size(); ++i)
+    out[i] = iterate[i];
+}
+
+void HawkesLogLikNewtonCG::set_starting_iterate(ArrayDouble &new_iterate) {
+  for (ulong i = 0; i < new_iterate.size(); ++i) {
+    if (i < n_nodes && new_iterate[i] <= 0) {
+      TICK_ERROR("HawkesLogLikNewtonCG must be started with positive baselines");
+    }
+    iterate[i] = std::max(0., new_iterate[i]);
+  }
+  stalled = false;
+  objective = compute_objective(iterate, &grad);
+}
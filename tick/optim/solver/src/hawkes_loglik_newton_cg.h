@@ -0,0 +1,142 @@
+#ifndef TICK_OPTIM_SOLVER_SRC_HAWKES_LOGLIK_NEWTON_CG_H_
+#define TICK_OPTIM_SOLVER_SRC_HAWKES_LOGLIK_NEWTON_CG_H_
+
+// License: BSD 3 clause
+
+#include "base.h"
+#include "model.h"
+#include "prox.h"
+#include "separable_penalization.h"
+
+/** \class HawkesLogLikNewtonCG
+ * \brief Projected truncated Newton solver for the log-likelihood models of Hawkes processes with
+ * fixed exponential kernels
+ * \note All coefficients are constrained to be non-negative. At each iteration, the coefficients
+ * that are zero and whose gradient is positive are frozen, and the Newton direction on the other
+ * ones is approximated by conjugate gradient, using only hessian vector products of the model.
+ * The step is then chosen by backtracking along the projection of this direction on the
+ * non-negative orthant, baselines being kept positive so that the loss remains finite.
+ * Supported penalizations are ProxPositive, and ProxL1, ProxL2Sq and ProxElasticNet with
+ * positive set to true. Since the non-negativity constraint cannot be lifted, other proxes, or
+ * proxes applied to only part of the coefficients, are rejected.
+ */
+class HawkesLogLikNewtonCG {
+ protected:
+  ModelPtr model;
+
+  ProxPtr prox;
+
+  //! @brief Tolerance on the projected gradient
+  double tol;
+
+  //! @brief Maximum number of conjugate gradient iterations per Newton iteration
+  ulong max_cg_iter;
+
+  //! @brief Iteration counter
+  ulong t = 1;
+
+  ulong n_nodes;
+
+  //! @brief Iterate, in the layout of the model coefficients
+  ArrayDouble iterate;
+
+  //! @brief Objective and its gradient at the current iterate
+  double objective;
+  ArrayDouble grad;
+
+  //! @brief Penalization of each coefficient, in the layout of the model coefficients
+  SeparablePenalization penalization;
+
+  //! @brief Number of hessian vector products computed so far
+  ulong n_hessian_vector_products = 0;
+
+  //! @brief True if neither the Newton step nor the projected gradient step of the last
+  //! iteration could decrease the objective
+  bool stalled = false;
+
+ public:
+  /**
+   * @brief Constructor
+   * \param tol : tolerance on the infinity norm of the projected gradient
+   * \param max_cg_iter : maximum number of conjugate gradient iterations per Newton iteration
+   */
+  explicit HawkesLogLikNewtonCG(double tol = 1e-8, ulong max_cg_iter = 50);
+
+  /**
+   * @brief Set the model
+   * \param model : a log-likelihood model of Hawkes processes implementing
+   * hessian_vector_product
+   */
+  void set_model(ModelPtr model);
+
+  void set_prox(ProxPtr prox);
+
+  //! @brief Run one projected truncated Newton iteration
+  void solve();
+
+  void get_minimizer(ArrayDouble &out);
+
+  void get_iterate(ArrayDouble &out);
+
+  /**
+   * @brief Set the starting iterate
+   * \param new_iterate : starting point, whose baselines must be positive
+   * \note Negative coefficients are set to zero
+   */
+  void set_starting_iterate(ArrayDouble &new_iterate);
+
+  //! @brief Returns the infinity norm of the projected gradient at the current iterate
+  double get_projected_grad_norm() const;
+
+  //! @brief Returns true if the projected gradient is below tol
+  bool is_solved() const;
+
+  //! @brief Returns true if the last iteration could not decrease the objective, even with a
+  //! projected gradient step, while the projected gradient might still be above tol
+  inline bool is_stalled() const {
+    return stalled;
+  }
+
+  inline ulong get_t() const {
+    return t;
+  }
+
+  inline double get_tol() const {
+    return tol;
+  }
+
+  inline void set_tol(double tol) {
+    this->tol = tol;
+  }
+
+  inline ulong get_max_cg_iter() const {
+    return max_cg_iter;
+  }
+
+  inline void set_max_cg_iter(ulong max_cg_iter) {
+    this->max_cg_iter = max_cg_iter;
+  }
+
+  inline ulong get_n_hessian_vector_products() const {
+    return n_hessian_vector_products;
+  }
+
+ private:
+  //! @brief Objective (loss and penalization) at coeffs, and its gradient if grad_out is given
+  double compute_objective(const ArrayDouble &coeffs, ArrayDouble *grad_out = nullptr);
+
+  //! @brief Product of the hessian of the objective at the iterate with vector
+  void hessian_vector_product(const ArrayDouble &vector, ArrayDouble &out);
+
+  //! @brief Read the penalization strengths, returns true if they changed
+  bool update_penalization();
+
+  /**
+   * @brief Backtracking line search along the projection of direction on non-negative
+   * coefficients, coefficients that are not free being set to zero
+   * \return true if the iterate was moved, false if the objective could not be decreased
+   */
+  bool line_search(const ArrayDouble &direction, const std::vector<bool> &free);
+};
+
+#endif  // TICK_OPTIM_SOLVER_SRC_HAWKES_LOGLIK_NEWTON_CG_H_
@@ -0,0 +1,53 @@
+// License: BSD 3 clause
+
+#include <algorithm>
+
+#include "separable_penalization.h"
+#include "prox_elasticnet.h"
+
+bool SeparablePenalization::update(ProxPtr prox, const ulong n_coeffs,
+                                   const std::string &solver_name) {
+  double l1 = 0, l2sq = 0;
+  bool is_positive = false;
+  ulong start = 0, end = n_coeffs;
+  if (prox != nullptr) {
+    const std::string prox_name = prox->get_class_name();
+    if (prox_name == "ProxL1") {
+      l1 = prox->get_strength();
+    } else if (prox_name == "ProxL2Sq") {
+      l2sq = prox->get_strength();
+    } else if (prox_name == "ProxElasticNet") {
+      const double ratio = static_cast<ProxElasticNet *>(prox.get())->get_ratio();
+      l1 = prox->get_strength() * ratio;
+      l2sq = prox->get_strength() * (1 - ratio);
+    } else if (prox_name != "ProxZero" && prox_name != "ProxPositive") {
+      TICK_ERROR(solver_name << " cannot be used with " << prox_name);
+    }
+    is_positive = prox_name == "ProxPositive" || prox->get_positive();
+
+    if (prox->get_has_range()) {
+      start = prox->get_start();
+      end = std::min(prox->get_end(), n_coeffs);
+    }
+  }
+
+  bool changed = l_l1.size() != n_coeffs;
+  if (changed) {
+    l_l1 = ArrayDouble(n_coeffs);
+    l_l2sq = ArrayDouble(n_coeffs);
+    positive = std::vector<bool>(n_coeffs);
+  }
+  for (ulong k = 0; k < n_coeffs; ++k) {
+    const bool in_range = k >= start && k < end;
+    const double l1_k = in_range ? l1 : 0;
+    const double l2sq_k = in_range ? l2sq : 0;
+    const bool positive_k = in_range && is_positive;
+    if (changed || l_l1[k] != l1_k || l_l2sq[k] != l2sq_k || positive[k] != positive_k) {
+      changed = true;
+      l_l1[k] = l1_k;
+      l_l2sq[k] = l2sq_k;
+      positive[k] = positive_k;
+    }
+  }
+  return changed;
+}
@@ -0,0 +1,35 @@
+#ifndef TICK_OPTIM_SOLVER_SRC_SEPARABLE_PENALIZATION_H_
+#define TICK_OPTIM_SOLVER_SRC_SEPARABLE_PENALIZATION_H_
+
+// License: BSD 3 clause
+
+#include <string>
+#include <vector>
+
+#include "base.h"
+#include "prox.h"
+
+/** \class SeparablePenalization
+ * \brief Penalization strengths of each coefficient for solvers that handle L1, L2Sq and
+ * positivity terms themselves instead of calling the prox
+ * \note Supported proxes are ProxZero, ProxPositive, ProxL1, ProxL2Sq and ProxElasticNet
+ */
+class SeparablePenalization {
+ public:
+  //! @brief L1 and L2Sq penalization strengths of each coefficient
+  ArrayDouble l_l1, l_l2sq;
+
+  //! @brief Coefficients constrained to be non-negative
+  std::vector<bool> positive;
+
+  /**
+   * @brief Read the strengths of the given prox
+   * \param prox : the prox to read, no penalization if nullptr
+   * \param n_coeffs : number of coefficients of the model
+   * \param solver_name : name of the solver, used in the error raised for unsupported proxes
+   * \return true if the strength or the constraint of any coefficient changed
+   */
+  bool update(ProxPtr prox, ulong n_coeffs, const std::string &solver_name);
+};
+
+#endif  // TICK_OPTIM_SOLVER_SRC_SEPARABLE_PENALIZATION_H_
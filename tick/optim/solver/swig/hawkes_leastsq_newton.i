@@ -0,0 +1,34 @@
+// License: BSD 3 clause
+
+%include <std_shared_ptr.i>
+
+%{
+#include "hawkes_leastsq_newton.h"
+#include "model.h"
+%}
+
+class HawkesLeastSqNewton {
+
+public:
+
+    HawkesLeastSqNewton(double tol = 0.,
+                        int max_n_threads = 1);
+
+    void set_model(std::shared_ptr<Model> model);
+
+    void set_prox(std::shared_ptr<Prox> prox);
+
+    void solve();
+
+    void get_minimizer(ArrayDouble &out);
+
+    void get_iterate(ArrayDouble &out);
+
+    void set_starting_iterate(ArrayDouble &new_iterate);
+
+    bool is_solved() const;
+
+    inline double get_tol() const;
+
+    inline void set_tol(double tol);
+};
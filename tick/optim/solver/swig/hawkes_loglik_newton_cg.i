@@ -0,0 +1,44 @@
+// License: BSD 3 clause
+
+%include <std_shared_ptr.i>
+
+%{
+#include "hawkes_loglik_newton_cg.h"
+#include "model.h"
+%}
+
+class HawkesLogLikNewtonCG {
+
+public:
+
+    HawkesLogLikNewtonCG(double tol = 1e-8,
+                         unsigned long max_cg_iter = 50);
+
+    void set_model(std::shared_ptr<Model> model);
+
+    void set_prox(std::shared_ptr<Prox> prox);
+
+    void solve();
+
+    void get_minimizer(ArrayDouble &out);
+
+    void get_iterate(ArrayDouble &out);
+
+    void set_starting_iterate(ArrayDouble &new_iterate);
+
+    double get_projected_grad_norm() const;
+
+    bool is_solved() const;
+
+    inline bool is_stalled() const;
+
+    inline double get_tol() const;
+
+    inline void set_tol(double tol);
+
+    inline unsigned long get_max_cg_iter() const;
+
+    inline void set_max_cg_iter(unsigned long max_cg_iter);
+
+    inline unsigned long get_n_hessian_vector_products() const;
+};
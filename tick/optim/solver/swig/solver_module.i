@@ -19,3 +19,5 @@
 %include svrg.i
 %include sdca.i
 %include adagrad.i
+%include hawkes_leastsq_newton.i
+%include hawkes_loglik_newton_cg.i
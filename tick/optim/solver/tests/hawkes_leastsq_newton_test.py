@@ -0,0 +1,152 @@
+# License: BSD 3 clause
+
+import unittest
+
+import numpy as np
+
+from tick.optim.model import ModelHawkesFixedExpKernLeastSq, ModelLinReg
+from tick.optim.prox import ProxZero, ProxPositive, ProxL1, ProxL2Sq, \
+    ProxElasticNet, ProxTV
+from tick.optim.solver import HawkesLeastSqNewton, AGD
+from tick.simulation import SimuHawkesExpKernels
+
+
+class Test(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(238924)
+        self.n_nodes = 3
+        self.decay = 2.
+        adjacency = np.random.uniform(0, 0.2, (self.n_nodes, self.n_nodes))
+        baseline = np.random.uniform(0.2, 0.5, self.n_nodes)
+        hawkes = SimuHawkesExpKernels(adjacency=adjacency, decays=self.decay,
+                                      baseline=baseline, end_time=2000,
+                                      verbose=False, seed=1039)
+        hawkes.simulate()
+        self.model = ModelHawkesFixedExpKernLeastSq(self.decay) \
+            .fit(hawkes.timestamps)
+
+    def test_hawkes_leastsq_newton_closed_form(self):
+        """...Test HawkesLeastSqNewton finds the minimizer of the unpenalized
+        and ridge penalized least squares loss
+        """
+        n_coeffs = self.model.n_coeffs
+        hessian = self.model.hessian(np.zeros(n_coeffs)).toarray()
+        grad_zero = self.model.grad(np.zeros(n_coeffs))
+
+        for prox, l_l2sq in [(ProxZero(), 0.), (ProxL2Sq(1e-2), 1e-2)]:
+            solver = HawkesLeastSqNewton(verbose=False)
+            solver.set_model(self.model).set_prox(prox)
+            coeffs = solver.solve()
+
+            expected = np.linalg.solve(hessian + l_l2sq * np.eye(n_coeffs),
+                                       -grad_zero)
+            np.testing.assert_array_almost_equal(coeffs, expected)
+            # The linear system is solved exactly at the first iteration
+            self.assertEqual(len(solver.history.values['obj']), 1)
+
+    def test_hawkes_leastsq_newton_several_realizations(self):
+        """...Test HawkesLeastSqNewton finds the minimizer of the least squares
+        loss of a model fitted on several realizations
+        """
+        timestamps_list = []
+        for seed in [1039, 2093, 3141]:
+            hawkes = SimuHawkesExpKernels(
+                adjacency=0.1 * np.ones((self.n_nodes, self.n_nodes)),
+                decays=self.decay, baseline=0.3 * np.ones(self.n_nodes),
+                end_time=500, verbose=False, seed=seed)
+            hawkes.simulate()
+            timestamps_list.append(hawkes.timestamps)
+        model = ModelHawkesFixedExpKernLeastSq(self.decay, n_threads=2) \
+            .fit(timestamps_list)
+
+        n_coeffs = model.n_coeffs
+        hessian = model.hessian(np.zeros(n_coeffs)).toarray()
+        grad_zero = model.grad(np.zeros(n_coeffs))
+
+        solver = HawkesLeastSqNewton(verbose=False, n_threads=2)
+        solver.set_model(model).set_prox(ProxZero())
+        np.testing.assert_array_almost_equal(
+            solver.solve(), np.linalg.solve(hessian, -grad_zero))
+
+        prox = ProxL1(1e-2, positive=True)
+        solver.set_prox(prox)
+        coeffs = solver.solve()
+        agd = AGD(step=1e-2, max_iter=5000, tol=0, verbose=False)
+        agd.set_model(model).set_prox(prox)
+        agd_coeffs = agd.solve(np.ones(n_coeffs))
+        np.testing.assert_array_almost_equal(coeffs, agd_coeffs, decimal=3)
+
+    def test_hawkes_leastsq_newton_penalized(self):
+        """...Test HawkesLeastSqNewton finds the same minimizer as AGD with
+        positive and sparse penalizations
+        """
+        proxs = [ProxPositive(), ProxL1(1e-2, positive=True),
+                 ProxL1(1e-2), ProxElasticNet(1e-2, 0.5, positive=True),
+                 ProxL1(1e-2, range=(self.n_nodes, self.model.n_coeffs),
+                        positive=True)]
+        for prox in proxs:
+            solver = HawkesLeastSqNewton(verbose=False, n_threads=2)
+            solver.set_model(self.model).set_prox(prox)
+            coeffs = solver.solve()
+            self.assertTrue(solver._solver.is_solved())
+
+            agd = AGD(step=1e-2, max_iter=5000, tol=0, verbose=False)
+            agd.set_model(self.model).set_prox(prox)
+            agd_coeffs = agd.solve(np.ones(self.model.n_coeffs))
+
+            np.testing.assert_array_almost_equal(coeffs, agd_coeffs,
+                                                 decimal=3)
+            self.assertLessEqual(solver.objective(coeffs),
+                                 agd.objective(agd_coeffs) + 1e-10)
+
+    def test_hawkes_leastsq_newton_warm_start(self):
+        """...Test HawkesLeastSqNewton stops immediately when started at
+        the minimizer
+        """
+        solver = HawkesLeastSqNewton(verbose=False)
+        solver.set_model(self.model).set_prox(ProxL1(1e-2, positive=True))
+        coeffs = solver.solve()
+        solver.solve(coeffs)
+        np.testing.assert_array_almost_equal(solver.solution, coeffs)
+        self.assertEqual(len(solver.history.values['obj']), 1)
+
+    def test_hawkes_leastsq_newton_updated_objective(self):
+        """...Test HawkesLeastSqNewton takes into account a prox strength
+        or model data changed after they have been set
+        """
+        prox = ProxL1(1e-2, positive=True)
+        solver = HawkesLeastSqNewton(verbose=False)
+        solver.set_model(self.model).set_prox(prox)
+        solver.solve()
+
+        prox.strength = 1e-1
+        coeffs = solver.solve()
+        fresh_solver = HawkesLeastSqNewton(verbose=False)
+        fresh_solver.set_model(self.model) \
+            .set_prox(ProxL1(1e-1, positive=True))
+        np.testing.assert_array_almost_equal(coeffs, fresh_solver.solve())
+
+        hawkes = SimuHawkesExpKernels(
+            adjacency=0.1 * np.ones((self.n_nodes, self.n_nodes)),
+            decays=self.decay, baseline=0.3 * np.ones(self.n_nodes),
+            end_time=2000, verbose=False, seed=2093)
+        hawkes.simulate()
+        self.model.fit(hawkes.timestamps)
+        coeffs = solver.solve()
+        fresh_solver.set_model(self.model)
+        np.testing.assert_array_almost_equal(coeffs, fresh_solver.solve())
+
+    def test_hawkes_leastsq_newton_errors(self):
+        """...Test HawkesLeastSqNewton only accepts Hawkes least squares
+        models and separable penalizations it can handle
+        """
+        solver = HawkesLeastSqNewton(verbose=False)
+        model = ModelLinReg().fit(np.random.randn(10, 3), np.random.randn(10))
+        with self.assertRaises(ValueError):
+            solver.set_model(model)
+        with self.assertRaises(ValueError):
+            solver.set_prox(ProxTV(1e-2))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,128 @@
+# License: BSD 3 clause
+
+import unittest
+
+import numpy as np
+
+from tick.optim.model import ModelHawkesFixedExpKernLogLik, \
+    ModelHawkesFixedExpKernLeastSq
+from tick.optim.prox import ProxZero, ProxPositive, ProxL1, ProxL2Sq, \
+    ProxElasticNet, ProxTV
+from tick.optim.solver import HawkesLogLikNewtonCG
+from tick.simulation import SimuHawkesExpKernels
+
+
+class Test(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(238924)
+        self.n_nodes = 3
+        self.decay = 2.
+        adjacency = np.random.uniform(0, 0.2, (self.n_nodes, self.n_nodes))
+        adjacency[0, 1] = 0
+        baseline = np.random.uniform(0.2, 0.5, self.n_nodes)
+        hawkes = SimuHawkesExpKernels(adjacency=adjacency, decays=self.decay,
+                                      baseline=baseline, end_time=2000,
+                                      verbose=False, seed=1039)
+        hawkes.simulate()
+        self.model = ModelHawkesFixedExpKernLogLik(self.decay) \
+            .fit(hawkes.timestamps)
+
+    def test_hawkes_loglik_newton_cg_optimality(self):
+        """...Test HawkesLogLikNewtonCG reaches the optimality conditions of
+        the penalized log-likelihood under positivity constraints
+        """
+        proxs = [(ProxPositive(), 0., 0.),
+                 (ProxL1(1e-2, positive=True), 1e-2, 0.),
+                 (ProxL2Sq(1e-2, positive=True), 0., 1e-2),
+                 (ProxElasticNet(1e-2, 0.5, positive=True), 5e-3, 5e-3)]
+        for prox, l_l1, l_l2sq in proxs:
+            solver = HawkesLogLikNewtonCG(tol=1e-10, verbose=False)
+            solver.set_model(self.model).set_prox(prox)
+            coeffs = solver.solve()
+            self.assertTrue(solver._solver.is_solved())
+            self.assertLess(len(solver.history.values['obj']), 50)
+
+            grad = self.model.grad(coeffs) + l_l1 + l_l2sq * coeffs
+            self.assertTrue(np.all(coeffs >= 0))
+            self.assertTrue(np.all(coeffs[:self.n_nodes] > 0))
+            np.testing.assert_array_almost_equal(grad[coeffs > 0], 0,
+                                                 decimal=6)
+            self.assertTrue(np.all(grad[coeffs == 0] > -1e-6))
+
+    def test_hawkes_loglik_newton_cg_warm_start(self):
+        """...Test HawkesLogLikNewtonCG stops immediately when started at
+        the minimizer
+        """
+        solver = HawkesLogLikNewtonCG(tol=1e-10, verbose=False)
+        solver.set_model(self.model).set_prox(ProxL1(1e-2, positive=True))
+        coeffs = solver.solve()
+        solver.solve(coeffs)
+        np.testing.assert_array_almost_equal(solver.solution, coeffs)
+        self.assertEqual(len(solver.history.values['obj']), 1)
+
+    def test_hawkes_loglik_newton_cg_gradient_fallback(self):
+        """...Test HawkesLogLikNewtonCG takes projected gradient steps when
+        the Newton direction cannot decrease the objective, without reporting
+        convergence
+        """
+        # Without conjugate gradient iterations, the Newton direction is zero
+        solver = HawkesLogLikNewtonCG(tol=1e-10, max_iter=20, max_cg_iter=0,
+                                      verbose=False)
+        solver.set_model(self.model).set_prox(ProxPositive())
+        solver.solve()
+        objectives = solver.history.values['obj']
+        self.assertEqual(len(objectives), 21)
+        self.assertTrue(np.all(np.diff(objectives) <= 0))
+        self.assertLess(objectives[-1], objectives[0])
+        self.assertFalse(any(solver.history.values['stalled']))
+        self.assertFalse(solver._solver.is_solved())
+
+    def test_hawkes_loglik_newton_cg_updated_prox(self):
+        """...Test HawkesLogLikNewtonCG takes into account a prox strength
+        changed after the prox has been set
+        """
+        prox = ProxL1(1e-2, positive=True)
+        solver = HawkesLogLikNewtonCG(tol=1e-10, verbose=False)
+        solver.set_model(self.model).set_prox(prox)
+        solver.solve()
+
+        prox.strength = 1e-1
+        coeffs = solver.solve()
+        fresh_solver = HawkesLogLikNewtonCG(tol=1e-10, verbose=False)
+        fresh_solver.set_model(self.model) \
+            .set_prox(ProxL1(1e-1, positive=True))
+        np.testing.assert_array_almost_equal(coeffs, fresh_solver.solve(),
+                                             decimal=6)
+
+    def test_hawkes_loglik_newton_cg_errors(self):
+        """...Test HawkesLogLikNewtonCG only accepts Hawkes log-likelihood
+        models, penalizations it can handle and positive baselines
+        """
+        solver = HawkesLogLikNewtonCG(verbose=False)
+        model = ModelHawkesFixedExpKernLeastSq(self.decay)
+        with self.assertRaises(ValueError):
+            solver.set_model(model)
+        with self.assertRaises(ValueError):
+            solver.set_prox(ProxTV(1e-2))
+        # Non-negativity cannot be lifted
+        with self.assertRaises(ValueError):
+            solver.set_prox(ProxZero())
+        with self.assertRaises(ValueError):
+            solver.set_prox(ProxL1(1e-2))
+        with self.assertRaises(ValueError):
+            solver.set_prox(ProxL1(1e-2, range=(0, self.n_nodes),
+                                   positive=True))
+
+        solver.set_model(self.model).set_prox(ProxPositive())
+        with self.assertRaises(RuntimeError):
+            solver.solve(np.zeros(self.model.n_coeffs))
+
+        prox = ProxL1(1e-2, positive=True)
+        solver.set_prox(prox)
+        prox.positive = False
+        with self.assertRaises(RuntimeError):
+            solver.solve()
+
+
+if __name__ == "__main__":
+    unittest.main()
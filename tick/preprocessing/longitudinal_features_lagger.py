@@ -33,6 +33,11 @@ class LongitudinalFeaturesLagger(Base):
         lag = 1, ..., n_lags. If lag = 0, this preprocessor does nothing.
         n_lags must be non-negative.
 
+    n_jobs : `int`, default=-1
+        Number of threads used to lag sparse features, samples being
+        processed in parallel. If negative or zero, the number of available
+        cores is used.
+
     Attributes
     ----------
     mapper : `dict`
@@ -141,7 +146,7 @@ class LongitudinalFeaturesLagger(Base):
         self._set("_n_output_features", int(n_init_features *
                                             (self.n_lags + 1)))
         self._set("_cpp_preprocessor",
-                  _LongitudinalFeaturesLagger(X, self.n_lags))
+                  _LongitudinalFeaturesLagger(X, self.n_lags, self.n_jobs))
         self._set("_fitted", True)
 
         return self
@@ -178,9 +183,7 @@ class LongitudinalFeaturesLagger(Base):
         base_shape = (self._n_intervals, self._n_init_features)
         X = check_longitudinal_features_consistency(X, base_shape, "float64")
         if sps.issparse(X[0]):
-            X_with_lags = [self._sparse_lagger(x, int(censoring[i]))
-                           for i, x in enumerate(X)]
-            # Don't get why int() is required here as censoring_i is uint64
+            X_with_lags = self._sparse_lagger(X, censoring)
         else:
             X_with_lags = [self._dense_lagger(x, int(censoring[i]))
                            for i, x in enumerate(X)]
@@ -225,21 +228,23 @@ class LongitudinalFeaturesLagger(Base):
             censoring_i)
         return output
 
-    def _sparse_lagger(self, feature_matrix, censoring_i):
-        coo = feature_matrix.tocoo()
-        estimated_nnz = coo.nnz * (self.n_lags + 1)
-        out_row = np.zeros((estimated_nnz,), dtype="uint64")
-        out_col = np.zeros((estimated_nnz,), dtype="uint64")
-        out_data = np.zeros((estimated_nnz,), dtype="float64")
+    def _sparse_lagger(self, X, censoring):
+        # All samples are lagged at once in stacked CSR buffers: a counting
+        # pass gives the offset of each sample, then a filling pass writes
+        # each sample in its own slice. The output matrices share the data
+        # buffer, while scipy converts the uint64 indices and indptr slices to
+        # its own index dtype, hence copies them.
+        n_samples = len(X)
+        n_rows = self._n_intervals + 1
+        offsets = self._cpp_preprocessor.sparse_lagged_offsets(X, censoring)
+        indptr = np.empty((n_samples * n_rows,), dtype="uint64")
+        indices = np.empty((offsets[-1],), dtype="uint64")
+        data = np.empty((offsets[-1],), dtype="float64")
         self._cpp_preprocessor.sparse_lag_preprocessor(
-            coo.row.astype("uint64"),
-            coo.col.astype("uint64"),
-            coo.data,
-            out_row,
-            out_col,
-            out_data,
-            censoring_i
-            )
-        return sps.csr_matrix((out_data, (out_row, out_col)),
-                              shape=(self._n_intervals,
-                                     self._n_output_features))
+            X, censoring, offsets, indptr, indices, data)
+        shape = (self._n_intervals, self._n_output_features)
+        return [sps.csr_matrix((data[offsets[i]:offsets[i + 1]],
+                                indices[offsets[i]:offsets[i + 1]],
+                                indptr[i * n_rows:(i + 1) * n_rows]),
+                               shape=shape)
+                for i in range(n_samples)]
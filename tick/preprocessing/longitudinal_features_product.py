@@ -39,6 +39,14 @@ class LongitudinalFeaturesProduct(Base):
         Number of tasks to run in parallel. If set to -1, the number of tasks is 
         set to the number of cores.
 
+    observed_pairs_only : `bool`, default=False
+        Only available for infinite exposures. If True, product columns are
+        only created for the pairs of features exposed together in at least
+        one sample given to `fit`, instead of all the `comb(n_features, 2)`
+        pairs. This keeps the output width manageable with a large number of
+        features. Products of pairs not observed during `fit` are dropped by
+        `transform`.
+
     Attributes
     ----------
     mapper : `dict`
@@ -76,17 +84,23 @@ class LongitudinalFeaturesProduct(Base):
         "_n_init_features": {"writable": False},
         "_n_output_features": {"writable": False},
         "_n_intervals": {"writable": False},
+        "observed_pairs_only": {"writable": False},
         "_preprocessor": {"writable": False},
         "_fitted": {"writable": False}
     }
 
-    def __init__(self, exposure_type="infinite", n_threads=-1):
+    def __init__(self, exposure_type="infinite", n_threads=-1,
+                 observed_pairs_only=False):
         Base.__init__(self)
         if exposure_type not in ["infinite", "short"]:
             raise ValueError("exposure_type should be either 'infinite' or\
              'short', not %s" % exposure_type)
+        if observed_pairs_only and exposure_type != "infinite":
+            raise ValueError("observed_pairs_only is only available with\
+             infinite exposures")
         self.n_threads = n_threads
         self.exposure_type = exposure_type
+        self.observed_pairs_only = observed_pairs_only
         self._reset()
 
     def _reset(self):
@@ -135,14 +149,28 @@ class LongitudinalFeaturesProduct(Base):
                      product features.")
         self._set("_n_init_features", n_init_features)
         self._set("_n_intervals", n_intervals)
-        comb_it = combinations(range(n_init_features), 2)
-        mapper = {i + n_init_features: c for i, c in enumerate(comb_it)}
-        self._set("_mapper", mapper)
-        self._set("_n_output_features", int(n_init_features +
-                                            comb(n_init_features, 2)))
 
         if sps.issparse(X[0]) and self.exposure_type == "infinite":
-            self._set("_preprocessor", SparseLongitudinalFeaturesProduct(X))
+            self._set("_preprocessor",
+                      SparseLongitudinalFeaturesProduct(X, self.n_threads))
+
+        if self.observed_pairs_only:
+            if self._preprocessor is None:
+                raise ValueError("Infinite exposures should be stored in \
+                    sparse matrices as this hypothesis induces sparsity in the \
+                    feature matrix.")
+            self._preprocessor.fit_observed_pairs(X)
+            pairs = self._preprocessor.get_observed_pairs()
+            mapper = {i + n_init_features: (int(p // n_init_features),
+                                            int(p % n_init_features))
+                      for i, p in enumerate(pairs)}
+            n_output_features = n_init_features + len(pairs)
+        else:
+            comb_it = combinations(range(n_init_features), 2)
+            mapper = {i + n_init_features: c for i, c in enumerate(comb_it)}
+            n_output_features = n_init_features + comb(n_init_features, 2)
+        self._set("_mapper", mapper)
+        self._set("_n_output_features", int(n_output_features))
 
         self._set("_fitted", True)
 
@@ -206,11 +234,7 @@ class LongitudinalFeaturesProduct(Base):
     def infinite_exposure_products(self, X):
         """Add product features to X in the infinite exposure case."""
         if sps.issparse(X[0]):
-            X_with_products = [self._sparse_infinite_product(arr) for arr in X]
-            # TODO: fix multiprocessing
-            # X_with_products = Parallel(n_threads=self.n_threads)(
-            #     delayed(self._sparse_infinite_product)(arr) for arr in X)
-            # Should be done in C++
+            X_with_products = self._sparse_infinite_product(X)
         else:
             raise ValueError("Infinite exposures should be stored in \
                     sparse matrices as this hypothesis induces sparsity in the \
@@ -246,23 +270,25 @@ class LongitudinalFeaturesProduct(Base):
                      for i, j in self.mapper.values()])
         return sps.hstack(feat).tocsr()
 
-    def _sparse_infinite_product(self, feat_mat):
-        """Performs feature product on a scipy.sparse.csr_matrix containing
-        infinite exposures."""
-        coo = feat_mat.tocoo()
-        nnz = coo.nnz
-        new_nnz = self._n_output_features * nnz
-        new_row = np.zeros((new_nnz,), dtype="uint64")
-        new_col = np.zeros((new_nnz,), dtype="uint64")
-        new_data = np.zeros((new_nnz,), dtype="float64")
-        self._preprocessor.sparse_features_product(
-            coo.row.astype("uint64"),
-            coo.col.astype("uint64"),
-            coo.data,
-            new_row,
-            new_col,
-            new_data)
-        return sps.csr_matrix((new_data, (new_row, new_col)),
-                              shape=(self._n_intervals,
-                                     self._n_output_features)
-                              )
+    def _sparse_infinite_product(self, X):
+        """Performs feature product on a list of scipy.sparse.csr_matrix
+        containing infinite exposures."""
+        # All samples are processed at once in stacked CSR buffers: a counting
+        # pass gives the offset of each sample, then a filling pass writes
+        # each sample in its own slice. The output matrices share the data
+        # buffer, while scipy converts the uint64 indices and indptr slices to
+        # its own index dtype, hence copies them.
+        n_samples = len(X)
+        n_rows = self._n_intervals + 1
+        offsets = self._preprocessor.sparse_features_product_offsets(X)
+        indptr = np.empty((n_samples * n_rows,), dtype="uint64")
+        indices = np.empty((offsets[-1],), dtype="uint64")
+        data = np.empty((offsets[-1],), dtype="float64")
+        self._preprocessor.sparse_features_product(X, offsets, indptr,
+                                                   indices, data)
+        shape = (self._n_intervals, self._n_output_features)
+        return [sps.csr_matrix((data[offsets[i]:offsets[i + 1]],
+                                indices[offsets[i]:offsets[i + 1]],
+                                indptr[i * n_rows:(i + 1) * n_rows]),
+                               shape=shape)
+                for i in range(n_samples)]
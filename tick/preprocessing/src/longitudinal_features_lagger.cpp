@@ -8,13 +8,16 @@
 
 LongitudinalFeaturesLagger::LongitudinalFeaturesLagger(
     const SBaseArrayDouble2dPtrList1D &features,
-    const ulong n_lags)
+    const ulong n_lags,
+    const int n_threads)
     : n_intervals(features[0]->n_rows()),
       n_lags(n_lags),
       n_samples(features.size()),
       n_observations(n_samples * n_intervals),
       n_features(features[0]->n_cols()),
-      n_lagged_features(n_features * (n_lags + 1)) {
+      n_lagged_features(n_features * (n_lags + 1)),
+      n_threads(n_threads >= 1 ? n_threads
+                               : std::thread::hardware_concurrency()) {
   if (n_lags >= n_intervals) {
     TICK_ERROR("n_lags must be between 0 and (n_intervals - 1)");
   }
@@ -78,4 +81,167 @@ void LongitudinalFeaturesLagger::sparse_lag_preprocessor(ArrayULong &row,
       j++;
     }
   }
-}
\ No newline at end of file
+}
+void LongitudinalFeaturesLagger::check_sparse_features(
+    const SBaseArrayDouble2dPtrList1D &features,
+    const ArrayULong &censoring) const {
+  if (censoring.size() != features.size()) {
+    TICK_ERROR("censoring must have one entry per sample");
+  }
+  for (ulong i = 0; i < features.size(); ++i) {
+    if (!features[i]->is_sparse()) {
+      TICK_ERROR("features of sample " << i << " must be sparse");
+    }
+    if (features[i]->n_rows() != n_intervals ||
+        features[i]->n_cols() != n_features) {
+      TICK_ERROR("features of sample " << i
+                     << " must have shape (n_intervals, n_features)");
+    }
+  }
+}
+
+void LongitudinalFeaturesLagger::count_lagged_nnz_i(
+    const ulong i,
+    const SBaseArrayDouble2dPtrList1D &features,
+    const ArrayULong &censoring,
+    ArrayULong &offsets) const {
+  offsets[i + 1] = 0;
+  // Empty sparse arrays may not allocate their row indices
+  if (features[i]->size_data() == 0) return;
+  const INDICE_TYPE *row_indices = features[i]->row_indices();
+  const ulong max_row = std::min(censoring[i], n_intervals);
+  // Raw row r contributes to the lagged rows r, ..., r + n_lags, which is
+  // counted with a sliding window over the raw row sizes
+  ulong nnz = 0, window = 0;
+  for (ulong r = 0; r < max_row; ++r) {
+    window += row_indices[r + 1] - row_indices[r];
+    if (r > n_lags) {
+      window -= row_indices[r - n_lags] - row_indices[r - n_lags - 1];
+    }
+    nnz += window;
+  }
+  offsets[i + 1] = nnz;
+}
+
+template <typename T>
+void LongitudinalFeaturesLagger::lag_sample_csr(const BaseArrayDouble2d &features,
+                                                const ulong censoring_i,
+                                                T *indptr_i,
+                                                T *indices_i,
+                                                double *data_i) const {
+  const INDICE_TYPE *row_indices = features.row_indices();
+  const INDICE_TYPE *feature_indices = features.indices();
+  const double *values = features.data();
+  const ulong max_row =
+      features.size_data() == 0 ? 0 : std::min(censoring_i, n_intervals);
+  // cursor[l] walks through the raw row r - l up to end[l]
+  std::vector<ulong> cursor(n_lags + 1), end(n_lags + 1);
+  ulong nnz = 0;
+  indptr_i[0] = 0;
+  for (ulong r = 0; r < n_intervals; ++r) {
+    if (r < max_row) {
+      const ulong n_active = std::min(n_lags, r) + 1;
+      for (ulong l = 0; l < n_active; ++l) {
+        cursor[l] = row_indices[r - l];
+        end[l] = row_indices[r - l + 1];
+      }
+      // Merge the raw rows r, ..., r - n_lags on the feature index, ties
+      // going to the smallest lag, so that the lagged columns
+      // feature * (n_lags + 1) + lag come out sorted
+      while (true) {
+        ulong best = n_active;
+        for (ulong l = 0; l < n_active; ++l) {
+          if (cursor[l] < end[l] &&
+              (best == n_active ||
+                  feature_indices[cursor[l]] < feature_indices[cursor[best]])) {
+            best = l;
+          }
+        }
+        if (best == n_active) break;
+        indices_i[nnz] = feature_indices[cursor[best]] * (n_lags + 1) + best;
+        data_i[nnz] = values[cursor[best]];
+        ++cursor[best];
+        ++nnz;
+      }
+    }
+    indptr_i[r + 1] = nnz;
+  }
+}
+
+void LongitudinalFeaturesLagger::fill_lagged_csr_i(
+    const ulong i,
+    const SBaseArrayDouble2dPtrList1D &features,
+    const ArrayULong &censoring,
+    const ArrayULong &offsets,
+    ArrayULong &out_indptr,
+    ArrayULong &out_indices,
+    ArrayDouble &out_data) const {
+  lag_sample_csr(*features[i], censoring[i],
+                 out_indptr.data() + i * (n_intervals + 1),
+                 out_indices.data() + offsets[i],
+                 out_data.data() + offsets[i]);
+}
+
+void LongitudinalFeaturesLagger::fill_lagged_sparse_i(
+    const ulong i,
+    const SBaseArrayDouble2dPtrList1D &features,
+    const ArrayULong &censoring,
+    SSparseArrayDouble2dPtrList1D &out) const {
+  if (out[i]->size_data() == 0) return;
+  lag_sample_csr(*features[i], censoring[i],
+                 out[i]->row_indices(), out[i]->indices(), out[i]->data());
+}
+
+SArrayULongPtr LongitudinalFeaturesLagger::sparse_lagged_offsets(
+    const SBaseArrayDouble2dPtrList1D &features,
+    const ArrayULong &censoring) const {
+  check_sparse_features(features, censoring);
+  const ulong n = features.size();
+  SArrayULongPtr offsets = SArrayULong::new_ptr(n + 1);
+  offsets->init_to_zero();
+  parallel_run(n_threads, n,
+               &LongitudinalFeaturesLagger::count_lagged_nnz_i,
+               this, features, censoring, *offsets);
+  for (ulong i = 0; i < n; ++i) (*offsets)[i + 1] += (*offsets)[i];
+  return offsets;
+}
+
+void LongitudinalFeaturesLagger::sparse_lag_preprocessor(
+    const SBaseArrayDouble2dPtrList1D &features,
+    const ArrayULong &censoring,
+    const ArrayULong &offsets,
+    ArrayULong &out_indptr,
+    ArrayULong &out_indices,
+    ArrayDouble &out_data) const {
+  check_sparse_features(features, censoring);
+  const ulong n = features.size();
+  if (offsets.size() != n + 1) {
+    TICK_ERROR("offsets must be of size n_samples + 1");
+  }
+  if (out_indptr.size() != n * (n_intervals + 1)) {
+    TICK_ERROR("out_indptr must be of size n_samples * (n_intervals + 1)");
+  }
+  if (out_indices.size() != offsets[n] || out_data.size() != offsets[n]) {
+    TICK_ERROR("out_indices and out_data must be of size offsets[n_samples]");
+  }
+  parallel_run(n_threads, n,
+               &LongitudinalFeaturesLagger::fill_lagged_csr_i,
+               this, features, censoring, offsets,
+               out_indptr, out_indices, out_data);
+}
+
+SSparseArrayDouble2dPtrList1D LongitudinalFeaturesLagger::sparse_lag_preprocessor(
+    const SBaseArrayDouble2dPtrList1D &features,
+    const ArrayULong &censoring) const {
+  SArrayULongPtr offsets = sparse_lagged_offsets(features, censoring);
+  const ulong n = features.size();
+  SSparseArrayDouble2dPtrList1D out(n);
+  for (ulong i = 0; i < n; ++i) {
+    out[i] = SSparseArrayDouble2d::new_ptr(n_intervals, n_lagged_features,
+                                           (*offsets)[i + 1] - (*offsets)[i]);
+  }
+  parallel_run(n_threads, n,
+               &LongitudinalFeaturesLagger::fill_lagged_sparse_i,
+               this, features, censoring, out);
+  return out;
+}
@@ -20,10 +20,41 @@ class LongitudinalFeaturesLagger {
   ulong n_observations;
   ulong n_features;
   ulong n_lagged_features;
+  unsigned int n_threads;
+
+  void count_lagged_nnz_i(const ulong i,
+                          const SBaseArrayDouble2dPtrList1D &features,
+                          const ArrayULong &censoring,
+                          ArrayULong &offsets) const;
+
+  void fill_lagged_csr_i(const ulong i,
+                         const SBaseArrayDouble2dPtrList1D &features,
+                         const ArrayULong &censoring,
+                         const ArrayULong &offsets,
+                         ArrayULong &out_indptr,
+                         ArrayULong &out_indices,
+                         ArrayDouble &out_data) const;
+
+  void fill_lagged_sparse_i(const ulong i,
+                            const SBaseArrayDouble2dPtrList1D &features,
+                            const ArrayULong &censoring,
+                            SSparseArrayDouble2dPtrList1D &out) const;
+
+  //! @brief Write the lagged rows of one sample in its own CSR buffers
+  template <typename T>
+  void lag_sample_csr(const BaseArrayDouble2d &features,
+                      const ulong censoring_i,
+                      T *indptr_i,
+                      T *indices_i,
+                      double *data_i) const;
+
+  void check_sparse_features(const SBaseArrayDouble2dPtrList1D &features,
+                             const ArrayULong &censoring) const;
 
  public:
   LongitudinalFeaturesLagger(const SBaseArrayDouble2dPtrList1D &features,
-                             const ulong n_lags);
+                             const ulong n_lags,
+                             const int n_threads = 1);
 
   void dense_lag_preprocessor(ArrayDouble2d &features,
                               ArrayDouble2d &out,
@@ -37,6 +68,49 @@ class LongitudinalFeaturesLagger {
                                ArrayDouble &out_data,
                                ulong censoring) const;
 
+  /**
+   * \brief Counting pass of the CSR lagging of all samples at once.
+   * \param features : list of n_samples sparse matrices of shape
+   * (n_intervals, n_features)
+   * \param censoring : censoring of each sample, in [1, n_intervals]
+   * \return array of size n_samples + 1 whose i-th entry is the offset of
+   * sample i in the stacked data and indices buffers, the last entry being
+   * the total number of lagged entries
+   */
+  SArrayULongPtr sparse_lagged_offsets(
+      const SBaseArrayDouble2dPtrList1D &features,
+      const ArrayULong &censoring) const;
+
+  /**
+   * \brief Filling pass of the CSR lagging of all samples at once.
+   * Samples are processed in parallel and written in disjoint slices of the
+   * output buffers, whose column indices are sorted within each row.
+   * \param offsets : output of sparse_lagged_offsets
+   * \param out_indptr : stacked row pointers, of size
+   * n_samples * (n_intervals + 1). The row pointers of sample i are relative
+   * to offsets[i]
+   * \param out_indices : stacked column indices, of size offsets[n_samples]
+   * \param out_data : stacked values, of size offsets[n_samples]
+   */
+  void sparse_lag_preprocessor(const SBaseArrayDouble2dPtrList1D &features,
+                               const ArrayULong &censoring,
+                               const ArrayULong &offsets,
+                               ArrayULong &out_indptr,
+                               ArrayULong &out_indices,
+                               ArrayDouble &out_data) const;
+
+  /**
+   * \brief Lag all samples and return them as sparse matrices of shape
+   * (n_intervals, n_features * (n_lags + 1))
+   */
+  SSparseArrayDouble2dPtrList1D sparse_lag_preprocessor(
+      const SBaseArrayDouble2dPtrList1D &features,
+      const ArrayULong &censoring) const;
+
+  unsigned int get_n_threads() const { return n_threads; }
+
+  void set_n_threads(unsigned int n_threads) { this->n_threads = n_threads; }
+
   template <class Archive>
   void serialize(Archive & ar) {
     ar(CEREAL_NVP(n_intervals));
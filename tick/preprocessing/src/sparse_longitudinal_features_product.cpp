@@ -6,10 +6,15 @@
 
 #include "sparse_longitudinal_features_product.h"
 #include <map>
+#include <algorithm>
 
 SparseLongitudinalFeaturesProduct::SparseLongitudinalFeaturesProduct(
-    const SBaseArrayDouble2dPtrList1D &features)
-    : n_features(features[0]->n_cols()) {}
+    const SBaseArrayDouble2dPtrList1D &features,
+    const int n_threads)
+    : n_features(features[0]->n_cols()),
+      n_threads(n_threads >= 1 ? n_threads
+                               : std::thread::hardware_concurrency()),
+      compact(false) {}
 
 ulong SparseLongitudinalFeaturesProduct::get_feature_product_col(ulong col1,
                                                                  ulong col2,
@@ -79,3 +84,202 @@ void SparseLongitudinalFeaturesProduct::sparse_features_product(ArrayULong &row,
     }
   }
 }
+
+void SparseLongitudinalFeaturesProduct::check_sparse_features(
+    const SBaseArrayDouble2dPtrList1D &features) const {
+  for (ulong i = 0; i < features.size(); ++i) {
+    if (!features[i]->is_sparse()) {
+      TICK_ERROR("features of sample " << i << " must be sparse");
+    }
+    if (features[i]->n_rows() != features[0]->n_rows() ||
+        features[i]->n_cols() != n_features) {
+      TICK_ERROR("features of sample " << i
+                     << " must have shape (n_intervals, n_features)");
+    }
+  }
+}
+
+void SparseLongitudinalFeaturesProduct::get_exposures(
+    const BaseArrayDouble2d &features,
+    std::vector<ulong> &cols,
+    std::vector<ulong> &last_rows) const {
+  cols.clear();
+  last_rows.clear();
+  // Empty sparse arrays may not allocate their row indices
+  if (features.size_data() == 0) return;
+  const INDICE_TYPE *row_indices = features.row_indices();
+  const INDICE_TYPE *indices = features.indices();
+  std::vector<std::pair<ulong, ulong>> exposures;
+  exposures.reserve(features.size_data());
+  for (ulong r = 0; r < features.n_rows(); ++r) {
+    for (ulong k = row_indices[r]; k < row_indices[r + 1]; ++k) {
+      exposures.emplace_back(indices[k], r);
+    }
+  }
+  std::sort(exposures.begin(), exposures.end());
+  for (const auto &exposure : exposures) {
+    if (!cols.empty() && cols.back() == exposure.first) {
+      last_rows.back() = exposure.second;
+    } else {
+      cols.push_back(exposure.first);
+      last_rows.push_back(exposure.second);
+    }
+  }
+}
+
+ulong SparseLongitudinalFeaturesProduct::get_product_col(ulong c1,
+                                                         ulong c2) const {
+  if (!compact) return get_feature_product_col(c1, c2, n_features);
+  auto it = pair_columns.find(c1 * n_features + c2);
+  return it == pair_columns.end() ? n_output_features() : it->second;
+}
+
+ulong SparseLongitudinalFeaturesProduct::n_output_features() const {
+  if (compact) return n_features + pair_keys.size();
+  return n_features + n_features * (n_features - 1) / 2;
+}
+
+SArrayULongPtr SparseLongitudinalFeaturesProduct::get_observed_pairs() const {
+  SArrayULongPtr pairs = SArrayULong::new_ptr(pair_keys.size());
+  std::copy(pair_keys.begin(), pair_keys.end(), pairs->data());
+  return pairs;
+}
+
+void SparseLongitudinalFeaturesProduct::collect_pair_keys_i(
+    const ulong i,
+    const SBaseArrayDouble2dPtrList1D &features,
+    std::vector<std::vector<ulong>> &keys) const {
+  std::vector<ulong> cols, last_rows;
+  get_exposures(*features[i], cols, last_rows);
+  std::vector<ulong> &keys_i = keys[i];
+  keys_i.clear();
+  for (ulong a = 0; a < cols.size(); ++a) {
+    for (ulong b = a + 1; b < cols.size(); ++b) {
+      keys_i.push_back(cols[a] * n_features + cols[b]);
+    }
+  }
+}
+
+void SparseLongitudinalFeaturesProduct::fit_observed_pairs(
+    const SBaseArrayDouble2dPtrList1D &features) {
+  check_sparse_features(features);
+  std::vector<std::vector<ulong>> keys(features.size());
+  parallel_run(n_threads, features.size(),
+               &SparseLongitudinalFeaturesProduct::collect_pair_keys_i,
+               this, features, keys);
+  pair_keys.clear();
+  for (auto &keys_i : keys) {
+    pair_keys.insert(pair_keys.end(), keys_i.begin(), keys_i.end());
+    std::vector<ulong>().swap(keys_i);
+  }
+  std::sort(pair_keys.begin(), pair_keys.end());
+  pair_keys.erase(std::unique(pair_keys.begin(), pair_keys.end()),
+                  pair_keys.end());
+  pair_columns.clear();
+  pair_columns.reserve(pair_keys.size());
+  for (ulong k = 0; k < pair_keys.size(); ++k) {
+    pair_columns[pair_keys[k]] = n_features + k;
+  }
+  compact = true;
+}
+
+void SparseLongitudinalFeaturesProduct::count_product_nnz_i(
+    const ulong i,
+    const SBaseArrayDouble2dPtrList1D &features,
+    ArrayULong &offsets) const {
+  std::vector<ulong> cols, last_rows;
+  get_exposures(*features[i], cols, last_rows);
+  ulong nnz = features[i]->size_data();
+  const ulong missing = n_output_features();
+  for (ulong a = 0; a < cols.size(); ++a) {
+    for (ulong b = a + 1; b < cols.size(); ++b) {
+      if (get_product_col(cols[a], cols[b]) != missing) nnz++;
+    }
+  }
+  offsets[i + 1] = nnz;
+}
+
+void SparseLongitudinalFeaturesProduct::fill_product_csr_i(
+    const ulong i,
+    const SBaseArrayDouble2dPtrList1D &features,
+    const ArrayULong &offsets,
+    ArrayULong &out_indptr,
+    ArrayULong &out_indices,
+    ArrayDouble &out_data) const {
+  const BaseArrayDouble2d &features_i = *features[i];
+  const ulong n_rows = features_i.n_rows();
+  std::vector<ulong> cols, last_rows;
+  get_exposures(features_i, cols, last_rows);
+
+  // (row, col) of every output entry, data always equal to 1 with the
+  // infinite exposure hypothesis
+  std::vector<std::pair<ulong, ulong>> entries;
+  entries.reserve(offsets[i + 1] - offsets[i]);
+  if (features_i.size_data() > 0) {
+    const INDICE_TYPE *row_indices = features_i.row_indices();
+    const INDICE_TYPE *indices = features_i.indices();
+    for (ulong r = 0; r < n_rows; ++r) {
+      for (ulong k = row_indices[r]; k < row_indices[r + 1]; ++k) {
+        entries.emplace_back(r, indices[k]);
+      }
+    }
+  }
+  const ulong missing = n_output_features();
+  for (ulong a = 0; a < cols.size(); ++a) {
+    for (ulong b = a + 1; b < cols.size(); ++b) {
+      const ulong c = get_product_col(cols[a], cols[b]);
+      if (c != missing) {
+        entries.emplace_back(std::max(last_rows[a], last_rows[b]), c);
+      }
+    }
+  }
+  std::sort(entries.begin(), entries.end());
+
+  ulong *indptr_i = out_indptr.data() + i * (n_rows + 1);
+  ulong *indices_i = out_indices.data() + offsets[i];
+  double *data_i = out_data.data() + offsets[i];
+  ulong k = 0;
+  indptr_i[0] = 0;
+  for (ulong r = 0; r < n_rows; ++r) {
+    for (; k < entries.size() && entries[k].first == r; ++k) {
+      indices_i[k] = entries[k].second;
+      data_i[k] = 1;
+    }
+    indptr_i[r + 1] = k;
+  }
+}
+
+SArrayULongPtr SparseLongitudinalFeaturesProduct::sparse_features_product_offsets(
+    const SBaseArrayDouble2dPtrList1D &features) const {
+  check_sparse_features(features);
+  const ulong n = features.size();
+  SArrayULongPtr offsets = SArrayULong::new_ptr(n + 1);
+  offsets->init_to_zero();
+  parallel_run(n_threads, n,
+               &SparseLongitudinalFeaturesProduct::count_product_nnz_i,
+               this, features, *offsets);
+  for (ulong i = 0; i < n; ++i) (*offsets)[i + 1] += (*offsets)[i];
+  return offsets;
+}
+
+void SparseLongitudinalFeaturesProduct::sparse_features_product(
+    const SBaseArrayDouble2dPtrList1D &features,
+    const ArrayULong &offsets,
+    ArrayULong &out_indptr,
+    ArrayULong &out_indices,
+    ArrayDouble &out_data) const {
+  check_sparse_features(features);
+  const ulong n = features.size();
+  if (offsets.size() != n + 1) {
+    TICK_ERROR("offsets must be of size n_samples + 1");
+  }
+  if (n > 0 && out_indptr.size() != n * (features[0]->n_rows() + 1)) {
+    TICK_ERROR("out_indptr must be of size n_samples * (n_intervals + 1)");
+  }
+  if (out_indices.size() != offsets[n] || out_data.size() != offsets[n]) {
+    TICK_ERROR("out_indices and out_data must be of size offsets[n_samples]");
+  }
+  parallel_run(n_threads, n,
+               &SparseLongitudinalFeaturesProduct::fill_product_csr_i,
+               this, features, offsets, out_indptr, out_indices, out_data);
+}
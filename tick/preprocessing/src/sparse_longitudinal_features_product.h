@@ -8,15 +8,58 @@
 // License: BSD 3 clause
 
 #include "base.h"
+#include <unordered_map>
 #include <cereal/types/polymorphic.hpp>
 #include <cereal/types/base_class.hpp>
+#include <cereal/types/vector.hpp>
+#include <cereal/types/unordered_map.hpp>
 
 class SparseLongitudinalFeaturesProduct {
   protected:
     ulong n_features;
+    unsigned int n_threads;
+
+    //! @brief Whether product columns are restricted to the pairs observed
+    //! in fit_observed_pairs
+    bool compact;
+
+    //! @brief Observed pairs keys c1 * n_features + c2 (c1 < c2), sorted.
+    //! The product of the k-th pair is stored in column n_features + k
+    std::vector<ulong> pair_keys;
+
+    //! @brief Maps an observed pair key to its product column
+    std::unordered_map<ulong, ulong> pair_columns;
+
+    //! @brief Feature columns of a sample along with the last row where
+    //! each of them is exposed, in column order
+    void get_exposures(const BaseArrayDouble2d &features,
+                       std::vector<ulong> &cols,
+                       std::vector<ulong> &last_rows) const;
+
+    //! @brief Product column of the pair (c1, c2), c1 < c2, or
+    //! n_output_features() if this pair has no column
+    ulong get_product_col(ulong c1, ulong c2) const;
+
+    void collect_pair_keys_i(const ulong i,
+                             const SBaseArrayDouble2dPtrList1D &features,
+                             std::vector<std::vector<ulong>> &keys) const;
+
+    void count_product_nnz_i(const ulong i,
+                             const SBaseArrayDouble2dPtrList1D &features,
+                             ArrayULong &offsets) const;
+
+    void fill_product_csr_i(const ulong i,
+                            const SBaseArrayDouble2dPtrList1D &features,
+                            const ArrayULong &offsets,
+                            ArrayULong &out_indptr,
+                            ArrayULong &out_indices,
+                            ArrayDouble &out_data) const;
+
+    void check_sparse_features(const SBaseArrayDouble2dPtrList1D &features) const;
 
   public:
-    SparseLongitudinalFeaturesProduct(const SBaseArrayDouble2dPtrList1D &features);
+    SparseLongitudinalFeaturesProduct(const SBaseArrayDouble2dPtrList1D &features,
+                                      const int n_threads = 1);
 
 
     inline ulong get_feature_product_col(ulong col1,
@@ -30,9 +73,60 @@ class SparseLongitudinalFeaturesProduct {
                                  ArrayULong &out_col,
                                  ArrayDouble &out_data) const;
 
+    /**
+     * \brief Restrict product columns to the pairs of features exposed
+     * together in at least one sample. Products then take n_observed_pairs
+     * columns instead of n_features * (n_features - 1) / 2, pairs being
+     * ordered as (c1, c2) in lexicographic order.
+     * \param features : list of n_samples sparse matrices of shape
+     * (n_intervals, n_features)
+     */
+    void fit_observed_pairs(const SBaseArrayDouble2dPtrList1D &features);
+
+    /**
+     * \brief Counting pass of the CSR feature product of all samples at once.
+     * \return array of size n_samples + 1 whose i-th entry is the offset of
+     * sample i in the stacked data and indices buffers, the last entry being
+     * the total number of entries
+     */
+    SArrayULongPtr sparse_features_product_offsets(
+        const SBaseArrayDouble2dPtrList1D &features) const;
+
+    /**
+     * \brief Filling pass of the CSR feature product of all samples at once.
+     * Samples are processed in parallel and written in disjoint slices of the
+     * output buffers, whose column indices are sorted within each row.
+     * \param offsets : output of sparse_features_product_offsets
+     * \param out_indptr : stacked row pointers, of size
+     * n_samples * (n_intervals + 1). The row pointers of sample i are relative
+     * to offsets[i]
+     * \param out_indices : stacked column indices, of size offsets[n_samples]
+     * \param out_data : stacked values, of size offsets[n_samples]
+     */
+    void sparse_features_product(const SBaseArrayDouble2dPtrList1D &features,
+                                 const ArrayULong &offsets,
+                                 ArrayULong &out_indptr,
+                                 ArrayULong &out_indices,
+                                 ArrayDouble &out_data) const;
+
+    //! @brief Number of columns of the output matrices
+    ulong n_output_features() const;
+
+    //! @brief Observed pairs as keys c1 * n_features + c2, in column order
+    SArrayULongPtr get_observed_pairs() const;
+
+    bool get_compact() const { return compact; }
+
+    unsigned int get_n_threads() const { return n_threads; }
+
+    void set_n_threads(unsigned int n_threads) { this->n_threads = n_threads; }
+
   template <class Archive>
   void serialize(Archive & ar) {
     ar(CEREAL_NVP(n_features));
+    ar(CEREAL_NVP(compact));
+    ar(CEREAL_NVP(pair_keys));
+    ar(CEREAL_NVP(pair_columns));
   }
 };
 
@@ -8,7 +8,8 @@ class LongitudinalFeaturesLagger {
 
  public:
   LongitudinalFeaturesLagger(const SBaseArrayDouble2dPtrList1D &features,
-                             const ulong n_lags);
+                             const ulong n_lags,
+                             const int n_threads = 1);
 
   void dense_lag_preprocessor(ArrayDouble2d &features,
                               ArrayDouble2d &out,
@@ -22,6 +23,21 @@ class LongitudinalFeaturesLagger {
                                ArrayDouble &out_data,
                                ulong censoring) const;
 
+  SArrayULongPtr sparse_lagged_offsets(
+      const SBaseArrayDouble2dPtrList1D &features,
+      const ArrayULong &censoring) const;
+
+  void sparse_lag_preprocessor(const SBaseArrayDouble2dPtrList1D &features,
+                               const ArrayULong &censoring,
+                               const ArrayULong &offsets,
+                               ArrayULong &out_indptr,
+                               ArrayULong &out_indices,
+                               ArrayDouble &out_data) const;
+
+  unsigned int get_n_threads() const;
+
+  void set_n_threads(unsigned int n_threads);
+
 };
 
 TICK_MAKE_PICKLABLE(LongitudinalFeaturesLagger);
\ No newline at end of file
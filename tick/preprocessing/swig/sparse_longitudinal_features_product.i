@@ -7,7 +7,8 @@
 class SparseLongitudinalFeaturesProduct {
 
   public:
-    SparseLongitudinalFeaturesProduct(const SBaseArrayDouble2dPtrList1D &features);
+    SparseLongitudinalFeaturesProduct(const SBaseArrayDouble2dPtrList1D &features,
+                                      const int n_threads = 1);
 
     void sparse_features_product(ArrayULong &row,
                                  ArrayULong &col,
@@ -15,6 +16,27 @@ class SparseLongitudinalFeaturesProduct {
                                  ArrayULong &out_row,
                                  ArrayULong &out_col,
                                  ArrayDouble &out_data) const;
+
+    void fit_observed_pairs(const SBaseArrayDouble2dPtrList1D &features);
+
+    SArrayULongPtr sparse_features_product_offsets(
+        const SBaseArrayDouble2dPtrList1D &features) const;
+
+    void sparse_features_product(const SBaseArrayDouble2dPtrList1D &features,
+                                 const ArrayULong &offsets,
+                                 ArrayULong &out_indptr,
+                                 ArrayULong &out_indices,
+                                 ArrayDouble &out_data) const;
+
+    ulong n_output_features() const;
+
+    SArrayULongPtr get_observed_pairs() const;
+
+    bool get_compact() const;
+
+    unsigned int get_n_threads() const;
+
+    void set_n_threads(unsigned int n_threads);
 };
 
 TICK_MAKE_PICKLABLE(SparseLongitudinalFeaturesProduct);
\ No newline at end of file
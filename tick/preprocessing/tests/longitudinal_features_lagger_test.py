@@ -40,6 +40,21 @@ class Test(unittest.TestCase):
         feat_prod = [f.todense() for f in feat_prod]
         np.testing.assert_equal(feat_prod, self.expected_output)
 
+    def test_sparse_dense_consistency(self):
+        np.random.seed(42)
+        n_intervals, n_features, n_lags = 10, 5, 3
+        features = [np.random.binomial(1, .3, size=(n_intervals, n_features))
+                    .astype("float64") for _ in range(20)]
+        censoring = np.random.randint(1, n_intervals + 1, size=20)\
+            .astype("uint64")
+        dense = LongitudinalFeaturesLagger(n_lags=n_lags)\
+            .fit_transform(features, censoring)
+        sparse = LongitudinalFeaturesLagger(n_lags=n_lags, n_jobs=3)\
+            .fit_transform([csr_matrix(f) for f in features], censoring)
+        for d, s in zip(dense, sparse):
+            self.assertTrue(s.has_sorted_indices)
+            np.testing.assert_equal(s.toarray(), d)
+
 
 if __name__ == "__main__":
     unittest.main()
\ No newline at end of file
@@ -68,6 +68,33 @@ class Test(unittest.TestCase):
         feat_prod = [f.toarray() for f in feat_prod]
         np.testing.assert_equal(feat_prod, expected_output)
 
+    def test_sparse_infinite_observed_pairs_only(self):
+        # Features 0 and 2 are never exposed together
+        infinite_exposures = [np.array([[0, 1, 0],
+                                        [0, 0, 0],
+                                        [0, 0, 1]], dtype="float64"),
+                              np.array([[1, 1, 0],
+                                        [0, 0, 0],
+                                        [0, 0, 0]], dtype="float64")
+                              ]
+        expected_output = \
+            [np.array([[0, 1, 0, 0, 0],
+                       [0, 0, 0, 0, 0],
+                       [0, 0, 1, 0, 1],
+                       ], dtype="float64"),
+             np.array([[1, 1, 0, 1, 0],
+                       [0, 0, 0, 0, 0],
+                       [0, 0, 0, 0, 0],
+                       ], dtype="float64")
+             ]
+        sparse_feat = [csr_matrix(f) for f in infinite_exposures]
+        pp = LongitudinalFeaturesProduct("infinite", n_threads=2,
+                                         observed_pairs_only=True)
+        feat_prod = pp.fit_transform(sparse_feat)
+        self.assertEqual(pp.mapper, {3: (0, 1), 4: (1, 2)})
+        feat_prod = [f.toarray() for f in feat_prod]
+        np.testing.assert_equal(feat_prod, expected_output)
+
 
 if __name__ == "__main__":
     unittest.main()
\ No newline at end of file
@@ -248,6 +248,94 @@ class SimuHawkes(SimuPointProcess):
         """
         return self._pp.get_baseline(i, t_values)
 
+    def _timestamps_or_simulated(self, timestamps):
+        if timestamps is None:
+            return self.timestamps
+        return [np.ascontiguousarray(timestamps_i, dtype=float)
+                for timestamps_i in timestamps]
+
+    def compensators(self, timestamps=None, n_threads=1):
+        """Computes the compensator of each node at each of its jumps
+
+        .. math::
+            \\Lambda_i(t) = \\int_0^t \\lambda_i(s) ds
+
+        Parameters
+        ----------
+        timestamps : `list` of `np.ndarray`, size=n_nodes, default=None
+            Sorted jumps of each node. If `None`, the jumps of the simulated
+            realization are used
+
+        n_threads : `int`, default=1
+            Number of threads used, computations are run in parallel over
+            nodes
+
+        Returns
+        -------
+        output : `list` of `np.ndarray`, size=n_nodes
+            Value of the compensator of each node at each of its jumps
+        """
+        timestamps = self._timestamps_or_simulated(timestamps)
+        return self._pp.get_compensators(timestamps, n_threads)
+
+    def residuals(self, timestamps=None, n_threads=1):
+        """Computes the time-rescaled inter-arrival times of each node
+
+        .. math::
+            \\Lambda_i(t^i_k) - \\Lambda_i(t^i_{k-1})
+
+        where :math:`\\Lambda_i` is the compensator of node :math:`i` and
+        :math:`t^i_0 = 0`. If timestamps is a realization of this Hawkes
+        process, they are independent exponential random variables of mean 1
+
+        Parameters
+        ----------
+        timestamps : `list` of `np.ndarray`, size=n_nodes, default=None
+            Sorted jumps of each node. If `None`, the jumps of the simulated
+            realization are used
+
+        n_threads : `int`, default=1
+            Number of threads used, computations are run in parallel over
+            nodes
+
+        Returns
+        -------
+        output : `list` of `np.ndarray`, size=n_nodes
+            Rescaled inter-arrival times of each node
+        """
+        timestamps = self._timestamps_or_simulated(timestamps)
+        return self._pp.get_residuals(timestamps, n_threads)
+
+    def intensities(self, times, timestamps=None, n_threads=1):
+        """Computes the intensity of each node at the given times
+
+        Parameters
+        ----------
+        times : `np.ndarray`
+            Sorted times at which intensities are computed
+
+        timestamps : `list` of `np.ndarray`, size=n_nodes, default=None
+            Sorted jumps of each node. If `None`, the jumps of the simulated
+            realization are used
+
+        n_threads : `int`, default=1
+            Number of threads used, computations are run in parallel over
+            nodes
+
+        Returns
+        -------
+        output : `list` of `np.ndarray`, size=n_nodes
+            Value of the intensity of each node at the given times
+
+        Notes
+        -----
+        Contrary to `track_intensity`, this does not require to simulate the
+        process again and times can be chosen freely
+        """
+        times = np.ascontiguousarray(times, dtype=float)
+        timestamps = self._timestamps_or_simulated(timestamps)
+        return self._pp.get_intensities(times, timestamps, n_threads)
+
     def _simulate(self):
         """Launch simulation of the Hawkes process by thinning
         """
@@ -119,4 +119,75 @@ double Hawkes::get_baseline_bound(unsigned int i, double t) {
   return baselines[i]->get_future_bound(t);
 }
 
+SArrayDoublePtrList1D Hawkes::get_compensators(const SArrayDoublePtrList1D &timestamps,
+                                               int n_threads) {
+  check_timestamps(timestamps);
 
+  SArrayDoublePtrList1D compensators(n_nodes);
+  parallel_run(n_threads, n_nodes, &Hawkes::compute_compensator, this, timestamps, compensators);
+  return compensators;
+}
+
+SArrayDoublePtrList1D Hawkes::get_residuals(const SArrayDoublePtrList1D &timestamps,
+                                            int n_threads) {
+  SArrayDoublePtrList1D residuals = get_compensators(timestamps, n_threads);
+  for (SArrayDoublePtr &residuals_i : residuals) {
+    // Backward, so that each difference uses the compensator at the previous jump
+    for (ulong k = residuals_i->size(); k > 1; --k) {
+      (*residuals_i)[k - 1] -= (*residuals_i)[k - 2];
+    }
+  }
+  return residuals;
+}
+
+void Hawkes::compute_compensator(ulong i,
+                                 const SArrayDoublePtrList1D &timestamps,
+                                 SArrayDoublePtrList1D &compensators) {
+  const ArrayDouble &timestamps_i = *timestamps[i];
+  SArrayDoublePtr compensator_i = SArrayDouble::new_ptr(timestamps_i.size());
+
+  for (ulong k = 0; k < timestamps_i.size(); ++k) {
+    (*compensator_i)[k] = baselines[i]->get_primitive(timestamps_i[k]);
+  }
+  for (ulong j = 0; j < n_nodes; ++j) {
+    kernels[i * n_nodes + j]->add_primitive_convolutions(timestamps_i, *timestamps[j],
+                                                         *compensator_i);
+  }
+  compensators[i] = compensator_i;
+}
+
+SArrayDoublePtrList1D Hawkes::get_intensities(const ArrayDouble &times,
+                                              const SArrayDoublePtrList1D &timestamps,
+                                              int n_threads) {
+  check_timestamps(timestamps);
+  for (ulong q = 1; q < times.size(); ++q) {
+    if (times[q] < times[q - 1]) TICK_ERROR("times must be sorted");
+  }
+
+  SArrayDoublePtrList1D intensities(n_nodes);
+  parallel_run(n_threads, n_nodes, &Hawkes::compute_intensity, this, times, timestamps,
+               intensities);
+  return intensities;
+}
+
+void Hawkes::compute_intensity(ulong i,
+                               const ArrayDouble &times,
+                               const SArrayDoublePtrList1D &timestamps,
+                               SArrayDoublePtrList1D &intensities) {
+  SArrayDoublePtr intensity_i = SArrayDouble::new_ptr(times.size());
+
+  for (ulong q = 0; q < times.size(); ++q) {
+    (*intensity_i)[q] = baselines[i]->get_value(times[q]);
+  }
+  for (ulong j = 0; j < n_nodes; ++j) {
+    kernels[i * n_nodes + j]->add_convolutions(times, *timestamps[j], *intensity_i);
+  }
+  intensities[i] = intensity_i;
+}
+
+void Hawkes::check_timestamps(const SArrayDoublePtrList1D &timestamps) {
+  if (timestamps.size() != n_nodes) {
+    TICK_ERROR("timestamps (size=" << timestamps.size() << ") should contain one array per "
+                                   "node (n_nodes=" << n_nodes << ")");
+  }
+}
@@ -122,7 +122,76 @@ class Hawkes : public PP {
    */
   SArrayDoublePtr get_baseline(unsigned int i, ArrayDouble &t);
 
+  /**
+   * @brief Computes the compensator of each node at each of its jumps
+   * \f[
+   *     \Lambda_i(t) = \int_0^t \lambda_i(s) ds
+   *     = \int_0^t \mu_i(s) ds + \sum_{j=1}^D \sum_{t^j_k < t} \Phi_{ij}(t - t^j_k)
+   * \f]
+   * where \f$ \Phi_{ij} \f$ is the primitive of the kernel \f$ \phi_{ij} \f$
+   * \param timestamps : The sorted jumps of each node
+   * \param n_threads : Number of threads used, computations are run in parallel over nodes
+   * \return For each node i, the values of \f$ \Lambda_i \f$ at its jumps
+   */
+  SArrayDoublePtrList1D get_compensators(const SArrayDoublePtrList1D &timestamps,
+                                         int n_threads = 1);
+
+  /**
+   * @brief Computes the time-rescaled inter-arrival times of each node
+   * \f$ \Lambda_i(t^i_k) - \Lambda_i(t^i_{k-1}) \f$ with \f$ t^i_0 = 0 \f$
+   * \param timestamps : The sorted jumps of each node
+   * \param n_threads : Number of threads used, computations are run in parallel over nodes
+   * \return For each node i, its rescaled inter-arrival times
+   * \note If timestamps is a realization of this process, they are independent exponential
+   * random variables of mean 1
+   */
+  SArrayDoublePtrList1D get_residuals(const SArrayDoublePtrList1D &timestamps,
+                                      int n_threads = 1);
+
+  /**
+   * @brief Computes the intensity of each node at the given times
+   * \f[
+   *     \lambda_i(t) = \mu_i(t) + \sum_{j=1}^D \sum_{t^j_k \leq t} \phi_{ij}(t - t^j_k)
+   * \f]
+   * \param times : The sorted times at which intensities are computed
+   * \param timestamps : The sorted jumps of each node
+   * \param n_threads : Number of threads used, computations are run in parallel over nodes
+   * \return For each node i, the values of \f$ \lambda_i \f$ at the given times
+   * \note Times and jumps are traversed once per kernel, which avoids recording intensity
+   * during simulation or computing one convolution per time
+   */
+  SArrayDoublePtrList1D get_intensities(const ArrayDouble &times,
+                                        const SArrayDoublePtrList1D &timestamps,
+                                        int n_threads = 1);
+
  private :
+  /**
+   * @brief Computes the compensator of node i at each of its jumps
+   * \param i : the node
+   * \param timestamps : The sorted jumps of each node
+   * \param compensators : The list in which the compensator of node i is stored
+   * \note This does not modify the kernels and is called concurrently for several nodes
+   */
+  void compute_compensator(ulong i,
+                           const SArrayDoublePtrList1D &timestamps,
+                           SArrayDoublePtrList1D &compensators);
+
+  /**
+   * @brief Computes the intensity of node i at the given times
+   * \param i : the node
+   * \param times : The sorted times at which the intensity is computed
+   * \param timestamps : The sorted jumps of each node
+   * \param intensities : The list in which the intensity of node i is stored
+   * \note This does not modify the kernels and is called concurrently for several nodes
+   */
+  void compute_intensity(ulong i,
+                         const ArrayDouble &times,
+                         const SArrayDoublePtrList1D &timestamps,
+                         SArrayDoublePtrList1D &intensities);
+
+  //! @brief Checks that there is one array of timestamps per node
+  void check_timestamps(const SArrayDoublePtrList1D &timestamps);
+
   /**
    * @brief Virtual method called once (at startup) to set the initial
    * intensity
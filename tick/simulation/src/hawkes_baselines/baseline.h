@@ -25,6 +25,9 @@ class HawkesBaseline {
   //! @brief get the future maximum reachable value of the baseline after time t
   virtual double get_future_bound(double t) = 0;
 
+  //! @brief get the integral of the baseline between 0 and t
+  virtual double get_primitive(double t) = 0;
+
   template<class Archive>
   void serialize(Archive &ar) {}
 };
@@ -17,3 +17,7 @@ SArrayDoublePtr HawkesConstantBaseline::get_value(ArrayDouble &t) {
 double HawkesConstantBaseline::get_future_bound(double t) {
   return value;
 }
+
+double HawkesConstantBaseline::get_primitive(double t) {
+  return t > 0 ? value * t : 0;
+}
@@ -31,6 +31,9 @@ class HawkesConstantBaseline : public HawkesBaseline {
   //! @brief get the future maximum reachable value of the baseline after time t
   double get_future_bound(double t) override;
 
+  //! @brief get the integral of the baseline between 0 and t
+  double get_primitive(double t) override;
+
   template<class Archive>
   void serialize(Archive &ar) {
     ar(cereal::make_nvp("HawkesBaseline", cereal::base_class<HawkesBaseline>(this)));
@@ -27,3 +27,7 @@ SArrayDoublePtr HawkesTimeFunctionBaseline::get_value(ArrayDouble &t) {
 double HawkesTimeFunctionBaseline::get_future_bound(double t) {
   return time_function.future_bound(t);
 }
+
+double HawkesTimeFunctionBaseline::get_primitive(double t) {
+  return time_function.primitive(t);
+}
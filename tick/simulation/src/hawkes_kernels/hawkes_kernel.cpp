@@ -3,6 +3,8 @@
 
 #include "hawkes_kernel.h"
 
+#include <algorithm>
+
 // Constructor
 HawkesKernel::HawkesKernel(double support) : support(support) {}
 
@@ -41,6 +43,65 @@ double HawkesKernel::get_norm(int nsteps) {
   return norm;
 }
 
+// Get the primitive of the kernel
+// By default, it discretizes the integral with a midpoint Riemann sum
+// Should be overloaded if a closed formula exists
+double HawkesKernel::get_primitive(double x) {
+  const double upper_bound = std::min(x, support);
+  if (is_zero() || upper_bound <= 0)
+    return 0;
+
+  const int nsteps = 10000;
+  const double dx = upper_bound / nsteps;
+  double primitive = 0;
+  for (int k = 0; k < nsteps; ++k)
+    primitive += get_value((k + 0.5) * dx) * dx;
+
+  return primitive;
+}
+
+// Adds the integrals of the convolution kernel*process between 0 and each time
+// Events whose primitive has reached its support all contribute the same value, others are
+// kept in the window [first, last)
+void HawkesKernel::add_primitive_convolutions(const ArrayDouble &times,
+                                              const ArrayDouble &timestamps,
+                                              ArrayDouble &out) {
+  if (is_zero()) return;
+
+  const double full_primitive = get_primitive(get_support());
+  ulong first = 0, last = 0;
+  for (ulong q = 0; q < times.size(); ++q) {
+    const double time = times[q];
+    while (last < timestamps.size() && timestamps[last] < time) last++;
+    while (first < last && timestamps[first] <= time - get_support()) first++;
+
+    double value = first * full_primitive;
+    for (ulong k = first; k < last; ++k)
+      value += get_primitive(time - timestamps[k]);
+    out[q] += value;
+  }
+}
+
+// Adds the convolutions kernel*process at each time
+// Only the events in the support, in the window [first, last), contribute
+void HawkesKernel::add_convolutions(const ArrayDouble &times,
+                                    const ArrayDouble &timestamps,
+                                    ArrayDouble &out) {
+  if (is_zero()) return;
+
+  ulong first = 0, last = 0;
+  for (ulong q = 0; q < times.size(); ++q) {
+    const double time = times[q];
+    while (last < timestamps.size() && timestamps[last] <= time) last++;
+    while (first < last && timestamps[first] <= time - get_support()) first++;
+
+    double value = 0;
+    for (ulong k = first; k < last; ++k)
+      value += get_value(time - timestamps[k]);
+    out[q] += value;
+  }
+}
+
 // Returns the convolution kernel*process(time)
 // If bound != NULL then *bound will return a bound of the future values of the convolution, i.e., MAX(kernel*process(t>=time))
 // Should be overloaded for efficiency if there is a faster way to compute this convolution than just regular algorithm
@@ -71,6 +71,52 @@ class HawkesKernel {
    */
   virtual double get_norm(int nsteps = 10000);
 
+  /**
+   * Computes the primitive of the kernel
+   * \f[
+   *     \Phi(x) = \int_0^x \phi(s) ds
+   * \f]
+   * @param x: The upper bound of the integral
+   * @note By default it approximates the integral with a midpoint Riemann sum of 10000 steps.
+   * It should be overloaded if a closed formula exists
+   */
+  virtual double get_primitive(double x);
+
+  /**
+   * Adds to out the convolution of the process with the primitive of the kernel at each of the
+   * given times
+   * \f[
+   *     \int_0^t \Phi(t - s) dN(s) = \sum_{t_k < t} \Phi(t - t_k)
+   * \f]
+   * which is the integral of the convolution of the process with the kernel between 0 and t
+   * @param times: The sorted times \f$ t \f$ at which the integral is computed
+   * @param timestamps: The sorted process \f$ N \f$ with which the convolution is computed
+   * @param out: Array of the size of times, incremented with the integral at each time
+   * @note Contrary to get_convolution, this does not modify the kernel and can be called
+   * concurrently. By default, events older than the support contribute the L1 norm of the
+   * kernel and the others are kept in a sliding window, it should be overloaded if there is a
+   * recursive formula
+   */
+  virtual void add_primitive_convolutions(const ArrayDouble &times,
+                                          const ArrayDouble &timestamps,
+                                          ArrayDouble &out);
+
+  /**
+   * Adds to out the convolution of the process with the kernel at each of the given times
+   * \f[
+   *     \int_0^t \phi(t - s) dN(s) = \sum_{t_k \leq t} \phi(t - t_k)
+   * \f]
+   * @param times: The sorted times \f$ t \f$ at which the convolution is computed
+   * @param timestamps: The sorted process \f$ N \f$ with which the convolution is computed
+   * @param out: Array of the size of times, incremented with the convolution at each time
+   * @note Contrary to get_convolution, this does not modify the kernel and can be called
+   * concurrently. By default, events in the support are kept in a sliding window while times
+   * are traversed, it should be overloaded if there is a recursive formula
+   */
+  virtual void add_convolutions(const ArrayDouble &times,
+                                const ArrayDouble &timestamps,
+                                ArrayDouble &out);
+
   /**
    * Computes the convolution of the process with the kernel
    * \f[
@@ -91,3 +91,54 @@ double HawkesKernelExp::get_convolution(const double time,
   return value;
 }
 
+
+double HawkesKernelExp::get_primitive(double x) {
+  if (intensity == 0 || x <= 0)
+    return 0;
+
+  return intensity * (1 - cexp(-decay * x));
+}
+
+// The integral is intensity * (n - s) where n is the number of events before time and
+// s = sum_{t_k < time} exp(-decay (time - t_k)), which is updated at each event
+void HawkesKernelExp::add_primitive_convolutions(const ArrayDouble &times,
+                                                 const ArrayDouble &timestamps,
+                                                 ArrayDouble &out) {
+  if (intensity == 0) return;
+
+  // Value of s at the last event
+  double sum_exp = 0;
+  double last_time = 0;
+  ulong k = 0;
+  for (ulong q = 0; q < times.size(); ++q) {
+    const double time = times[q];
+    while (k < timestamps.size() && timestamps[k] < time) {
+      sum_exp = sum_exp * cexp(-decay * (timestamps[k] - last_time)) + 1;
+      last_time = timestamps[k];
+      k++;
+    }
+    if (k > 0) out[q] += intensity * (k - sum_exp * cexp(-decay * (time - last_time)));
+  }
+}
+
+// The convolution is intensity * decay * s where s = sum_{t_k <= time} exp(-decay (time - t_k))
+// is updated at each event
+void HawkesKernelExp::add_convolutions(const ArrayDouble &times,
+                                       const ArrayDouble &timestamps,
+                                       ArrayDouble &out) {
+  if (intensity == 0) return;
+
+  // Value of s at the last event
+  double sum_exp = 0;
+  double last_time = 0;
+  ulong k = 0;
+  for (ulong q = 0; q < times.size(); ++q) {
+    const double time = times[q];
+    while (k < timestamps.size() && timestamps[k] <= time) {
+      sum_exp = sum_exp * cexp(-decay * (timestamps[k] - last_time)) + 1;
+      last_time = timestamps[k];
+      k++;
+    }
+    if (k > 0) out[q] += intensity * decay * sum_exp * cexp(-decay * (time - last_time));
+  }
+}
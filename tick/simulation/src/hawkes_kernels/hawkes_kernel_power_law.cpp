@@ -3,6 +3,8 @@
 
 #include "hawkes_kernel_power_law.h"
 
+#include <algorithm>
+
 HawkesKernelPowerLaw::HawkesKernelPowerLaw(double multiplier,
                                            double cutoff,
                                            double exponent,
@@ -33,3 +35,14 @@ double HawkesKernelPowerLaw::get_norm(int nsteps) {
   return norm;
 }
 
+double HawkesKernelPowerLaw::get_primitive(double x) {
+  const double upper_bound = std::min(x, support);
+  if (upper_bound <= 0)
+    return 0;
+
+  if (exponent == 1)
+    return multiplier * log((upper_bound + cutoff) / cutoff);
+
+  return (pow(upper_bound + cutoff, 1 - exponent) - pow(cutoff, 1 - exponent))
+      * multiplier / (1 - exponent);
+}
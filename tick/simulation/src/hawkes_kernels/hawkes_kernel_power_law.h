@@ -80,6 +80,13 @@ class HawkesKernelPowerLaw : public HawkesKernel {
    */
   double get_norm(int nsteps = 10000) override;
 
+  /**
+   * Computes the primitive of the kernel with an explicit formula
+   * @param x: The upper bound of the integral
+   * @return \f$ \int_0^x \phi(s) ds \f$
+   */
+  double get_primitive(double x) override;
+
   template<class Archive>
   void serialize(Archive &ar) {
     ar(cereal::make_nvp("HawkesKernel", cereal::base_class<HawkesKernel>(this)));
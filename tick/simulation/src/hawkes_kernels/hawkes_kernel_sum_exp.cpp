@@ -115,6 +115,73 @@ double HawkesKernelSumExp::get_convolution(const double time, const ArrayDouble
   return value;
 }
 
+double HawkesKernelSumExp::get_primitive(double x) {
+  if (x <= 0) return 0;
+
+  double primitive = 0;
+  for (ulong u = 0; u < n_decays; ++u) {
+    if (intensities[u] == 0) continue;
+    primitive += intensities[u] * (1 - cexp(-decays[u] * x));
+  }
+  return primitive;
+}
+
+// For each decay, the integral is intensity * (n - s) where n is the number of events before
+// time and s = sum_{t_k < time} exp(-decay (time - t_k)), which is updated at each event
+void HawkesKernelSumExp::add_primitive_convolutions(const ArrayDouble &times,
+                                                    const ArrayDouble &timestamps,
+                                                    ArrayDouble &out) {
+  // Values of s at the last event
+  ArrayDouble sum_exps(n_decays);
+  sum_exps.init_to_zero();
+  double last_time = 0;
+  ulong k = 0;
+  for (ulong q = 0; q < times.size(); ++q) {
+    const double time = times[q];
+    while (k < timestamps.size() && timestamps[k] < time) {
+      for (ulong u = 0; u < n_decays; ++u) {
+        sum_exps[u] = sum_exps[u] * cexp(-decays[u] * (timestamps[k] - last_time)) + 1;
+      }
+      last_time = timestamps[k];
+      k++;
+    }
+    if (k == 0) continue;
+
+    for (ulong u = 0; u < n_decays; ++u) {
+      if (intensities[u] == 0) continue;
+      out[q] += intensities[u] * (k - sum_exps[u] * cexp(-decays[u] * (time - last_time)));
+    }
+  }
+}
+
+// For each decay, the convolution is intensity * decay * s where
+// s = sum_{t_k <= time} exp(-decay (time - t_k)) is updated at each event
+void HawkesKernelSumExp::add_convolutions(const ArrayDouble &times,
+                                          const ArrayDouble &timestamps,
+                                          ArrayDouble &out) {
+  // Values of s at the last event
+  ArrayDouble sum_exps(n_decays);
+  sum_exps.init_to_zero();
+  double last_time = 0;
+  ulong k = 0;
+  for (ulong q = 0; q < times.size(); ++q) {
+    const double time = times[q];
+    while (k < timestamps.size() && timestamps[k] <= time) {
+      for (ulong u = 0; u < n_decays; ++u) {
+        sum_exps[u] = sum_exps[u] * cexp(-decays[u] * (timestamps[k] - last_time)) + 1;
+      }
+      last_time = timestamps[k];
+      k++;
+    }
+    if (k == 0) continue;
+
+    for (ulong u = 0; u < n_decays; ++u) {
+      if (intensities[u] == 0) continue;
+      out[q] += intensities[u] * decays[u] * sum_exps[u] * cexp(-decays[u] * (time - last_time));
+    }
+  }
+}
+
 double HawkesKernelSumExp::get_norm(int nsteps) {
   return intensities.sum();
 }
@@ -99,6 +99,36 @@ class HawkesKernelSumExp : public HawkesKernel {
                          const ArrayDouble &timestamps,
                          double *const bound) override;
 
+  /**
+   * Computes the primitive of the kernel with an explicit formula
+   * @param x: The upper bound of the integral
+   * @return \f$ \int_0^x \phi(s) ds \f$
+   */
+  double get_primitive(double x) override;
+
+  /**
+   * Adds to out the integral of the convolution of the process with the kernel between 0 and
+   * each of the given times. It is updated recursively from one time to the next one, hence
+   * in O(1) per time and per event
+   * @param times: The sorted times \f$ t \f$ at which the integral is computed
+   * @param timestamps: The sorted process \f$ N \f$ with which the convolution is computed
+   * @param out: Array of the size of times, incremented with the integral at each time
+   */
+  void add_primitive_convolutions(const ArrayDouble &times,
+                                  const ArrayDouble &timestamps,
+                                  ArrayDouble &out) override;
+
+  /**
+   * Adds to out the convolution of the process with the kernel at each of the given times. It
+   * is updated recursively from one time to the next one, hence in O(1) per time and per event
+   * @param times: The sorted times \f$ t \f$ at which the convolution is computed
+   * @param timestamps: The sorted process \f$ N \f$ with which the convolution is computed
+   * @param out: Array of the size of times, incremented with the convolution at each time
+   */
+  void add_convolutions(const ArrayDouble &times,
+                        const ArrayDouble &timestamps,
+                        ArrayDouble &out) override;
+
   //! simple setter
   static void set_fast_exp(bool flag) { use_fast_exp = flag; }
   //! simple getter
@@ -2,12 +2,53 @@
 
 #include "hawkes_kernel_time_func.h"
 
+#include <algorithm>
+
+namespace {
+
+template<TimeFunction::InterMode inter_mode>
+double time_func_convolution(const TimeFunction &time_function, double support, double time,
+                             const ArrayDouble &timestamps, double *const bound) {
+  const double first_time = time - support;
+  ulong k = std::upper_bound(timestamps.data(), timestamps.data() + timestamps.size(), time)
+      - timestamps.data();
+
+  double value = 0;
+  for (; k >= 1 && timestamps[k - 1] >= first_time; --k) {
+    const double x = time - timestamps[k - 1];
+    value += time_function.value_no_dispatch<inter_mode>(x);
+    if (bound) *bound += time_function.future_bound_no_dispatch<inter_mode>(x);
+  }
+  return value;
+}
+
+template<TimeFunction::InterMode inter_mode>
+void time_func_add_convolutions(const TimeFunction &time_function, double support,
+                                const ArrayDouble &times, const ArrayDouble &timestamps,
+                                ArrayDouble &out) {
+  ulong first = 0, last = 0;
+  for (ulong q = 0; q < times.size(); ++q) {
+    const double time = times[q];
+    while (last < timestamps.size() && timestamps[last] <= time) last++;
+    while (first < last && timestamps[first] <= time - support) first++;
+
+    double value = 0;
+    for (ulong k = first; k < last; ++k)
+      value += time_function.value_no_dispatch<inter_mode>(time - timestamps[k]);
+    out[q] += value;
+  }
+}
+
+}  // namespace
+
 HawkesKernelTimeFunc::HawkesKernelTimeFunc(const TimeFunction &time_function)
     : HawkesKernel(), time_function(time_function) {
   if (time_function.get_border_type() != TimeFunction::BorderType::Border0) TICK_ERROR(
       "Only TimeFunction with a border 0 can be used in HawkesKernelTimeFunc");
 
   support = time_function.get_support_right();
+  // Computed once, so that convolution bounds can be read concurrently
+  this->time_function.compute_future_max();
 }
 
 HawkesKernelTimeFunc::HawkesKernelTimeFunc(const ArrayDouble &t_axis, const ArrayDouble &y_axis)
@@ -26,4 +67,48 @@ double HawkesKernelTimeFunc::get_future_max(double t, double value_at_t) {
   return time_function.future_bound(t);
 }
 
+double HawkesKernelTimeFunc::get_primitive(double x) {
+  return x <= 0 ? 0 : time_function.primitive(x);
+}
+
+double HawkesKernelTimeFunc::get_convolution(const double time,
+                                             const ArrayDouble &timestamps,
+                                             double *const bound) {
+  if (bound) *bound = 0;
+  if (time_function.get_sampled_y() == nullptr)
+    return HawkesKernel::get_convolution(time, timestamps, bound);
+  if (bound && time_function.get_future_max() == nullptr) time_function.compute_future_max();
 
+  switch (time_function.get_inter_mode()) {
+    case (TimeFunction::InterMode::InterLinear):
+      return time_func_convolution<TimeFunction::InterMode::InterLinear>(
+          time_function, support, time, timestamps, bound);
+    case (TimeFunction::InterMode::InterConstLeft):
+      return time_func_convolution<TimeFunction::InterMode::InterConstLeft>(
+          time_function, support, time, timestamps, bound);
+    case (TimeFunction::InterMode::InterConstRight):
+      return time_func_convolution<TimeFunction::InterMode::InterConstRight>(
+          time_function, support, time, timestamps, bound);
+    default:throw std::runtime_error("Undefined interpolation mode");
+  }
+}
+
+void HawkesKernelTimeFunc::add_convolutions(const ArrayDouble &times,
+                                            const ArrayDouble &timestamps,
+                                            ArrayDouble &out) {
+  if (time_function.get_sampled_y() == nullptr)
+    return HawkesKernel::add_convolutions(times, timestamps, out);
+
+  switch (time_function.get_inter_mode()) {
+    case (TimeFunction::InterMode::InterLinear):
+      return time_func_add_convolutions<TimeFunction::InterMode::InterLinear>(
+          time_function, support, times, timestamps, out);
+    case (TimeFunction::InterMode::InterConstLeft):
+      return time_func_add_convolutions<TimeFunction::InterMode::InterConstLeft>(
+          time_function, support, times, timestamps, out);
+    case (TimeFunction::InterMode::InterConstRight):
+      return time_func_add_convolutions<TimeFunction::InterMode::InterConstRight>(
+          time_function, support, times, timestamps, out);
+    default:throw std::runtime_error("Undefined interpolation mode");
+  }
+}
@@ -38,6 +38,43 @@ class HawkesKernelTimeFunc : public HawkesKernel {
   */
   double get_future_max(double t, double value_at_t) override;
 
+  /**
+   * Computes the convolution of the process with the kernel
+   * \f[
+   *     \int_0^t \phi(t - s) dN(s) = \sum_{t_k} \phi(t - t_k)
+   * \f]
+   * Events in the support are read backward from the last one before t, and the kernel
+   * values are evaluated by the TimeFunction with its interpolation mode dispatched once
+   * @param time: The time \f$ t \f$ up to the convolution is computed
+   * @param timestamps: The process \f$ N \f$ with which the convolution is computed
+   * @param bound: if `bound != nullptr` we store in this variable we store the maximum value that
+   * the convolution can reach until next jump. This is useful for Ogata's thinning algorithm.
+   * @return the value of the convolution
+   */
+  double get_convolution(const double time,
+                         const ArrayDouble &timestamps,
+                         double *const bound) override;
+
+  /**
+   * Adds to out the convolution of the process with the kernel at each of the given times.
+   * Events in the support are kept in a sliding window and the kernel values are evaluated by
+   * the TimeFunction with its interpolation mode dispatched once
+   * @param times: The sorted times \f$ t \f$ at which the convolution is computed
+   * @param timestamps: The sorted process \f$ N \f$ with which the convolution is computed
+   * @param out: Array of the size of times, incremented with the convolution at each time
+   */
+  void add_convolutions(const ArrayDouble &times,
+                        const ArrayDouble &timestamps,
+                        ArrayDouble &out) override;
+
+  /**
+   * Computes the primitive of the kernel from the primitive of the TimeFunction, which is
+   * tabulated on its sampled times
+   * @param x: The upper bound of the integral
+   * @return \f$ \int_0^x \phi(s) ds \f$
+   */
+  double get_primitive(double x) override;
+
   //! @brief simple getter
   const TimeFunction &get_time_function() const { return time_function; }
 
@@ -19,6 +19,14 @@ class Hawkes : public PP {
 
   SArrayDoublePtr get_baseline(unsigned int i, ArrayDouble &t);
   double get_baseline(unsigned int i, double t);
+
+  SArrayDoublePtrList1D get_compensators(const SArrayDoublePtrList1D &timestamps,
+                                         int n_threads = 1);
+  SArrayDoublePtrList1D get_residuals(const SArrayDoublePtrList1D &timestamps,
+                                      int n_threads = 1);
+  SArrayDoublePtrList1D get_intensities(const ArrayDouble &times,
+                                        const SArrayDoublePtrList1D &timestamps,
+                                        int n_threads = 1);
 };
 
 TICK_MAKE_PICKLABLE(Hawkes, 0);
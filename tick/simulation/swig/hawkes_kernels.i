@@ -23,6 +23,7 @@ class HawkesKernel {
   double get_value(double x);
   SArrayDoublePtr get_values(const ArrayDouble &t_values);
   virtual double get_norm(int nsteps = 10000);
+  virtual double get_primitive(double x);
 };
 
 
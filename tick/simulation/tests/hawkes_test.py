@@ -103,6 +103,38 @@ class Test(unittest.TestCase):
             self.assertAlmostEqual(np.mean(hawkes.tracked_intensity[i]),
                                    mean_intensity[i], delta=0.3)
 
+    def test_hawkes_residuals(self):
+        """...Test that Hawkes residuals are exponential of mean 1 and add
+        up to the compensators
+        """
+        hawkes = SimuHawkes(kernels=self.kernels, baseline=self.baseline,
+                            seed=308, end_time=10000, verbose=False)
+        hawkes.simulate()
+
+        compensators = hawkes.compensators(n_threads=2)
+        residuals = hawkes.residuals(hawkes.timestamps)
+        for i in range(hawkes.n_nodes):
+            self.assertEqual(len(residuals[i]), len(hawkes.timestamps[i]))
+            np.testing.assert_array_almost_equal(np.cumsum(residuals[i]),
+                                                 compensators[i])
+            self.assertTrue(np.all(residuals[i] > 0))
+            self.assertAlmostEqual(np.mean(residuals[i]), 1, delta=0.1)
+
+    def test_hawkes_intensities(self):
+        """...Test that Hawkes intensities computed at given times match
+        the ones tracked during simulation
+        """
+        hawkes = SimuHawkes(kernels=self.kernels, baseline=self.baseline,
+                            seed=308, end_time=100, verbose=False)
+        hawkes.track_intensity(0.1)
+        hawkes.simulate()
+
+        times = hawkes.intensity_tracked_times
+        intensities = hawkes.intensities(times, n_threads=2)
+        for i in range(hawkes.n_nodes):
+            np.testing.assert_array_almost_equal(intensities[i],
+                                                 hawkes.tracked_intensity[i])
+
     def test_simu_hawkes_constructor(self):
         """...Test SimuHawkes constructor
         """
@@ -0,0 +1,51 @@
+#ifndef TICK_SIMULATION_TESTS_SRC_HAWKES_GTEST_UTILS_H_
+#define TICK_SIMULATION_TESTS_SRC_HAWKES_GTEST_UTILS_H_
+
+// License: BSD 3 clause
+
+#include <array>
+#include <hawkes_kernels/hawkes_kernel.h>
+
+//! @brief Copy test times stored in a std::array into an ArrayDouble
+template <std::size_t N>
+inline ArrayDouble to_array_double(const std::array<double, N> &values) {
+  ArrayDouble array(N);
+  std::copy(values.begin(), values.end(), array.data());
+  return array;
+}
+
+/**
+ * @brief Brute force reference of HawkesKernel::add_primitive_convolutions: sum over the
+ * timestamps t_k < t of the kernel primitive at t - t_k, for each t of times
+ */
+inline ArrayDouble brute_force_primitive_convolutions(HawkesKernel &kernel,
+                                                      const ArrayDouble &times,
+                                                      const ArrayDouble &timestamps) {
+  ArrayDouble primitive_convolutions(times.size());
+  primitive_convolutions.init_to_zero();
+  for (ulong q = 0; q < times.size(); ++q) {
+    for (ulong k = 0; k < timestamps.size(); ++k) {
+      if (timestamps[k] < times[q])
+        primitive_convolutions[q] += kernel.get_primitive(times[q] - timestamps[k]);
+    }
+  }
+  return primitive_convolutions;
+}
+
+/**
+ * @brief Brute force reference of HawkesKernel::add_convolutions: sum over the timestamps
+ * t_k <= t of the kernel value at t - t_k, for each t of times
+ */
+inline ArrayDouble brute_force_convolutions(HawkesKernel &kernel, const ArrayDouble &times,
+                                            const ArrayDouble &timestamps) {
+  ArrayDouble convolutions(times.size());
+  convolutions.init_to_zero();
+  for (ulong q = 0; q < times.size(); ++q) {
+    for (ulong k = 0; k < timestamps.size(); ++k) {
+      if (timestamps[k] <= times[q]) convolutions[q] += kernel.get_value(times[q] - timestamps[k]);
+    }
+  }
+  return convolutions;
+}
+
+#endif  // TICK_SIMULATION_TESTS_SRC_HAWKES_GTEST_UTILS_H_
@@ -3,6 +3,7 @@
 
 #include <gtest/gtest.h>
 #include <hawkes_kernels/hawkes_kernel_exp.h>
+#include "hawkes_gtest_utils.h"
 
 double compute_expkernel_convolution(double decay,
                                      double intensity,
@@ -81,6 +82,56 @@ TEST_F(HawkesKernelExpTest, get_norm) {
   EXPECT_DOUBLE_EQ(hawkes_kernel_exp.get_norm(), intensity);
 }
 
+TEST_F(HawkesKernelExpTest, get_primitive) {
+  EXPECT_DOUBLE_EQ(hawkes_kernel_exp.get_primitive(-1.), 0);
+  for (double test_time : test_times) {
+    EXPECT_DOUBLE_EQ(hawkes_kernel_exp.get_primitive(test_time),
+                     intensity * (1 - exp(-decay * test_time)));
+  }
+}
+
+TEST_F(HawkesKernelExpTest, add_primitive_convolutions) {
+  const ArrayDouble times = to_array_double(test_times);
+
+  ArrayDouble primitive_convolutions(times.size());
+  primitive_convolutions.fill(1.);
+  hawkes_kernel_exp.add_primitive_convolutions(times, timestamps, primitive_convolutions);
+
+  ArrayDouble generic_primitive_convolutions(times.size());
+  generic_primitive_convolutions.fill(1.);
+  hawkes_kernel_exp.HawkesKernel::add_primitive_convolutions(times, timestamps,
+                                                             generic_primitive_convolutions);
+
+  const ArrayDouble expected =
+      brute_force_primitive_convolutions(hawkes_kernel_exp, times, timestamps);
+  for (ulong q = 0; q < times.size(); ++q) {
+    EXPECT_DOUBLE_EQ(generic_primitive_convolutions[q], 1. + expected[q]);
+    EXPECT_NEAR(primitive_convolutions[q], 1. + expected[q], 1e-12);
+  }
+
+  // The state used by get_convolution is left untouched
+  EXPECT_DOUBLE_EQ(hawkes_kernel_exp.get_convolution(test_times[0], timestamps, nullptr),
+                   compute_expkernel_convolution(decay, intensity, timestamps, test_times[0]));
+}
+
+TEST_F(HawkesKernelExpTest, add_convolutions) {
+  const ArrayDouble times = to_array_double(test_times);
+
+  ArrayDouble convolutions(times.size());
+  convolutions.fill(1.);
+  hawkes_kernel_exp.add_convolutions(times, timestamps, convolutions);
+
+  ArrayDouble generic_convolutions(times.size());
+  generic_convolutions.fill(1.);
+  hawkes_kernel_exp.HawkesKernel::add_convolutions(times, timestamps, generic_convolutions);
+
+  const ArrayDouble expected = brute_force_convolutions(hawkes_kernel_exp, times, timestamps);
+  for (ulong q = 0; q < times.size(); ++q) {
+    EXPECT_DOUBLE_EQ(generic_convolutions[q], 1. + expected[q]);
+    EXPECT_NEAR(convolutions[q], 1. + expected[q], 1e-12);
+  }
+}
+
 TEST_F(HawkesKernelExpTest, get_convolution_value) {
   double time0 = timestamps[0];
   EXPECT_DOUBLE_EQ(hawkes_kernel_exp.get_convolution(time0 - 0.1, timestamps, nullptr), 0);
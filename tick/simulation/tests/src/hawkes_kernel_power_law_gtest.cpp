@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 #include <hawkes_kernels/hawkes_kernel_power_law.h>
+#include "hawkes_gtest_utils.h"
 
 class HawkesKernelPowerLawTest : public ::testing::Test {
  protected:
@@ -43,6 +44,53 @@ TEST_F(HawkesKernelPowerLawTest, get_norm) {
                    1.2096372793483503);
 }
 
+TEST_F(HawkesKernelPowerLawTest, get_primitive) {
+  EXPECT_DOUBLE_EQ(hawkes_kernel_power_law.get_primitive(-1.), 0);
+  for (double test_time : test_times) {
+    EXPECT_DOUBLE_EQ(hawkes_kernel_power_law.get_primitive(test_time),
+                     multiplier / (1 - exponent)
+                         * (pow(test_time + cutoff, 1 - exponent) - pow(cutoff, 1 - exponent)));
+  }
+  const double support = hawkes_kernel_power_law.get_support();
+  EXPECT_DOUBLE_EQ(hawkes_kernel_power_law.get_primitive(2 * support),
+                   hawkes_kernel_power_law.get_norm());
+
+  HawkesKernelPowerLaw kernel_exponent_1(multiplier, cutoff, 1., 10.);
+  EXPECT_DOUBLE_EQ(kernel_exponent_1.get_primitive(3.), multiplier * log((3. + cutoff) / cutoff));
+  EXPECT_NEAR(kernel_exponent_1.get_primitive(3.),
+              kernel_exponent_1.HawkesKernel::get_primitive(3.), 1e-3);
+}
+
+TEST_F(HawkesKernelPowerLawTest, add_primitive_convolutions) {
+  const ArrayDouble times = to_array_double(test_times);
+
+  // A short support, so that some events are older than the support
+  HawkesKernelPowerLaw kernel(multiplier, cutoff, exponent, 1.5);
+  ArrayDouble primitive_convolutions(times.size());
+  primitive_convolutions.init_to_zero();
+  kernel.add_primitive_convolutions(times, timestamps, primitive_convolutions);
+
+  const ArrayDouble expected = brute_force_primitive_convolutions(kernel, times, timestamps);
+  for (ulong q = 0; q < times.size(); ++q) {
+    EXPECT_NEAR(primitive_convolutions[q], expected[q], 1e-12);
+  }
+}
+
+TEST_F(HawkesKernelPowerLawTest, add_convolutions) {
+  ArrayDouble times {0.31, 1., 2.32, 3.5, 5., 8.};
+
+  // A short support, so that some events are older than the support
+  HawkesKernelPowerLaw kernel(multiplier, cutoff, exponent, 1.5);
+  ArrayDouble convolutions(times.size());
+  convolutions.init_to_zero();
+  kernel.add_convolutions(times, timestamps, convolutions);
+
+  const ArrayDouble expected = brute_force_convolutions(kernel, times, timestamps);
+  for (ulong q = 0; q < times.size(); ++q) {
+    EXPECT_DOUBLE_EQ(convolutions[q], expected[q]);
+  }
+}
+
 TEST_F(HawkesKernelPowerLawTest, invalid_constructor_parameters) {
   EXPECT_THROW(HawkesKernelPowerLaw(multiplier, cutoff, exponent, -1, -1), std::invalid_argument);
   EXPECT_THROW(HawkesKernelPowerLaw(multiplier, cutoff, exponent, -1, 0), std::invalid_argument);
@@ -4,6 +4,7 @@
 #include <gtest/gtest.h>
 #include "base.h"
 #include <hawkes_kernels/hawkes_kernel_sum_exp.h>
+#include "hawkes_gtest_utils.h"
 
 double compute_sumexpkernel_get_value(ArrayDouble &decays,
                                       ArrayDouble &intensities,
@@ -121,6 +122,43 @@ TEST_F(HawkesKernelSumExpTest, get_norm) {
   EXPECT_DOUBLE_EQ(hawkes_kernel_sum_exp->get_norm(), intensities.sum());
 }
 
+TEST_F(HawkesKernelSumExpTest, get_primitive) {
+  EXPECT_DOUBLE_EQ(hawkes_kernel_sum_exp->get_primitive(-1.), 0);
+  for (double test_time : test_times) {
+    double expected = 0;
+    for (ulong u = 0; u < decays.size(); ++u)
+      expected += intensities[u] * (1 - exp(-decays[u] * test_time));
+    EXPECT_DOUBLE_EQ(hawkes_kernel_sum_exp->get_primitive(test_time), expected);
+  }
+}
+
+TEST_F(HawkesKernelSumExpTest, add_primitive_convolutions) {
+  const ArrayDouble times = to_array_double(test_times);
+
+  ArrayDouble primitive_convolutions(times.size());
+  primitive_convolutions.init_to_zero();
+  hawkes_kernel_sum_exp->add_primitive_convolutions(times, timestamps, primitive_convolutions);
+
+  const ArrayDouble expected =
+      brute_force_primitive_convolutions(*hawkes_kernel_sum_exp, times, timestamps);
+  for (ulong q = 0; q < times.size(); ++q) {
+    EXPECT_NEAR(primitive_convolutions[q], expected[q], 1e-12);
+  }
+}
+
+TEST_F(HawkesKernelSumExpTest, add_convolutions) {
+  const ArrayDouble times = to_array_double(test_times);
+
+  ArrayDouble convolutions(times.size());
+  convolutions.init_to_zero();
+  hawkes_kernel_sum_exp->add_convolutions(times, timestamps, convolutions);
+
+  const ArrayDouble expected = brute_force_convolutions(*hawkes_kernel_sum_exp, times, timestamps);
+  for (ulong q = 0; q < times.size(); ++q) {
+    EXPECT_NEAR(convolutions[q], expected[q], 1e-12);
+  }
+}
+
 TEST_F(HawkesKernelSumExpTest, get_convolution_value) {
   double time0 = timestamps[0];
   EXPECT_DOUBLE_EQ(hawkes_kernel_sum_exp->get_convolution(time0 - 0.1, timestamps, nullptr), 0);
@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 #include <hawkes_kernels/hawkes_kernel_time_func.h>
+#include "hawkes_gtest_utils.h"
 
 class HawkesKernelTimeFuncTest : public ::testing::Test {
  protected:
@@ -41,6 +42,64 @@ TEST_F(HawkesKernelTimeFuncTest, get_norm) {
   EXPECT_NEAR(hawkes_kernel_time_func->get_norm(), 5.5, 1e-3);
 }
 
+TEST_F(HawkesKernelTimeFuncTest, get_primitive) {
+  EXPECT_DOUBLE_EQ(hawkes_kernel_time_func->get_primitive(-3), 0);
+  EXPECT_DOUBLE_EQ(hawkes_kernel_time_func->get_primitive(1), 0);
+  EXPECT_NEAR(hawkes_kernel_time_func->get_primitive(2), 1., 1e-12);
+  EXPECT_NEAR(hawkes_kernel_time_func->get_primitive(3.5), 4.375, 1e-12);
+  EXPECT_NEAR(hawkes_kernel_time_func->get_primitive(4), 5.5, 1e-12);
+  EXPECT_NEAR(hawkes_kernel_time_func->get_primitive(10), 5.5, 1e-12);
+}
+
+TEST_F(HawkesKernelTimeFuncTest, add_primitive_convolutions) {
+  ArrayDouble times {0.5, 1.5, 2.32, 4.3, 6., 9.};
+  ArrayDouble timestamps {0.31, 0.93, 1.29, 2.32, 4.25};
+
+  ArrayDouble primitive_convolutions(times.size());
+  primitive_convolutions.init_to_zero();
+  hawkes_kernel_time_func->add_primitive_convolutions(times, timestamps, primitive_convolutions);
+
+  const ArrayDouble expected =
+      brute_force_primitive_convolutions(*hawkes_kernel_time_func, times, timestamps);
+  for (ulong q = 0; q < times.size(); ++q) {
+    EXPECT_NEAR(primitive_convolutions[q], expected[q], 1e-12);
+  }
+}
+
+TEST_F(HawkesKernelTimeFuncTest, get_convolution) {
+  ArrayDouble t_axis {0.5, 1., 2.5, 4};
+  ArrayDouble y_axis {1, 2, 0.5, 0};
+  ArrayDouble timestamps {0.31, 0.93, 1.29, 2.32, 4.25, 4.25, 6.};
+  ArrayDouble times {0.1, 0.93, 1.5, 2.32, 3.7, 4.25, 5.1, 7., 12.};
+
+  for (auto inter_mode : {TimeFunction::InterMode::InterLinear,
+                          TimeFunction::InterMode::InterConstLeft,
+                          TimeFunction::InterMode::InterConstRight}) {
+    HawkesKernelTimeFunc kernel(TimeFunction(t_axis, y_axis, TimeFunction::BorderType::Border0,
+                                             inter_mode, 0.1));
+
+    ArrayDouble convolutions(times.size());
+    convolutions.init_to_zero();
+    kernel.add_convolutions(times, timestamps, convolutions);
+
+    for (ulong q = 0; q < times.size(); ++q) {
+      // Generic convolution, on the events up to this time
+      ulong n_past = 0;
+      while (n_past < timestamps.size() && timestamps[n_past] <= times[q]) n_past++;
+      ArrayDouble past_timestamps(n_past);
+      std::copy(timestamps.data(), timestamps.data() + n_past, past_timestamps.data());
+
+      double bound, expected_bound;
+      const double expected = kernel.HawkesKernel::get_convolution(times[q], past_timestamps,
+                                                                   &expected_bound);
+      EXPECT_DOUBLE_EQ(kernel.get_convolution(times[q], timestamps, &bound), expected);
+      EXPECT_DOUBLE_EQ(bound, expected_bound);
+      EXPECT_DOUBLE_EQ(kernel.get_convolution(times[q], timestamps, nullptr), expected);
+      EXPECT_DOUBLE_EQ(convolutions[q], expected);
+    }
+  }
+}
+
 TEST_F(HawkesKernelTimeFuncTest, get_support) {
   EXPECT_GE(hawkes_kernel_time_func->get_support(), 4);
 }
\ No newline at end of file
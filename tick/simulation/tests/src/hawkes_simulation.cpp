@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 #include "hawkes.h"
+#include "hawkes_gtest_utils.h"
 
 TEST(SimuHawkesTest, constant_baseline) {
   Hawkes hawkes(1);
@@ -24,3 +25,92 @@ TEST(SimuHawkesTest, tuple_baseline) {
   // Check that intensity TimeFunction is cycled
   EXPECT_GT(hawkes.timestamps[0]->last(), 10);
 }
+
+class SimuHawkesKernelsTest : public ::testing::Test {
+ protected:
+  // Two nodes, with a constant and a piecewise linear baseline, and exponential, sum of
+  // exponentials and power law kernels
+  Hawkes hawkes;
+
+  SimuHawkesKernelsTest() : hawkes(2, 1039) {}
+
+  void SetUp() override {
+    hawkes.set_baseline(0, 0.4);
+    ArrayDouble t_values {0., 1., 2.};
+    ArrayDouble y_values {0.2, 0.6, 0.2};
+    hawkes.set_baseline(1, t_values, y_values);
+
+    HawkesKernelPtr kernel_exp = std::make_shared<HawkesKernelExp>(0.3, 2.);
+    ArrayDouble intensities {0.1, 0.2};
+    ArrayDouble decays {1., 3.};
+    HawkesKernelPtr kernel_sum_exp = std::make_shared<HawkesKernelSumExp>(intensities, decays);
+    HawkesKernelPtr kernel_power_law = std::make_shared<HawkesKernelPowerLaw>(0.1, 0.5, 1.5, 3.);
+    hawkes.set_kernel(0, 0, kernel_exp);
+    hawkes.set_kernel(0, 1, kernel_sum_exp);
+    hawkes.set_kernel(1, 0, kernel_power_law);
+  }
+};
+
+TEST_F(SimuHawkesKernelsTest, compensators) {
+  hawkes.simulate(100.);
+  SArrayDoublePtrList1D timestamps = hawkes.get_timestamps();
+  SArrayDoublePtrList1D compensators = hawkes.get_compensators(timestamps, 2);
+  SArrayDoublePtrList1D residuals = hawkes.get_residuals(timestamps);
+
+  for (unsigned int i = 0; i < 2; ++i) {
+    const ArrayDouble &times = *timestamps[i];
+    ASSERT_EQ(compensators[i]->size(), times.size());
+    ASSERT_EQ(residuals[i]->size(), times.size());
+
+    ArrayDouble expected(times.size());
+    for (ulong k = 0; k < times.size(); ++k) {
+      expected[k] = i == 0 ? 0.4 * times[k] : hawkes.baselines[i]->get_primitive(times[k]);
+    }
+    for (unsigned int j = 0; j < 2; ++j) {
+      expected.mult_incr(
+          brute_force_primitive_convolutions(*hawkes.get_kernel(i, j), times, *timestamps[j]), 1.);
+    }
+
+    double previous_compensator = 0;
+    for (ulong k = 0; k < times.size(); ++k) {
+      EXPECT_NEAR((*compensators[i])[k], expected[k], 1e-9);
+      EXPECT_NEAR((*residuals[i])[k], expected[k] - previous_compensator, 1e-9);
+      previous_compensator = expected[k];
+    }
+  }
+
+  SArrayDoublePtrList1D wrong_timestamps(1);
+  EXPECT_THROW(hawkes.get_compensators(wrong_timestamps), std::runtime_error);
+}
+
+TEST_F(SimuHawkesKernelsTest, intensities) {
+  hawkes.activate_itr(0.1);
+  hawkes.simulate(100.);
+  SArrayDoublePtrList1D timestamps = hawkes.get_timestamps();
+  ArrayDouble times = *hawkes.get_itr_times();
+  SArrayDoublePtrList1D computed_intensities = hawkes.get_intensities(times, timestamps, 2);
+
+  for (unsigned int i = 0; i < 2; ++i) {
+    ASSERT_EQ(computed_intensities[i]->size(), times.size());
+
+    ArrayDouble expected(times.size());
+    for (ulong q = 0; q < times.size(); ++q) expected[q] = hawkes.get_baseline(i, times[q]);
+    for (unsigned int j = 0; j < 2; ++j) {
+      expected.mult_incr(
+          brute_force_convolutions(*hawkes.get_kernel(i, j), times, *timestamps[j]), 1.);
+    }
+
+    for (ulong q = 0; q < times.size(); ++q) {
+      EXPECT_NEAR((*computed_intensities[i])[q], expected[q], 1e-9);
+    }
+  }
+
+  // Tracked intensity is recorded with the baseline of the previous time, hence it matches only
+  // for constant baselines
+  for (ulong q = 0; q < times.size(); ++q) {
+    EXPECT_NEAR((*computed_intensities[0])[q], (*hawkes.get_itr()[0])[q], 1e-9);
+  }
+
+  ArrayDouble unsorted_times {1., 0.5};
+  EXPECT_THROW(hawkes.get_intensities(unsorted_times, timestamps), std::runtime_error);
+}